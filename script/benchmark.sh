@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Indexes the bundled sample projects headless and writes one json benchmark report per project.
+# usage: script/benchmark.sh [release|debug] [output directory] [project names...]
+
+set -e
+
+ABORT="\033[31mAbort:\033[00m"
+SUCCESS="\033[32mSuccess:\033[00m"
+INFO="\033[33mInfo:\033[00m"
+
+ROOT_DIR="$( cd "$( dirname "$0" )/.." && pwd )"
+
+BUILD_TYPE="Release"
+if [ "$1" = "debug" ] || [ "$1" = "d" ]
+then
+	BUILD_TYPE="Debug"
+fi
+
+APP_DIR=$ROOT_DIR/build/$BUILD_TYPE/app
+if [ ! -x "$APP_DIR/Sourcetrail" ]
+then
+	echo -e $ABORT "no Sourcetrail executable found in $APP_DIR"
+	exit 1
+fi
+
+OUTPUT_DIR="${2:-$ROOT_DIR/build/benchmark}"
+mkdir -p $OUTPUT_DIR
+OUTPUT_DIR="$( cd "$OUTPUT_DIR" && pwd )"
+
+PROJECTS="${@:3}"
+if [ -z "$PROJECTS" ]
+then
+	PROJECTS="tictactoe_cpp tutorial"
+fi
+
+for PROJECT in $PROJECTS
+do
+	# index a fresh copy, so each run starts without a database and the sample projects stay untouched
+	WORK_DIR=$OUTPUT_DIR/$PROJECT
+	rm -rf $WORK_DIR
+	cp -r $ROOT_DIR/bin/app/user/projects/$PROJECT $WORK_DIR
+
+	echo -e $INFO "indexing $PROJECT"
+	(cd $APP_DIR && ./Sourcetrail index --full \
+		--benchmark-report $OUTPUT_DIR/$PROJECT.json \
+		$WORK_DIR/$PROJECT.srctrlprj)
+
+	if [ ! -f "$OUTPUT_DIR/$PROJECT.json" ]
+	then
+		echo -e $ABORT "no benchmark report written for $PROJECT"
+		exit 1
+	fi
+done
+
+echo -e $SUCCESS "benchmark reports written to $OUTPUT_DIR"
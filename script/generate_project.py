@@ -0,0 +1,270 @@
+#!/usr/bin/env python3
+# generates a synthetic C++ or Java project of configurable size and shape for scaling tests.
+# writes the sources, a compile_commands.json (C++) and a Sourcetrail project file.
+
+import argparse
+import json
+import os
+import random
+
+
+def parse_arguments():
+	parser = argparse.ArgumentParser(description='Generate a synthetic project for indexing scaling tests.')
+	parser.add_argument('output', help='directory the project gets written to')
+	parser.add_argument('--language', choices=['cpp', 'java'], default='cpp')
+	parser.add_argument('--name', default=None, help='project name, defaults to the output directory name')
+	parser.add_argument('--files', type=int, default=100, help='number of source files (C++: plus one header each)')
+	parser.add_argument('--include-depth', type=int, default=4,
+		help='C++: length of header include chains, Java: depth of nested packages')
+	parser.add_argument('--classes-per-file', type=int, default=4)
+	parser.add_argument('--methods-per-class', type=int, default=4)
+	parser.add_argument('--functions-per-file', type=int, default=8)
+	parser.add_argument('--template-density', type=float, default=0.25,
+		help='fraction of classes that are templates (C++) or generics (Java)')
+	parser.add_argument('--fan-out', type=int, default=3, help='number of classes deriving from each class')
+	parser.add_argument('--call-graph', choices=['chain', 'tree', 'random'], default='tree',
+		help='how the generated functions call each other')
+	parser.add_argument('--calls-per-function', type=int, default=2, help='calls per function for the random call graph')
+	parser.add_argument('--seed', type=int, default=0, help='seed, the same arguments always generate the same project')
+	return parser.parse_args()
+
+
+class Module:
+	def __init__(self, index, level, parent):
+		self.index = index
+		self.level = level
+		self.parent = parent	# module whose declarations are visible in this one, or None
+		self.classes = []		# (class name, base index within module or -1, is template)
+		self.functions = []
+
+	def visible_modules(self):
+		module = self
+		while module:
+			yield module
+			module = module.parent
+
+
+def create_modules(args):
+	# modules are arranged in levels, each module sees exactly one module of the level above,
+	# so the include (or package) depth is bounded by include_depth
+	rng = random.Random(args.seed)
+	depth = max(1, args.include_depth)
+	modules = []
+	for i in range(args.files):
+		level = i % depth
+		parent = None
+		if level > 0:
+			candidates = [m for m in modules if m.level == level - 1]
+			parent = rng.choice(candidates)
+		module = Module(i, level, parent)
+
+		for c in range(args.classes_per_file):
+			# classes form a tree with the requested fan-out, the root derives from the parent module
+			base = (c - 1) // max(1, args.fan_out) if c > 0 else -1
+			module.classes.append(('Class%d_%d' % (i, c), base, rng.random() < args.template_density))
+		module.functions = ['function%d_%d' % (i, f) for f in range(args.functions_per_file)]
+		modules.append(module)
+	return modules
+
+
+def callees(args, rng, module, function_index):
+	local = module.functions
+	outer = module.parent.functions if module.parent else []
+	if args.call_graph == 'chain':
+		if function_index + 1 < len(local):
+			return [(module, function_index + 1)]
+		return [(module.parent, 0)] if outer else []
+	if args.call_graph == 'tree':
+		children = [c for c in (2 * function_index + 1, 2 * function_index + 2) if c < len(local)]
+		if children:
+			return [(module, c) for c in children]
+		return [(module.parent, 0)] if outer else []
+
+	# random: any function of a visible module that cannot recurse
+	candidates = []
+	for visible in module.visible_modules():
+		for f in range(len(visible.functions)):
+			if visible != module or f > function_index:
+				candidates.append((visible, f))
+	return rng.sample(candidates, min(args.calls_per_function, len(candidates)))
+
+
+def base_class_name(module, base, language):
+	if base >= 0:
+		name, _, is_template = module.classes[base]
+	elif module.parent:
+		name, _, is_template = module.parent.classes[0]
+	else:
+		return None
+	if is_template:
+		return name + ('<int>' if language == 'cpp' else '<Integer>')
+	return name
+
+
+def write_file(path, lines):
+	os.makedirs(os.path.dirname(path), exist_ok=True)
+	with open(path, 'w') as f:
+		f.write('\n'.join(lines) + '\n')
+
+
+def generate_cpp(args, modules, output):
+	rng = random.Random(args.seed + 1)
+	compile_commands = []
+	for module in modules:
+		header = ['#pragma once', '']
+		if module.parent:
+			header.append('#include "module%d.h"' % module.parent.index)
+		header.append('')
+		header.append('namespace module%d' % module.index)
+		header.append('{')
+		for f in module.functions:
+			header.append('int %s(int value);' % f)
+		header.append('')
+
+		for c, (name, base, is_template) in enumerate(module.classes):
+			base_name = base_class_name(module, base, 'cpp')
+			if base < 0 and module.parent:
+				base_name = 'module%d::%s' % (module.parent.index, base_name)
+			if is_template:
+				header.append('template <typename T>')
+			header.append('class %s%s' % (name, ' : public ' + base_name if base_name else ''))
+			header.append('{')
+			header.append('public:')
+			for m in range(args.methods_per_class):
+				function = module.functions[m % len(module.functions)] if module.functions else None
+				body = 'return %s(value + %d);' % (function, m) if function else 'return value;'
+				header.append('\tint method%d(int value) { %s }' % (m, body))
+			if is_template:
+				header.append('\tT member;')
+			header.append('};')
+			header.append('')
+		header.append('}')
+		write_file(os.path.join(output, 'include', 'module%d.h' % module.index), header)
+
+		source = ['#include "module%d.h"' % module.index, '', 'namespace module%d' % module.index, '{']
+		for i, f in enumerate(module.functions):
+			source.append('int %s(int value)' % f)
+			source.append('{')
+			for callee_module, callee_index in callees(args, rng, module, i):
+				source.append('\tvalue += module%d::%s(value - 1);' % (
+					callee_module.index, callee_module.functions[callee_index]))
+			source.append('\treturn value;')
+			source.append('}')
+			source.append('')
+		for name, _, is_template in module.classes:
+			if is_template:
+				source.append('template class %s<int>;' % name)
+		source.append('}')
+		source_path = os.path.join(output, 'src', 'module%d.cpp' % module.index)
+		write_file(source_path, source)
+
+		compile_commands.append({
+			'directory': output,
+			'command': 'clang++ -std=c++17 -I%s -c %s' % (os.path.join(output, 'include'), source_path),
+			'file': source_path})
+
+	with open(os.path.join(output, 'compile_commands.json'), 'w') as f:
+		json.dump(compile_commands, f, indent=1)
+
+	return '\n'.join([
+		'            <build_file_path>',
+		'                <compilation_db_path>./compile_commands.json</compilation_db_path>',
+		'            </build_file_path>',
+		'            <indexed_header_paths>',
+		'                <indexed_header_path>./include</indexed_header_path>',
+		'            </indexed_header_paths>',
+		'            <name>Generated Source Group</name>',
+		'            <status>enabled</status>',
+		'            <type>C/C++ from Compilation Database</type>'])
+
+
+def java_package(module):
+	parts = []
+	for visible in module.visible_modules():
+		parts.insert(0, 'module%d' % visible.index)
+	return 'generated.' + '.'.join(parts)
+
+
+def generate_java(args, modules, output):
+	rng = random.Random(args.seed + 1)
+	for module in modules:
+		package = java_package(module)
+		directory = os.path.join(output, 'src', *package.split('.'))
+
+		# the free functions of a module become static methods of its Functions class
+		functions = ['package %s;' % package, '', 'public class Functions', '{']
+		for i, f in enumerate(module.functions):
+			functions.append('\tpublic static int %s(int value)' % f)
+			functions.append('\t{')
+			for callee_module, callee_index in callees(args, rng, module, i):
+				functions.append('\t\tvalue += %s.Functions.%s(value - 1);' % (
+					java_package(callee_module), callee_module.functions[callee_index]))
+			functions.append('\t\treturn value;')
+			functions.append('\t}')
+		functions.append('}')
+		write_file(os.path.join(directory, 'Functions.java'), functions)
+
+		for name, base, is_template in module.classes:
+			base_name = base_class_name(module, base, 'java')
+			if base < 0 and module.parent:
+				base_name = java_package(module.parent) + '.' + base_name
+			lines = ['package %s;' % package, '']
+			lines.append('public class %s%s%s' % (
+				name, '<T>' if is_template else '', ' extends ' + base_name if base_name else ''))
+			lines.append('{')
+			for m in range(args.methods_per_class):
+				function = module.functions[m % len(module.functions)] if module.functions else None
+				body = 'return Functions.%s(value + %d);' % (function, m) if function else 'return value;'
+				lines.append('\tpublic int method%d(int value) { %s }' % (m, body))
+			if is_template:
+				lines.append('\tpublic T member;')
+			lines.append('}')
+			write_file(os.path.join(directory, name + '.java'), lines)
+
+	return '\n'.join([
+		'            <java_standard>12</java_standard>',
+		'            <name>Generated Source Group</name>',
+		'            <source_extensions>',
+		'                <source_extension>.java</source_extension>',
+		'            </source_extensions>',
+		'            <source_paths>',
+		'                <source_path>./src</source_path>',
+		'            </source_paths>',
+		'            <status>enabled</status>',
+		'            <type>Java Source Group</type>',
+		'            <use_jre_system_library>1</use_jre_system_library>'])
+
+
+def main():
+	args = parse_arguments()
+	output = os.path.abspath(args.output)
+	name = args.name or os.path.basename(output)
+	os.makedirs(output, exist_ok=True)
+
+	modules = create_modules(args)
+	if args.language == 'cpp':
+		source_group = generate_cpp(args, modules, output)
+	else:
+		source_group = generate_java(args, modules, output)
+
+	with open(os.path.join(output, name + '.srctrlprj'), 'w') as f:
+		f.write('\n'.join([
+			'<?xml version="1.0" encoding="utf-8" ?>',
+			'<config>',
+			'    <source_groups>',
+			'        <source_group_00000000-0000-0000-0000-000000000000>',
+			source_group,
+			'        </source_group_00000000-0000-0000-0000-000000000000>',
+			'    </source_groups>',
+			'    <version>8</version>',
+			'</config>',
+			'']))
+
+	class_count = len(modules) * args.classes_per_file
+	function_count = len(modules) * (args.functions_per_file + args.classes_per_file * args.methods_per_class)
+	print('generated %s project "%s" with %d files, %d classes and %d functions' % (
+		args.language, name, len(modules), class_count, function_count))
+
+
+if __name__ == '__main__':
+	main()
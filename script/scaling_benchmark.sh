@@ -0,0 +1,59 @@
+#!/bin/bash
+
+# Generates synthetic projects of growing size and indexes each of them headless, writing one json
+# benchmark report per project that also contains the times of the most common storage queries.
+# usage: script/scaling_benchmark.sh [release|debug] [output directory] [file counts...]
+# the shape of the generated projects can be changed with GENERATOR_ARGS, e.g.
+# GENERATOR_ARGS="--language java --call-graph random" script/scaling_benchmark.sh
+
+set -e
+
+ABORT="\033[31mAbort:\033[00m"
+SUCCESS="\033[32mSuccess:\033[00m"
+INFO="\033[33mInfo:\033[00m"
+
+ROOT_DIR="$( cd "$( dirname "$0" )/.." && pwd )"
+
+BUILD_TYPE="Release"
+if [ "$1" = "debug" ] || [ "$1" = "d" ]
+then
+	BUILD_TYPE="Debug"
+fi
+
+APP_DIR=$ROOT_DIR/build/$BUILD_TYPE/app
+if [ ! -x "$APP_DIR/Sourcetrail" ]
+then
+	echo -e $ABORT "no Sourcetrail executable found in $APP_DIR"
+	exit 1
+fi
+
+OUTPUT_DIR="${2:-$ROOT_DIR/build/scaling_benchmark}"
+mkdir -p $OUTPUT_DIR
+OUTPUT_DIR="$( cd "$OUTPUT_DIR" && pwd )"
+
+FILE_COUNTS="${@:3}"
+if [ -z "$FILE_COUNTS" ]
+then
+	FILE_COUNTS="100 1000 10000"
+fi
+
+for FILE_COUNT in $FILE_COUNTS
+do
+	PROJECT=generated_$FILE_COUNT
+	rm -rf $OUTPUT_DIR/$PROJECT
+
+	python3 $ROOT_DIR/script/generate_project.py $OUTPUT_DIR/$PROJECT --files $FILE_COUNT $GENERATOR_ARGS
+
+	echo -e $INFO "indexing $PROJECT"
+	(cd $APP_DIR && ./Sourcetrail index --full \
+		--benchmark-report $OUTPUT_DIR/$PROJECT.json \
+		$OUTPUT_DIR/$PROJECT/$PROJECT.srctrlprj)
+
+	if [ ! -f "$OUTPUT_DIR/$PROJECT.json" ]
+	then
+		echo -e $ABORT "no benchmark report written for $PROJECT"
+		exit 1
+	fi
+done
+
+echo -e $SUCCESS "benchmark reports written to $OUTPUT_DIR"
@@ -11,10 +11,12 @@
 #include "CommandLineParser.h"
 #include "ConsoleLogger.h"
 #include "FileLogger.h"
+#include "IndexingBenchmark.h"
 #include "LanguagePackageManager.h"
 #include "LogManager.h"
 #include "MessageIndexingInterrupted.h"
 #include "MessageLoadProject.h"
+#include "MessageReindexFile.h"
 #include "MessageStatus.h"
 #include "QtApplication.h"
 #include "QtCoreApplication.h"
@@ -159,8 +161,20 @@ int main(int argc, char* argv[])
 		{
 			std::wcout << commandLineParser.getError() << std::endl;
 		}
+		else if (!commandLineParser.getReindexFilePath().empty())
+		{
+			// the file gets re-indexed within this process once the project is loaded
+			MessageLoadProject(commandLineParser.getProjectFilePath()).dispatch();
+			MessageReindexFile(commandLineParser.getReindexFilePath()).dispatch();
+		}
 		else
 		{
+			if (!commandLineParser.getBenchmarkReportFilePath().empty())
+			{
+				IndexingBenchmark::getInstance()->enable(
+					commandLineParser.getBenchmarkReportFilePath());
+			}
+
 			MessageLoadProject(
 				commandLineParser.getProjectFilePath(),
 				false,
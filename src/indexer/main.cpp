@@ -101,7 +101,14 @@ int main(int argc, char* argv[])
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
 
 	InterprocessIndexer indexer(instanceUuid, processId);
-	indexer.work();
+	indexer.setRecycleLimits(
+		static_cast<size_t>(std::max(0, appSettings->getIndexerProcessMaximumTranslationUnitCount())),
+		static_cast<size_t>(std::max(0, appSettings->getIndexerProcessMaximumMemory())));
+	if (appSettings->getSharedHeaderIndexingEnabled())
+	{
+		indexer.enableSharedHeaderIndexing();
+	}
 
-	return 0;
+	// a non-zero exit code makes the app restart this indexer process
+	return indexer.work() ? 0 : 1;
 }
@@ -8,6 +8,7 @@
 #include "FileSystem.h"
 #include "GraphViewStyle.h"
 #include "IDECommunicationController.h"
+#include "IndexingBenchmark.h"
 #include "LogManager.h"
 #include "MainView.h"
 #include "MessageFilterErrorCountUpdate.h"
@@ -233,9 +234,22 @@ void Application::handleMessage(MessageIndexingFinished* message)
 	if (m_hasGUI)
 	{
 		MessageRefreshUI().afterIndexing().dispatch();
+
+		// the file watcher does not report changes again that arrived while indexing
+		if (m_project && m_project->hasWatchedFileChanges())
+		{
+			MessageRefresh().watchedFilesOnly().dispatch();
+		}
 	}
 	else
 	{
+		if (m_project && IndexingBenchmark::getInstance()->isEnabled())
+		{
+			IndexingBenchmark::getInstance()->measureQueries(m_storageCache.get());
+			IndexingBenchmark::getInstance()->writeReport(
+				m_project->getDBFilePath(), m_storageCache->getStorageStats());
+		}
+
 		MessageQuitApplication().dispatch();
 	}
 }
@@ -333,6 +347,15 @@ void Application::handleMessage(MessageRefresh* message)
 {
 	TRACE("app refresh");
 
+	if (message->watchedFiles)
+	{
+		if (m_project && checkSharedMemory())
+		{
+			m_project->refreshWatchedFiles();
+		}
+		return;
+	}
+
 	refreshProject(message->all ? REFRESH_ALL_FILES : REFRESH_UPDATED_FILES, false);
 }
 
@@ -355,6 +378,19 @@ void Application::handleMessage(MessageRefreshUI* message)
 	}
 }
 
+void Application::handleMessage(MessageReindexFile* message)
+{
+	TRACE("app reindex file");
+
+	const bool reindexing = m_project && m_project->reindexFile(message->filePath);
+
+	// the re-indexed file finishes like indexing, which also quits without gui
+	if (!reindexing && !m_hasGUI)
+	{
+		MessageQuitApplication().dispatch();
+	}
+}
+
 void Application::handleMessage(MessageSwitchColorScheme* message)
 {
 	MessageStatus(L"Switch color scheme: " + message->colorSchemePath.wstr()).dispatch();
@@ -11,6 +11,7 @@
 #include "MessageLoadProject.h"
 #include "MessageRefresh.h"
 #include "MessageRefreshUI.h"
+#include "MessageReindexFile.h"
 #include "MessageSwitchColorScheme.h"
 #include "MessageWindowFocus.h"
 #include "Project.h"
@@ -31,6 +32,7 @@ class Application
 	, public MessageListener<MessageLoadProject>
 	, public MessageListener<MessageRefresh>
 	, public MessageListener<MessageRefreshUI>
+	, public MessageListener<MessageReindexFile>
 	, public MessageListener<MessageSwitchColorScheme>
 	, public MessageListener<MessageWindowFocus>
 {
@@ -72,6 +74,7 @@ private:
 	void handleMessage(MessageLoadProject* message) override;
 	void handleMessage(MessageRefresh* message) override;
 	void handleMessage(MessageRefreshUI* message) override;
+	void handleMessage(MessageReindexFile* message) override;
 	void handleMessage(MessageSwitchColorScheme* message) override;
 	void handleMessage(MessageWindowFocus* message) override;
 
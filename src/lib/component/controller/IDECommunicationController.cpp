@@ -4,6 +4,7 @@
 #include "MessageActivateWindow.h"
 #include "MessagePingReceived.h"
 #include "MessageProjectNew.h"
+#include "MessageReindexFile.h"
 #include "MessageStatus.h"
 #include "MessageTabOpenWith.h"
 #include "logging.h"
@@ -41,6 +42,10 @@ void IDECommunicationController::handleIncomingMessage(const std::wstring& messa
 	{
 		handleCreateCDBProjectMessage(NetworkProtocolHelper::parseCreateCDBProjectMessage(message));
 	}
+	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::REINDEX_FILE)
+	{
+		handleReindexFileMessage(NetworkProtocolHelper::parseReindexFileMessage(message));
+	}
 	else if (type == NetworkProtocolHelper::MESSAGE_TYPE::PING)
 	{
 		handlePing(NetworkProtocolHelper::parsePingMessage(message));
@@ -152,6 +157,19 @@ void IDECommunicationController::handleCreateCDBProjectMessage(
 	}
 }
 
+void IDECommunicationController::handleReindexFileMessage(
+	const NetworkProtocolHelper::ReindexFileMessage& message)
+{
+	if (message.valid)
+	{
+		MessageReindexFile(message.filePath.getCanonical()).dispatch();
+	}
+	else
+	{
+		LOG_ERROR_STREAM(<< "Unable to re-index file, invalid data received");
+	}
+}
+
 void IDECommunicationController::handlePing(const NetworkProtocolHelper::PingMessage& message)
 {
 	if (message.valid)
@@ -43,6 +43,7 @@ private:
 	void handleSetActiveTokenMessage(const NetworkProtocolHelper::SetActiveTokenMessage& message);
 	void handleCreateProjectMessage(const NetworkProtocolHelper::CreateProjectMessage& message);
 	void handleCreateCDBProjectMessage(const NetworkProtocolHelper::CreateCDBProjectMessage& message);
+	void handleReindexFileMessage(const NetworkProtocolHelper::ReindexFileMessage& message);
 	void handlePing(const NetworkProtocolHelper::PingMessage& message);
 
 	virtual void handleMessage(MessageWindowFocus* message);
@@ -15,6 +15,7 @@ std::wstring NetworkProtocolHelper::s_endOfMessageToken = L"<EOM>";
 std::wstring NetworkProtocolHelper::s_createProjectPrefix = L"createProject";
 std::wstring NetworkProtocolHelper::s_createCDBProjectPrefix = L"createCDBProject";
 std::wstring NetworkProtocolHelper::s_createCDBPrefix = L"createCDB";
+std::wstring NetworkProtocolHelper::s_reindexFilePrefix = L"reindexFile";
 std::wstring NetworkProtocolHelper::s_pingPrefix = L"ping";
 
 NetworkProtocolHelper::MESSAGE_TYPE NetworkProtocolHelper::getMessageType(const std::wstring& message)
@@ -35,6 +36,10 @@ NetworkProtocolHelper::MESSAGE_TYPE NetworkProtocolHelper::getMessageType(const
 		{
 			return MESSAGE_TYPE::CREATE_CDB_MESSAGE;
 		}
+		else if (subMessages[0] == s_reindexFilePrefix)
+		{
+			return MESSAGE_TYPE::REINDEX_FILE;
+		}
 		else if (subMessages[0] == s_pingPrefix)
 		{
 			return MESSAGE_TYPE::PING;
@@ -176,6 +181,38 @@ NetworkProtocolHelper::CreateCDBProjectMessage NetworkProtocolHelper::parseCreat
 	return networkMessage;
 }
 
+NetworkProtocolHelper::ReindexFileMessage NetworkProtocolHelper::parseReindexFileMessage(
+	const std::wstring& message)
+{
+	std::vector<std::wstring> subMessages = divideMessage(message);
+
+	NetworkProtocolHelper::ReindexFileMessage networkMessage;
+
+	if (!subMessages.empty())
+	{
+		if (subMessages[0] == s_reindexFilePrefix)
+		{
+			if (subMessages.size() != 3)
+			{
+				LOG_ERROR("Failed to parse reindexFile message, invalid token count");
+			}
+			else if (!subMessages[1].empty())
+			{
+				networkMessage.filePath = FilePath(subMessages[1]);
+				networkMessage.valid = true;
+			}
+		}
+		else
+		{
+			LOG_ERROR(
+				L"Failed to parse message, invalid type token: " + subMessages[0] + L". Expected " +
+				s_reindexFilePrefix);
+		}
+	}
+
+	return networkMessage;
+}
+
 NetworkProtocolHelper::PingMessage NetworkProtocolHelper::parsePingMessage(const std::wstring& message)
 {
 	std::vector<std::wstring> subMessages = divideMessage(message);
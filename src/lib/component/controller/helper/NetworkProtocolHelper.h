@@ -34,6 +34,15 @@ public:
 		bool valid;
 	};
 
+	struct ReindexFileMessage
+	{
+	public:
+		ReindexFileMessage(): filePath(L""), valid(false) {}
+
+		FilePath filePath;
+		bool valid;
+	};
+
 	struct PingMessage
 	{
 	public:
@@ -49,6 +58,7 @@ public:
 		SET_ACTIVE_TOKEN,
 		CREATE_PROJECT,
 		CREATE_CDB_MESSAGE,
+		REINDEX_FILE,
 		PING
 	};
 
@@ -57,6 +67,7 @@ public:
 	static SetActiveTokenMessage parseSetActiveTokenMessage(const std::wstring& message);
 	static CreateProjectMessage parseCreateProjectMessage(const std::wstring& message);
 	static CreateCDBProjectMessage parseCreateCDBProjectMessage(const std::wstring& message);
+	static ReindexFileMessage parseReindexFileMessage(const std::wstring& message);
 	static PingMessage parsePingMessage(const std::wstring& message);
 
 	static std::wstring buildSetIDECursorMessage(
@@ -75,6 +86,7 @@ private:
 	static std::wstring s_createProjectPrefix;
 	static std::wstring s_createCDBProjectPrefix;
 	static std::wstring s_createCDBPrefix;
+	static std::wstring s_reindexFilePrefix;
 	static std::wstring s_pingPrefix;
 };
 
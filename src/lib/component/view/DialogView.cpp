@@ -53,6 +53,8 @@ void DialogView::updateIndexingDialog(
 {
 }
 
+void DialogView::updateIndexingMemoryUsage(size_t byteSize, size_t byteBudget) {}
+
 void DialogView::updateCustomIndexingDialog(
 	size_t startedFileCount,
 	size_t finishedFileCount,
@@ -67,6 +69,8 @@ DatabasePolicy DialogView::finishedIndexingDialog(
 	size_t completedFileCount,
 	size_t totalFileCount,
 	float time,
+	float makespan,
+	float predictedMakespan,
 	ErrorCountInfo errorInfo,
 	bool interrupted,
 	bool shallow)
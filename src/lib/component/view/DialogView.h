@@ -59,6 +59,7 @@ public:
 		size_t finishedFileCount,
 		size_t totalFileCount,
 		const std::vector<FilePath>& sourcePaths);
+	virtual void updateIndexingMemoryUsage(size_t byteSize, size_t byteBudget);
 	virtual void updateCustomIndexingDialog(
 		size_t startedFileCount,
 		size_t finishedFileCount,
@@ -70,6 +71,8 @@ public:
 		size_t completedFileCount,
 		size_t totalFileCount,
 		float time,
+		float makespan,
+		float predictedMakespan,
 		ErrorCountInfo errorInfo,
 		bool interrupted,
 		bool shallow);
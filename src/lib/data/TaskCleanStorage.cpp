@@ -10,10 +10,12 @@ TaskCleanStorage::TaskCleanStorage(
 	std::weak_ptr<PersistentStorage> storage,
 	std::shared_ptr<DialogView> dialogView,
 	const std::vector<FilePath>& filePaths,
+	const std::set<FilePath>& keptFileNodePaths,
 	bool clearAllErrors)
 	: m_storage(storage)
 	, m_dialogView(dialogView)
 	, m_filePaths(filePaths)
+	, m_keptFileNodePaths(keptFileNodePaths)
 	, m_clearAllErrors(clearAllErrors)
 {
 }
@@ -43,7 +45,7 @@ Task::TaskState TaskCleanStorage::doUpdate(std::shared_ptr<Blackboard> blackboar
 			storage->clearAllErrors();
 		}
 
-		storage->clearFileElements(m_filePaths, [=](int progress) {
+		storage->clearFileElements(m_filePaths, m_keptFileNodePaths, [=](int progress) {
 			m_dialogView->showProgressDialog(
 				L"Clearing", std::to_wstring(m_filePaths.size()) + L" Files", progress);
 		});
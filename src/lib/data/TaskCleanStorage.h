@@ -1,6 +1,7 @@
 #ifndef TASK_CLEAN_STORAGE_H
 #define TASK_CLEAN_STORAGE_H
 
+#include <set>
 #include <vector>
 
 #include "Task.h"
@@ -17,6 +18,7 @@ public:
 		std::weak_ptr<PersistentStorage> storage,
 		std::shared_ptr<DialogView> dialogView,
 		const std::vector<FilePath>& filePaths,
+		const std::set<FilePath>& keptFileNodePaths,
 		bool clearAllErrors);
 
 private:
@@ -28,6 +30,7 @@ private:
 	std::weak_ptr<PersistentStorage> m_storage;
 	std::shared_ptr<DialogView> m_dialogView;
 	std::vector<FilePath> m_filePaths;
+	std::set<FilePath> m_keptFileNodePaths;
 	bool m_clearAllErrors;
 
 	TimeStamp m_start;
@@ -2,6 +2,7 @@
 
 #include "Blackboard.h"
 #include "DialogView.h"
+#include "IndexingBenchmark.h"
 #include "MessageIndexingFinished.h"
 #include "MessageIndexingStatus.h"
 #include "MessageStatus.h"
@@ -25,7 +26,9 @@ void TaskFinishParsing::terminate()
 
 void TaskFinishParsing::doEnter(std::shared_ptr<Blackboard> blackboard)
 {
+	IndexingBenchmark::ScopedPhase phase("finish_storage");
 	m_storage->setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+	m_storage->updateFileDependencies();
 }
 
 Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboard)
@@ -37,6 +40,7 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 	m_dialogView->hideUnknownProgressDialog();
 
 	double time = TimeStamp::durationSeconds(start);
+	IndexingBenchmark::getInstance()->addPhaseTime("optimize_storage", time);
 
 	if (blackboard->exists("clear_time"))
 	{
@@ -58,6 +62,12 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 	int sourceFileCount = 0;
 	blackboard->get("source_file_count", sourceFileCount);
 
+	float makespan = 0.0f;
+	blackboard->get("index_makespan", makespan);
+
+	float predictedMakespan = 0.0f;
+	blackboard->get("predicted_index_makespan", predictedMakespan);
+
 	bool interruptedIndexing = false;
 	blackboard->get("interrupted_indexing", interruptedIndexing);
 
@@ -86,6 +96,8 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 		stats.completedFileCount,
 		stats.fileCount,
 		static_cast<float>(time),
+		makespan,
+		predictedMakespan,
 		errorInfo,
 		interruptedIndexing,
 		shallowIndexing);
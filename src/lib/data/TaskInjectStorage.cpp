@@ -1,5 +1,7 @@
 #include "TaskInjectStorage.h"
 
+#include "Blackboard.h"
+#include "IndexingBenchmark.h"
 #include "Storage.h"
 #include "StorageProvider.h"
 
@@ -13,16 +15,20 @@ void TaskInjectStorage::doEnter(std::shared_ptr<Blackboard> blackboard) {}
 
 Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
-	if (m_storageProvider->getStorageCount() > 0)
+	// small storages keep getting merged while indexing, each injection commits a transaction
+	bool flush = false;
+	blackboard->get("indexer_threads_stopped", flush);
+
+	std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeStorageToInject(flush);
+	if (source)
 	{
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
-		if (source)
+		if (std::shared_ptr<Storage> target = m_target.lock())
 		{
-			if (std::shared_ptr<Storage> target = m_target.lock())
-			{
-				target->inject(source.get());
-				return STATE_SUCCESS;
-			}
+			IndexingBenchmark::getInstance()->addTranslationUnits(source->getIndexingCosts());
+
+			IndexingBenchmark::ScopedPhase phase("inject");
+			target->inject(source.get());
+			return STATE_SUCCESS;
 		}
 	}
 
@@ -1,5 +1,6 @@
 #include "TaskMergeStorages.h"
 
+#include "IndexingBenchmark.h"
 #include "StorageProvider.h"
 
 TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider)
@@ -11,30 +12,24 @@ void TaskMergeStorages::doEnter(std::shared_ptr<Blackboard> blackboard) {}
 
 Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> blackboard)
 {
-	if (m_storageProvider->getStorageCount() > 2)	 // largest storage won't be touched here
+	const int storageCount = m_storageProvider->getStorageCount();
+
+	// several of these tasks run in parallel, each merging a different pair of storages
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>> storages =
+		m_storageProvider->consumeStoragesToMerge();
+	if (!storages.first || !storages.second)
 	{
-		std::shared_ptr<IntermediateStorage> target = m_storageProvider->consumeSecondLargestStorage();
-		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeSecondLargestStorage();
-		if (target && source)
-		{
-			target->inject(source.get());
-			m_storageProvider->insert(target);
-			return STATE_SUCCESS;
-		}
-		else
-		{
-			if (target)
-			{
-				m_storageProvider->insert(target);
-			}
-			if (source)
-			{
-				m_storageProvider->insert(source);
-			}
-		}
+		m_storageProvider->waitForStorageCountAbove(storageCount, 100);
+		return STATE_FAILURE;
 	}
 
-	return STATE_FAILURE;
+	// the smaller storage gets copied into the larger one
+	{
+		IndexingBenchmark::ScopedPhase phase("merge");
+		storages.first->inject(storages.second.get());
+	}
+	m_storageProvider->insert(storages.first);
+	return STATE_SUCCESS;
 }
 
 void TaskMergeStorages::doExit(std::shared_ptr<Blackboard> blackboard) {}
@@ -0,0 +1,62 @@
+#include "InProcessIntermediateStorageManager.h"
+
+#include <string>
+
+#include "IntermediateStorage.h"
+
+InProcessIntermediateStorageManager::InProcessIntermediateStorageManager()
+	: m_storageCount(0), m_byteSize(0)
+{
+}
+
+bool InProcessIntermediateStorageManager::pushIntermediateStorage(
+	const std::shared_ptr<IntermediateStorage>& intermediateStorage, const FilePath& sourceFilePath)
+{
+	const size_t byteSize = intermediateStorage->getByteSize(sizeof(std::wstring));
+
+	m_storages.push(std::make_pair(intermediateStorage, byteSize));
+	m_byteSize += static_cast<long long>(byteSize);
+	m_storageCount++;
+	return true;
+}
+
+std::shared_ptr<IntermediateStorage> InProcessIntermediateStorageManager::popIntermediateStorage()
+{
+	// only pop while storages are counted, so the count never drops below zero. only the single
+	// consumer decreases it, so it cannot drop in between.
+	std::pair<std::shared_ptr<IntermediateStorage>, size_t> storage;
+	if (m_storageCount == 0 || !m_storages.pop(storage))
+	{
+		return nullptr;
+	}
+
+	m_storageCount--;
+	m_byteSize -= static_cast<long long>(storage.second);
+
+	{
+		std::lock_guard<std::mutex> lock(m_popMutex);
+	}
+	m_popCondition.notify_all();
+
+	return storage.first;
+}
+
+size_t InProcessIntermediateStorageManager::getIntermediateStorageCount()
+{
+	return m_storageCount;
+}
+
+size_t InProcessIntermediateStorageManager::getIntermediateStorageByteSize()
+{
+	const long long byteSize = m_byteSize;
+	return byteSize > 0 ? static_cast<size_t>(byteSize) : 0;
+}
+
+void InProcessIntermediateStorageManager::waitForIntermediateStorageByteSizeBelow(
+	size_t byteSize, size_t timeoutMS)
+{
+	std::unique_lock<std::mutex> lock(m_popMutex);
+	m_popCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&]() {
+		return m_storageCount == 0 || m_byteSize < static_cast<long long>(byteSize);
+	});
+}
@@ -0,0 +1,43 @@
+#ifndef IN_PROCESS_INTERMEDIATE_STORAGE_MANAGER_H
+#define IN_PROCESS_INTERMEDIATE_STORAGE_MANAGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#include "IntermediateStorageManager.h"
+#include "LockFreeQueue.h"
+
+// Hands storages from indexer threads to the app without copying them, shared by all indexer
+// threads of the app.
+class InProcessIntermediateStorageManager: public IntermediateStorageManager
+{
+public:
+	InProcessIntermediateStorageManager();
+
+	bool pushIntermediateStorage(
+		const std::shared_ptr<IntermediateStorage>& intermediateStorage,
+		const FilePath& sourceFilePath) override;
+	std::shared_ptr<IntermediateStorage> popIntermediateStorage() override;
+
+	size_t getIntermediateStorageCount() override;
+	size_t getIntermediateStorageByteSize() override;
+
+	void waitForIntermediateStorageByteSizeBelow(size_t byteSize, size_t timeoutMS) override;
+
+private:
+	// storages are queued with their byte size, so it does not need to be computed again on pop
+	LockFreeQueue<std::pair<std::shared_ptr<IntermediateStorage>, size_t>> m_storages;
+
+	// only published after the storage is linked into the queue, so a storage can be popped before
+	// its byte size was added and the sum may drop below zero for a moment
+	std::atomic<size_t> m_storageCount;
+	std::atomic<long long> m_byteSize;
+
+	// only used for waiting on the consumer, pushing does not lock
+	std::mutex m_popMutex;
+	std::condition_variable m_popCondition;
+};
+
+#endif	  // IN_PROCESS_INTERMEDIATE_STORAGE_MANAGER_H
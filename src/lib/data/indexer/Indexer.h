@@ -17,6 +17,8 @@ public:
 	IndexerCommandType getSupportedIndexerCommandType() const override;
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
 	void interrupt() override;
+	void setIndexedHeaderManager(
+		std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager) override;
 
 private:
 	virtual void doIndex(
@@ -46,6 +48,13 @@ void Indexer<T>::interrupt()
 	m_indexerStateInfo->indexingInterrupted = true;
 }
 
+template <typename T>
+void Indexer<T>::setIndexedHeaderManager(
+	std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager)
+{
+	m_indexerStateInfo->indexedHeaderManager = indexedHeaderManager;
+}
+
 template <typename T>
 std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCommand> indexerCommand)
 {
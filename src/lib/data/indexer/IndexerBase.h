@@ -9,6 +9,7 @@
 class FileRegister;
 class IndexerCommand;
 class IntermediateStorage;
+class InterprocessIndexedHeaderManager;
 
 class IndexerBase
 {
@@ -20,6 +21,9 @@ public:
 	virtual std::shared_ptr<IntermediateStorage> index(
 		std::shared_ptr<IndexerCommand> indexerCommand) = 0;
 	virtual void interrupt() = 0;
+
+	virtual void setIndexedHeaderManager(
+		std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager) = 0;
 };
 
 #endif	  // INDEXER_BASE_H
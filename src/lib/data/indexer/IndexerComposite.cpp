@@ -37,3 +37,12 @@ void IndexerComposite::interrupt()
 		it.second->interrupt();
 	}
 }
+
+void IndexerComposite::setIndexedHeaderManager(
+	std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setIndexedHeaderManager(indexedHeaderManager);
+	}
+}
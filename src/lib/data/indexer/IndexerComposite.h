@@ -19,6 +19,9 @@ public:
 
 	void interrupt() override;
 
+	void setIndexedHeaderManager(
+		std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager) override;
+
 private:
 	std::map<IndexerCommandType, std::shared_ptr<IndexerBase>> m_indexers;
 };
@@ -1,10 +1,17 @@
 #ifndef INDEXER_STATE_INFO_H
 #define INDEXER_STATE_INFO_H
 
+#include <memory>
+
+class InterprocessIndexedHeaderManager;
+
 struct IndexerStateInfo
 {
 public:
 	bool indexingInterrupted;
+
+	// set if headers are only indexed by the first translation unit that includes them
+	std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager;
 };
 
 #endif	  // INDEXER_STATE_INFO_H
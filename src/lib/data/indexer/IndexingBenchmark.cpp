@@ -0,0 +1,204 @@
+#include "IndexingBenchmark.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "FileSystem.h"
+#include "Graph.h"
+#include "NodeTypeSet.h"
+#include "SourceLocationCollection.h"
+#include "StorageAccess.h"
+#include "logging.h"
+
+IndexingBenchmark::ScopedPhase::ScopedPhase(const char* phaseName): m_phaseName(phaseName)
+{
+	if (IndexingBenchmark::getInstance()->isEnabled())
+	{
+		m_start = TimeStamp::now();
+	}
+}
+
+IndexingBenchmark::ScopedPhase::~ScopedPhase()
+{
+	std::shared_ptr<IndexingBenchmark> benchmark = IndexingBenchmark::getInstance();
+	if (benchmark->isEnabled())
+	{
+		benchmark->addPhaseTime(m_phaseName, TimeStamp::durationSeconds(m_start));
+	}
+}
+
+std::shared_ptr<IndexingBenchmark> IndexingBenchmark::s_instance(new IndexingBenchmark());
+
+std::shared_ptr<IndexingBenchmark> IndexingBenchmark::getInstance()
+{
+	return s_instance;
+}
+
+void IndexingBenchmark::enable(const FilePath& reportFilePath)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_reportFilePath = reportFilePath;
+	m_startTime = TimeStamp::now();
+	m_phaseTimes.clear();
+	m_translationUnits.clear();
+	m_enabled = true;
+}
+
+bool IndexingBenchmark::isEnabled() const
+{
+	return m_enabled;
+}
+
+void IndexingBenchmark::addPhaseTime(const std::string& phaseName, double seconds)
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	PhaseTime& phaseTime = m_phaseTimes[phaseName];
+	phaseTime.seconds += seconds;
+	phaseTime.count++;
+}
+
+void IndexingBenchmark::addTranslationUnits(const std::vector<StorageIndexingCost>& costs)
+{
+	if (!m_enabled)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_translationUnits.insert(m_translationUnits.end(), costs.begin(), costs.end());
+}
+
+void IndexingBenchmark::measureQueries(StorageAccess* storageAccess)
+{
+	if (!m_enabled || !storageAccess)
+	{
+		return;
+	}
+
+	std::vector<SearchMatch> matches;
+	{
+		ScopedPhase phase("query_autocompletion");
+		for (const wchar_t* query: {L"a", L"e", L"get", L"class"})
+		{
+			std::vector<SearchMatch> queryMatches = storageAccess->getAutocompletionMatches(
+				query, NodeTypeSet::all(), false);
+			matches.insert(matches.end(), queryMatches.begin(), queryMatches.end());
+		}
+	}
+
+	{
+		ScopedPhase phase("query_graph_for_all");
+		storageAccess->getGraphForAll();
+	}
+
+	// activate the first few matches the way the graph and code views do on a click
+	const size_t activatedMatchCount = 20;
+	for (size_t i = 0; i < matches.size() && i < activatedMatchCount; i++)
+	{
+		if (matches[i].tokenIds.empty())
+		{
+			continue;
+		}
+
+		std::vector<Id> activeTokenIds;
+		{
+			ScopedPhase phase("query_active_token_ids");
+			Id declarationId = 0;
+			activeTokenIds = storageAccess->getActiveTokenIdsForId(
+				matches[i].tokenIds.front(), &declarationId);
+		}
+
+		{
+			ScopedPhase phase("query_symbol_graph");
+			storageAccess->getGraphForActiveTokenIds(activeTokenIds, {});
+		}
+
+		{
+			ScopedPhase phase("query_source_locations");
+			storageAccess->getSourceLocationsForTokenIds(activeTokenIds);
+		}
+	}
+}
+
+bool IndexingBenchmark::writeReport(
+	const FilePath& databaseFilePath, const StorageStats& stats) const
+{
+	if (!m_enabled)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	// phases running in parallel add up their times, so these may exceed the total time
+	QJsonObject phases;
+	for (const auto& p: m_phaseTimes)
+	{
+		QJsonObject phase;
+		phase["seconds"] = p.second.seconds;
+		phase["count"] = static_cast<double>(p.second.count);
+		phases[QString::fromStdString(p.first)] = phase;
+	}
+
+	// sorted by path, so reports of repeated runs can be compared line by line
+	std::vector<StorageIndexingCost> translationUnits = m_translationUnits;
+	std::sort(
+		translationUnits.begin(),
+		translationUnits.end(),
+		[](const StorageIndexingCost& a, const StorageIndexingCost& b) {
+			return a.filePath < b.filePath;
+		});
+
+	QJsonArray translationUnitArray;
+	double parseSeconds = 0.0;
+	for (const StorageIndexingCost& cost: translationUnits)
+	{
+		QJsonObject translationUnit;
+		translationUnit["file"] = QString::fromStdWString(cost.filePath);
+		translationUnit["parse_ms"] = static_cast<double>(cost.indexingTimeMS);
+		translationUnit["peak_memory_kb"] = static_cast<double>(cost.peakMemoryKB);
+		translationUnit["result_size_kb"] = static_cast<double>(cost.resultSizeKB);
+		translationUnitArray.append(translationUnit);
+
+		parseSeconds += cost.indexingTimeMS / 1000.0;
+	}
+
+	QJsonObject database;
+	database["file"] = QString::fromStdWString(databaseFilePath.wstr());
+	database["byte_size"] = static_cast<double>(
+		databaseFilePath.exists() ? FileSystem::getFileByteSize(databaseFilePath) : 0);
+	database["file_count"] = static_cast<double>(stats.fileCount);
+	database["completed_file_count"] = static_cast<double>(stats.completedFileCount);
+	database["node_count"] = static_cast<double>(stats.nodeCount);
+	database["edge_count"] = static_cast<double>(stats.edgeCount);
+
+	QJsonObject report;
+	report["total_seconds"] = TimeStamp::durationSeconds(m_startTime);
+	report["parse_seconds"] = parseSeconds;
+	report["phases"] = phases;
+	report["translation_units"] = translationUnitArray;
+	report["database"] = database;
+
+	std::ofstream fileStream(m_reportFilePath.str(), std::ios::trunc | std::ios::binary);
+	if (!fileStream)
+	{
+		LOG_ERROR(L"Unable to write benchmark report to " + m_reportFilePath.wstr());
+		return false;
+	}
+
+	fileStream << QJsonDocument(report).toJson(QJsonDocument::Indented).toStdString();
+
+	LOG_INFO(L"Wrote benchmark report to " + m_reportFilePath.wstr());
+	return true;
+}
+
+IndexingBenchmark::IndexingBenchmark(): m_enabled(false) {}
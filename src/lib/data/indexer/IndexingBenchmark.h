@@ -0,0 +1,71 @@
+#ifndef INDEXING_BENCHMARK_H
+#define INDEXING_BENCHMARK_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+#include "StorageIndexingCost.h"
+#include "StorageStats.h"
+#include "TimeStamp.h"
+
+class StorageAccess;
+
+// collects the time spent in each phase of indexing and the parse time of each translation unit
+// while a headless benchmark run is going on, so it can be written as json report at the end.
+// recording does nothing unless the benchmark got enabled.
+class IndexingBenchmark
+{
+public:
+	// adds the time until destruction to the given phase
+	class ScopedPhase
+	{
+	public:
+		ScopedPhase(const char* phaseName);
+		~ScopedPhase();
+
+	private:
+		const char* m_phaseName;
+		TimeStamp m_start;
+	};
+
+	static std::shared_ptr<IndexingBenchmark> getInstance();
+
+	void enable(const FilePath& reportFilePath);
+	bool isEnabled() const;
+
+	void addPhaseTime(const std::string& phaseName, double seconds);
+	void addTranslationUnits(const std::vector<StorageIndexingCost>& costs);
+
+	// runs the queries the views use most on the finished index and adds their times as phases
+	void measureQueries(StorageAccess* storageAccess);
+
+	bool writeReport(const FilePath& databaseFilePath, const StorageStats& stats) const;
+
+private:
+	struct PhaseTime
+	{
+		double seconds = 0.0;
+		size_t count = 0;
+	};
+
+	static std::shared_ptr<IndexingBenchmark> s_instance;
+
+	IndexingBenchmark();
+	IndexingBenchmark(const IndexingBenchmark&) = delete;
+	void operator=(const IndexingBenchmark&) = delete;
+
+	std::atomic<bool> m_enabled;
+	FilePath m_reportFilePath;
+	TimeStamp m_startTime;
+
+	mutable std::mutex m_mutex;
+	std::map<std::string, PhaseTime> m_phaseTimes;
+	std::vector<StorageIndexingCost> m_translationUnits;
+};
+
+#endif	  // INDEXING_BENCHMARK_H
@@ -0,0 +1,117 @@
+#include "IndexingCostModel.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include "FileSystem.h"
+#include "utilityFile.h"
+
+IndexingCostModel::IndexingCostModel(const std::vector<StorageIndexingCost>& recordedCosts)
+{
+	for (const StorageIndexingCost& cost: recordedCosts)
+	{
+		m_recordedTimesMS[cost.filePath] = cost.indexingTimeMS;
+	}
+}
+
+std::vector<FilePath> IndexingCostModel::getScheduledSourceFilePaths(
+	const std::vector<FilePath>& sourceFilePaths)
+{
+	m_scheduledTimesMS.clear();
+
+	const bool hasRecordedTimes = std::any_of(
+		sourceFilePaths.begin(), sourceFilePaths.end(), [this](const FilePath& filePath) {
+			return m_recordedTimesMS.find(filePath.wstr()) != m_recordedTimesMS.end();
+		});
+	if (!hasRecordedTimes)
+	{
+		return utility::partitionFilePathsBySize(sourceFilePaths, 2);
+	}
+
+	struct ScheduledFile
+	{
+		FilePath filePath;
+		double byteSize;
+		double timeMS;
+		bool recorded;
+	};
+
+	std::vector<ScheduledFile> scheduledFiles;
+	scheduledFiles.reserve(sourceFilePaths.size());
+
+	double recordedByteSize = 0;
+	double recordedTimeMS = 0;
+	for (const FilePath& filePath: sourceFilePaths)
+	{
+		ScheduledFile file {
+			filePath,
+			filePath.exists() ? static_cast<double>(FileSystem::getFileByteSize(filePath)) : 1.0,
+			0.0,
+			false};
+
+		auto it = m_recordedTimesMS.find(filePath.wstr());
+		if (it != m_recordedTimesMS.end())
+		{
+			file.timeMS = static_cast<double>(it->second);
+			file.recorded = true;
+
+			recordedByteSize += file.byteSize;
+			recordedTimeMS += file.timeMS;
+		}
+
+		scheduledFiles.push_back(file);
+	}
+
+	const double timeMSPerByte = recordedByteSize > 0 ? recordedTimeMS / recordedByteSize : 0.0;
+	for (ScheduledFile& file: scheduledFiles)
+	{
+		if (!file.recorded)
+		{
+			file.timeMS = file.byteSize * timeMSPerByte;
+		}
+	}
+
+	std::stable_sort(
+		scheduledFiles.begin(),
+		scheduledFiles.end(),
+		[](const ScheduledFile& a, const ScheduledFile& b) { return a.timeMS > b.timeMS; });
+
+	std::vector<FilePath> scheduledFilePaths;
+	scheduledFilePaths.reserve(scheduledFiles.size());
+	for (const ScheduledFile& file: scheduledFiles)
+	{
+		scheduledFilePaths.push_back(file.filePath);
+		m_scheduledTimesMS.push_back(file.timeMS);
+	}
+	return scheduledFilePaths;
+}
+
+size_t IndexingCostModel::getPredictedMakespanMS(size_t indexerCount) const
+{
+	if (m_scheduledTimesMS.empty() || !indexerCount)
+	{
+		return 0;
+	}
+
+	std::priority_queue<double, std::vector<double>, std::greater<double>> indexerLoadsMS;
+	for (size_t i = 0; i < indexerCount; i++)
+	{
+		indexerLoadsMS.push(0.0);
+	}
+
+	for (double timeMS: m_scheduledTimesMS)
+	{
+		const double loadMS = indexerLoadsMS.top();
+		indexerLoadsMS.pop();
+		indexerLoadsMS.push(loadMS + timeMS);
+	}
+
+	double makespanMS = 0;
+	while (!indexerLoadsMS.empty())
+	{
+		makespanMS = indexerLoadsMS.top();
+		indexerLoadsMS.pop();
+	}
+	return static_cast<size_t>(makespanMS);
+}
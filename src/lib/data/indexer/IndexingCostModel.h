@@ -0,0 +1,32 @@
+#ifndef INDEXING_COST_MODEL_H
+#define INDEXING_COST_MODEL_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+#include "StorageIndexingCost.h"
+
+// Predicts how long indexing each source file takes from the times recorded during the previous
+// refresh. Source files without a recorded time are estimated by their size, scaled with the
+// average indexing time per byte of the recorded source files.
+class IndexingCostModel
+{
+public:
+	IndexingCostModel(const std::vector<StorageIndexingCost>& recordedCosts);
+
+	// orders the source files longest expected indexing time first, so the indexers don't end up
+	// waiting for a single large translation unit at the end of indexing
+	std::vector<FilePath> getScheduledSourceFilePaths(const std::vector<FilePath>& sourceFilePaths);
+
+	// makespan of the last schedule when each source file is handed to the next idle indexer,
+	// 0 if no indexing time was recorded for any of the scheduled source files
+	size_t getPredictedMakespanMS(size_t indexerCount) const;
+
+private:
+	std::map<std::wstring, size_t> m_recordedTimesMS;
+	std::vector<double> m_scheduledTimesMS;
+};
+
+#endif	  // INDEXING_COST_MODEL_H
@@ -0,0 +1,31 @@
+#ifndef INTERMEDIATE_STORAGE_MANAGER_H
+#define INTERMEDIATE_STORAGE_MANAGER_H
+
+#include <memory>
+
+class FilePath;
+class IntermediateStorage;
+
+// transport for indexing results from the indexers to the app
+class IntermediateStorageManager
+{
+public:
+	virtual ~IntermediateStorageManager() = default;
+
+	// returns false if the storage could not be queued. the path of the indexed source file is
+	// reported as crashed if the storage cannot be read back on the other side.
+	virtual bool pushIntermediateStorage(
+		const std::shared_ptr<IntermediateStorage>& intermediateStorage,
+		const FilePath& sourceFilePath) = 0;
+	// returns nullptr if no storage is ready or the next one could not be read back
+	virtual std::shared_ptr<IntermediateStorage> popIntermediateStorage() = 0;
+
+	virtual size_t getIntermediateStorageCount() = 0;
+	virtual size_t getIntermediateStorageByteSize() = 0;
+
+	// block until the queued storages take less than the given amount of bytes or the queue is
+	// empty, so a single storage exceeding the limit can always be queued
+	virtual void waitForIntermediateStorageByteSizeBelow(size_t byteSize, size_t timeoutMS) = 0;
+};
+
+#endif	  // INTERMEDIATE_STORAGE_MANAGER_H
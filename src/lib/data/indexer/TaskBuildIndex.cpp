@@ -1,10 +1,14 @@
 #include "TaskBuildIndex.h"
 
 #include "AppPath.h"
+#include "ApplicationSettings.h"
 #include "Blackboard.h"
 #include "DialogView.h"
 #include "FileLogger.h"
+#include "InProcessIntermediateStorageManager.h"
+#include "IndexingBenchmark.h"
 #include "InterprocessIndexer.h"
+#include "InterprocessIntermediateStorageManager.h"
 #include "MessageIndexingStatus.h"
 #include "MessageStatus.h"
 #include "ParserClientImpl.h"
@@ -18,16 +22,20 @@ TaskBuildIndex::TaskBuildIndex(
 	std::shared_ptr<StorageProvider> storageProvider,
 	std::shared_ptr<DialogView> dialogView,
 	const std::string& appUUID,
-	bool multiProcessIndexing)
+	bool multiProcessIndexing,
+	size_t indexerQueueByteBudget)
 	: m_storageProvider(storageProvider)
 	, m_dialogView(dialogView)
 	, m_appUUID(appUUID)
 	, m_multiProcessIndexing(multiProcessIndexing)
+	, m_indexerQueueByteBudget(indexerQueueByteBudget)
 	, m_interprocessIndexingStatusManager(appUUID, 0, true)
+	, m_interprocessIndexedHeaderManager(appUUID, 0, true)
 	, m_indexerCommandQueueStopped(false)
 	, m_processCount(processCount)
 	, m_interrupted(false)
 	, m_indexingFileCount(0)
+	, m_unfetchedProcessId(0)
 	, m_runningThreadCount(0)
 {
 }
@@ -36,6 +44,7 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 {
 	m_interprocessIndexingStatusManager.setIndexingInterrupted(false);
 
+	m_indexingStartTime = TimeStamp::now();
 	m_indexingFileCount = 0;
 	updateIndexingDialog(blackboard, std::vector<FilePath>());
 
@@ -46,6 +55,12 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 		logFilePath = dynamic_cast<FileLogger*>(logger)->getLogFilePath().wstr();
 	}
 
+	std::shared_ptr<InProcessIntermediateStorageManager> inProcessStorageManager;
+	if (!m_multiProcessIndexing)
+	{
+		inProcessStorageManager = std::make_shared<InProcessIntermediateStorageManager>();
+	}
+
 	// start indexer processes
 	for (unsigned int i = 0; i < m_processCount; i++)
 	{
@@ -56,16 +71,19 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 
 		const int processId = i + 1;	// 0 remains reserved for the main process
 
-		m_interprocessIntermediateStorageManagers.push_back(
-			std::make_shared<InterprocessIntermediateStorageManager>(m_appUUID, processId, true));
-
 		if (m_multiProcessIndexing)
 		{
+			// each process gets its own queue and an equal part of the budget
+			std::shared_ptr<InterprocessIntermediateStorageManager> storageManager =
+				std::make_shared<InterprocessIntermediateStorageManager>(m_appUUID, processId, true);
+			storageManager->setMaximumQueuedByteSize(m_indexerQueueByteBudget / m_processCount);
+			m_intermediateStorageManagers.push_back(storageManager);
 			m_processThreads.push_back(
 				new std::thread(&TaskBuildIndex::runIndexerProcess, this, processId, logFilePath));
 		}
 		else
 		{
+			m_intermediateStorageManagers.push_back(inProcessStorageManager);
 			m_processThreads.push_back(
 				new std::thread(&TaskBuildIndex::runIndexerThread, this, processId));
 		}
@@ -108,7 +126,7 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
 		updateIndexingDialog(blackboard, std::vector<FilePath>());
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	m_interprocessIndexingStatusManager.waitForIndexingStatusChange(50);
 
 	return STATE_RUNNING;
 }
@@ -122,6 +140,17 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 	}
 	m_processThreads.clear();
 
+	const float makespan = static_cast<float>(TimeStamp::durationSeconds(m_indexingStartTime));
+	float predictedMakespan = 0.0f;
+	blackboard->get<float>("predicted_index_makespan", predictedMakespan);
+	blackboard->set<float>("index_makespan", makespan);
+	IndexingBenchmark::getInstance()->addPhaseTime("indexing", makespan);
+
+	LOG_INFO(
+		"Indexing makespan: " + TimeStamp::secondsToString(makespan) +
+		(predictedMakespan > 0.0f ? ", predicted: " + TimeStamp::secondsToString(predictedMakespan)
+								  : ""));
+
 	if (!m_interrupted)
 	{
 		while (fetchIntermediateStorages(blackboard))
@@ -162,6 +191,7 @@ void TaskBuildIndex::doReset(std::shared_ptr<Blackboard> blackboard) {}
 void TaskBuildIndex::terminate()
 {
 	m_interrupted = true;
+	m_interprocessIndexingStatusManager.setIndexingInterrupted(true);
 	utility::killRunningProcesses();
 }
 
@@ -200,8 +230,10 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
 		commandArguments.push_back(L"\"" + logFilePath + L"\"");
 	}
 
+	// the indexer process keeps running until the indexer command queue is closed, it only needs to
+	// be restarted if it crashed or if it stopped after reaching its memory or translation unit limit
 	int result = 1;
-	while ((!m_indexerCommandQueueStopped || result != 0) && !m_interrupted)
+	while (result != 0 && !m_interrupted)
 	{
 		result = utility::executeProcessAndGetExitCode(commandPath, commandArguments, FilePath(), -1);
 
@@ -216,17 +248,20 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
 
 void TaskBuildIndex::runIndexerThread(int processId)
 {
-	do
 	{
-		InterprocessIndexer indexer(m_appUUID, processId);
-		indexer.work();	   // this will only return if there are no indexer commands left in the queue
-		if (!m_interrupted)
+		// all threads share one queue and the whole budget
+		InterprocessIndexer indexer(
+			m_appUUID,
+			processId,
+			m_intermediateStorageManagers[processId - 1],
+			m_indexerQueueByteBudget);
+		if (ApplicationSettings::getInstance()->getSharedHeaderIndexingEnabled())
 		{
-			// sleeping if interrupted may result in a crash due to objects that are already
-			// destroyed after waking up again
-			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			indexer.enableSharedHeaderIndexing();
 		}
-	} while (!m_indexerCommandQueueStopped && !m_interrupted);
+		indexer.work();	   // this will only return once the indexer command queue got closed and
+						   // drained or indexing got interrupted
+	}
 
 	{
 		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
@@ -238,12 +273,13 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 {
 	int poppedStorageCount = 0;
 
-	int providerStorageCount = m_storageProvider->getStorageCount();
-	if (providerStorageCount > 10)
+	// leave the storages with the indexers until merging and injecting freed enough memory
+	if (m_storageProvider->isOverBudget())
 	{
-		LOG_INFO_STREAM(<< "waiting, too many storages queued: " << providerStorageCount);
+		LOG_INFO_STREAM(
+			<< "waiting, storages too large: " << m_storageProvider->getByteSize() << " bytes");
 
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		m_storageProvider->waitForByteSizeBelowBudget(100);
 
 		return true;
 	}
@@ -251,15 +287,20 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 	TimeStamp t = TimeStamp::now();
 	do
 	{
-		Id finishedProcessId = m_interprocessIndexingStatusManager.getNextFinishedProcessId();
+		Id finishedProcessId = m_unfetchedProcessId;
+		m_unfetchedProcessId = 0;
+		if (!finishedProcessId)
+		{
+			finishedProcessId = m_interprocessIndexingStatusManager.getNextFinishedProcessId();
+		}
 		if (!finishedProcessId ||
-			finishedProcessId > m_interprocessIntermediateStorageManagers.size())
+			finishedProcessId > m_intermediateStorageManagers.size())
 		{
 			break;
 		}
 
-		std::shared_ptr<InterprocessIntermediateStorageManager> storageManager =
-			m_interprocessIntermediateStorageManagers[finishedProcessId - 1];
+		std::shared_ptr<IntermediateStorageManager> storageManager =
+			m_intermediateStorageManagers[finishedProcessId - 1];
 
 		const size_t storageCount = storageManager->getIntermediateStorageCount();
 		if (!storageCount)
@@ -267,11 +308,25 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 			break;
 		}
 
-		LOG_INFO_STREAM(<< storageManager->getProcessId() << " - storage count: " << storageCount);
-		m_storageProvider->insert(storageManager->popIntermediateStorage());
+		LOG_INFO_STREAM(<< finishedProcessId << " - storage count: " << storageCount);
+
+		std::shared_ptr<IntermediateStorage> storage;
+		{
+			IndexingBenchmark::ScopedPhase phase("storage_transfer");
+			storage = storageManager->popIntermediateStorage();
+		}
+		if (!storage)
+		{
+			// the push of the storage has not finished yet or it could not be read back, then the
+			// next storage of the process is fetched on the next update
+			m_unfetchedProcessId = finishedProcessId;
+			break;
+		}
+		m_storageProvider->insert(storage);
 		poppedStorageCount++;
-	} while (TimeStamp::now().deltaMS(t) <
-			 500);	  // don't process all storages at once to allow for status updates in-between
+	} while (!m_storageProvider->isOverBudget() &&
+			 TimeStamp::now().deltaMS(t) <
+				 500);	  // don't process all storages at once to allow for status updates in-between
 
 	if (poppedStorageCount > 0)
 	{
@@ -296,6 +351,8 @@ void TaskBuildIndex::updateIndexingDialog(
 
 	m_dialogView->updateIndexingDialog(
 		m_indexingFileCount, indexedSourceFileCount, sourceFileCount, sourcePaths);
+	m_dialogView->updateIndexingMemoryUsage(
+		m_storageProvider->getByteSize(), m_storageProvider->getByteBudget());
 
 	int progress = 0;
 	if (sourceFileCount)
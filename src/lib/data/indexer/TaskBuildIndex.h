@@ -6,10 +6,12 @@
 #include "MessageIndexingInterrupted.h"
 #include "MessageListener.h"
 #include "Task.h"
+#include "TimeStamp.h"
 
+#include "InterprocessIndexedHeaderManager.h"
 #include "InterprocessIndexerCommandManager.h"
 #include "InterprocessIndexingStatusManager.h"
-#include "InterprocessIntermediateStorageManager.h"
+#include "IntermediateStorageManager.h"
 
 class DialogView;
 class StorageProvider;
@@ -25,7 +27,8 @@ public:
 		std::shared_ptr<StorageProvider> storageProvider,
 		std::shared_ptr<DialogView> dialogView,
 		const std::string& appUUID,
-		bool multiProcessIndexing);
+		bool multiProcessIndexing,
+		size_t indexerQueueByteBudget);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -49,17 +52,22 @@ protected:
 	std::shared_ptr<DialogView> m_dialogView;
 	const std::string m_appUUID;
 	bool m_multiProcessIndexing;
+	const size_t m_indexerQueueByteBudget;	  // shared by all indexers, 0 means no limit
 
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
+	InterprocessIndexedHeaderManager m_interprocessIndexedHeaderManager;
 	bool m_indexerCommandQueueStopped;
 	size_t m_processCount;
 	bool m_interrupted;
 	size_t m_indexingFileCount;
+	TimeStamp m_indexingStartTime;
 
 	// store as plain pointers to avoid deallocation issues when closing app during indexing
 	std::vector<std::thread*> m_processThreads;
-	std::vector<std::shared_ptr<InterprocessIntermediateStorageManager>>
-		m_interprocessIntermediateStorageManagers;
+	// indexed by process id - 1, all indexer threads share a single in-process storage manager
+	std::vector<std::shared_ptr<IntermediateStorageManager>> m_intermediateStorageManagers;
+	// finished process whose storage was not ready to be popped yet, fetched again first
+	Id m_unfetchedProcessId;
 
 	size_t m_runningThreadCount;
 	std::mutex m_runningThreadCountMutex;
@@ -3,30 +3,47 @@
 #include "Blackboard.h"
 #include "FileSystem.h"
 #include "IndexerCommandProvider.h"
+#include "IndexingBenchmark.h"
+#include "TimeStamp.h"
 #include "logging.h"
-#include "utilityFile.h"
 
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(
 	const std::string& appUUID,
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-	size_t maximumQueueSize)
+	size_t maximumQueueSize,
+	const std::vector<StorageIndexingCost>& recordedIndexingCosts,
+	size_t indexerCount)
 	: m_indexerCommandProvider(std::move(indexerCommandProvider))
 	, m_indexerCommandManager(appUUID, 0, true)
 	, m_maximumQueueSize(maximumQueueSize)
+	, m_indexingCostModel(recordedIndexingCosts)
+	, m_indexerCount(indexerCount)
 {
 }
 
 void TaskFillIndexerCommandsQueue::doEnter(std::shared_ptr<Blackboard> blackboard)
 {
+	m_indexerCommandManager.setIndexerCommandQueueClosed(false);
+
 	{
+		IndexingBenchmark::ScopedPhase phase("command_queue_filling");
 		std::lock_guard<std::mutex> lock(m_commandsMutex);
-		for (const FilePath& filePath:
-			 utility::partitionFilePathsBySize(m_indexerCommandProvider->getAllSourceFilePaths(), 2))
+		for (const FilePath& filePath: m_indexingCostModel.getScheduledSourceFilePaths(
+				 m_indexerCommandProvider->getAllSourceFilePaths()))
 		{
 			m_filePathQueue.emplace(filePath);
 		}
 	}
 
+	const size_t predictedMakespanMS = m_indexingCostModel.getPredictedMakespanMS(m_indexerCount);
+	if (predictedMakespanMS)
+	{
+		LOG_INFO(
+			"Predicted indexing makespan with " + std::to_string(m_indexerCount) +
+			" indexers: " + TimeStamp::secondsToString(predictedMakespanMS / 1000.0));
+	}
+	blackboard->set<float>("predicted_index_makespan", predictedMakespanMS / 1000.0f);
+
 	fillCommandQueue();
 
 	blackboard->set<bool>("indexer_command_queue_started", true);
@@ -49,13 +66,16 @@ Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboar
 		}
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	// refill as soon as the indexers consumed half of the queue
+	m_indexerCommandManager.waitForIndexerCommandCountBelow(m_maximumQueueSize / 2 + 1, 200);
 
 	return STATE_RUNNING;
 }
 
 void TaskFillIndexerCommandsQueue::doExit(std::shared_ptr<Blackboard> blackboard)
 {
+	// let the indexers shut down once they processed the remaining commands
+	m_indexerCommandManager.setIndexerCommandQueueClosed(true);
 	blackboard->set<bool>("indexer_command_queue_stopped", true);
 }
 
@@ -67,6 +87,7 @@ void TaskFillIndexerCommandsQueue::doReset(std::shared_ptr<Blackboard> blackboar
 void TaskFillIndexerCommandsQueue::terminate()
 {
 	m_interrupted = true;
+	m_indexerCommandManager.setIndexerCommandQueueClosed(true);
 }
 
 void TaskFillIndexerCommandsQueue::handleMessage(MessageIndexingInterrupted* message)
@@ -100,6 +121,7 @@ bool TaskFillIndexerCommandsQueue::fillCommandQueue()
 		return false;
 	}
 
+	IndexingBenchmark::ScopedPhase phase("command_queue_filling");
 	std::lock_guard<std::mutex> lock(m_commandsMutex);
 	std::vector<std::shared_ptr<IndexerCommand>> commands;
 
@@ -7,6 +7,7 @@
 #include "MessageListener.h"
 #include "Task.h"
 
+#include "IndexingCostModel.h"
 #include "InterprocessIndexerCommandManager.h"
 
 class IndexerCommandProvider;
@@ -19,7 +20,9 @@ public:
 	TaskFillIndexerCommandsQueue(
 		const std::string& appUUID,
 		std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-		size_t maximumQueueSize);
+		size_t maximumQueueSize,
+		const std::vector<StorageIndexingCost>& recordedIndexingCosts,
+		size_t indexerCount);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -38,6 +41,9 @@ private:
 
 	const size_t m_maximumQueueSize;
 
+	IndexingCostModel m_indexingCostModel;
+	const size_t m_indexerCount;
+
 	std::queue<FilePath> m_filePathQueue;
 	std::mutex m_commandsMutex;
 
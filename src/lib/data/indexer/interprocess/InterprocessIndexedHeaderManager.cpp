@@ -0,0 +1,106 @@
+#include "InterprocessIndexedHeaderManager.h"
+
+#include "logging.h"
+
+const char* InterprocessIndexedHeaderManager::s_sharedMemoryNamePrefix = "ihdr_";
+
+const char* InterprocessIndexedHeaderManager::s_headersKeyName = "indexed_headers";
+
+namespace
+{
+// headers claimed by a translation unit that is still running map to the process id of its
+// indexer, committed headers map to 0
+using SharedHeaderMap = SharedMemory::Map<SharedMemory::String, Id>;
+}	 // namespace
+
+InterprocessIndexedHeaderManager::InterprocessIndexedHeaderManager(
+	const std::string& instanceUuid, Id processId, bool isOwner)
+	: BaseInterprocessDataManager(
+		  s_sharedMemoryNamePrefix + instanceUuid, 1048576 /* 1 MB */, instanceUuid, processId, isOwner)
+{
+}
+
+bool InterprocessIndexedHeaderManager::claimHeader(const std::string& headerKey)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const size_t requiredSize = 16384 + 4 * headerKey.size();
+	if (access.getFreeMemorySize() < requiredSize)
+	{
+		LOG_INFO_STREAM(
+			<< "grow memory - size: " << access.getMemorySize()
+			<< " free: " << access.getFreeMemorySize() << " alloc: " << access.getMemorySize());
+		access.growMemory(access.getMemorySize());
+	}
+
+	SharedHeaderMap* headers = access.accessValueWithAllocator<SharedHeaderMap>(s_headersKeyName);
+	if (!headers)
+	{
+		// index the header in case of doubt
+		return true;
+	}
+
+	SharedMemory::String key(access.getAllocator());
+	key = headerKey.c_str();
+
+	auto result = headers->insert(SharedHeaderMap::value_type(key, m_processId));
+	if (!result.second)
+	{
+		// a header is only skipped once the result that contains it got delivered, a pending claim
+		// gets released if its indexer crashes and nobody would record the header then
+		return result.first->second != 0;
+	}
+
+	m_claimedHeaderKeys.push_back(headerKey);
+	return true;
+}
+
+void InterprocessIndexedHeaderManager::commitClaimedHeaders()
+{
+	if (m_claimedHeaderKeys.empty())
+	{
+		return;
+	}
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedHeaderMap* headers = access.accessValueWithAllocator<SharedHeaderMap>(s_headersKeyName);
+	if (headers)
+	{
+		SharedMemory::String key(access.getAllocator());
+		for (const std::string& headerKey: m_claimedHeaderKeys)
+		{
+			key = headerKey.c_str();
+			SharedHeaderMap::iterator it = headers->find(key);
+			if (it != headers->end())
+			{
+				it->second = 0;
+			}
+		}
+	}
+
+	m_claimedHeaderKeys.clear();
+}
+
+void InterprocessIndexedHeaderManager::releaseClaimedHeaders()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedHeaderMap* headers = access.accessValueWithAllocator<SharedHeaderMap>(s_headersKeyName);
+	if (headers)
+	{
+		for (SharedHeaderMap::iterator it = headers->begin(); it != headers->end();)
+		{
+			if (it->second == m_processId)
+			{
+				it = headers->erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
+	}
+
+	m_claimedHeaderKeys.clear();
+}
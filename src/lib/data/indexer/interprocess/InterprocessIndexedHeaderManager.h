@@ -0,0 +1,35 @@
+#ifndef INTERPROCESS_INDEXED_HEADER_MANAGER_H
+#define INTERPROCESS_INDEXED_HEADER_MANAGER_H
+
+#include <vector>
+
+#include "BaseInterprocessDataManager.h"
+
+// Registry of the headers that were already indexed during the current refresh, shared by all
+// indexers. The first translation unit that claims a header records its contents, all others only
+// record references into it.
+class InterprocessIndexedHeaderManager: public BaseInterprocessDataManager
+{
+public:
+	InterprocessIndexedHeaderManager(const std::string& instanceUuid, Id processId, bool isOwner);
+	virtual ~InterprocessIndexedHeaderManager() = default;
+
+	// returns true if the header should be indexed by the caller, which is the case unless the
+	// header was claimed and committed by another translation unit
+	bool claimHeader(const std::string& headerKey);
+
+	// keep the headers claimed for the current translation unit after its result got delivered
+	void commitClaimedHeaders();
+
+	// allow other translation units to claim the headers again, also releases claims left over by a
+	// crashed indexer with the same process id
+	void releaseClaimedHeaders();
+
+private:
+	static const char* s_sharedMemoryNamePrefix;
+	static const char* s_headersKeyName;
+
+	std::vector<std::string> m_claimedHeaderKeys;
+};
+
+#endif	  // INTERPROCESS_INDEXED_HEADER_MANAGER_H
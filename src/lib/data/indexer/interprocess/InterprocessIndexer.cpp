@@ -1,36 +1,106 @@
 #include "InterprocessIndexer.h"
 
+#include <atomic>
+
 #include "FileRegister.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "IntermediateStorage.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
+#include "TimeStamp.h"
 #include "logging.h"
+#include "utilityApp.h"
 
 InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
 	: m_interprocessIndexerCommandManager(uuid, processId, false)
 	, m_interprocessIndexingStatusManager(uuid, processId, false)
-	, m_interprocessIntermediateStorageManager(uuid, processId, false)
+	, m_maximumQueuedByteSize(0)
+	, m_recordPeakMemory(true)
 	, m_uuid(uuid)
 	, m_processId(processId)
+	, m_maximumTranslationUnitCount(0)
+	, m_maximumMemoryMB(0)
 {
+	// the app sets the limit for this process when creating the shared memory
+	std::shared_ptr<InterprocessIntermediateStorageManager> intermediateStorageManager =
+		std::make_shared<InterprocessIntermediateStorageManager>(uuid, processId, false);
+	m_maximumQueuedByteSize = intermediateStorageManager->getMaximumQueuedByteSize();
+	m_intermediateStorageManager = intermediateStorageManager;
 }
 
-void InterprocessIndexer::work()
+InterprocessIndexer::InterprocessIndexer(
+	const std::string& uuid,
+	Id processId,
+	std::shared_ptr<IntermediateStorageManager> intermediateStorageManager,
+	size_t maximumQueuedByteSize)
+	: m_interprocessIndexerCommandManager(uuid, processId, false)
+	, m_interprocessIndexingStatusManager(uuid, processId, false)
+	, m_intermediateStorageManager(intermediateStorageManager)
+	, m_maximumQueuedByteSize(maximumQueuedByteSize)
+	, m_recordPeakMemory(false)
+	, m_uuid(uuid)
+	, m_processId(processId)
+	, m_maximumTranslationUnitCount(0)
+	, m_maximumMemoryMB(0)
 {
+}
+
+void InterprocessIndexer::setRecycleLimits(size_t maximumTranslationUnitCount, size_t maximumMemoryMB)
+{
+	m_maximumTranslationUnitCount = maximumTranslationUnitCount;
+	m_maximumMemoryMB = maximumMemoryMB;
+}
+
+void InterprocessIndexer::enableSharedHeaderIndexing()
+{
+	m_indexedHeaderManager = std::make_shared<InterprocessIndexedHeaderManager>(
+		m_uuid, m_processId, false);
+}
+
+bool InterprocessIndexer::work()
+{
+	bool recycle = false;
 	bool updaterThreadRunning = true;
 	std::shared_ptr<std::thread> updaterThread;
 	std::shared_ptr<IndexerBase> indexer;
 
+	std::atomic<size_t> peakResidentMemory(0);
+	auto sampleResidentMemory = [&]() {
+		const size_t residentMemory = utility::getResidentMemorySize();
+		size_t peak = peakResidentMemory;
+		while (residentMemory > peak && !peakResidentMemory.compare_exchange_weak(peak, residentMemory))
+			;
+	};
+
 	try
 	{
 		LOG_INFO_STREAM(<< m_processId << " starting up indexer");
 		indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
 
+		if (m_indexedHeaderManager)
+		{
+			// headers claimed by a previous indexer with this id that crashed need to be indexed again
+			m_indexedHeaderManager->releaseClaimedHeaders();
+			indexer->setIndexedHeaderManager(m_indexedHeaderManager);
+		}
+
 		updaterThread = std::make_shared<std::thread>([&]() {
+			size_t tickCount = 0;
 			while (updaterThreadRunning)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+				if (m_recordPeakMemory)
+				{
+					sampleResidentMemory();
+				}
+
+				// checking for interrupts is more expensive than sampling the memory
+				if (++tickCount % 10)
+				{
+					continue;
+				}
 
 				if (m_interprocessIndexingStatusManager.getIndexingInterrupted())
 				{
@@ -53,9 +123,23 @@ void InterprocessIndexer::work()
 			}
 		});
 
-		while (std::shared_ptr<IndexerCommand> indexerCommand =
-				   m_interprocessIndexerCommandManager.popIndexerCommand())
+		size_t indexedTranslationUnitCount = 0;
+		while (updaterThreadRunning)
 		{
+			std::shared_ptr<IndexerCommand> indexerCommand =
+				m_interprocessIndexerCommandManager.popIndexerCommand();
+			if (!indexerCommand)
+			{
+				if (m_interprocessIndexerCommandManager.getIndexerCommandQueueClosed())
+				{
+					break;
+				}
+
+				// stay alive and wait for the queue to get refilled
+				m_interprocessIndexerCommandManager.waitForIndexerCommands(1000);
+				continue;
+			}
+
 			LOG_INFO_STREAM(
 				<< m_processId << " fetched indexer command for \""
 				<< indexerCommand->getSourceFilePath().str() << "\"");
@@ -63,18 +147,24 @@ void InterprocessIndexer::work()
 				<< m_processId << " indexer commands left: "
 				<< m_interprocessIndexerCommandManager.indexerCommandCount());
 
-			while (updaterThreadRunning)
+			while (updaterThreadRunning && m_maximumQueuedByteSize)
 			{
-				const size_t storageCount =
-					m_interprocessIntermediateStorageManager.getIntermediateStorageCount();
-				if (storageCount < 2)
+				// a single queued result may exceed the limit, otherwise a large translation unit
+				// could never be handed over
+				const size_t storageByteSize =
+					m_intermediateStorageManager->getIntermediateStorageByteSize();
+				if (storageByteSize < m_maximumQueuedByteSize ||
+					!m_intermediateStorageManager->getIntermediateStorageCount())
 				{
 					break;
 				}
 
-				LOG_INFO_STREAM(<< m_processId << " waits, too many intermediate storages: " << storageCount);
+				LOG_INFO_STREAM(
+					<< m_processId << " waits, intermediate storages too large: " << storageByteSize
+					<< " bytes");
 
-				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+				m_intermediateStorageManager->waitForIntermediateStorageByteSizeBelow(
+					m_maximumQueuedByteSize, 1000);
 			}
 
 			if (!updaterThreadRunning)
@@ -87,18 +177,66 @@ void InterprocessIndexer::work()
 				indexerCommand->getSourceFilePath());
 
 			LOG_INFO_STREAM(<< m_processId << " starting to index current file");
+			const TimeStamp indexingStartTime = TimeStamp::now();
+			peakResidentMemory = 0;
+			if (m_recordPeakMemory)
+			{
+				sampleResidentMemory();
+			}
+
 			std::shared_ptr<IntermediateStorage> result = indexer->index(indexerCommand);
 
 			if (result)
 			{
-				LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
-				m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
+				if (m_recordPeakMemory)
+				{
+					sampleResidentMemory();
+				}
+
+				// recorded for scheduling the longest translation units first on the next refresh
+				result->addIndexingCosts({StorageIndexingCost(
+					indexerCommand->getSourceFilePath().wstr(),
+					TimeStamp::now().deltaMS(indexingStartTime),
+					peakResidentMemory / 1024,
+					result->getByteSize(sizeof(std::wstring)) / 1024)});
+
+				LOG_INFO_STREAM(<< m_processId << " pushing index to storage manager");
+				if (!m_intermediateStorageManager->pushIntermediateStorage(
+						result, indexerCommand->getSourceFilePath()))
+				{
+					// the source file is recorded as not indexed and its claimed headers are released
+					LOG_ERROR_STREAM(
+						<< m_processId << " dropped the index of \""
+						<< indexerCommand->getSourceFilePath().str() << "\"");
+					m_interprocessIndexingStatusManager.addCrashedSourceFile(
+						indexerCommand->getSourceFilePath());
+					result.reset();
+				}
+			}
+
+			if (m_indexedHeaderManager)
+			{
+				if (result)
+				{
+					m_indexedHeaderManager->commitClaimedHeaders();
+				}
+				else
+				{
+					m_indexedHeaderManager->releaseClaimedHeaders();
+				}
 			}
 
 			LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current file");
 			m_interprocessIndexingStatusManager.finishIndexingSourceFile();
 
 			LOG_INFO_STREAM(<< m_processId << " all done");
+
+			indexedTranslationUnitCount++;
+			if (recycleLimitReached(indexedTranslationUnitCount))
+			{
+				recycle = true;
+				break;
+			}
 		}
 	}
 	catch (boost::interprocess::interprocess_exception& e)
@@ -117,4 +255,31 @@ void InterprocessIndexer::work()
 	}
 
 	LOG_INFO_STREAM(<< m_processId << " shutting down indexer");
+
+	return !recycle;
+}
+
+bool InterprocessIndexer::recycleLimitReached(size_t indexedTranslationUnitCount) const
+{
+	if (m_maximumTranslationUnitCount && indexedTranslationUnitCount >= m_maximumTranslationUnitCount)
+	{
+		LOG_INFO_STREAM(
+			<< m_processId << " reached translation unit limit after " << indexedTranslationUnitCount
+			<< " translation units");
+		return true;
+	}
+
+	if (m_maximumMemoryMB)
+	{
+		const size_t residentMemoryMB = utility::getResidentMemorySize() / 1048576;
+		if (residentMemoryMB >= m_maximumMemoryMB)
+		{
+			LOG_INFO_STREAM(
+				<< m_processId << " reached memory limit with " << residentMemoryMB << " MB after "
+				<< indexedTranslationUnitCount << " translation units");
+			return true;
+		}
+	}
+
+	return false;
 }
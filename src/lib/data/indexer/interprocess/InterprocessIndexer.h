@@ -1,6 +1,7 @@
 #ifndef INTERPROCESS_INDEXER_H
 #define INTERPROCESS_INDEXER_H
 
+#include "InterprocessIndexedHeaderManager.h"
 #include "InterprocessIndexerCommandManager.h"
 #include "InterprocessIndexingStatusManager.h"
 #include "InterprocessIntermediateStorageManager.h"
@@ -10,15 +11,41 @@ class InterprocessIndexer
 public:
 	InterprocessIndexer(const std::string& uuid, Id processId);
 
-	void work();
+	// indexer running in a thread of the app, results are passed to the given storage manager that
+	// may be shared with other indexer threads, the memory used for indexing is not recorded since it
+	// cannot be told apart from the memory of the app. indexing waits while the queued results take
+	// more than maximumQueuedByteSize, 0 means no limit.
+	InterprocessIndexer(
+		const std::string& uuid,
+		Id processId,
+		std::shared_ptr<IntermediateStorageManager> intermediateStorageManager,
+		size_t maximumQueuedByteSize);
+
+	// limits after which the indexer stops to get replaced by a fresh process, 0 means no limit
+	void setRecycleLimits(size_t maximumTranslationUnitCount, size_t maximumMemoryMB);
+
+	// record the contents of each header only in the first translation unit that includes it
+	void enableSharedHeaderIndexing();
+
+	// returns false if the indexer stopped because a recycle limit was reached before the indexer
+	// command queue was closed and drained
+	bool work();
 
 private:
+	bool recycleLimitReached(size_t indexedTranslationUnitCount) const;
+
 	InterprocessIndexerCommandManager m_interprocessIndexerCommandManager;
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
-	InterprocessIntermediateStorageManager m_interprocessIntermediateStorageManager;
+	std::shared_ptr<IntermediateStorageManager> m_intermediateStorageManager;
+	std::shared_ptr<InterprocessIndexedHeaderManager> m_indexedHeaderManager;
+	size_t m_maximumQueuedByteSize;
+	const bool m_recordPeakMemory;
 
 	const std::string m_uuid;
 	const Id m_processId;
+
+	size_t m_maximumTranslationUnitCount;
+	size_t m_maximumMemoryMB;
 };
 
 #endif	  // INTERPROCESS_INDEXER_H
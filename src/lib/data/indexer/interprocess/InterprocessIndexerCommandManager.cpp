@@ -6,6 +6,8 @@
 const char* InterprocessIndexerCommandManager::s_sharedMemoryNamePrefix = "icmd_";
 
 const char* InterprocessIndexerCommandManager::s_indexerCommandsKeyName = "indexer_commands";
+const char* InterprocessIndexerCommandManager::s_indexerCommandQueueClosedKeyName =
+	"indexer_commands_closed_flag";
 
 InterprocessIndexerCommandManager::InterprocessIndexerCommandManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -57,6 +59,8 @@ void InterprocessIndexerCommandManager::pushIndexerCommands(
 		sharedCommand.fromLocal(command.get());
 	}
 
+	access.notifyAll();
+
 	LOG_INFO(access.logString());
 }
 
@@ -76,6 +80,8 @@ std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCom
 
 	queue->pop_front();
 
+	access.notifyAll();
+
 	return command;
 }
 
@@ -92,6 +98,8 @@ void InterprocessIndexerCommandManager::clearIndexerCommands()
 	}
 
 	queue->clear();
+
+	access.notifyAll();
 }
 
 size_t InterprocessIndexerCommandManager::indexerCommandCount()
@@ -108,3 +116,55 @@ size_t InterprocessIndexerCommandManager::indexerCommandCount()
 
 	return queue->size();
 }
+
+void InterprocessIndexerCommandManager::waitForIndexerCommands(size_t timeoutMS)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	access.waitForNotification(timeoutMS, [&]() {
+		SharedMemory::Queue<SharedIndexerCommand>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+				s_indexerCommandsKeyName);
+		bool* closedPtr = access.accessValue<bool>(s_indexerCommandQueueClosedKeyName);
+		return !queue || !closedPtr || queue->size() || *closedPtr;
+	});
+}
+
+void InterprocessIndexerCommandManager::waitForIndexerCommandCountBelow(
+	size_t count, size_t timeoutMS)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	access.waitForNotification(timeoutMS, [&]() {
+		SharedMemory::Queue<SharedIndexerCommand>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+				s_indexerCommandsKeyName);
+		return !queue || queue->size() < count;
+	});
+}
+
+void InterprocessIndexerCommandManager::setIndexerCommandQueueClosed(bool closed)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	bool* closedPtr = access.accessValue<bool>(s_indexerCommandQueueClosedKeyName);
+	if (closedPtr)
+	{
+		*closedPtr = closed;
+	}
+
+	access.notifyAll();
+}
+
+bool InterprocessIndexerCommandManager::getIndexerCommandQueueClosed()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	bool* closedPtr = access.accessValue<bool>(s_indexerCommandQueueClosedKeyName);
+	if (closedPtr)
+	{
+		return *closedPtr;
+	}
+
+	return false;
+}
@@ -18,9 +18,19 @@ public:
 	void clearIndexerCommands();
 	size_t indexerCommandCount();
 
+	// block until commands are available or the queue got closed
+	void waitForIndexerCommands(size_t timeoutMS);
+	// block until the queue holds less than the given amount of commands
+	void waitForIndexerCommandCountBelow(size_t count, size_t timeoutMS);
+
+	// a closed queue won't receive any further commands, indexers can shut down once it is empty
+	void setIndexerCommandQueueClosed(bool closed);
+	bool getIndexerCommandQueueClosed();
+
 private:
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_indexerCommandsKeyName;
+	static const char* s_indexerCommandQueueClosedKeyName;
 };
 
 #endif	  // INTERPROCESS_INDEXER_COMMAND_MANAGER_H
@@ -85,6 +85,8 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
 		it = currentFilesPtr->insert(std::pair<Id, SharedMemory::String>(getProcessId(), str)).first;
 		it->second = str;
 	}
+
+	access.notifyAll();
 }
 
 void InterprocessIndexingStatusManager::finishIndexingSourceFile()
@@ -105,6 +107,30 @@ void InterprocessIndexingStatusManager::finishIndexingSourceFile()
 	{
 		finishedProcessIdsPtr->push_back(m_processId);
 	}
+
+	access.notifyAll();
+}
+
+void InterprocessIndexingStatusManager::addCrashedSourceFile(const FilePath& filePath)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	const std::string crashedFilePath = utility::encodeToUtf8(filePath.wstr());
+	const size_t estimatedSize = 3 * (262144 + sizeof(SharedMemory::String) + crashedFilePath.size());
+	while (access.getFreeMemorySize() < estimatedSize)
+	{
+		access.growMemory(access.getMemorySize());
+	}
+
+	SharedMemory::Vector<SharedMemory::String>* crashedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(
+			s_crashedFilesKeyName);
+	if (crashedFilesPtr)
+	{
+		SharedMemory::String str(access.getAllocator());
+		str = crashedFilePath.c_str();
+		crashedFilesPtr->push_back(str);
+	}
 }
 
 void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
@@ -147,6 +173,21 @@ Id InterprocessIndexingStatusManager::getNextFinishedProcessId()
 	return 0;
 }
 
+void InterprocessIndexingStatusManager::waitForIndexingStatusChange(size_t timeoutMS)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	access.waitForNotification(timeoutMS, [&]() {
+		SharedMemory::Queue<Id>* finishedProcessIdsPtr =
+			access.accessValueWithAllocator<SharedMemory::Queue<Id>>(s_finishedProcessIdsKeyName);
+		SharedMemory::Queue<SharedMemory::String>* indexingFilesPtr =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
+				s_indexingFilesKeyName);
+		return !finishedProcessIdsPtr || !indexingFilesPtr || finishedProcessIdsPtr->size() ||
+			indexingFilesPtr->size();
+	});
+}
+
 std::vector<FilePath> InterprocessIndexingStatusManager::getCurrentlyIndexedSourceFilePaths()
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
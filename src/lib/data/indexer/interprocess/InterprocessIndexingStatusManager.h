@@ -15,11 +15,18 @@ public:
 	void startIndexingSourceFile(const FilePath& filePath);
 	void finishIndexingSourceFile();
 
+	// reports a source file whose result got lost like one whose indexer crashed, so it is recorded
+	// as not indexed and indexed again on the next refresh
+	void addCrashedSourceFile(const FilePath& filePath);
+
 	void setIndexingInterrupted(bool interrupted);
 	bool getIndexingInterrupted();
 
 	Id getNextFinishedProcessId();
 
+	// block until an indexer started or finished a source file
+	void waitForIndexingStatusChange(size_t timeoutMS);
+
 	std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
 	std::vector<FilePath> getCrashedSourceFilePaths();
 
@@ -1,14 +1,36 @@
 #include "InterprocessIntermediateStorageManager.h"
 
+#include <algorithm>
+
+#include <boost/interprocess/offset_ptr.hpp>
+
+#include "FlatIntermediateStorage.h"
 #include "IntermediateStorage.h"
-#include "SharedIntermediateStorage.h"
+#include "InterprocessIndexingStatusManager.h"
 #include "logging.h"
+#include "utilityString.h"
+
+namespace
+{
+// the utf8 path of the indexed source file follows the flat storage in the same allocation
+struct SharedFlatIntermediateStorage
+{
+	boost::interprocess::offset_ptr<char> data;
+	size_t byteSize;
+	size_t sourceFilePathSize;
+};
+
+using SharedFlatIntermediateStorageQueue = SharedMemory::Queue<SharedFlatIntermediateStorage>;
+}	 // namespace
 
 const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "iist_";
 
 const char* InterprocessIntermediateStorageManager::s_intermediatStoragesKeyName =
 	"intermediate_storages";
 
+const char* InterprocessIntermediateStorageManager::s_maximumQueuedByteSizeKeyName =
+	"maximum_queued_byte_size";
+
 InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
 	: BaseInterprocessDataManager(
@@ -21,16 +43,18 @@ InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 {
 }
 
-void InterprocessIntermediateStorageManager::pushIntermediateStorage(
-	const std::shared_ptr<IntermediateStorage>& intermediateStorage)
+bool InterprocessIntermediateStorageManager::pushIntermediateStorage(
+	const std::shared_ptr<IntermediateStorage>& intermediateStorage, const FilePath& sourceFilePath)
 {
 	const size_t requiredInsertsToShrink = 10;
 
-	const size_t overestimationMultiplier = 2;
-	const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) +
-								 sizeof(SharedIntermediateStorage)) *
-			overestimationMultiplier +
-		1048576 /* 1 MB */;
+	// the flat encoding knows its exact size up front, so only the queue and allocator bookkeeping
+	// need some headroom
+	const FlatIntermediateStorage flatStorage(*intermediateStorage);
+	const std::string sourceFilePathUtf8 = utility::encodeToUtf8(sourceFilePath.wstr());
+	const size_t byteSize = flatStorage.getByteSize();
+	const size_t allocationSize = byteSize + sourceFilePathUtf8.size();
+	const size_t requiredSize = allocationSize + 65536 /* 64 KB */;
 
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
@@ -54,28 +78,47 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 		m_insertsWithoutGrowth++;
 	}
 
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+	SharedFlatIntermediateStorageQueue* queue =
+		access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
 			s_intermediatStoragesKeyName);
 	if (!queue)
 	{
-		return;
+		LOG_ERROR("Unable to access the queue of intermediate storages.");
+		return false;
 	}
 
-	queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-	SharedIntermediateStorage& storage = queue->back();
+	char* data = static_cast<char*>(access.getAllocator()->allocate(allocationSize, std::nothrow));
+	if (!data)
+	{
+		// free memory may be fragmented, so grow by the full size and try again
+		LOG_INFO_STREAM(<< "grow fragmented memory - alloc: " << requiredSize);
+		access.growMemory(requiredSize);
+		m_insertsWithoutGrowth = 0;
 
-	storage.setStorageNodes(intermediateStorage->getStorageNodes());
-	storage.setStorageFiles(intermediateStorage->getStorageFiles());
-	storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-	storage.setStorageEdges(intermediateStorage->getStorageEdges());
-	storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-	storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-	storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-	storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-	storage.setStorageErrors(intermediateStorage->getErrors());
+		queue = access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
+			s_intermediatStoragesKeyName);
+		data = static_cast<char*>(access.getAllocator()->allocate(allocationSize, std::nothrow));
+		if (!queue || !data)
+		{
+			LOG_ERROR_STREAM(<< "Unable to allocate " << allocationSize << " bytes of shared memory.");
+			if (data)
+			{
+				access.getAllocator()->deallocate(data);
+			}
+			return false;
+		}
+	}
 
-	storage.setNextId(intermediateStorage->getNextId());
+	flatStorage.write(data);
+	std::copy(sourceFilePathUtf8.begin(), sourceFilePathUtf8.end(), data + byteSize);
+
+	SharedFlatIntermediateStorage storage;
+	storage.data = data;
+	storage.byteSize = byteSize;
+	storage.sourceFilePathSize = sourceFilePathUtf8.size();
+	queue->push_back(storage);
+
+	access.notifyAll();
 
 	if (m_insertsWithoutGrowth >= requiredInsertsToShrink)
 	{
@@ -89,38 +132,48 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 	}
 
 	LOG_INFO(access.logString());
+	return true;
 }
 
 std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::popIntermediateStorage()
 {
-	SharedMemory::ScopedAccess access(&m_sharedMemory);
-
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
-			s_intermediatStoragesKeyName);
-	if (!queue || !queue->size())
+	std::shared_ptr<IntermediateStorage> storage;
+	std::string sourceFilePath;
 	{
-		return nullptr;
-	}
+		SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-	SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
+		SharedFlatIntermediateStorageQueue* queue =
+			access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
+				s_intermediatStoragesKeyName);
+		if (!queue || !queue->size())
+		{
+			return nullptr;
+		}
 
-	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		const SharedFlatIntermediateStorage& sharedStorage = queue->front();
 
-	storage->setStorageNodes(sharedIntermediateStorage.getStorageNodes());
-	storage->setStorageFiles(sharedIntermediateStorage.getStorageFiles());
-	storage->setStorageSymbols(sharedIntermediateStorage.getStorageSymbols());
-	storage->setStorageEdges(sharedIntermediateStorage.getStorageEdges());
-	storage->setStorageLocalSymbols(sharedIntermediateStorage.getStorageLocalSymbols());
-	storage->setStorageSourceLocations(sharedIntermediateStorage.getStorageSourceLocations());
-	storage->setStorageOccurrences(sharedIntermediateStorage.getStorageOccurrences());
-	storage->setComponentAccesses(sharedIntermediateStorage.getStorageComponentAccesses());
-	storage->setErrors(sharedIntermediateStorage.getStorageErrors());
+		storage = FlatIntermediateStorage::read(sharedStorage.data.get(), sharedStorage.byteSize);
+		if (!storage)
+		{
+			sourceFilePath.assign(
+				sharedStorage.data.get() + sharedStorage.byteSize, sharedStorage.sourceFilePathSize);
+		}
 
-	storage->setNextId(sharedIntermediateStorage.getNextId());
+		access.getAllocator()->deallocate(sharedStorage.data.get());
+		queue->pop_front();
+		access.notifyAll();
 
-	queue->pop_front();
-	LOG_INFO(access.logString());
+		LOG_INFO(access.logString());
+	}
+
+	if (!storage)
+	{
+		LOG_ERROR("Unable to read the intermediate storage of " + sourceFilePath + ".");
+
+		// the translation unit is recorded like a crashed one after indexing
+		InterprocessIndexingStatusManager(m_instanceUuid, m_processId, false)
+			.addCrashedSourceFile(FilePath(utility::decodeFromUtf8(sourceFilePath)));
+	}
 
 	return storage;
 }
@@ -129,8 +182,8 @@ size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount()
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+	SharedFlatIntermediateStorageQueue* queue =
+		access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
 			s_intermediatStoragesKeyName);
 	if (!queue)
 	{
@@ -139,3 +192,65 @@ size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount()
 
 	return queue->size();
 }
+
+size_t InterprocessIntermediateStorageManager::getIntermediateStorageByteSize()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedFlatIntermediateStorageQueue* queue =
+		access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
+			s_intermediatStoragesKeyName);
+	if (!queue)
+	{
+		return 0;
+	}
+
+	size_t byteSize = 0;
+	for (const SharedFlatIntermediateStorage& storage: *queue)
+	{
+		byteSize += storage.byteSize;
+	}
+	return byteSize;
+}
+
+void InterprocessIntermediateStorageManager::waitForIntermediateStorageByteSizeBelow(
+	size_t byteSize, size_t timeoutMS)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	access.waitForNotification(timeoutMS, [&]() {
+		SharedFlatIntermediateStorageQueue* queue =
+			access.accessValueWithAllocator<SharedFlatIntermediateStorageQueue>(
+				s_intermediatStoragesKeyName);
+		if (!queue || queue->empty())
+		{
+			return true;
+		}
+
+		size_t queuedByteSize = 0;
+		for (const SharedFlatIntermediateStorage& storage: *queue)
+		{
+			queuedByteSize += storage.byteSize;
+		}
+		return queuedByteSize < byteSize;
+	});
+}
+
+size_t InterprocessIntermediateStorageManager::getMaximumQueuedByteSize()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	size_t* byteSizePtr = access.accessValue<size_t>(s_maximumQueuedByteSizeKeyName);
+	return byteSizePtr ? *byteSizePtr : 0;
+}
+
+void InterprocessIntermediateStorageManager::setMaximumQueuedByteSize(size_t byteSize)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	size_t* byteSizePtr = access.accessValue<size_t>(s_maximumQueuedByteSizeKeyName);
+	if (byteSizePtr)
+	{
+		*byteSizePtr = byteSize;
+	}
+}
@@ -2,23 +2,34 @@
 #define INTERPROCESS_INTERMEDIATE_STORAGE_MANAGER_H
 
 #include "BaseInterprocessDataManager.h"
+#include "IntermediateStorageManager.h"
 
-class IntermediateStorage;
-
-class InterprocessIntermediateStorageManager: public BaseInterprocessDataManager
+class InterprocessIntermediateStorageManager
+	: public BaseInterprocessDataManager
+	, public IntermediateStorageManager
 {
 public:
 	InterprocessIntermediateStorageManager(const std::string& instanceUuid, Id processId, bool isOwner);
 	virtual ~InterprocessIntermediateStorageManager() = default;
 
-	void pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage);
-	std::shared_ptr<IntermediateStorage> popIntermediateStorage();
+	bool pushIntermediateStorage(
+		const std::shared_ptr<IntermediateStorage>& intermediateStorage,
+		const FilePath& sourceFilePath) override;
+	std::shared_ptr<IntermediateStorage> popIntermediateStorage() override;
+
+	size_t getIntermediateStorageCount() override;
+	size_t getIntermediateStorageByteSize() override;
+
+	void waitForIntermediateStorageByteSizeBelow(size_t byteSize, size_t timeoutMS) override;
 
-	size_t getIntermediateStorageCount();
+	// set by the app, so the indexer process knows how many bytes it may keep queued, 0 means no limit
+	size_t getMaximumQueuedByteSize();
+	void setMaximumQueuedByteSize(size_t byteSize);
 
 private:
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_intermediatStoragesKeyName;
+	static const char* s_maximumQueuedByteSizeKeyName;
 
 	size_t m_insertsWithoutGrowth;
 };
@@ -0,0 +1,741 @@
+#include "FlatIntermediateStorage.h"
+
+#include <cstring>
+
+#include <boost/locale/encoding_utf.hpp>
+#include <boost/locale/utf.hpp>
+
+#include "IntermediateStorage.h"
+#include "logging.h"
+
+namespace
+{
+const uint32_t s_magic = 0x53495453;	// "STIS"
+const uint32_t s_version = 3;
+
+struct FlatHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t nextId;
+
+	uint64_t fileCount;
+	uint64_t nodeCount;
+	uint64_t symbolCount;
+	uint64_t edgeCount;
+	uint64_t localSymbolCount;
+	uint64_t occurrenceCount;
+	uint64_t componentAccessCount;
+	uint64_t elementComponentCount;
+	uint64_t errorCount;
+	uint64_t indexingCostCount;
+	uint64_t sourceLocationCount;
+
+	uint64_t sourceLocationsOffset;
+	uint64_t stringTableOffset;
+};
+
+struct FlatFile
+{
+	uint64_t id;
+	uint64_t filePath;
+	uint64_t languageIdentifier;
+	uint64_t interfaceHash;
+	uint32_t indexed;
+	uint32_t complete;
+};
+
+struct FlatNode
+{
+	uint64_t id;
+	uint64_t serializedName;
+	int32_t type;
+	int32_t padding;
+};
+
+struct FlatSymbol
+{
+	uint64_t id;
+	int32_t definitionKind;
+	int32_t padding;
+};
+
+struct FlatEdge
+{
+	uint64_t id;
+	uint64_t sourceNodeId;
+	uint64_t targetNodeId;
+	int32_t type;
+	int32_t padding;
+};
+
+struct FlatLocalSymbol
+{
+	uint64_t id;
+	uint64_t name;
+};
+
+struct FlatOccurrence
+{
+	uint64_t elementId;
+	uint64_t sourceLocationId;
+};
+
+struct FlatComponentAccess
+{
+	uint64_t nodeId;
+	int32_t type;
+	int32_t padding;
+};
+
+struct FlatElementComponent
+{
+	uint64_t elementId;
+	uint64_t data;
+	int32_t type;
+	int32_t padding;
+};
+
+struct FlatError
+{
+	uint64_t id;
+	uint64_t message;
+	uint64_t translationUnit;
+	uint32_t fatal;
+	uint32_t indexed;
+};
+
+struct FlatIndexingCost
+{
+	uint64_t filePath;
+	uint64_t indexingTimeMS;
+	uint64_t peakMemoryKB;
+	uint64_t resultSizeKB;
+};
+
+size_t alignSize(size_t size)
+{
+	return (size + 7) & ~static_cast<size_t>(7);
+}
+
+uint64_t toZigZag(uint64_t delta)
+{
+	const int64_t value = static_cast<int64_t>(delta);
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+uint64_t fromZigZag(uint64_t value)
+{
+	return (value >> 1) ^ (~(value & 1) + 1);
+}
+
+size_t getVarintSize(uint64_t value)
+{
+	size_t size = 1;
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		size++;
+	}
+	return size;
+}
+
+char* writeVarint(char* data, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		*data++ = static_cast<char>((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	*data++ = static_cast<char>(value);
+	return data;
+}
+
+// returns nullptr if the varint exceeds the buffer
+const char* readVarint(const char* data, const char* end, uint64_t& value)
+{
+	value = 0;
+	for (int shift = 0; data < end && shift < 64; shift += 7)
+	{
+		const uint64_t byte = static_cast<unsigned char>(*data++);
+		value |= (byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return data;
+		}
+	}
+	return nullptr;
+}
+
+template <typename Function>
+void forEachCodePoint(const std::wstring& str, Function function)
+{
+	using namespace boost::locale::utf;
+
+	std::wstring::const_iterator it = str.begin();
+	while (it != str.end())
+	{
+		const code_point c = utf_traits<wchar_t>::decode(it, str.end());
+		if (c != illegal && c != incomplete)
+		{
+			function(c);
+		}
+	}
+}
+
+size_t getUtf8Size(const std::wstring& str)
+{
+	size_t size = 0;
+	forEachCodePoint(str, [&size](boost::locale::utf::code_point c) {
+		size += boost::locale::utf::utf_traits<char>::width(c);
+	});
+	return size;
+}
+
+size_t getStringSize(const std::wstring& str)
+{
+	const size_t utf8Size = getUtf8Size(str);
+	return getVarintSize(utf8Size) + utf8Size;
+}
+
+class SourceLocationEncoder
+{
+public:
+	template <typename Function>
+	void encode(const StorageSourceLocation& location, Function function)
+	{
+		function(toZigZag(location.id - m_id));
+		function(toZigZag(location.fileNodeId - m_fileNodeId));
+		function(toZigZag(location.startLine - m_startLine));
+		function(location.startCol);
+		function(toZigZag(location.endLine - location.startLine));
+		function(toZigZag(location.endCol - location.startCol));
+		function(toZigZag(static_cast<uint64_t>(static_cast<int64_t>(location.type))));
+
+		m_id = location.id;
+		m_fileNodeId = location.fileNodeId;
+		m_startLine = location.startLine;
+	}
+
+private:
+	uint64_t m_id = 0;
+	uint64_t m_fileNodeId = 0;
+	uint64_t m_startLine = 0;
+};
+
+void writeString(char* data, const std::wstring& str)
+{
+	char* it = writeVarint(data, getUtf8Size(str));
+	forEachCodePoint(str, [&it](boost::locale::utf::code_point c) {
+		it = boost::locale::utf::utf_traits<char>::encode(c, it);
+	});
+}
+
+class FlatReader
+{
+public:
+	FlatReader(const char* data, size_t byteSize): m_data(data), m_byteSize(byteSize), m_valid(true)
+	{
+	}
+
+	bool isValid() const
+	{
+		return m_valid;
+	}
+
+	template <typename T>
+	const T* getRecords(size_t& offset, uint64_t count)
+	{
+		const size_t recordsSize = alignSize(sizeof(T) * count);
+		if (!m_valid || count > m_byteSize / sizeof(T) || offset + recordsSize > m_byteSize)
+		{
+			m_valid = false;
+			return nullptr;
+		}
+
+		const T* records = reinterpret_cast<const T*>(m_data + offset);
+		offset += recordsSize;
+		return records;
+	}
+
+	void setStringTable(size_t offset)
+	{
+		m_stringTableOffset = offset;
+		if (offset > m_byteSize)
+		{
+			m_valid = false;
+		}
+	}
+
+	std::wstring getString(uint64_t offset)
+	{
+		const char* end = m_data + m_byteSize;
+		const char* begin = m_data + m_stringTableOffset;
+		if (!m_valid || offset >= static_cast<uint64_t>(end - begin))
+		{
+			m_valid = false;
+			return std::wstring();
+		}
+
+		uint64_t size = 0;
+		begin = readVarint(begin + offset, end, size);
+		if (!begin || size > static_cast<uint64_t>(end - begin))
+		{
+			m_valid = false;
+			return std::wstring();
+		}
+
+		return boost::locale::conv::utf_to_utf<wchar_t>(begin, begin + size);
+	}
+
+	const char* m_data;
+	const size_t m_byteSize;
+
+private:
+	size_t m_stringTableOffset = 0;
+	bool m_valid;
+};
+}	 // namespace
+
+std::shared_ptr<IntermediateStorage> FlatIntermediateStorage::read(const char* data, size_t byteSize)
+{
+	FlatHeader header;
+	if (byteSize < sizeof(FlatHeader))
+	{
+		LOG_ERROR("Flat intermediate storage is too small to contain a header.");
+		return nullptr;
+	}
+
+	std::memcpy(&header, data, sizeof(FlatHeader));
+	if (header.magic != s_magic || header.version != s_version)
+	{
+		LOG_ERROR("Flat intermediate storage has an unknown format.");
+		return nullptr;
+	}
+
+	FlatReader reader(data, byteSize);
+	size_t offset = alignSize(sizeof(FlatHeader));
+
+	const FlatFile* files = reader.getRecords<FlatFile>(offset, header.fileCount);
+	const FlatNode* nodes = reader.getRecords<FlatNode>(offset, header.nodeCount);
+	const FlatSymbol* symbols = reader.getRecords<FlatSymbol>(offset, header.symbolCount);
+	const FlatEdge* edges = reader.getRecords<FlatEdge>(offset, header.edgeCount);
+	const FlatLocalSymbol* localSymbols = reader.getRecords<FlatLocalSymbol>(
+		offset, header.localSymbolCount);
+	const FlatOccurrence* occurrences = reader.getRecords<FlatOccurrence>(
+		offset, header.occurrenceCount);
+	const FlatComponentAccess* componentAccesses = reader.getRecords<FlatComponentAccess>(
+		offset, header.componentAccessCount);
+	const FlatElementComponent* elementComponents = reader.getRecords<FlatElementComponent>(
+		offset, header.elementComponentCount);
+	const FlatError* errors = reader.getRecords<FlatError>(offset, header.errorCount);
+	const FlatIndexingCost* indexingCosts = reader.getRecords<FlatIndexingCost>(
+		offset, header.indexingCostCount);
+	reader.setStringTable(header.stringTableOffset);
+
+	if (!reader.isValid() || offset != header.sourceLocationsOffset ||
+		header.sourceLocationsOffset > header.stringTableOffset)
+	{
+		LOG_ERROR("Flat intermediate storage has invalid section sizes.");
+		return nullptr;
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+
+	{
+		std::vector<StorageFile> storageFiles;
+		storageFiles.reserve(header.fileCount);
+		for (size_t i = 0; i < header.fileCount; i++)
+		{
+			storageFiles.emplace_back(
+				files[i].id,
+				reader.getString(files[i].filePath),
+				reader.getString(files[i].languageIdentifier),
+				"",
+				files[i].indexed != 0,
+				files[i].complete != 0);
+			storageFiles.back().interfaceHash = files[i].interfaceHash;
+		}
+		storage->setStorageFiles(std::move(storageFiles));
+	}
+	{
+		std::vector<StorageNode> storageNodes;
+		storageNodes.reserve(header.nodeCount);
+		for (size_t i = 0; i < header.nodeCount; i++)
+		{
+			storageNodes.emplace_back(
+				nodes[i].id, nodes[i].type, reader.getString(nodes[i].serializedName));
+		}
+		storage->setStorageNodes(std::move(storageNodes));
+	}
+	{
+		std::vector<StorageSymbol> storageSymbols;
+		storageSymbols.reserve(header.symbolCount);
+		for (size_t i = 0; i < header.symbolCount; i++)
+		{
+			storageSymbols.emplace_back(symbols[i].id, symbols[i].definitionKind);
+		}
+		storage->setStorageSymbols(std::move(storageSymbols));
+	}
+	{
+		std::vector<StorageEdge> storageEdges;
+		storageEdges.reserve(header.edgeCount);
+		for (size_t i = 0; i < header.edgeCount; i++)
+		{
+			storageEdges.emplace_back(
+				edges[i].id, edges[i].type, edges[i].sourceNodeId, edges[i].targetNodeId);
+		}
+		storage->setStorageEdges(std::move(storageEdges));
+	}
+	{
+		// all of these were written sorted and without duplicates, as the setters expect them
+		std::vector<StorageLocalSymbol> storageLocalSymbols;
+		storageLocalSymbols.reserve(header.localSymbolCount);
+		for (size_t i = 0; i < header.localSymbolCount; i++)
+		{
+			storageLocalSymbols.emplace_back(
+				localSymbols[i].id, reader.getString(localSymbols[i].name));
+		}
+		storage->setStorageLocalSymbols(std::move(storageLocalSymbols));
+	}
+	{
+		std::vector<StorageOccurrence> storageOccurrences;
+		storageOccurrences.reserve(header.occurrenceCount);
+		for (size_t i = 0; i < header.occurrenceCount; i++)
+		{
+			storageOccurrences.emplace_back(
+				occurrences[i].elementId, occurrences[i].sourceLocationId);
+		}
+		storage->setStorageOccurrences(std::move(storageOccurrences));
+	}
+	{
+		std::vector<StorageComponentAccess> storageComponentAccesses;
+		storageComponentAccesses.reserve(header.componentAccessCount);
+		for (size_t i = 0; i < header.componentAccessCount; i++)
+		{
+			storageComponentAccesses.emplace_back(
+				componentAccesses[i].nodeId, componentAccesses[i].type);
+		}
+		storage->setComponentAccesses(std::move(storageComponentAccesses));
+	}
+	{
+		std::vector<StorageElementComponent> storageElementComponents;
+		storageElementComponents.reserve(header.elementComponentCount);
+		for (size_t i = 0; i < header.elementComponentCount; i++)
+		{
+			storageElementComponents.emplace_back(
+				elementComponents[i].elementId,
+				elementComponents[i].type,
+				reader.getString(elementComponents[i].data));
+		}
+		storage->setElementComponents(std::move(storageElementComponents));
+	}
+	{
+		std::vector<StorageError> storageErrors;
+		storageErrors.reserve(header.errorCount);
+		for (size_t i = 0; i < header.errorCount; i++)
+		{
+			storageErrors.emplace_back(
+				errors[i].id,
+				reader.getString(errors[i].message),
+				reader.getString(errors[i].translationUnit),
+				errors[i].fatal != 0,
+				errors[i].indexed != 0);
+		}
+		storage->setErrors(std::move(storageErrors));
+	}
+	{
+		std::vector<StorageIndexingCost> storageIndexingCosts;
+		storageIndexingCosts.reserve(header.indexingCostCount);
+		for (size_t i = 0; i < header.indexingCostCount; i++)
+		{
+			storageIndexingCosts.emplace_back(
+				reader.getString(indexingCosts[i].filePath),
+				indexingCosts[i].indexingTimeMS,
+				indexingCosts[i].peakMemoryKB,
+				indexingCosts[i].resultSizeKB);
+		}
+		storage->setIndexingCosts(std::move(storageIndexingCosts));
+	}
+	{
+		const char* it = data + header.sourceLocationsOffset;
+		const char* end = data + header.stringTableOffset;
+
+		uint64_t values[7];
+		uint64_t id = 0;
+		uint64_t fileNodeId = 0;
+		uint64_t startLine = 0;
+
+		std::vector<StorageSourceLocation> storageSourceLocations;
+		storageSourceLocations.reserve(header.sourceLocationCount);
+		for (size_t i = 0; i < header.sourceLocationCount && it; i++)
+		{
+			for (size_t j = 0; j < 7 && it; j++)
+			{
+				it = readVarint(it, end, values[j]);
+			}
+
+			if (it)
+			{
+				id += fromZigZag(values[0]);
+				fileNodeId += fromZigZag(values[1]);
+				startLine += fromZigZag(values[2]);
+
+				storageSourceLocations.emplace_back(
+					id,
+					fileNodeId,
+					startLine,
+					values[3],
+					startLine + fromZigZag(values[4]),
+					values[3] + fromZigZag(values[5]),
+					static_cast<int>(static_cast<int64_t>(fromZigZag(values[6]))));
+			}
+		}
+
+		if (!it)
+		{
+			LOG_ERROR("Flat intermediate storage has invalid source locations.");
+			return nullptr;
+		}
+		storage->setStorageSourceLocations(std::move(storageSourceLocations));
+	}
+
+	if (!reader.isValid())
+	{
+		LOG_ERROR("Flat intermediate storage has invalid string references.");
+		return nullptr;
+	}
+
+	storage->setNextId(header.nextId);
+
+	return storage;
+}
+
+FlatIntermediateStorage::FlatIntermediateStorage(const IntermediateStorage& storage)
+	: m_storage(storage), m_stringTableSize(0)
+{
+	size_t size = alignSize(sizeof(FlatHeader));
+	size += alignSize(sizeof(FlatFile) * storage.getStorageFiles().size());
+	size += alignSize(sizeof(FlatNode) * storage.getStorageNodes().size());
+	size += alignSize(sizeof(FlatSymbol) * storage.getStorageSymbols().size());
+	size += alignSize(sizeof(FlatEdge) * storage.getStorageEdges().size());
+	size += alignSize(sizeof(FlatLocalSymbol) * storage.getStorageLocalSymbols().size());
+	size += alignSize(sizeof(FlatOccurrence) * storage.getStorageOccurrences().size());
+	size += alignSize(sizeof(FlatComponentAccess) * storage.getComponentAccesses().size());
+	size += alignSize(sizeof(FlatElementComponent) * storage.getElementComponents().size());
+	size += alignSize(sizeof(FlatError) * storage.getErrors().size());
+	size += alignSize(sizeof(FlatIndexingCost) * storage.getIndexingCosts().size());
+	m_sourceLocationsOffset = size;
+
+	SourceLocationEncoder encoder;
+	for (const StorageSourceLocation& location: storage.getStorageSourceLocations())
+	{
+		encoder.encode(location, [&size](uint64_t value) { size += getVarintSize(value); });
+	}
+	size = alignSize(size);
+	m_stringTableOffset = size;
+
+	for (const StorageFile& file: storage.getStorageFiles())
+	{
+		addString(file.filePath);
+		addString(file.languageIdentifier);
+	}
+	for (const StorageNode& node: storage.getStorageNodes())
+	{
+		addString(node.serializedName);
+	}
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
+	{
+		addString(localSymbol.name);
+	}
+	for (const StorageElementComponent& component: storage.getElementComponents())
+	{
+		addString(component.data);
+	}
+	for (const StorageError& error: storage.getErrors())
+	{
+		addString(error.message);
+		addString(error.translationUnit);
+	}
+	for (const StorageIndexingCost& indexingCost: storage.getIndexingCosts())
+	{
+		addString(indexingCost.filePath);
+	}
+	m_byteSize = size + m_stringTableSize;
+}
+
+size_t FlatIntermediateStorage::getByteSize() const
+{
+	return m_byteSize;
+}
+
+void FlatIntermediateStorage::write(char* data) const
+{
+	FlatHeader* header = reinterpret_cast<FlatHeader*>(data);
+	std::memset(header, 0, sizeof(FlatHeader));
+	header->magic = s_magic;
+	header->version = s_version;
+	header->nextId = m_storage.getNextId();
+	header->fileCount = m_storage.getStorageFiles().size();
+	header->nodeCount = m_storage.getStorageNodes().size();
+	header->symbolCount = m_storage.getStorageSymbols().size();
+	header->edgeCount = m_storage.getStorageEdges().size();
+	header->localSymbolCount = m_storage.getStorageLocalSymbols().size();
+	header->occurrenceCount = m_storage.getStorageOccurrences().size();
+	header->componentAccessCount = m_storage.getComponentAccesses().size();
+	header->elementComponentCount = m_storage.getElementComponents().size();
+	header->errorCount = m_storage.getErrors().size();
+	header->indexingCostCount = m_storage.getIndexingCosts().size();
+	header->sourceLocationCount = m_storage.getStorageSourceLocations().size();
+	header->sourceLocationsOffset = m_sourceLocationsOffset;
+	header->stringTableOffset = m_stringTableOffset;
+
+	for (const std::pair<const std::wstring* const, uint64_t>& string: m_stringOffsets)
+	{
+		writeString(data + m_stringTableOffset + string.second, *string.first);
+	}
+
+	size_t offset = alignSize(sizeof(FlatHeader));
+
+	for (const StorageFile& file: m_storage.getStorageFiles())
+	{
+		FlatFile* record = reinterpret_cast<FlatFile*>(data + offset);
+		record->id = file.id;
+		record->filePath = getStringOffset(file.filePath);
+		record->languageIdentifier = getStringOffset(file.languageIdentifier);
+		record->interfaceHash = file.interfaceHash;
+		record->indexed = file.indexed;
+		record->complete = file.complete;
+		offset += sizeof(FlatFile);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageNode& node: m_storage.getStorageNodes())
+	{
+		FlatNode* record = reinterpret_cast<FlatNode*>(data + offset);
+		record->id = node.id;
+		record->serializedName = getStringOffset(node.serializedName);
+		record->type = node.type;
+		record->padding = 0;
+		offset += sizeof(FlatNode);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageSymbol& symbol: m_storage.getStorageSymbols())
+	{
+		FlatSymbol* record = reinterpret_cast<FlatSymbol*>(data + offset);
+		record->id = symbol.id;
+		record->definitionKind = symbol.definitionKind;
+		record->padding = 0;
+		offset += sizeof(FlatSymbol);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageEdge& edge: m_storage.getStorageEdges())
+	{
+		FlatEdge* record = reinterpret_cast<FlatEdge*>(data + offset);
+		record->id = edge.id;
+		record->sourceNodeId = edge.sourceNodeId;
+		record->targetNodeId = edge.targetNodeId;
+		record->type = edge.type;
+		record->padding = 0;
+		offset += sizeof(FlatEdge);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageLocalSymbol& localSymbol: m_storage.getStorageLocalSymbols())
+	{
+		FlatLocalSymbol* record = reinterpret_cast<FlatLocalSymbol*>(data + offset);
+		record->id = localSymbol.id;
+		record->name = getStringOffset(localSymbol.name);
+		offset += sizeof(FlatLocalSymbol);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageOccurrence& occurrence: m_storage.getStorageOccurrences())
+	{
+		FlatOccurrence* record = reinterpret_cast<FlatOccurrence*>(data + offset);
+		record->elementId = occurrence.elementId;
+		record->sourceLocationId = occurrence.sourceLocationId;
+		offset += sizeof(FlatOccurrence);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageComponentAccess& componentAccess: m_storage.getComponentAccesses())
+	{
+		FlatComponentAccess* record = reinterpret_cast<FlatComponentAccess*>(data + offset);
+		record->nodeId = componentAccess.nodeId;
+		record->type = componentAccess.type;
+		record->padding = 0;
+		offset += sizeof(FlatComponentAccess);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageElementComponent& component: m_storage.getElementComponents())
+	{
+		FlatElementComponent* record = reinterpret_cast<FlatElementComponent*>(data + offset);
+		record->elementId = component.elementId;
+		record->data = getStringOffset(component.data);
+		record->type = component.type;
+		record->padding = 0;
+		offset += sizeof(FlatElementComponent);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageError& error: m_storage.getErrors())
+	{
+		FlatError* record = reinterpret_cast<FlatError*>(data + offset);
+		record->id = error.id;
+		record->message = getStringOffset(error.message);
+		record->translationUnit = getStringOffset(error.translationUnit);
+		record->fatal = error.fatal;
+		record->indexed = error.indexed;
+		offset += sizeof(FlatError);
+	}
+	offset = alignSize(offset);
+
+	for (const StorageIndexingCost& indexingCost: m_storage.getIndexingCosts())
+	{
+		FlatIndexingCost* record = reinterpret_cast<FlatIndexingCost*>(data + offset);
+		record->filePath = getStringOffset(indexingCost.filePath);
+		record->indexingTimeMS = indexingCost.indexingTimeMS;
+		record->peakMemoryKB = indexingCost.peakMemoryKB;
+		record->resultSizeKB = indexingCost.resultSizeKB;
+		offset += sizeof(FlatIndexingCost);
+	}
+	offset = alignSize(offset);
+
+	char* it = data + offset;
+	SourceLocationEncoder encoder;
+	for (const StorageSourceLocation& location: m_storage.getStorageSourceLocations())
+	{
+		encoder.encode(location, [&it](uint64_t value) { it = writeVarint(it, value); });
+	}
+
+	// zero the alignment padding in front of the string table
+	std::memset(it, 0, data + m_stringTableOffset - it);
+}
+
+size_t FlatIntermediateStorage::StringHash::operator()(const std::wstring* str) const
+{
+	return std::hash<std::wstring>()(*str);
+}
+
+bool FlatIntermediateStorage::StringEqual::operator()(
+	const std::wstring* a, const std::wstring* b) const
+{
+	return *a == *b;
+}
+
+void FlatIntermediateStorage::addString(const std::wstring& str)
+{
+	if (m_stringOffsets.emplace(&str, m_stringTableSize).second)
+	{
+		m_stringTableSize += getStringSize(str);
+	}
+}
+
+uint64_t FlatIntermediateStorage::getStringOffset(const std::wstring& str) const
+{
+	return m_stringOffsets.find(&str)->second;
+}
@@ -0,0 +1,57 @@
+#ifndef FLAT_INTERMEDIATE_STORAGE_H
+#define FLAT_INTERMEDIATE_STORAGE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+class IntermediateStorage;
+
+// Relocatable binary encoding of an IntermediateStorage used to hand indexing results from the
+// indexer processes to the app. The encoding is written in a single pass into a buffer of exactly
+// getByteSize() bytes and is read directly from that buffer, so it can live in shared memory.
+//
+// layout (all sections 8 byte aligned):
+// - header with element counts and section sizes
+// - fixed width records for files, nodes, symbols, edges, local symbols, occurrences, component
+//   accesses, element components, errors and indexing costs, strings are referenced by offset into
+//   the string table
+// - source locations as varints, delta encoded in the order of the storage
+// - string table of utf8 encoded, varint length prefixed strings, equal strings are stored once
+class FlatIntermediateStorage
+{
+public:
+	static std::shared_ptr<IntermediateStorage> read(const char* data, size_t byteSize);
+
+	FlatIntermediateStorage(const IntermediateStorage& storage);
+
+	size_t getByteSize() const;
+
+	// data has to point to at least getByteSize() bytes with an alignment of 8
+	void write(char* data) const;
+
+private:
+	// strings are referenced instead of copied, since the storage outlives the encoding
+	struct StringHash
+	{
+		size_t operator()(const std::wstring* str) const;
+	};
+	struct StringEqual
+	{
+		bool operator()(const std::wstring* a, const std::wstring* b) const;
+	};
+
+	void addString(const std::wstring& str);
+	uint64_t getStringOffset(const std::wstring& str) const;
+
+	const IntermediateStorage& m_storage;
+	std::unordered_map<const std::wstring*, uint64_t, StringHash, StringEqual> m_stringOffsets;
+	size_t m_stringTableSize;
+
+	size_t m_sourceLocationsOffset;
+	size_t m_stringTableOffset;
+	size_t m_byteSize;
+};
+
+#endif	  // FLAT_INTERMEDIATE_STORAGE_H
@@ -0,0 +1,41 @@
+#include "NamePrefixCache.h"
+
+#include <functional>
+
+Id NamePrefixCache::getNodeId(
+	Id parentNodeId, const std::wstring& delimiter, const NameElement& element) const
+{
+	const size_t position = m_index.find(
+		getHash(parentNodeId, delimiter, element), [&](size_t i) {
+			const Prefix& prefix = m_prefixes[i];
+			return prefix.parentNodeId == parentNodeId &&
+				(parentNodeId || prefix.delimiter == delimiter) &&
+				prefix.element.getName() == element.getName() &&
+				prefix.element.getSignature().getPrefix() == element.getSignature().getPrefix() &&
+				prefix.element.getSignature().getPostfix() == element.getSignature().getPostfix();
+		});
+
+	return position != HashIndex::s_notFound ? m_prefixes[position].nodeId : 0;
+}
+
+void NamePrefixCache::addNodeId(
+	Id parentNodeId, const std::wstring& delimiter, const NameElement& element, Id nodeId)
+{
+	m_index.insert(getHash(parentNodeId, delimiter, element), m_prefixes.size());
+	m_prefixes.push_back({parentNodeId, parentNodeId ? L"" : delimiter, element, nodeId});
+}
+
+size_t NamePrefixCache::getHash(
+	Id parentNodeId, const std::wstring& delimiter, const NameElement& element)
+{
+	const std::hash<std::wstring> hash;
+
+	size_t result = HashIndex::combineHash(0, static_cast<size_t>(parentNodeId));
+	if (!parentNodeId)
+	{
+		result = HashIndex::combineHash(result, hash(delimiter));
+	}
+	result = HashIndex::combineHash(result, hash(element.getName()));
+	result = HashIndex::combineHash(result, hash(element.getSignature().getPrefix()));
+	return HashIndex::combineHash(result, hash(element.getSignature().getPostfix()));
+}
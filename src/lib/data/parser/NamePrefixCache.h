@@ -0,0 +1,37 @@
+#ifndef NAME_PREFIX_CACHE_H
+#define NAME_PREFIX_CACHE_H
+
+#include <string>
+#include <vector>
+
+#include "HashIndex.h"
+#include "NameElement.h"
+#include "types.h"
+
+// interns the prefixes of recorded name hierarchies as a tree of node ids. each prefix is identified
+// by the node id of its parent prefix and its last name element, so known names can be resolved
+// without serializing them again.
+class NamePrefixCache
+{
+public:
+	// returns 0 if the prefix is not cached, the delimiter only matters for top level elements
+	Id getNodeId(Id parentNodeId, const std::wstring& delimiter, const NameElement& element) const;
+	void addNodeId(
+		Id parentNodeId, const std::wstring& delimiter, const NameElement& element, Id nodeId);
+
+private:
+	struct Prefix
+	{
+		Id parentNodeId;
+		std::wstring delimiter;
+		NameElement element;
+		Id nodeId;
+	};
+
+	static size_t getHash(Id parentNodeId, const std::wstring& delimiter, const NameElement& element);
+
+	HashIndex m_index;
+	std::vector<Prefix> m_prefixes;
+};
+
+#endif	  // NAME_PREFIX_CACHE_H
@@ -18,6 +18,8 @@ public:
 
 	virtual Id recordFile(const FilePath& filePath, bool indexed) = 0;
 	virtual void recordFileLanguage(Id fileId, const std::wstring& languageIdentifier) = 0;
+	// parts of a file's interface, like declarations and macros, that other files can depend on
+	virtual void recordInterfaceComponent(Id fileId, const std::string& component) = 0;
 
 	virtual Id recordSymbol(const NameHierarchy& symbolName) = 0;
 	virtual void recordSymbolKind(Id symbolId, SymbolKind symbolKind) = 0;
@@ -1,6 +1,7 @@
 #include "ParserClientImpl.h"
 
 #include "Edge.h"
+#include "FileFingerprint.h"
 #include "Node.h"
 #include "ParseLocation.h"
 
@@ -18,6 +19,12 @@ void ParserClientImpl::recordFileLanguage(Id fileId, const std::wstring& languag
 	m_storage->setFileLanguage(fileId, languageIdentifier);
 }
 
+void ParserClientImpl::recordInterfaceComponent(Id fileId, const std::string& component)
+{
+	m_storage->addFileInterfaceHash(
+		fileId, FileFingerprint::fromContent(component.data(), component.size()).getHash());
+}
+
 Id ParserClientImpl::recordSymbol(const NameHierarchy& symbolName)
 {
 	return addNodeHierarchy(symbolName);
@@ -201,31 +208,31 @@ LocationType ParserClientImpl::parseLocationTypeToLocationType(ParseLocationType
 
 Id ParserClientImpl::addNodeHierarchy(const NameHierarchy& nameHierarchy)
 {
-	Id childNodeId = 0;
-	Id firstNodeId = 0;
-	for (size_t i = nameHierarchy.size(); i > 0; i--)
+	// walks down from the outermost name, so only prefixes that were not recorded before by this
+	// client need to be serialized
+	Id parentNodeId = 0;
+	for (size_t i = 0; i < nameHierarchy.size(); i++)
 	{
-		std::pair<Id, bool> ret = m_storage->addNode(StorageNodeData(
-			nodeKindToInt(NODE_SYMBOL), NameHierarchy::serializeRange(nameHierarchy, 0, i)));
-
-		if (!firstNodeId)
+		Id nodeId = m_namePrefixCache.getNodeId(
+			parentNodeId, nameHierarchy.getDelimiter(), nameHierarchy[i]);
+		if (!nodeId)
 		{
-			firstNodeId = ret.first;
-		}
+			std::pair<Id, bool> ret = m_storage->addNode(StorageNodeData(
+				nodeKindToInt(NODE_SYMBOL), NameHierarchy::serializeRange(nameHierarchy, 0, i + 1)));
+			nodeId = ret.first;
 
-		if (childNodeId != 0)
-		{
-			addEdge(Edge::EDGE_MEMBER, ret.first, childNodeId);
-		}
+			if (ret.second)
+			{
+				addEdge(Edge::EDGE_MEMBER, parentNodeId, nodeId);
+			}
 
-		if (!ret.second)
-		{
-			return firstNodeId;
+			m_namePrefixCache.addNodeId(
+				parentNodeId, nameHierarchy.getDelimiter(), nameHierarchy[i], nodeId);
 		}
 
-		childNodeId = ret.first;
+		parentNodeId = nodeId;
 	}
-	return firstNodeId;
+	return parentNodeId;
 }
 
 Id ParserClientImpl::addFileName(const FilePath& filePath)
@@ -6,6 +6,7 @@
 #include "DefinitionKind.h"
 #include "IntermediateStorage.h"
 #include "LocationType.h"
+#include "NamePrefixCache.h"
 #include "Node.h"
 #include "ParserClient.h"
 
@@ -16,6 +17,7 @@ public:
 
 	Id recordFile(const FilePath& filePath, bool indexed) override;
 	void recordFileLanguage(Id fileId, const std::wstring& languageIdentifier) override;
+	void recordInterfaceComponent(Id fileId, const std::string& component) override;
 
 	Id recordSymbol(const NameHierarchy& symbolName) override;
 	void recordSymbolKind(Id symbolId, SymbolKind symbolKind) override;
@@ -56,6 +58,7 @@ private:
 
 	IntermediateStorage* const m_storage;
 	std::map<std::wstring, Id> m_fileIdMap;
+	NamePrefixCache m_namePrefixCache;
 };
 
 #endif	  // PARSER_CLIENT_IMPL_H
@@ -5,8 +5,10 @@
 #include "PersistentStorage.h"
 
 TaskParseWrapper::TaskParseWrapper(
-	std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView)
-	: m_storage(storage), m_dialogView(dialogView)
+	std::weak_ptr<PersistentStorage> storage,
+	std::shared_ptr<DialogView> dialogView,
+	SqliteIndexStorage::StorageModeType writeMode)
+	: m_storage(storage), m_dialogView(dialogView), m_writeMode(writeMode)
 {
 }
 
@@ -24,7 +26,7 @@ void TaskParseWrapper::doEnter(std::shared_ptr<Blackboard> blackboard)
 	{
 		if (std::shared_ptr<PersistentStorage> storage = m_storage.lock())
 		{
-			storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+			storage->setMode(m_writeMode);
 		}
 	}
 }
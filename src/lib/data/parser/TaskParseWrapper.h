@@ -3,6 +3,7 @@
 
 #include <memory>
 
+#include "SqliteIndexStorage.h"
 #include "Task.h"
 #include "TaskDecorator.h"
 #include "TaskRunner.h"
@@ -15,7 +16,11 @@ class PersistentStorage;
 class TaskParseWrapper: public TaskDecorator
 {
 public:
-	TaskParseWrapper(std::weak_ptr<PersistentStorage> storage, std::shared_ptr<DialogView> dialogView);
+	// the storage is switched to the given write mode while indexing
+	TaskParseWrapper(
+		std::weak_ptr<PersistentStorage> storage,
+		std::shared_ptr<DialogView> dialogView,
+		SqliteIndexStorage::StorageModeType writeMode);
 
 private:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -25,6 +30,7 @@ private:
 
 	std::weak_ptr<PersistentStorage> m_storage;
 	std::shared_ptr<DialogView> m_dialogView;
+	const SqliteIndexStorage::StorageModeType m_writeMode;
 
 	TimeStamp m_start;
 };
@@ -0,0 +1,127 @@
+#include "FileDependencyIndex.h"
+
+FileDependencyIndex::FileDependencyIndex(): m_built(false) {}
+
+void FileDependencyIndex::build(const std::vector<std::pair<Id, Id>>& dependencies)
+{
+	clear();
+
+	auto getIndex = [this](Id id) {
+		auto it = m_indices.emplace(id, static_cast<uint32_t>(m_ids.size()));
+		if (it.second)
+		{
+			m_ids.push_back(id);
+		}
+		return it.first->second;
+	};
+
+	std::vector<std::pair<uint32_t, uint32_t>> forwardEdges;
+	std::vector<std::pair<uint32_t, uint32_t>> backwardEdges;
+	forwardEdges.reserve(dependencies.size());
+	backwardEdges.reserve(dependencies.size());
+
+	for (const std::pair<Id, Id>& dependency: dependencies)
+	{
+		const uint32_t dependentIndex = getIndex(dependency.first);
+		const uint32_t dependencyIndex = getIndex(dependency.second);
+
+		forwardEdges.emplace_back(dependentIndex, dependencyIndex);
+		backwardEdges.emplace_back(dependencyIndex, dependentIndex);
+	}
+
+	buildAdjacency(forwardEdges, m_dependencies);
+	buildAdjacency(backwardEdges, m_dependents);
+
+	m_built = true;
+}
+
+void FileDependencyIndex::clear()
+{
+	m_indices.clear();
+	m_ids.clear();
+	m_dependents = Adjacency();
+	m_dependencies = Adjacency();
+	m_built = false;
+}
+
+bool FileDependencyIndex::isBuilt() const
+{
+	return m_built;
+}
+
+std::set<Id> FileDependencyIndex::getDependentFileIds(const std::set<Id>& fileIds) const
+{
+	return collectReachable(m_dependents, fileIds);
+}
+
+std::set<Id> FileDependencyIndex::getDependencyFileIds(const std::set<Id>& fileIds) const
+{
+	return collectReachable(m_dependencies, fileIds);
+}
+
+void FileDependencyIndex::buildAdjacency(
+	const std::vector<std::pair<uint32_t, uint32_t>>& indexEdges, Adjacency& adjacency) const
+{
+	// counting sort by source index
+	adjacency.offsets.assign(m_ids.size() + 1, 0);
+	for (const std::pair<uint32_t, uint32_t>& edge: indexEdges)
+	{
+		adjacency.offsets[edge.first + 1]++;
+	}
+
+	for (size_t i = 1; i < adjacency.offsets.size(); i++)
+	{
+		adjacency.offsets[i] += adjacency.offsets[i - 1];
+	}
+
+	std::vector<uint32_t> positions(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+	adjacency.neighbours.resize(indexEdges.size());
+	for (const std::pair<uint32_t, uint32_t>& edge: indexEdges)
+	{
+		adjacency.neighbours[positions[edge.first]++] = edge.second;
+	}
+}
+
+std::set<Id> FileDependencyIndex::collectReachable(
+	const Adjacency& adjacency, const std::set<Id>& fileIds) const
+{
+	std::vector<bool> visited(m_ids.size(), false);
+	std::vector<bool> reached(m_ids.size(), false);
+	std::vector<uint32_t> stack;
+
+	for (Id fileId: fileIds)
+	{
+		auto it = m_indices.find(fileId);
+		if (it != m_indices.end() && !visited[it->second])
+		{
+			visited[it->second] = true;
+			stack.push_back(it->second);
+		}
+	}
+
+	// the given files are only part of the result if they can be reached from one of them
+	std::set<Id> reachedIds;
+	while (!stack.empty())
+	{
+		const uint32_t index = stack.back();
+		stack.pop_back();
+
+		for (uint32_t i = adjacency.offsets[index]; i < adjacency.offsets[index + 1]; i++)
+		{
+			const uint32_t neighbour = adjacency.neighbours[i];
+			if (!reached[neighbour])
+			{
+				reached[neighbour] = true;
+				reachedIds.insert(m_ids[neighbour]);
+			}
+
+			if (!visited[neighbour])
+			{
+				visited[neighbour] = true;
+				stack.push_back(neighbour);
+			}
+		}
+	}
+
+	return reachedIds;
+}
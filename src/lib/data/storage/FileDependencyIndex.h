@@ -0,0 +1,51 @@
+#ifndef FILE_DEPENDENCY_INDEX_H
+#define FILE_DEPENDENCY_INDEX_H
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "types.h"
+
+// compressed adjacency arrays of the file dependency graph in both directions. file ids are mapped
+// to dense indices, so the transitive dependents or dependencies of a set of files can be
+// collected without any lookups in node based containers.
+class FileDependencyIndex
+{
+public:
+	FileDependencyIndex();
+
+	// takes pairs of dependent and depended on file ids
+	void build(const std::vector<std::pair<Id, Id>>& dependencies);
+	void clear();
+
+	bool isBuilt() const;
+
+	// files that depend on any of the given files, directly or transitively
+	std::set<Id> getDependentFileIds(const std::set<Id>& fileIds) const;
+	// files that any of the given files depend on, directly or transitively
+	std::set<Id> getDependencyFileIds(const std::set<Id>& fileIds) const;
+
+private:
+	struct Adjacency
+	{
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> neighbours;
+	};
+
+	void buildAdjacency(
+		const std::vector<std::pair<uint32_t, uint32_t>>& indexEdges, Adjacency& adjacency) const;
+	std::set<Id> collectReachable(const Adjacency& adjacency, const std::set<Id>& fileIds) const;
+
+	std::unordered_map<Id, uint32_t> m_indices;
+	std::vector<Id> m_ids;
+
+	Adjacency m_dependents;
+	Adjacency m_dependencies;
+
+	bool m_built;
+};
+
+#endif	  // FILE_DEPENDENCY_INDEX_H
@@ -1,9 +1,64 @@
 #include "IntermediateStorage.h"
 
+#include <functional>
+#include <set>
+
 #include "LocationType.h"
 #include "utility.h"
 
-IntermediateStorage::IntermediateStorage(): m_nextId(1) {}
+namespace
+{
+size_t getHash(Id id)
+{
+	return HashIndex::combineHash(0, static_cast<size_t>(id));
+}
+
+size_t getHash(const StorageNodeData& node)
+{
+	return std::hash<std::wstring>()(node.serializedName);
+}
+
+size_t getHash(const StorageEdgeData& edge)
+{
+	size_t hash = HashIndex::combineHash(0, static_cast<size_t>(edge.type));
+	hash = HashIndex::combineHash(hash, static_cast<size_t>(edge.sourceNodeId));
+	return HashIndex::combineHash(hash, static_cast<size_t>(edge.targetNodeId));
+}
+
+size_t getHash(const StorageLocalSymbolData& localSymbol)
+{
+	return std::hash<std::wstring>()(localSymbol.name);
+}
+
+size_t getHash(const StorageSourceLocationData& location)
+{
+	size_t hash = HashIndex::combineHash(0, static_cast<size_t>(location.fileNodeId));
+	hash = HashIndex::combineHash(hash, location.startLine);
+	hash = HashIndex::combineHash(hash, location.startCol);
+	hash = HashIndex::combineHash(hash, location.endLine);
+	hash = HashIndex::combineHash(hash, location.endCol);
+	return HashIndex::combineHash(hash, static_cast<size_t>(location.type));
+}
+
+// equality as defined by the ordering of the storage types
+template <typename T>
+bool isEquivalent(const T& a, const T& b)
+{
+	return !(a < b) && !(b < a);
+}
+
+template <typename ElementType, typename DataType>
+void rebuildIndex(HashIndex& index, const std::vector<ElementType>& elements)
+{
+	index.clear();
+	for (size_t i = 0; i < elements.size(); i++)
+	{
+		index.insert(getHash(static_cast<const DataType&>(elements[i])), i);
+	}
+}
+}	 // namespace
+
+IntermediateStorage::IntermediateStorage(): m_finished(true), m_nextId(1) {}
 
 void IntermediateStorage::clear()
 {
@@ -20,14 +75,20 @@ void IntermediateStorage::clear()
 	m_edgesIndex.clear();
 	m_edges.clear();
 
+	m_localSymbolsIndex.clear();
 	m_localSymbols.clear();
+	m_sourceLocationsIndex.clear();
 	m_sourceLocations.clear();
 	m_occurrences.clear();
 	m_componentAccesses.clear();
+	m_elementComponents.clear();
+	m_finished = true;
 
 	m_errorsIndex.clear();
 	m_errors.clear();
 
+	m_indexingCosts.clear();
+
 	m_nextId = 1;
 }
 
@@ -55,17 +116,18 @@ size_t IntermediateStorage::getByteSize(size_t stringSize) const
 		byteSize += stringSize + storageNode.serializedName.size();
 	}
 
-	for (const StorageLocalSymbol& storageLocalSymbol: getStorageLocalSymbols())
+	// uses the members directly, so checking the size does not sort anything
+	for (const StorageLocalSymbol& storageLocalSymbol: m_localSymbols)
 	{
 		byteSize += sizeof(StorageLocalSymbol);
 		byteSize += stringSize + storageLocalSymbol.name.size();
 	}
 
 	byteSize += sizeof(StorageEdge) * getStorageEdges().size();
-	byteSize += sizeof(StorageComponentAccess) * getComponentAccesses().size();
-	byteSize += sizeof(StorageOccurrence) * getStorageOccurrences().size();
+	byteSize += sizeof(StorageComponentAccess) * m_componentAccesses.size();
+	byteSize += sizeof(StorageOccurrence) * m_occurrences.size();
 	byteSize += sizeof(StorageSymbol) * getStorageSymbols().size();
-	byteSize += sizeof(StorageSourceLocation) * getStorageSourceLocations().size();
+	byteSize += sizeof(StorageSourceLocation) * m_sourceLocations.size();
 
 	return byteSize;
 }
@@ -118,10 +180,13 @@ void IntermediateStorage::setFilesWithErrorsIncomplete()
 
 std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData)
 {
-	auto it = m_nodesIndex.find(nodeData);
-	if (it != m_nodesIndex.end())
+	const size_t hash = getHash(nodeData);
+	const size_t position = m_nodesIndex.find(hash, [&](size_t i) {
+		return m_nodes[i].serializedName == nodeData.serializedName;
+	});
+	if (position != HashIndex::s_notFound)
 	{
-		StorageNode& storedNode = m_nodes[it->second];
+		StorageNode& storedNode = m_nodes[position];
 		if (storedNode.type < nodeData.type)
 		{
 			storedNode.type = nodeData.type;
@@ -131,8 +196,8 @@ std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData
 
 	Id nodeId = m_nextId++;
 	m_nodes.emplace_back(nodeId, nodeData);
-	m_nodesIndex.emplace(nodeData, m_nodes.size() - 1);
-	m_nodeIdIndex.emplace(nodeId, m_nodes.size() - 1);
+	m_nodesIndex.insert(hash, m_nodes.size() - 1);
+	m_nodeIdIndex.insert(getHash(nodeId), m_nodes.size() - 1);
 	return std::make_pair(nodeId, true);
 }
 
@@ -149,10 +214,11 @@ std::vector<Id> IntermediateStorage::addNodes(const std::vector<StorageNode>& no
 
 void IntermediateStorage::setNodeType(Id nodeId, int nodeType)
 {
-	auto it = m_nodeIdIndex.find(nodeId);
-	if (it != m_nodeIdIndex.end() && m_nodes[it->second].type < nodeType)
+	const size_t position = m_nodeIdIndex.find(
+		getHash(nodeId), [&](size_t i) { return m_nodes[i].id == nodeId; });
+	if (position != HashIndex::s_notFound && m_nodes[position].type < nodeType)
 	{
-		m_nodes[it->second].type = nodeType;
+		m_nodes[position].type = nodeType;
 	}
 }
 
@@ -187,6 +253,11 @@ void IntermediateStorage::addFile(const StorageFile& file)
 		{
 			storedFile.languageIdentifier = file.languageIdentifier;
 		}
+
+		if (!storedFile.interfaceHash)
+		{
+			storedFile.interfaceHash = file.interfaceHash;
+		}
 	}
 	else
 	{
@@ -205,17 +276,30 @@ void IntermediateStorage::setFileLanguage(Id fileId, const std::wstring& languag
 	}
 }
 
+void IntermediateStorage::addFileInterfaceHash(Id fileId, unsigned long long componentHash)
+{
+	// summing keeps the result independent of the order in which components get recorded
+	auto it = m_filesIdIndex.find(fileId);
+	if (it != m_filesIdIndex.end())
+	{
+		m_files[it->second].interfaceHash += componentHash;
+	}
+}
+
 Id IntermediateStorage::addEdge(const StorageEdgeData& edgeData)
 {
-	auto it = m_edgesIndex.find(edgeData);
-	if (it != m_edgesIndex.end())
+	const size_t hash = getHash(edgeData);
+	const size_t position = m_edgesIndex.find(hash, [&](size_t i) {
+		return isEquivalent<StorageEdgeData>(m_edges[i], edgeData);
+	});
+	if (position != HashIndex::s_notFound)
 	{
-		return m_edges[it->second].id;
+		return m_edges[position].id;
 	}
 
 	Id edgeId = m_nextId++;
 	m_edges.emplace_back(edgeId, edgeData);
-	m_edgesIndex.emplace(edgeData, m_edges.size() - 1);
+	m_edgesIndex.insert(hash, m_edges.size() - 1);
 	return edgeId;
 }
 
@@ -232,18 +316,28 @@ std::vector<Id> IntermediateStorage::addEdges(const std::vector<StorageEdge>& ed
 
 Id IntermediateStorage::addLocalSymbol(const StorageLocalSymbolData& localSymbolData)
 {
-	auto it = m_localSymbols.find(StorageLocalSymbol(0, localSymbolData));
-	if (it != m_localSymbols.end())
+	if (m_localSymbolsIndex.size() != m_localSymbols.size())
 	{
-		return it->id;
+		rebuildIndex<StorageLocalSymbol, StorageLocalSymbolData>(
+			m_localSymbolsIndex, m_localSymbols);
+	}
+
+	const size_t hash = getHash(localSymbolData);
+	const size_t position = m_localSymbolsIndex.find(
+		hash, [&](size_t i) { return m_localSymbols[i].name == localSymbolData.name; });
+	if (position != HashIndex::s_notFound)
+	{
+		return m_localSymbols[position].id;
 	}
 
 	Id localSymbolId = m_nextId++;
-	m_localSymbols.emplace(localSymbolId, localSymbolData);
+	m_localSymbols.emplace_back(localSymbolId, localSymbolData);
+	m_localSymbolsIndex.insert(hash, m_localSymbols.size() - 1);
+	m_finished = false;
 	return localSymbolId;
 }
 
-std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> IntermediateStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	std::vector<Id> symbolIds;
 	symbolIds.reserve(symbols.size());
@@ -256,14 +350,25 @@ std::vector<Id> IntermediateStorage::addLocalSymbols(const std::set<StorageLocal
 
 Id IntermediateStorage::addSourceLocation(const StorageSourceLocationData& sourceLocationData)
 {
-	auto it = m_sourceLocations.find(StorageSourceLocation(0, sourceLocationData));
-	if (it != m_sourceLocations.end())
+	if (m_sourceLocationsIndex.size() != m_sourceLocations.size())
+	{
+		rebuildIndex<StorageSourceLocation, StorageSourceLocationData>(
+			m_sourceLocationsIndex, m_sourceLocations);
+	}
+
+	const size_t hash = getHash(sourceLocationData);
+	const size_t position = m_sourceLocationsIndex.find(hash, [&](size_t i) {
+		return isEquivalent<StorageSourceLocationData>(m_sourceLocations[i], sourceLocationData);
+	});
+	if (position != HashIndex::s_notFound)
 	{
-		return it->id;
+		return m_sourceLocations[position].id;
 	}
 
 	Id sourceLocationId = m_nextId++;
-	m_sourceLocations.emplace(sourceLocationId, sourceLocationData);
+	m_sourceLocations.emplace_back(sourceLocationId, sourceLocationData);
+	m_sourceLocationsIndex.insert(hash, m_sourceLocations.size() - 1);
+	m_finished = false;
 	return sourceLocationId;
 }
 
@@ -280,32 +385,39 @@ std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<Storag
 
 void IntermediateStorage::addOccurrence(const StorageOccurrence& occurrence)
 {
-	m_occurrences.emplace(occurrence);
+	m_occurrences.emplace_back(occurrence);
+	m_finished = false;
 }
 
 void IntermediateStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences)
 {
-	m_occurrences.insert(occurrences.begin(), occurrences.end());
+	m_occurrences.insert(m_occurrences.end(), occurrences.begin(), occurrences.end());
+	m_finished = false;
 }
 
 void IntermediateStorage::addComponentAccess(const StorageComponentAccess& componentAccess)
 {
-	m_componentAccesses.emplace(componentAccess);
+	m_componentAccesses.emplace_back(componentAccess);
+	m_finished = false;
 }
 
 void IntermediateStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses)
 {
-	m_componentAccesses.insert(componentAccesses.begin(), componentAccesses.end());
+	m_componentAccesses.insert(
+		m_componentAccesses.end(), componentAccesses.begin(), componentAccesses.end());
+	m_finished = false;
 }
 
 void IntermediateStorage::addElementComponent(const StorageElementComponent& component)
 {
-	m_elementComponents.emplace(component);
+	m_elementComponents.emplace_back(component);
+	m_finished = false;
 }
 
 void IntermediateStorage::addElementComponents(const std::vector<StorageElementComponent>& components)
 {
-	m_elementComponents.insert(components.begin(), components.end());
+	m_elementComponents.insert(m_elementComponents.end(), components.begin(), components.end());
+	m_finished = false;
 }
 
 Id IntermediateStorage::addError(const StorageErrorData& errorData)
@@ -322,6 +434,11 @@ Id IntermediateStorage::addError(const StorageErrorData& errorData)
 	return errorId;
 }
 
+void IntermediateStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs)
+{
+	m_indexingCosts.insert(m_indexingCosts.end(), costs.begin(), costs.end());
+}
+
 const std::vector<StorageNode>& IntermediateStorage::getStorageNodes() const
 {
 	return m_nodes;
@@ -342,28 +459,33 @@ const std::vector<StorageEdge>& IntermediateStorage::getStorageEdges() const
 	return m_edges;
 }
 
-const std::set<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
+const std::vector<StorageLocalSymbol>& IntermediateStorage::getStorageLocalSymbols() const
 {
+	finish();
 	return m_localSymbols;
 }
 
-const std::set<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& IntermediateStorage::getStorageSourceLocations() const
 {
+	finish();
 	return m_sourceLocations;
 }
 
-const std::set<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& IntermediateStorage::getStorageOccurrences() const
 {
+	finish();
 	return m_occurrences;
 }
 
-const std::set<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& IntermediateStorage::getComponentAccesses() const
 {
+	finish();
 	return m_componentAccesses;
 }
 
-const std::set<StorageElementComponent>& IntermediateStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& IntermediateStorage::getElementComponents() const
 {
+	finish();
 	return m_elementComponents;
 }
 
@@ -372,6 +494,11 @@ const std::vector<StorageError>& IntermediateStorage::getErrors() const
 	return m_errors;
 }
 
+const std::vector<StorageIndexingCost>& IntermediateStorage::getIndexingCosts() const
+{
+	return m_indexingCosts;
+}
+
 void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes)
 {
 	m_nodes = std::move(storageNodes);
@@ -380,8 +507,8 @@ void IntermediateStorage::setStorageNodes(std::vector<StorageNode> storageNodes)
 	m_nodeIdIndex.clear();
 	for (size_t i = 0; i < m_nodes.size(); i++)
 	{
-		m_nodesIndex.emplace(m_nodes[i], i);
-		m_nodeIdIndex.emplace(m_nodes[i].id, i);
+		m_nodesIndex.insert(getHash(m_nodes[i]), i);
+		m_nodeIdIndex.insert(getHash(m_nodes[i].id), i);
 	}
 }
 
@@ -407,34 +534,32 @@ void IntermediateStorage::setStorageEdges(std::vector<StorageEdge> storageEdges)
 {
 	m_edges = std::move(storageEdges);
 
-	m_edgesIndex.clear();
-	for (size_t i = 0; i < m_edges.size(); i++)
-	{
-		m_edgesIndex.emplace(m_edges[i], i);
-	}
+	rebuildIndex<StorageEdge, StorageEdgeData>(m_edgesIndex, m_edges);
 }
 
-void IntermediateStorage::setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols)
+void IntermediateStorage::setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols)
 {
 	m_localSymbols = std::move(storageLocalSymbols);
+	m_localSymbolsIndex.clear();
 }
 
-void IntermediateStorage::setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations)
+void IntermediateStorage::setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations)
 {
 	m_sourceLocations = std::move(storageSourceLocations);
+	m_sourceLocationsIndex.clear();
 }
 
-void IntermediateStorage::setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences)
+void IntermediateStorage::setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences)
 {
 	m_occurrences = std::move(storageOccurrences);
 }
 
-void IntermediateStorage::setComponentAccesses(std::set<StorageComponentAccess> componentAccesses)
+void IntermediateStorage::setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses)
 {
 	m_componentAccesses = std::move(componentAccesses);
 }
 
-void IntermediateStorage::setElementComponents(std::set<StorageElementComponent> components)
+void IntermediateStorage::setElementComponents(std::vector<StorageElementComponent> components)
 {
 	m_elementComponents = std::move(components);
 }
@@ -450,6 +575,11 @@ void IntermediateStorage::setErrors(std::vector<StorageError> errors)
 	}
 }
 
+void IntermediateStorage::setIndexingCosts(std::vector<StorageIndexingCost> costs)
+{
+	m_indexingCosts = std::move(costs);
+}
+
 Id IntermediateStorage::getNextId() const
 {
 	return m_nextId;
@@ -459,3 +589,24 @@ void IntermediateStorage::setNextId(const Id nextId)
 {
 	m_nextId = nextId;
 }
+
+void IntermediateStorage::finish() const
+{
+	if (m_finished)
+	{
+		return;
+	}
+
+	// sorting moves the elements, the indices are rebuilt once the next element gets added
+	utility::sortAndRemoveDuplicates(m_localSymbols);
+	m_localSymbolsIndex.clear();
+
+	utility::sortAndRemoveDuplicates(m_sourceLocations);
+	m_sourceLocationsIndex.clear();
+
+	utility::sortAndRemoveDuplicates(m_occurrences);
+	utility::sortAndRemoveDuplicates(m_componentAccesses);
+	utility::sortAndRemoveDuplicates(m_elementComponents);
+
+	m_finished = true;
+}
@@ -3,10 +3,13 @@
 
 #include <map>
 #include <memory>
-#include <set>
 
+#include "HashIndex.h"
 #include "Storage.h"
 
+// new elements are deduplicated through hash indices on top of append-only vectors. local symbols,
+// source locations, occurrences and component data are sorted and deduplicated once when first
+// requested through their getters after any change.
 class IntermediateStorage: public Storage
 {
 public:
@@ -28,10 +31,11 @@ public:
 	void addSymbols(const std::vector<StorageSymbol>& symbols) override;
 	void addFile(const StorageFile& file) override;
 	void setFileLanguage(Id fileId, const std::wstring& languageIdentifier);
+	void addFileInterfaceHash(Id fileId, unsigned long long componentHash);
 	Id addEdge(const StorageEdgeData& edgeData) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& localSymbolData) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& sourceLocationData) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& occurrence) override;
@@ -41,35 +45,42 @@ public:
 	void addElementComponent(const StorageElementComponent& component) override;
 	void addElementComponents(const std::vector<StorageElementComponent>& components) override;
 	Id addError(const StorageErrorData& errorData) override;
+	void addIndexingCosts(const std::vector<StorageIndexingCost>& costs) override;
 
 	const std::vector<StorageNode>& getStorageNodes() const override;
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
+	const std::vector<StorageIndexingCost>& getIndexingCosts() const override;
 
 	void setStorageNodes(std::vector<StorageNode> storageNodes);
 	void setStorageFiles(std::vector<StorageFile> storageFiles);
 	void setStorageSymbols(std::vector<StorageSymbol> storageSymbols);
 	void setStorageEdges(std::vector<StorageEdge> storageEdges);
-	void setStorageLocalSymbols(std::set<StorageLocalSymbol> storageLocalSymbols);
-	void setStorageSourceLocations(std::set<StorageSourceLocation> storageSourceLocations);
-	void setStorageOccurrences(std::set<StorageOccurrence> storageOccurrences);
-	void setComponentAccesses(std::set<StorageComponentAccess> componentAccesses);
-	void setElementComponents(std::set<StorageElementComponent> components);
+	// these expect the elements to be sorted and free of duplicates, as returned by the getters
+	void setStorageLocalSymbols(std::vector<StorageLocalSymbol> storageLocalSymbols);
+	void setStorageSourceLocations(std::vector<StorageSourceLocation> storageSourceLocations);
+	void setStorageOccurrences(std::vector<StorageOccurrence> storageOccurrences);
+	void setComponentAccesses(std::vector<StorageComponentAccess> componentAccesses);
+	void setElementComponents(std::vector<StorageElementComponent> components);
 	void setErrors(std::vector<StorageError> errors);
+	void setIndexingCosts(std::vector<StorageIndexingCost> costs);
 
 	Id getNextId() const;
 	void setNextId(const Id nextId);
 
 private:
-	std::map<StorageNodeData, size_t> m_nodesIndex;
-	std::map<Id, size_t> m_nodeIdIndex;
+	void finish() const;
+
+	// indices store positions in the vectors, so each name is kept in memory only once
+	HashIndex m_nodesIndex;
+	HashIndex m_nodeIdIndex;
 	std::vector<StorageNode> m_nodes;
 
 	std::map<StorageFile, size_t> m_filesIndex;	   // this is used to prevent duplicates (unique)
@@ -78,21 +89,27 @@ private:
 
 	std::vector<StorageSymbol> m_symbols;
 
-	std::map<StorageEdgeData, size_t> m_edgesIndex;
+	HashIndex m_edgesIndex;
 	std::vector<StorageEdge> m_edges;
 
-	std::set<StorageLocalSymbol> m_localSymbols;
+	// sorted by finish(), which invalidates the indices, so they get rebuilt on the next insertion
+	mutable HashIndex m_localSymbolsIndex;
+	mutable std::vector<StorageLocalSymbol> m_localSymbols;
 
-	std::set<StorageSourceLocation> m_sourceLocations;
+	mutable HashIndex m_sourceLocationsIndex;
+	mutable std::vector<StorageSourceLocation> m_sourceLocations;
 
-	std::set<StorageOccurrence> m_occurrences;
+	mutable std::vector<StorageOccurrence> m_occurrences;
+	mutable std::vector<StorageComponentAccess> m_componentAccesses;
+	mutable std::vector<StorageElementComponent> m_elementComponents;
 
-	std::set<StorageComponentAccess> m_componentAccesses;
-	std::set<StorageElementComponent> m_elementComponents;
+	mutable bool m_finished;
 
 	std::map<StorageErrorData, size_t> m_errorsIndex;	 // this is used to prevent duplicates (unique)
 	std::vector<StorageError> m_errors;
 
+	std::vector<StorageIndexingCost> m_indexingCosts;
+
 	Id m_nextId;
 };
 
@@ -9,6 +9,7 @@
 #include "FileInfo.h"
 #include "FilePath.h"
 #include "Graph.h"
+#include "IntermediateStorage.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
 #include "NodeTypeSet.h"
@@ -45,6 +46,9 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 	}
 
 	m_commandIndex.finishSetup();
+
+	// applied before any table is created, so a new database gets the page size of the profile
+	applyBrowseProfile();
 }
 
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data)
@@ -87,17 +91,35 @@ void PersistentStorage::addFile(const StorageFile& data)
 			m_sqliteIndexStorage.setFileCompleteIfNoError(
 				storedFile.id, storedFile.filePath, data.complete);
 		}
+
+		if (data.interfaceHash && data.interfaceHash != storedFile.interfaceHash)
+		{
+			m_sqliteIndexStorage.setFileInterfaceHash(storedFile.id, data.interfaceHash);
+		}
 	}
 }
 
 Id PersistentStorage::addEdge(const StorageEdgeData& data)
 {
-	return m_sqliteIndexStorage.addEdge(data);
+	const Id edgeId = m_sqliteIndexStorage.addEdge(data);
+	if (edgeId && data.type == Edge::typeToInt(Edge::EDGE_IMPORT))
+	{
+		m_injectedImportEdgeIds.push_back(edgeId);
+	}
+	return edgeId;
 }
 
 std::vector<Id> PersistentStorage::addEdges(const std::vector<StorageEdge>& edges)
 {
-	return m_sqliteIndexStorage.addEdges(edges);
+	std::vector<Id> edgeIds = m_sqliteIndexStorage.addEdges(edges);
+	for (size_t i = 0; i < edges.size() && i < edgeIds.size(); i++)
+	{
+		if (edgeIds[i] && edges[i].type == Edge::typeToInt(Edge::EDGE_IMPORT))
+		{
+			m_injectedImportEdgeIds.push_back(edgeIds[i]);
+		}
+	}
+	return edgeIds;
 }
 
 Id PersistentStorage::addLocalSymbol(const StorageLocalSymbolData& data)
@@ -105,7 +127,7 @@ Id PersistentStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return m_sqliteIndexStorage.addLocalSymbol(data);
 }
 
-std::vector<Id> PersistentStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> PersistentStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	return m_sqliteIndexStorage.addLocalSymbols(symbols);
 }
@@ -155,6 +177,11 @@ Id PersistentStorage::addError(const StorageErrorData& data)
 	return m_sqliteIndexStorage.addError(data).id;
 }
 
+void PersistentStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs)
+{
+	m_sqliteIndexStorage.addIndexingCosts(costs);
+}
+
 void PersistentStorage::removeElement(const Id id)
 {
 	m_sqliteIndexStorage.removeElement(id);
@@ -200,33 +227,39 @@ const std::vector<StorageEdge>& PersistentStorage::getStorageEdges() const
 	return m_storageData.edges = m_sqliteIndexStorage.getAll<StorageEdge>();
 }
 
-const std::set<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
+const std::vector<StorageLocalSymbol>& PersistentStorage::getStorageLocalSymbols() const
 {
-	return m_storageData.locals = utility::toSet(m_sqliteIndexStorage.getAll<StorageLocalSymbol>());
+	m_storageData.locals = m_sqliteIndexStorage.getAll<StorageLocalSymbol>();
+	utility::sortAndRemoveDuplicates(m_storageData.locals);
+	return m_storageData.locals;
 }
 
-const std::set<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
+const std::vector<StorageSourceLocation>& PersistentStorage::getStorageSourceLocations() const
 {
-	return m_storageData.locations = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageSourceLocation>());
+	m_storageData.locations = m_sqliteIndexStorage.getAll<StorageSourceLocation>();
+	utility::sortAndRemoveDuplicates(m_storageData.locations);
+	return m_storageData.locations;
 }
 
-const std::set<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
+const std::vector<StorageOccurrence>& PersistentStorage::getStorageOccurrences() const
 {
-	return m_storageData.occurrences = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageOccurrence>());
+	m_storageData.occurrences = m_sqliteIndexStorage.getAll<StorageOccurrence>();
+	utility::sortAndRemoveDuplicates(m_storageData.occurrences);
+	return m_storageData.occurrences;
 }
 
-const std::set<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
+const std::vector<StorageComponentAccess>& PersistentStorage::getComponentAccesses() const
 {
-	return m_storageData.accesses = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageComponentAccess>());
+	m_storageData.accesses = m_sqliteIndexStorage.getAll<StorageComponentAccess>();
+	utility::sortAndRemoveDuplicates(m_storageData.accesses);
+	return m_storageData.accesses;
 }
 
-const std::set<StorageElementComponent>& PersistentStorage::getElementComponents() const
+const std::vector<StorageElementComponent>& PersistentStorage::getElementComponents() const
 {
-	return m_storageData.components = utility::toSet(
-			   m_sqliteIndexStorage.getAll<StorageElementComponent>());
+	m_storageData.components = m_sqliteIndexStorage.getAll<StorageElementComponent>();
+	utility::sortAndRemoveDuplicates(m_storageData.components);
+	return m_storageData.components;
 }
 
 const std::vector<StorageError>& PersistentStorage::getErrors() const
@@ -239,16 +272,24 @@ const std::vector<StorageError>& PersistentStorage::getErrors() const
 	return m_storageData.errors = errors;
 }
 
+const std::vector<StorageIndexingCost>& PersistentStorage::getIndexingCosts() const
+{
+	return m_storageData.indexingCosts = m_sqliteIndexStorage.getAll<StorageIndexingCost>();
+}
+
 void PersistentStorage::startInjection()
 {
 	beforeErrorRecording();
 
+	m_sqliteIndexStorage.applyProfile(ApplicationSettings::getInstance()->getStorageProfile(
+		SqliteStorageProfileType::BULK_INDEXING));
 	m_sqliteIndexStorage.beginTransaction();
 }
 
 void PersistentStorage::finishInjection()
 {
 	m_sqliteIndexStorage.commitTransaction();
+	applyBrowseProfile();
 
 	afterErrorRecording();
 }
@@ -256,10 +297,37 @@ void PersistentStorage::finishInjection()
 void PersistentStorage::rollbackInjection()
 {
 	m_sqliteIndexStorage.rollbackTransaction();
+	applyBrowseProfile();
 
 	afterErrorRecording();
 }
 
+bool PersistentStorage::beginRefreshTransaction()
+{
+	if (!m_sqliteIndexStorage.enableWriteAheadLog())
+	{
+		return false;
+	}
+
+	m_sqliteIndexStorage.beginTransaction();
+	return true;
+}
+
+void PersistentStorage::commitRefreshTransaction()
+{
+	m_sqliteIndexStorage.commitTransaction();
+}
+
+void PersistentStorage::rollbackRefreshTransaction()
+{
+	m_sqliteIndexStorage.rollbackTransaction();
+}
+
+void PersistentStorage::disableWriteAheadLog()
+{
+	m_sqliteIndexStorage.disableWriteAheadLog();
+}
+
 void PersistentStorage::beforeErrorRecording()
 {
 	m_preInjectionErrorCount = m_sqliteIndexStorage.getErrorCount();
@@ -289,6 +357,13 @@ void PersistentStorage::setMode(const SqliteIndexStorage::StorageModeType mode)
 	m_sqliteIndexStorage.setMode(mode);
 }
 
+void PersistentStorage::applyBrowseProfile()
+{
+	std::shared_ptr<ApplicationSettings> settings = ApplicationSettings::getInstance();
+	m_sqliteIndexStorage.applyProfile(
+		settings->getStorageProfile(settings->getStorageBrowseProfileType()));
+}
+
 FilePath PersistentStorage::getIndexDbFilePath() const
 {
 	return m_sqliteIndexStorage.getDbFilePath();
@@ -319,6 +394,17 @@ void PersistentStorage::setProjectSettingsText(std::string text)
 	m_sqliteIndexStorage.setProjectSettingsText(text);
 }
 
+std::map<FilePath, unsigned long long> PersistentStorage::getPendingInterfaceHashes() const
+{
+	return m_sqliteIndexStorage.getPendingInterfaceHashes();
+}
+
+void PersistentStorage::setPendingInterfaceHashes(
+	const std::map<FilePath, unsigned long long>& interfaceHashes)
+{
+	m_sqliteIndexStorage.setPendingInterfaceHashes(interfaceHashes);
+}
+
 void PersistentStorage::setup()
 {
 	m_sqliteIndexStorage.setup();
@@ -339,6 +425,7 @@ void PersistentStorage::updateVersion()
 void PersistentStorage::clear()
 {
 	m_sqliteIndexStorage.clear();
+	m_injectedImportEdgeIds.clear();
 
 	clearCaches();
 }
@@ -355,32 +442,36 @@ void PersistentStorage::clearCaches()
 	m_fileNodeIndexed.clear();
 	m_fileNodeLanguage.clear();
 	m_symbolDefinitionKinds.clear();
+	m_fileDependencyIndex.clear();
 
 	m_hierarchyCache.clear();
 	m_fullTextSearchIndex.clear();
 	m_fullTextSearchCodec = "";
 }
 
-std::set<FilePath> PersistentStorage::getReferenced(const std::set<FilePath>& filePaths) const
+void PersistentStorage::updateFileDependencies()
 {
 	TRACE();
-	std::set<FilePath> referenced;
 
-	utility::append(referenced, getReferencedByIncludes(filePaths));
-	utility::append(referenced, getReferencedByImports(filePaths));
+	m_sqliteIndexStorage.addImportFileDependencies(m_injectedImportEdgeIds);
+	m_injectedImportEdgeIds.clear();
+	m_fileDependencyIndex.clear();
+}
+
+std::set<FilePath> PersistentStorage::getReferenced(const std::set<FilePath>& filePaths) const
+{
+	TRACE();
 
-	return referenced;
+	return getFileNodePaths(
+		getFileDependencyIndex().getDependencyFileIds(getFileNodeIds(filePaths)));
 }
 
 std::set<FilePath> PersistentStorage::getReferencing(const std::set<FilePath>& filePaths) const
 {
 	TRACE();
-	std::set<FilePath> referencing;
-
-	utility::append(referencing, getReferencingByIncludes(filePaths));
-	utility::append(referencing, getReferencingByImports(filePaths));
 
-	return referencing;
+	return getFileNodePaths(
+		getFileDependencyIndex().getDependentFileIds(getFileNodeIds(filePaths)));
 }
 
 void PersistentStorage::clearAllErrors()
@@ -391,26 +482,97 @@ void PersistentStorage::clearAllErrors()
 }
 
 void PersistentStorage::clearFileElements(
-	const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback)
+	const std::vector<FilePath>& filePaths,
+	const std::set<FilePath>& keptFileNodePaths,
+	std::function<void(int)> updateStatusCallback)
 {
 	TRACE();
 
 	std::vector<Id> fileNodeIds;
+	std::vector<Id> removedFileNodeIds;
+	std::vector<Id> keptFileNodeIds;
 	for (const StorageFile& file: m_sqliteIndexStorage.getFilesByPaths(filePaths))
 	{
 		fileNodeIds.push_back(file.id);
+
+		if (keptFileNodePaths.find(FilePath(file.filePath)) != keptFileNodePaths.end())
+		{
+			keptFileNodeIds.push_back(file.id);
+		}
+		else
+		{
+			removedFileNodeIds.push_back(file.id);
+		}
 	}
 
 	if (!fileNodeIds.empty())
 	{
 		m_sqliteIndexStorage.beginTransaction();
-		m_sqliteIndexStorage.removeElementsWithLocationInFiles(fileNodeIds, updateStatusCallback);
-		m_sqliteIndexStorage.removeElements(fileNodeIds);
+		m_sqliteIndexStorage.removeElementsWithLocationInFiles(
+			fileNodeIds, !keptFileNodeIds.empty(), updateStatusCallback);
+		if (!removedFileNodeIds.empty())
+		{
+			m_sqliteIndexStorage.removeElements(removedFileNodeIds);
+		}
+		if (!keptFileNodeIds.empty())
+		{
+			m_sqliteIndexStorage.removeFilesKeepingNodes(keptFileNodeIds);
+		}
 		m_sqliteIndexStorage.commitTransaction();
+		m_sqliteIndexStorage.clearTemporaryIndices();
+		m_fileDependencyIndex.clear();
 		updateStatusCallback(100);
 	}
 }
 
+bool PersistentStorage::replaceFileElements(
+	const std::set<FilePath>& filePaths,
+	const std::vector<std::shared_ptr<IntermediateStorage>>& intermediateStorages)
+{
+	TRACE();
+
+	const size_t transactionDepth = m_sqliteIndexStorage.getTransactionDepth();
+	std::string errorMessage;
+
+	m_sqliteIndexStorage.beginTransaction();
+	try
+	{
+		clearFileElements(utility::toVector(filePaths), std::set<FilePath>(), [](int progress) {});
+		for (const std::shared_ptr<IntermediateStorage>& intermediateStorage: intermediateStorages)
+		{
+			inject(intermediateStorage.get());
+		}
+		updateFileDependencies();
+	}
+	catch (CppSQLite3Exception e)
+	{
+		errorMessage = std::to_string(e.errorCode()) + ": " + e.errorMessage();
+	}
+	catch (std::exception& e)
+	{
+		errorMessage = e.what();
+	}
+
+	if (!errorMessage.empty())
+	{
+		LOG_ERROR("Replacing file elements failed, rolling back: " + errorMessage);
+
+		// transactions of an interrupted injection are still open as well
+		while (m_sqliteIndexStorage.getTransactionDepth() > transactionDepth)
+		{
+			m_sqliteIndexStorage.rollbackTransaction();
+		}
+		applyBrowseProfile();
+		m_sqliteIndexStorage.clearTemporaryIndices();
+		m_injectedImportEdgeIds.clear();
+		m_fileDependencyIndex.clear();
+		return false;
+	}
+
+	m_sqliteIndexStorage.commitTransaction();
+	return true;
+}
+
 std::vector<FileInfo> PersistentStorage::getFileInfoForAllFiles() const
 {
 	TRACE();
@@ -430,6 +592,28 @@ std::vector<FileInfo> PersistentStorage::getFileInfoForAllFiles() const
 	return fileInfos;
 }
 
+std::map<FilePath, FileFingerprint> PersistentStorage::getFileFingerprintsForAllFiles() const
+{
+	TRACE();
+
+	return m_sqliteIndexStorage.getFileFingerprints();
+}
+
+std::map<FilePath, unsigned long long> PersistentStorage::getInterfaceHashesForAllFiles() const
+{
+	TRACE();
+
+	std::map<FilePath, unsigned long long> interfaceHashes;
+	m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
+		if (file.interfaceHash)
+		{
+			interfaceHashes.emplace(FilePath(file.filePath), file.interfaceHash);
+		}
+	});
+
+	return interfaceHashes;
+}
+
 std::set<FilePath> PersistentStorage::getIncompleteFiles() const
 {
 	TRACE();
@@ -1783,15 +1967,24 @@ std::shared_ptr<TextAccess> PersistentStorage::getFileContent(
 	return TextAccess::createFromFile(FilePath(filePath));
 }
 
-bool PersistentStorage::hasContentForFile(const FilePath& filePath) const
+std::vector<std::string> PersistentStorage::getFileContentLines(
+	const FilePath& filePath, size_t firstLineNumber, size_t lastLineNumber) const
 {
-	std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(
-		filePath.wstr());
-	if (fileContent->getLineCount() > 0)
+	// resolved through the cached file paths, the file table has no path index while reading
+	const Id fileId = getFileNodeId(filePath);
+	std::vector<std::string> lines = m_sqliteIndexStorage.getFileContentLinesById(
+		fileId, firstLineNumber, lastLineNumber);
+	if (lines.empty() && !m_sqliteIndexStorage.hasFileContent(fileId))
 	{
-		return true;
+		return TextAccess::createFromFile(filePath)->getLines(
+			static_cast<unsigned int>(firstLineNumber), static_cast<unsigned int>(lastLineNumber));
 	}
-	return false;
+	return lines;
+}
+
+bool PersistentStorage::hasContentForFile(const FilePath& filePath) const
+{
+	return m_sqliteIndexStorage.hasFileContent(getFileNodeId(filePath));
 }
 
 FileInfo PersistentStorage::getFileInfoForFileId(Id id) const
@@ -2274,11 +2467,10 @@ TooltipSnippet PersistentStorage::getTooltipSnippetForNode(const StorageNode& no
 			};
 
 			std::vector<Annotation> annotations;
-			std::vector<std::string> lines =
-				getFileContent(sigLoc->getFilePath(), false)
-					->getLines(
-						static_cast<unsigned int>(sigLoc->getLineNumber()),
-						static_cast<unsigned int>(sigLoc->getEndLocation()->getLineNumber()));
+			std::vector<std::string> lines = getFileContentLines(
+				sigLoc->getFilePath(),
+				sigLoc->getLineNumber(),
+				sigLoc->getEndLocation()->getLineNumber());
 
 			// check if signature location refers to correct locations in the code
 			// wrongly recorded signature locations of implicit template methods in C++ caused crashes
@@ -2607,6 +2799,16 @@ FilePath PersistentStorage::getFileNodePath(Id fileId) const
 	return FilePath();
 }
 
+std::set<FilePath> PersistentStorage::getFileNodePaths(const std::set<Id>& fileIds) const
+{
+	std::set<FilePath> paths;
+	for (Id fileId: fileIds)
+	{
+		paths.insert(getFileNodePath(fileId));
+	}
+	return paths;
+}
+
 bool PersistentStorage::getFileNodeComplete(Id fileId) const
 {
 	auto it = m_fileNodeComplete.find(fileId);
@@ -2664,154 +2866,13 @@ std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToIncludedFileI
 	return fileIdToIncludingFileIdMap;
 }
 
-std::unordered_map<Id, std::set<Id>> PersistentStorage::getFileIdToImportingFileIdMap() const
-{
-	std::unordered_map<Id, std::set<Id>> fileIdToImportingFileIdMap;
-	{
-		std::vector<Id> importedElementIds;
-		std::map<Id, std::set<Id>> elementIdToImportingFileIds;
-
-		m_sqliteIndexStorage.forEachOfType<StorageEdge>(
-			Edge::typeToInt(Edge::EDGE_IMPORT),
-			[&importedElementIds, &elementIdToImportingFileIds](StorageEdge&& edge) {
-				importedElementIds.push_back(edge.targetNodeId);
-				elementIdToImportingFileIds[edge.targetNodeId].insert(edge.sourceNodeId);
-			});
-
-		std::unordered_map<Id, Id> importedElementIdToFileNodeId;
-		{
-			std::vector<Id> importedSourceLocationIds;
-			std::unordered_map<Id, Id> importedSourceLocationToElementIds;
-			for (const StorageOccurrence& occurrence:
-				 m_sqliteIndexStorage.getOccurrencesForElementIds(importedElementIds))
-			{
-				importedSourceLocationIds.push_back(occurrence.sourceLocationId);
-				importedSourceLocationToElementIds[occurrence.sourceLocationId] = occurrence.elementId;
-			}
-
-			for (const StorageSourceLocation& sourceLocation:
-				 m_sqliteIndexStorage.getAllByIds<StorageSourceLocation>(importedSourceLocationIds))
-			{
-				auto it = importedSourceLocationToElementIds.find(sourceLocation.id);
-				if (it != importedSourceLocationToElementIds.end())
-				{
-					importedElementIdToFileNodeId[it->second] = sourceLocation.fileNodeId;
-				}
-			}
-		}
-
-		for (const auto& it: elementIdToImportingFileIds)
-		{
-			auto importedFileIt = importedElementIdToFileNodeId.find(it.first);
-			if (importedFileIt != importedElementIdToFileNodeId.end())
-			{
-				fileIdToImportingFileIdMap[importedFileIt->second].insert(
-					it.second.begin(), it.second.end());
-			}
-		}
-	}
-	return fileIdToImportingFileIdMap;
-}
-
-std::set<Id> PersistentStorage::getReferenced(
-	const std::set<Id>& ids, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const
+const FileDependencyIndex& PersistentStorage::getFileDependencyIndex() const
 {
-	std::unordered_map<Id, std::set<Id>> idToReferencedIdMap;
-	for (const auto& it: idToReferencingIdMap)
+	if (!m_fileDependencyIndex.isBuilt())
 	{
-		for (Id referencingId: it.second)
-		{
-			idToReferencedIdMap[referencingId].insert(it.first);
-		}
+		m_fileDependencyIndex.build(m_sqliteIndexStorage.getFileDependencies());
 	}
-
-	return getReferencing(ids, idToReferencedIdMap);
-}
-
-std::set<Id> PersistentStorage::getReferencing(
-	const std::set<Id>& ids, std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const
-{
-	std::set<Id> referencingIds;
-
-	std::set<Id> processingIds = ids;
-	std::set<Id> processedIds;
-
-	while (!processingIds.empty())
-	{
-		std::set<Id> tempIds = processingIds;
-		utility::append(processedIds, processingIds);
-		processingIds.clear();
-
-		for (Id id: tempIds)
-		{
-			utility::append(referencingIds, idToReferencingIdMap[id]);
-			for (Id referencingId: idToReferencingIdMap[id])
-			{
-				if (processedIds.find(referencingId) == processedIds.end())
-				{
-					processingIds.insert(referencingId);
-				}
-			}
-		}
-	}
-
-	return referencingIds;
-}
-
-std::set<FilePath> PersistentStorage::getReferencedByIncludes(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferenced(
-		getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
-	{	 // TODO: performance optimize: use just one request for all ids!
-		paths.insert(getFileNodePath(id));
-	}
-
-	return paths;
-}
-
-std::set<FilePath> PersistentStorage::getReferencedByImports(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferenced(
-		getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
-	{
-		paths.insert(getFileNodePath(id));
-	}
-
-	return paths;
-}
-
-std::set<FilePath> PersistentStorage::getReferencingByIncludes(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferencing(
-		getFileNodeIds(filePaths), getFileIdToIncludingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
-	{
-		paths.insert(getFileNodePath(id));
-	}
-
-	return paths;
-}
-
-std::set<FilePath> PersistentStorage::getReferencingByImports(const std::set<FilePath>& filePaths) const
-{
-	const std::set<Id> ids = getReferencing(
-		getFileNodeIds(filePaths), getFileIdToImportingFileIdMap());
-
-	std::set<FilePath> paths;
-	for (Id id: ids)
-	{
-		paths.insert(getFileNodePath(id));
-	}
-
-	return paths;
+	return m_fileDependencyIndex;
 }
 
 void PersistentStorage::addNodesToGraph(
@@ -1,9 +1,12 @@
 #ifndef PERSISTENT_STORAGE_H
 #define PERSISTENT_STORAGE_H
 
+#include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
+#include "FileDependencyIndex.h"
 #include "FullTextSearchIndex.h"
 #include "HierarchyCache.h"
 #include "SearchIndex.h"
@@ -12,6 +15,8 @@
 #include "Storage.h"
 #include "StorageAccess.h"
 
+class IntermediateStorage;
+
 class PersistentStorage
 	: public Storage
 	, public StorageAccess
@@ -27,7 +32,7 @@ public:
 	Id addEdge(const StorageEdgeData& data) override;
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) override;
 	Id addLocalSymbol(const StorageLocalSymbolData& data) override;
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) override;
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) override;
 	Id addSourceLocation(const StorageSourceLocationData& data) override;
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) override;
 	void addOccurrence(const StorageOccurrence& data) override;
@@ -37,6 +42,7 @@ public:
 	void addElementComponent(const StorageElementComponent& component) override;
 	void addElementComponents(const std::vector<StorageElementComponent>& components) override;
 	Id addError(const StorageErrorData& data) override;
+	void addIndexingCosts(const std::vector<StorageIndexingCost>& costs) override;
 
 	void removeElement(const Id id);
 	void removeElements(const std::vector<Id>& ids);
@@ -48,22 +54,37 @@ public:
 	const std::vector<StorageFile>& getStorageFiles() const override;
 	const std::vector<StorageSymbol>& getStorageSymbols() const override;
 	const std::vector<StorageEdge>& getStorageEdges() const override;
-	const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const override;
-	const std::set<StorageSourceLocation>& getStorageSourceLocations() const override;
-	const std::set<StorageOccurrence>& getStorageOccurrences() const override;
-	const std::set<StorageComponentAccess>& getComponentAccesses() const override;
-	const std::set<StorageElementComponent>& getElementComponents() const override;
+	const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const override;
+	const std::vector<StorageSourceLocation>& getStorageSourceLocations() const override;
+	const std::vector<StorageOccurrence>& getStorageOccurrences() const override;
+	const std::vector<StorageComponentAccess>& getComponentAccesses() const override;
+	const std::vector<StorageElementComponent>& getElementComponents() const override;
 	const std::vector<StorageError>& getErrors() const override;
+	const std::vector<StorageIndexingCost>& getIndexingCosts() const override;
 
 	void startInjection() override;
 	void finishInjection() override;
 	void rollbackInjection();
 
+	// keeps all following changes in a single transaction, so other connections to the same database
+	// keep reading the previous state until it gets committed. returns false if the database does
+	// not support this.
+	bool beginRefreshTransaction();
+	void commitRefreshTransaction();
+	void rollbackRefreshTransaction();
+
+	// for a database that replaces another one by renaming its file once it is written
+	void disableWriteAheadLog();
+
 	void beforeErrorRecording();
 	void afterErrorRecording();
 
 	void setMode(const SqliteIndexStorage::StorageModeType mode);
 
+	// database settings for browsing as chosen in the application settings, injection switches to
+	// the bulk indexing settings and back
+	void applyBrowseProfile();
+
 	FilePath getIndexDbFilePath() const;
 	FilePath getBookmarkDbFilePath() const;
 
@@ -72,19 +93,37 @@ public:
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
 
+	// changed headers indexed without their dependents by a refresh that did not check them yet
+	std::map<FilePath, unsigned long long> getPendingInterfaceHashes() const;
+	void setPendingInterfaceHashes(const std::map<FilePath, unsigned long long>& interfaceHashes);
+
 	void setup();
 	void updateVersion();
 	void clear();
 	void clearCaches();
 
+	// stores the file dependencies that can only be resolved once all data has been injected
+	void updateFileDependencies();
 	std::set<FilePath> getReferenced(const std::set<FilePath>& filePaths) const;
 	std::set<FilePath> getReferencing(const std::set<FilePath>& filePaths) const;
 
 	void clearAllErrors();
+	// the nodes of files in keptFileNodePaths stay, so edges of other files pointing to them are kept,
+	// as well as edges of the cleared elements that belong to other files
 	void clearFileElements(
-		const std::vector<FilePath>& filePaths, std::function<void(int)> updateStatusCallback);
+		const std::vector<FilePath>& filePaths,
+		const std::set<FilePath>& keptFileNodePaths,
+		std::function<void(int)> updateStatusCallback);
+	// clears the files and injects the new results in a single transaction, which gets rolled back
+	// if that fails, so the previous data of the files stays available
+	bool replaceFileElements(
+		const std::set<FilePath>& filePaths,
+		const std::vector<std::shared_ptr<IntermediateStorage>>& intermediateStorages);
 
 	std::vector<FileInfo> getFileInfoForAllFiles() const;
+	std::map<FilePath, FileFingerprint> getFileFingerprintsForAllFiles() const;
+	// only contains files with a recorded interface hash
+	std::map<FilePath, unsigned long long> getInterfaceHashesForAllFiles() const;
 	std::set<FilePath> getIncompleteFiles() const;
 	bool getFilePathIndexed(const FilePath& path) const;
 
@@ -157,6 +196,9 @@ public:
 		const FilePath& filePath, LocationType type) const override;
 
 	std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
+	// reads only the stored content blocks holding the lines, line numbers start with 1
+	std::vector<std::string> getFileContentLines(
+		const FilePath& filePath, size_t firstLineNumber, size_t lastLineNumber) const;
 	bool hasContentForFile(const FilePath& filePath) const;
 
 	FileInfo getFileInfoForFileId(Id id) const override;
@@ -202,37 +244,27 @@ private:
 		std::vector<StorageFile> files;
 		std::vector<StorageSymbol> symbols;
 		std::vector<StorageEdge> edges;
-		std::set<StorageLocalSymbol> locals;
-		std::set<StorageSourceLocation> locations;
-		std::set<StorageOccurrence> occurrences;
-		std::set<StorageComponentAccess> accesses;
-		std::set<StorageElementComponent> components;
+		std::vector<StorageLocalSymbol> locals;
+		std::vector<StorageSourceLocation> locations;
+		std::vector<StorageOccurrence> occurrences;
+		std::vector<StorageComponentAccess> accesses;
+		std::vector<StorageElementComponent> components;
 		std::vector<StorageError> errors;
+		std::vector<StorageIndexingCost> indexingCosts;
 	} m_storageData;
 
 	Id getFileNodeId(const FilePath& filePath) const;
 	std::vector<Id> getFileNodeIds(const std::vector<FilePath>& filePaths) const;
 	std::set<Id> getFileNodeIds(const std::set<FilePath>& filePaths) const;
 	FilePath getFileNodePath(Id fileId) const;
+	std::set<FilePath> getFileNodePaths(const std::set<Id>& fileIds) const;
 	bool getFileNodeComplete(Id fileId) const;
 	bool getFileNodeIndexed(Id fileId) const;
 	std::wstring getFileNodeLanguage(Id fileId) const;
 
 	std::unordered_map<Id, std::set<Id>> getFileIdToIncludingFileIdMap() const;
 	std::unordered_map<Id, std::set<Id>> getFileIdToIncludedFileIdMap() const;
-	std::unordered_map<Id, std::set<Id>> getFileIdToImportingFileIdMap() const;
-	std::set<Id> getReferenced(
-		const std::set<Id>& filePaths,
-		std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
-	std::set<Id> getReferencing(
-		const std::set<Id>& filePaths,
-		std::unordered_map<Id, std::set<Id>> idToReferencingIdMap) const;
-
-	std::set<FilePath> getReferencedByIncludes(const std::set<FilePath>& filePaths) const;
-	std::set<FilePath> getReferencedByImports(const std::set<FilePath>& filePaths) const;
-
-	std::set<FilePath> getReferencingByIncludes(const std::set<FilePath>& filePaths) const;
-	std::set<FilePath> getReferencingByImports(const std::set<FilePath>& filePaths) const;
+	const FileDependencyIndex& getFileDependencyIndex() const;
 
 	void addNodesToGraph(const std::vector<Id>& nodeIds, Graph* graph, bool addChildCount) const;
 	void addEdgesToGraph(const std::vector<Id>& edgeIds, Graph* graph) const;
@@ -286,6 +318,10 @@ private:
 
 	HierarchyCache m_hierarchyCache;
 
+	mutable FileDependencyIndex m_fileDependencyIndex;
+	// import edges injected since the file dependencies were last updated
+	std::vector<Id> m_injectedImportEdgeIds;
+
 	bool m_hasJavaFiles = false;
 };
 
@@ -49,13 +49,15 @@ void Storage::inject(Storage* injected)
 			auto it = injectedIdToOwnElementId.find(file.id);
 			if (it != injectedIdToOwnElementId.end())
 			{
-				addFile(StorageFile(
+				StorageFile ownFile(
 					it->second,
 					file.filePath,
 					file.languageIdentifier,
 					file.modificationTime,
 					file.indexed,
-					file.complete));
+					file.complete);
+				ownFile.interfaceHash = file.interfaceHash;
+				addFile(ownFile);
 			}
 		}
 	}
@@ -134,7 +136,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject local symbols");
 
-		const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
+		const std::vector<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
 		std::vector<Id> symbolIds = addLocalSymbols(symbols);
 
 		auto it = symbols.begin();
@@ -151,7 +153,8 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject locations");
 
-		const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
+		const std::vector<StorageSourceLocation>& oldLocations =
+			injected->getStorageSourceLocations();
 		std::vector<StorageSourceLocation> locations;
 		locations.reserve(oldLocations.size());
 
@@ -193,7 +196,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject occurrences");
 
-		const std::set<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
+		const std::vector<StorageOccurrence>& oldOccurences = injected->getStorageOccurrences();
 
 		std::vector<StorageOccurrence> occurrences;
 		occurrences.reserve(oldOccurences.size());
@@ -235,7 +238,8 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject element components");
 
-		const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
+		const std::vector<StorageElementComponent>& oldComponents =
+			injected->getElementComponents();
 		std::vector<StorageElementComponent> components;
 		components.reserve(oldComponents.size());
 
@@ -254,7 +258,7 @@ void Storage::inject(Storage* injected)
 	{
 		// TRACE("inject accesses");
 
-		const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
+		const std::vector<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
 		std::vector<StorageComponentAccess> accesses;
 		accesses.reserve(oldAccesses.size());
 
@@ -270,6 +274,8 @@ void Storage::inject(Storage* injected)
 		addComponentAccesses(accesses);
 	}
 
+	addIndexingCosts(injected->getIndexingCosts());
+
 	finishInjection();
 }
 
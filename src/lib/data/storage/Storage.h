@@ -3,14 +3,15 @@
 
 #include <functional>
 #include <mutex>
-#include <set>
 #include <string>
+#include <vector>
 
 #include "StorageComponentAccess.h"
 #include "StorageEdge.h"
 #include "StorageElementComponent.h"
 #include "StorageError.h"
 #include "StorageFile.h"
+#include "StorageIndexingCost.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
@@ -32,7 +33,7 @@ public:
 	virtual Id addEdge(const StorageEdgeData& data) = 0;
 	virtual std::vector<Id> addEdges(const std::vector<StorageEdge>& edges) = 0;
 	virtual Id addLocalSymbol(const StorageLocalSymbolData& data) = 0;
-	virtual std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols) = 0;
+	virtual std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols) = 0;
 	virtual Id addSourceLocation(const StorageSourceLocationData& data) = 0;
 	virtual std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations) = 0;
 	virtual void addOccurrence(const StorageOccurrence& data) = 0;
@@ -42,17 +43,21 @@ public:
 	virtual void addElementComponent(const StorageElementComponent& component) = 0;
 	virtual void addElementComponents(const std::vector<StorageElementComponent>& components) = 0;
 	virtual Id addError(const StorageErrorData& data) = 0;
+	virtual void addIndexingCosts(const std::vector<StorageIndexingCost>& costs) = 0;
 
 	virtual const std::vector<StorageNode>& getStorageNodes() const = 0;
 	virtual const std::vector<StorageFile>& getStorageFiles() const = 0;
 	virtual const std::vector<StorageSymbol>& getStorageSymbols() const = 0;
 	virtual const std::vector<StorageEdge>& getStorageEdges() const = 0;
-	virtual const std::set<StorageLocalSymbol>& getStorageLocalSymbols() const = 0;
-	virtual const std::set<StorageSourceLocation>& getStorageSourceLocations() const = 0;
-	virtual const std::set<StorageOccurrence>& getStorageOccurrences() const = 0;
-	virtual const std::set<StorageComponentAccess>& getComponentAccesses() const = 0;
-	virtual const std::set<StorageElementComponent>& getElementComponents() const = 0;
+
+	// the following are sorted and free of duplicates according to the operator< of their elements
+	virtual const std::vector<StorageLocalSymbol>& getStorageLocalSymbols() const = 0;
+	virtual const std::vector<StorageSourceLocation>& getStorageSourceLocations() const = 0;
+	virtual const std::vector<StorageOccurrence>& getStorageOccurrences() const = 0;
+	virtual const std::vector<StorageComponentAccess>& getComponentAccesses() const = 0;
+	virtual const std::vector<StorageElementComponent>& getElementComponents() const = 0;
 	virtual const std::vector<StorageError>& getErrors() const = 0;
+	virtual const std::vector<StorageIndexingCost>& getIndexingCosts() const = 0;
 
 	void inject(Storage* injected);
 
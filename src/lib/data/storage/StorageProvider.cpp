@@ -1,63 +1,143 @@
 #include "StorageProvider.h"
 
+#include <iterator>
+#include <string>
+
 #include "logging.h"
 
+const size_t StorageProvider::s_injectionBatchSourceLocationCount = 250000;
+
+StorageProvider::StorageProvider(size_t byteBudget): m_byteSize(0), m_byteBudget(byteBudget) {}
+
 int StorageProvider::getStorageCount() const
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
 	return static_cast<int>(m_storages.size());
 }
 
-void StorageProvider::clear()
+size_t StorageProvider::getByteSize() const
 {
 	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	return m_storages.clear();
+	return m_byteSize;
+}
+
+size_t StorageProvider::getByteBudget() const
+{
+	return m_byteBudget;
+}
+
+bool StorageProvider::isOverBudget() const
+{
+	std::lock_guard<std::mutex> lock(m_storagesMutex);
+	return m_byteBudget && m_byteSize >= m_byteBudget;
+}
+
+void StorageProvider::waitForByteSizeBelowBudget(size_t timeoutMS) const
+{
+	std::unique_lock<std::mutex> lock(m_storagesMutex);
+	m_storagesCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&]() {
+		return !m_byteBudget || m_byteSize < m_byteBudget;
+	});
+}
+
+void StorageProvider::waitForStorageCountAbove(int count, size_t timeoutMS) const
+{
+	std::unique_lock<std::mutex> lock(m_storagesMutex);
+	m_storagesCondition.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&]() {
+		return static_cast<int>(m_storages.size()) > count;
+	});
+}
+
+void StorageProvider::clear()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		m_storages.clear();
+		m_byteSize = 0;
+	}
+	m_storagesCondition.notify_all();
 }
 
 void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage)
 {
+	if (!storage)
+	{
+		return;
+	}
+
 	const std::size_t storageSize = storage->getSourceLocationCount();
-	std::list<std::shared_ptr<IntermediateStorage>>::iterator it;
+	const std::size_t byteSize = storage->getByteSize(sizeof(std::wstring));
+	std::list<StoredStorage>::iterator it;
 
-	std::lock_guard<std::mutex> lock(m_storagesMutex);
-	for (it = m_storages.begin(); it != m_storages.end(); it++)
 	{
-		if ((*it)->getSourceLocationCount() < storageSize)
+		std::lock_guard<std::mutex> lock(m_storagesMutex);
+		for (it = m_storages.begin(); it != m_storages.end(); it++)
 		{
-			break;
+			if (it->storage->getSourceLocationCount() < storageSize)
+			{
+				break;
+			}
 		}
+		m_storages.insert(it, {storage, byteSize});
+		m_byteSize += byteSize;
 	}
-	m_storages.insert(it, storage);
+	m_storagesCondition.notify_all();
 }
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeSecondLargestStorage()
+std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>>
+	StorageProvider::consumeStoragesToMerge()
 {
-	std::shared_ptr<IntermediateStorage> ret;
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>> ret;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
-		if (m_storages.size() > 1)
+		if (m_storages.size() > 2)
 		{
-			std::list<std::shared_ptr<IntermediateStorage>>::iterator it = m_storages.begin();
-			it++;
-			ret = *it;
-			m_storages.erase(it);
+			std::list<StoredStorage>::iterator smallest = std::prev(m_storages.end());
+			std::list<StoredStorage>::iterator secondSmallest = std::prev(smallest);
+
+			if (smallest->storage->getSourceLocationCount() +
+					secondSmallest->storage->getSourceLocationCount() <=
+				s_injectionBatchSourceLocationCount)
+			{
+				// not accounted while merging, this stays below the size of one injection batch
+				ret = std::make_pair(secondSmallest->storage, smallest->storage);
+				m_byteSize -= smallest->byteSize + secondSmallest->byteSize;
+				m_storages.erase(secondSmallest, m_storages.end());
+			}
 		}
 	}
+
+	if (ret.first)
+	{
+		m_storagesCondition.notify_all();
+	}
 	return ret;
 }
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeLargestStorage()
+std::shared_ptr<IntermediateStorage> StorageProvider::consumeStorageToInject(bool flush)
 {
 	std::shared_ptr<IntermediateStorage> ret;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
-		if (!m_storages.empty())
+
+		// injecting is the only way to free memory, so it is preferred once most of the budget is used
+		const bool mostOfBudgetUsed = m_byteBudget && m_byteSize * 4 >= m_byteBudget * 3;
+
+		if (!m_storages.empty() &&
+			(flush || mostOfBudgetUsed ||
+			 m_storages.front().storage->getSourceLocationCount() * 2 >=
+				 s_injectionBatchSourceLocationCount))
 		{
-			ret = m_storages.front();
+			ret = m_storages.front().storage;
+			m_byteSize -= m_storages.front().byteSize;
 			m_storages.pop_front();
 		}
 	}
 
+	if (ret)
+	{
+		m_storagesCondition.notify_all();
+	}
 	return ret;
 }
 
@@ -66,10 +146,11 @@ void StorageProvider::logCurrentState() const
 	std::string logString = "Storages waiting for injection:";
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
-		for (const std::shared_ptr<IntermediateStorage>& storage: m_storages)
+		for (const StoredStorage& storedStorage: m_storages)
 		{
-			logString += " " + std::to_string(storage->getSourceLocationCount()) + ";";
+			logString += " " + std::to_string(storedStorage.storage->getSourceLocationCount()) + ";";
 		}
+		logString += " total bytes: " + std::to_string(m_byteSize);
 	}
 	LOG_INFO(logString);
 }
@@ -2,30 +2,62 @@
 #define STORAGE_PROVIDER_H
 
 #include "IntermediateStorage.h"
+#include <condition_variable>
 #include <list>
 #include <memory>
 #include <mutex>
 
+// Collects the indexing results until they get merged and injected. Storages are merged smallest
+// first, so merging forms a balanced tree, and they are injected once they reached a size that
+// amortizes the cost of a database transaction. The bytes taken by the collected storages are
+// tracked against a budget, once it is mostly used up storages get injected right away.
 class StorageProvider
 {
 public:
+	static const size_t s_injectionBatchSourceLocationCount;
+
+	// 0 means no budget
+	StorageProvider(size_t byteBudget = 0);
+
 	int getStorageCount() const;
 
+	size_t getByteSize() const;
+	size_t getByteBudget() const;
+	bool isOverBudget() const;
+
+	// blocks until the storages take less bytes than the budget
+	void waitForByteSizeBelowBudget(size_t timeoutMS) const;
+
+	// blocks until more than the given amount of storages is available
+	void waitForStorageCountAbove(int count, size_t timeoutMS) const;
+
 	void clear();
 
 	void insert(std::shared_ptr<IntermediateStorage> storage);
 
-	// returns empty shared_ptr if no storages available
-	std::shared_ptr<IntermediateStorage> consumeSecondLargestStorage();
+	// returns the two smallest storages, larger one first, if merging them stays within the
+	// injection batch size, the largest storage is never returned so it stays available for injection
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>>
+		consumeStoragesToMerge();
 
-	// returns empty shared_ptr if no storages available
-	std::shared_ptr<IntermediateStorage> consumeLargestStorage();
+	// returns the largest storage once it holds at least half of the injection batch size, most of
+	// the byte budget is used or flush is set, returns empty shared_ptr otherwise
+	std::shared_ptr<IntermediateStorage> consumeStorageToInject(bool flush);
 
 	void logCurrentState() const;
 
 private:
-	std::list<std::shared_ptr<IntermediateStorage>> m_storages;	   // larger storages are in front
+	struct StoredStorage
+	{
+		std::shared_ptr<IntermediateStorage> storage;
+		size_t byteSize;
+	};
+
+	std::list<StoredStorage> m_storages;	// larger storages are in front
+	size_t m_byteSize;
+	const size_t m_byteBudget;
 	mutable std::mutex m_storagesMutex;
+	mutable std::condition_variable m_storagesCondition;
 };
 
 #endif	  // STORAGE_PROVIDER_H
@@ -1,8 +1,14 @@
 #include "SqliteIndexStorage.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <sstream>
 #include <unordered_map>
 
+#include <QByteArray>
+
+#include "DefinitionKind.h"
+#include "Edge.h"
 #include "FileSystem.h"
 #include "LocationType.h"
 #include "SourceLocationCollection.h"
@@ -11,10 +17,27 @@
 #include "logging.h"
 #include "utilityString.h"
 
-const size_t SqliteIndexStorage::s_storageVersion = 25;
+const size_t SqliteIndexStorage::s_storageVersion = 30;
 
 namespace
 {
+// uncompressed size after which a block of file content lines is closed, longer lines get a block
+// of their own
+const size_t s_fileContentBlockSize = 16 * 1024;
+
+std::string decompressFileContentBlock(CppSQLite3Query& q, int field)
+{
+	int size = 0;
+	const unsigned char* data = q.getBlobField(field, size);
+	if (!data || size <= 0)
+	{
+		return "";
+	}
+
+	const QByteArray text = qUncompress(data, size);
+	return std::string(text.constData(), static_cast<size_t>(text.size()));
+}
+
 std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& name)
 {
 	size_t pos = name.find_last_of(L'<');
@@ -25,6 +48,24 @@ std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& n
 
 	return std::make_pair(name.substr(0, pos), name.substr(pos + 1, name.size() - pos - 2));
 }
+
+// interface hashes are stored as hex strings like the content hashes, an empty string means unknown
+std::string interfaceHashToString(unsigned long long interfaceHash)
+{
+	if (!interfaceHash)
+	{
+		return "";
+	}
+
+	char buffer[17];
+	std::snprintf(buffer, sizeof(buffer), "%016llx", interfaceHash);
+	return buffer;
+}
+
+unsigned long long interfaceHashFromString(const std::string& interfaceHash)
+{
+	return FileFingerprint::fromStored(0, interfaceHash).getHash();
+}
 }	 // namespace
 
 size_t SqliteIndexStorage::getStorageVersion()
@@ -44,12 +85,7 @@ size_t SqliteIndexStorage::getStaticVersion() const
 
 void SqliteIndexStorage::setMode(const StorageModeType mode)
 {
-	m_tempNodeNameIndex.clear();
-	m_tempWNodeNameIndex.clear();
-	m_tempNodeTypes.clear();
-	m_tempEdgeIndex.clear();
-	m_tempLocalSymbolIndex.clear();
-	m_tempSourceLocationIndices.clear();
+	clearTemporaryIndices();
 
 	std::vector<std::pair<int, SqliteDatabaseIndex>> indices = getIndices();
 	for (size_t i = 0; i < indices.size(); i++)
@@ -63,6 +99,27 @@ void SqliteIndexStorage::setMode(const StorageModeType mode)
 			indices[i].second.removeFromDatabase(m_database);
 		}
 	}
+
+	// the checks take a lookup of each referenced row for every inserted one, while all rows
+	// written into an empty database reference rows that were written before
+	if (mode == STORAGE_MODE_BULK_WRITE)
+	{
+		executeStatement("PRAGMA foreign_keys=OFF;");
+	}
+	else
+	{
+		executeStatement("PRAGMA foreign_keys=ON;");
+	}
+}
+
+void SqliteIndexStorage::clearTemporaryIndices()
+{
+	m_tempNodeNameIndex.clear();
+	m_tempWNodeNameIndex.clear();
+	m_tempNodeTypes.clear();
+	m_tempEdgeIndex.clear();
+	m_tempLocalSymbolIndex.clear();
+	m_tempSourceLocationIndices.clear();
 }
 
 std::string SqliteIndexStorage::getProjectSettingsText() const
@@ -75,6 +132,37 @@ void SqliteIndexStorage::setProjectSettingsText(std::string text)
 	insertOrUpdateMetaValue("project_settings", text);
 }
 
+std::map<FilePath, unsigned long long> SqliteIndexStorage::getPendingInterfaceHashes() const
+{
+	// one line per header, holding the hash and the path
+	std::map<FilePath, unsigned long long> interfaceHashes;
+	std::istringstream stream(getMetaValue("pending_interface_hashes"));
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		const size_t pos = line.find(' ');
+		if (pos != std::string::npos && pos + 1 < line.size())
+		{
+			interfaceHashes.emplace(
+				FilePath(utility::decodeFromUtf8(line.substr(pos + 1))),
+				interfaceHashFromString(line.substr(0, pos)));
+		}
+	}
+	return interfaceHashes;
+}
+
+void SqliteIndexStorage::setPendingInterfaceHashes(
+	const std::map<FilePath, unsigned long long>& interfaceHashes)
+{
+	std::string text;
+	for (const auto& p: interfaceHashes)
+	{
+		text += interfaceHashToString(p.second) + " " + utility::encodeToUtf8(p.first.wstr()) +
+			"\n";
+	}
+	insertOrUpdateMetaValue("pending_interface_hashes", text);
+}
+
 Id SqliteIndexStorage::addNode(const StorageNodeData& data)
 {
 	std::vector<Id> ids = addNodes({StorageNode(0, data)});
@@ -102,6 +190,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 
 	std::vector<Id> nodeIds(nodes.size(), 0);
 	std::vector<StorageNode> nodesToInsert;
+	const Id firstNewId = getNextElementId();
 	for (size_t i = 0; i < nodes.size(); i++)
 	{
 		const StorageNodeData& data = nodes[i];
@@ -130,8 +219,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 			}
 			else
 			{
-				executeStatement(m_insertElementStmt);
-				const Id id = static_cast<Id>(m_database.lastRowId());
+				const Id id = firstNewId + nodesToInsert.size();
 
 				nodesToInsert.emplace_back(id, data);
 				nodeIds[i] = id;
@@ -151,6 +239,7 @@ std::vector<Id> SqliteIndexStorage::addNodes(const std::vector<StorageNode>& nod
 
 	if (nodesToInsert.size())
 	{
+		addElements(firstNewId, nodesToInsert.size());
 		m_insertNodeBatchStatement.execute(nodesToInsert, this);
 	}
 
@@ -183,10 +272,12 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 	}
 
 	std::shared_ptr<TextAccess> content;
+	FileFingerprint fingerprint;
 	int lineCount = 0;
 	if (data.indexed)
 	{
 		content = TextAccess::createFromFile(filePath);
+		fingerprint = FileFingerprint::fromFile(filePath);
 		lineCount = content->getLineCount();
 	}
 
@@ -199,14 +290,15 @@ bool SqliteIndexStorage::addFile(const StorageFile& data)
 		m_insertFileStmt.bind(5, data.indexed);
 		m_insertFileStmt.bind(6, data.complete);
 		m_insertFileStmt.bind(7, lineCount);
+		m_insertFileStmt.bindInt64(8, sqlite_int64(fingerprint.getSize()));
+		m_insertFileStmt.bind(9, fingerprint.getHashString().c_str());
+		m_insertFileStmt.bind(10, interfaceHashToString(data.interfaceHash).c_str());
 		success = executeStatement(m_insertFileStmt);
 	}
 
 	if (success && content)
 	{
-		m_insertFileContentStmt.bind(1, int(data.id));
-		m_insertFileContentStmt.bind(2, content->getText().c_str());
-		success = executeStatement(m_insertFileContentStmt);
+		success = addFileContent(data.id, content->getAllLines());
 	}
 
 	return success;
@@ -231,6 +323,7 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 
 	std::vector<Id> edgeIds(edges.size(), 0);
 	std::vector<StorageEdge> edgesToInsert;
+	const Id firstNewId = getNextElementId();
 	for (size_t i = 0; i < edges.size(); i++)
 	{
 		const StorageEdge& data = edges[i];
@@ -241,8 +334,7 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 		}
 		else
 		{
-			executeStatement(m_insertElementStmt);
-			const Id id = static_cast<Id>(m_database.lastRowId());
+			const Id id = firstNewId + edgesToInsert.size();
 
 			edgeIds[i] = id;
 			edgesToInsert.emplace_back(id, data);
@@ -253,7 +345,23 @@ std::vector<Id> SqliteIndexStorage::addEdges(const std::vector<StorageEdge>& edg
 
 	if (edgesToInsert.size())
 	{
+		addElements(firstNewId, edgesToInsert.size());
 		m_insertEdgeBatchStatement.execute(edgesToInsert, this);
+
+		// include edges connect two file nodes, so they can be stored as file dependencies right away
+		std::vector<StorageEdge> includeEdges;
+		for (const StorageEdge& edge: edgesToInsert)
+		{
+			if (edge.type == Edge::typeToInt(Edge::EDGE_INCLUDE))
+			{
+				includeEdges.push_back(edge);
+			}
+		}
+
+		if (includeEdges.size())
+		{
+			m_insertFileDependencyBatchStatement.execute(includeEdges, this);
+		}
 	}
 
 	return edgeIds;
@@ -265,7 +373,7 @@ Id SqliteIndexStorage::addLocalSymbol(const StorageLocalSymbolData& data)
 	return ids.size() ? ids[0] : 0;
 }
 
-std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalSymbol>& symbols)
+std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols)
 {
 	if (m_tempLocalSymbolIndex.empty())
 	{
@@ -281,6 +389,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 	std::vector<Id> symbolIds(symbols.size(), 0);
 	std::vector<StorageLocalSymbol> symbolsToInsert;
+	const Id firstNewId = getNextElementId();
 	auto it = symbols.begin();
 	for (size_t i = 0; i < symbols.size(); i++)
 	{
@@ -301,8 +410,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 		if (!symbolIds[i])
 		{
-			executeStatement(m_insertElementStmt);
-			const Id id = static_cast<Id>(m_database.lastRowId());
+			const Id id = firstNewId + symbolsToInsert.size();
 
 			symbolIds[i] = id;
 			symbolsToInsert.emplace_back(id, data);
@@ -317,6 +425,7 @@ std::vector<Id> SqliteIndexStorage::addLocalSymbols(const std::set<StorageLocalS
 
 	if (symbolsToInsert.size())
 	{
+		addElements(firstNewId, symbolsToInsert.size());
 		m_insertLocalSymbolBatchStatement.execute(symbolsToInsert, this);
 	}
 
@@ -370,7 +479,6 @@ std::vector<Id> SqliteIndexStorage::addSourceLocations(const std::vector<Storage
 		}
 		else
 		{
-			executeStatement(m_insertElementStmt);
 			Id id = lastRowId + 1 + locationsToInsert.size();
 
 			locationIds[i] = id;
@@ -382,6 +490,8 @@ std::vector<Id> SqliteIndexStorage::addSourceLocations(const std::vector<Storage
 
 	if (locationsToInsert.size())
 	{
+		// locations take up element ids as well, even though they are numbered on their own
+		addElements(getNextElementId(), locationsToInsert.size());
 		m_insertSourceLocationBatchStatement.execute(locationsToInsert, this);
 	}
 
@@ -463,6 +573,19 @@ StorageError SqliteIndexStorage::addError(const StorageErrorData& data)
 	return StorageError(id, data);
 }
 
+void SqliteIndexStorage::addIndexingCosts(const std::vector<StorageIndexingCost>& costs)
+{
+	for (const StorageIndexingCost& cost: costs)
+	{
+		m_insertIndexingCostStmt.bind(1, utility::encodeToUtf8(cost.filePath).c_str());
+		m_insertIndexingCostStmt.bind(2, int(cost.indexingTimeMS));
+		m_insertIndexingCostStmt.bind(3, int(cost.peakMemoryKB));
+		m_insertIndexingCostStmt.bind(4, int(cost.resultSizeKB));
+		executeStatement(m_insertIndexingCostStmt);
+		m_insertIndexingCostStmt.reset();
+	}
+}
+
 void SqliteIndexStorage::removeElement(Id id)
 {
 	std::vector<Id> ids;
@@ -476,6 +599,14 @@ void SqliteIndexStorage::removeElements(const std::vector<Id>& ids)
 		"DELETE FROM element WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ");");
 }
 
+void SqliteIndexStorage::removeFilesKeepingNodes(const std::vector<Id>& fileIds)
+{
+	// the file nodes stay, so edges of other files pointing to them are kept as well
+	const std::string ids = utility::join(utility::toStrings(fileIds), ',');
+	executeStatement("DELETE FROM file_dependency WHERE source_file_id IN (" + ids + ");");
+	executeStatement("DELETE FROM file WHERE id IN (" + ids + ");");
+}
+
 void SqliteIndexStorage::removeOccurrence(const StorageOccurrence& occurrence)
 {
 	executeStatement(
@@ -499,144 +630,175 @@ void SqliteIndexStorage::removeElementsWithoutOccurrences(const std::vector<Id>&
 }
 
 void SqliteIndexStorage::removeElementsWithLocationInFiles(
-	const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback)
-{
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(1);
-	}
+	const std::vector<Id>& fileIds,
+	bool keepEdgesOfOtherFiles,
+	std::function<void(int)> updateStatusCallback)
+{
+	// each statement starts at the rows of the cleared files and follows the indices of the clear
+	// mode, so the cost depends on the amount of cleared data instead of the size of the database
+	const auto updateStatus = [&updateStatusCallback](int progress) {
+		if (updateStatusCallback != nullptr)
+		{
+			updateStatusCallback(progress);
+		}
+	};
 
-	// preparing
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(2);
-	}
+	updateStatus(1);
 
+	// preparing
+	executeStatement("DROP TABLE IF EXISTS temp.file_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 	executeStatement(
-		"CREATE TABLE IF NOT EXISTS element_id_to_clear("
+		"CREATE TEMP TABLE file_id_to_clear("
+		"id INTEGER NOT NULL, "
+		"PRIMARY KEY(id));");
+	executeStatement(
+		"CREATE TEMP TABLE element_id_to_clear("
 		"id INTEGER NOT NULL, "
 		"PRIMARY KEY(id));");
 
-	if (updateStatusCallback != nullptr)
+	try
+	{
+		CachedStatement statement(
+			this, "INSERT OR IGNORE INTO temp.file_id_to_clear(id) VALUES (?);");
+		for (Id fileId: fileIds)
+		{
+			statement.get().bind(1, int(fileId));
+			executeStatement(statement.get());
+		}
+	}
+	catch (CppSQLite3Exception e)
 	{
-		updateStatusCallback(3);
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
 
 	// store ids of all elements located in fileIds into element_id_to_clear
 	executeStatement(
-		"INSERT INTO element_id_to_clear "
-		"	SELECT occurrence.element_id "
-		"	FROM occurrence "
-		"	INNER JOIN source_location ON ("
+		"INSERT INTO temp.element_id_to_clear "
+		"	SELECT DISTINCT occurrence.element_id "
+		"	FROM source_location "
+		"	INNER JOIN occurrence ON ("
 		"		occurrence.source_location_id = source_location.id"
 		"	) "
-		"	WHERE source_location.file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') +
-		")"
-		"	GROUP BY (occurrence.element_id)");
+		"	WHERE source_location.file_node_id IN (SELECT id FROM temp.file_id_to_clear);");
 
-	if (updateStatusCallback != nullptr)
+	updateStatus(5);
+
+	const std::string occurrenceInOtherFile =
+		"	SELECT * FROM occurrence INNER JOIN source_location ON ("
+		"		occurrence.source_location_id = source_location.id"
+		"	) "
+		"	WHERE source_location.file_node_id NOT IN (SELECT id FROM temp.file_id_to_clear)";
+
+	// edges located in other files and edges without location that point to elements of other files
+	// (e.g. members that are defined somewhere else) are optionally kept
+	std::string keptEdgeCondition;
+	std::string keptOutgoingEdgeCondition;
+	if (keepEdgesOfOtherFiles)
 	{
-		updateStatusCallback(4);
+		keptEdgeCondition = " AND NOT EXISTS (" + occurrenceInOtherFile +
+			" AND occurrence.element_id = element.id)";
+		keptOutgoingEdgeCondition = " AND NOT EXISTS (" + occurrenceInOtherFile +
+			" AND occurrence.element_id = edge.id) "
+			"AND (EXISTS (SELECT * FROM occurrence WHERE occurrence.element_id = edge.id) "
+			"OR NOT EXISTS (" +
+			occurrenceInOtherFile + " AND occurrence.element_id = edge.target_node_id))";
 	}
 
 	// delete all edges in element_id_to_clear
 	executeStatement(
 		"DELETE FROM element WHERE element.id IN "
-		"	(SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN edge ON "
-		"(element_id_to_clear.id = edge.id))");
+		"	(SELECT id FROM temp.element_id_to_clear WHERE EXISTS "
+		"(SELECT * FROM edge WHERE edge.id = element_id_to_clear.id))" +
+		keptEdgeCondition);
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(30);
-	}
+	updateStatus(15);
 
 	// delete all edges originating from element_id_to_clear
 	executeStatement(
-		"DELETE FROM element WHERE element.id IN (SELECT id FROM edge WHERE source_node_id IN "
-		"(SELECT id FROM element_id_to_clear))");
+		"DELETE FROM element WHERE element.id IN (SELECT edge.id FROM edge WHERE "
+		"edge.source_node_id IN (SELECT id FROM temp.element_id_to_clear)" +
+		keptOutgoingEdgeCondition + ")");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(31);
-	}
+	updateStatus(25);
 
-	// remove all non existing ids from element_id_to_clear (they have been cleared by now and we
-	// can disregard them)
+	// remove all non existing ids (they have been cleared by now and we can disregard them) and
+	// all files (they will be cleared later) from element_id_to_clear
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id NOT IN ("
-		"	SELECT id FROM element"
-		")");
-
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(33);
-	}
+		"DELETE FROM temp.element_id_to_clear WHERE NOT EXISTS ("
+		"	SELECT * FROM element WHERE element.id = element_id_to_clear.id"
+		") OR EXISTS ("
+		"	SELECT * FROM file WHERE file.id = element_id_to_clear.id"
+		");");
 
-	// remove all files from element_id_to_clear (they will be cleared later)
-	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT id FROM file"
-		")");
+	updateStatus(30);
 
-	if (updateStatusCallback != nullptr)
+	// delete source locations from fileIds one file at a time (this also deletes the respective
+	// occurrences)
+	try
 	{
-		updateStatusCallback(34);
+		CachedStatement statement(this, "DELETE FROM source_location WHERE file_node_id = ?;");
+		for (size_t i = 0; i < fileIds.size(); i++)
+		{
+			statement.get().bind(1, int(fileIds[i]));
+			executeStatement(statement.get());
+			updateStatus(30 + static_cast<int>(30 * (i + 1) / fileIds.size()));
+		}
 	}
-
-	// delete source locations from fileIds (this also deletes the respective occurrences)
-	executeStatement(
-		"DELETE FROM source_location WHERE file_node_id IN (" +
-		utility::join(utility::toStrings(fileIds), ',') + ");");
-
-	if (updateStatusCallback != nullptr)
+	catch (CppSQLite3Exception e)
 	{
-		updateStatusCallback(45);
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
 
-	// remove all ids from element_id_to_clear that still have occurrences
+	// remove all ids from element_id_to_clear that still have occurrences or an edge pointing to
+	// them
 	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN occurrence ON "
-		"		element_id_to_clear.id = occurrence.element_id"
-		")");
+		"DELETE FROM temp.element_id_to_clear WHERE EXISTS ("
+		"	SELECT * FROM occurrence WHERE occurrence.element_id = element_id_to_clear.id"
+		") OR EXISTS ("
+		"	SELECT * FROM edge WHERE edge.target_node_id = element_id_to_clear.id"
+		");");
 
-	if (updateStatusCallback != nullptr)
+	updateStatus(65);
+
+	// delete all elements that are still listed in element_id_to_clear, in ranges of ids
+	std::vector<Id> elementIds;
 	{
-		updateStatusCallback(59);
+		CppSQLite3Query q = executeQuery("SELECT id FROM temp.element_id_to_clear ORDER BY id;");
+		while (!q.eof())
+		{
+			elementIds.push_back(q.getIntField(0, 0));
+			q.nextRow();
+		}
 	}
 
-	// remove all ids from element_id_to_clear that still have an edge pointing to them
-	executeStatement(
-		"DELETE FROM element_id_to_clear WHERE id IN ("
-		"	SELECT target_node_id FROM edge"
-		")");
-
-	if (updateStatusCallback != nullptr)
+	try
 	{
-		updateStatusCallback(74);
+		const size_t rangeSize = 1000;
+		CachedStatement statement(
+			this,
+			"DELETE FROM element WHERE id IN ("
+			"	SELECT id FROM temp.element_id_to_clear WHERE id >= ? AND id <= ?"
+			");");
+		for (size_t i = 0; i < elementIds.size(); i += rangeSize)
+		{
+			const size_t last = std::min(i + rangeSize, elementIds.size()) - 1;
+			statement.get().bind(1, int(elementIds[i]));
+			statement.get().bind(2, int(elementIds[last]));
+			executeStatement(statement.get());
+			updateStatus(65 + static_cast<int>(30 * (last + 1) / elementIds.size()));
+		}
 	}
-
-	// delete all elements that are still listed in element_id_to_clear
-	executeStatement(
-		"DELETE FROM element WHERE EXISTS ("
-		"	SELECT * FROM element_id_to_clear WHERE element.id = element_id_to_clear.id"
-		")");
-
-	if (updateStatusCallback != nullptr)
+	catch (CppSQLite3Exception e)
 	{
-		updateStatusCallback(87);
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
 	}
 
 	// cleaning up
-	executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
+	executeStatement("DROP TABLE IF EXISTS temp.file_id_to_clear;");
 
-	if (updateStatusCallback != nullptr)
-	{
-		updateStatusCallback(89);
-	}
+	updateStatus(95);
 }
 
 void SqliteIndexStorage::removeAllErrors()
@@ -667,8 +829,7 @@ bool SqliteIndexStorage::isFile(Id elementId) const
 
 StorageEdge SqliteIndexStorage::getEdgeById(Id edgeId) const
 {
-	std::vector<StorageEdge> candidates = doGetAll<StorageEdge>(
-		"WHERE id = " + std::to_string(edgeId));
+	std::vector<StorageEdge> candidates = doGetAll<StorageEdge>("WHERE id = ?", {edgeId});
 
 	if (candidates.size() > 0)
 	{
@@ -681,88 +842,75 @@ StorageEdge SqliteIndexStorage::getEdgeById(Id edgeId) const
 StorageEdge SqliteIndexStorage::getEdgeBySourceTargetType(Id sourceId, Id targetId, int type) const
 {
 	return doGetFirst<StorageEdge>(
-		"WHERE "
-		"source_node_id == " +
-		std::to_string(sourceId) +
-		" AND "
-		"target_node_id == " +
-		std::to_string(targetId) +
-		" AND "
-		"type == " +
-		std::to_string(type));
+		"WHERE source_node_id == ? AND target_node_id == ? AND type == ?",
+		{sourceId, targetId, type});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceId(Id sourceId) const
 {
-	return doGetAll<StorageEdge>("WHERE source_node_id == " + std::to_string(sourceId));
+	return doGetAll<StorageEdge>("WHERE source_node_id == ?", {sourceId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceIds(const std::vector<Id>& sourceIds) const
 {
+	BoundIdList idList(this, sourceIds);
 	return doGetAll<StorageEdge>(
-		"WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') + ")");
+		"WHERE source_node_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetId(Id targetId) const
 {
-	return doGetAll<StorageEdge>("WHERE target_node_id == " + std::to_string(targetId));
+	return doGetAll<StorageEdge>("WHERE target_node_id == ?", {targetId});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetIds(const std::vector<Id>& targetIds) const
 {
+	BoundIdList idList(this, targetIds);
 	return doGetAll<StorageEdge>(
-		"WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') + ")");
+		"WHERE target_node_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceOrTargetId(Id id) const
 {
-	return doGetAll<StorageEdge>(
-		"WHERE source_node_id == " + std::to_string(id) +
-		" OR target_node_id == " + std::to_string(id));
+	return doGetAll<StorageEdge>("WHERE source_node_id == ? OR target_node_id == ?", {id, id});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByType(int type) const
 {
-	return doGetAll<StorageEdge>("WHERE type == " + std::to_string(type));
+	return doGetAll<StorageEdge>("WHERE type == ?", {type});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourceType(Id sourceId, int type) const
 {
-	return doGetAll<StorageEdge>(
-		"WHERE source_node_id == " + std::to_string(sourceId) +
-		" AND type == " + std::to_string(type));
+	return doGetAll<StorageEdge>("WHERE source_node_id == ? AND type == ?", {sourceId, type});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesBySourcesType(
 	const std::vector<Id>& sourceIds, int type) const
 {
+	BoundIdList idList(this, sourceIds);
 	return doGetAll<StorageEdge>(
-		"WHERE source_node_id IN (" + utility::join(utility::toStrings(sourceIds), ',') +
-		")"
-		" AND type == " +
-		std::to_string(type));
+		"WHERE source_node_id IN (" + idList.getSql() + ") AND type == ?",
+		idList.getParameters({type}));
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetType(Id targetId, int type) const
 {
-	return doGetAll<StorageEdge>(
-		"WHERE target_node_id == " + std::to_string(targetId) +
-		" AND type == " + std::to_string(type));
+	return doGetAll<StorageEdge>("WHERE target_node_id == ? AND type == ?", {targetId, type});
 }
 
 std::vector<StorageEdge> SqliteIndexStorage::getEdgesByTargetsType(
 	const std::vector<Id>& targetIds, int type) const
 {
+	BoundIdList idList(this, targetIds);
 	return doGetAll<StorageEdge>(
-		"WHERE target_node_id IN (" + utility::join(utility::toStrings(targetIds), ',') +
-		")"
-		" AND type == " +
-		std::to_string(type));
+		"WHERE target_node_id IN (" + idList.getSql() + ") AND type == ?",
+		idList.getParameters({type}));
 }
 
 StorageNode SqliteIndexStorage::getNodeById(Id id) const
 {
-	std::vector<StorageNode> candidates = doGetAll<StorageNode>("WHERE id = " + std::to_string(id));
+	std::vector<StorageNode> candidates = doGetAll<StorageNode>("WHERE id = ?", {id});
 
 	if (candidates.size() > 0)
 	{
@@ -839,42 +987,86 @@ std::vector<int> SqliteIndexStorage::getAvailableEdgeTypes() const
 
 StorageFile SqliteIndexStorage::getFileByPath(const std::wstring& filePath) const
 {
-	return doGetFirst<StorageFile>("WHERE file.path == '" + utility::encodeToUtf8(filePath) + "'");
+	return doGetFirst<StorageFile>("WHERE file.path == ?", {utility::encodeToUtf8(filePath)});
 }
 
 std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<FilePath>& filePaths) const
 {
-	return doGetAll<StorageFile>(
-		"WHERE file.path IN ('" + utility::join(utility::toStrings(filePaths), "', '") + "')");
+	std::vector<std::string> paths;
+	for (const FilePath& filePath: filePaths)
+	{
+		paths.push_back(utility::encodeToUtf8(filePath.wstr()));
+	}
+	std::sort(paths.begin(), paths.end());
+	paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+	// bound in parts like short id lists, the placeholder count is rounded up to a power of two so
+	// only few query texts exist
+	const size_t maxBoundPathCount = 256;
+
+	std::vector<StorageFile> files;
+	for (size_t i = 0; i < paths.size(); i += maxBoundPathCount)
+	{
+		const size_t pathCount = std::min(maxBoundPathCount, paths.size() - i);
+		size_t placeholderCount = 1;
+		while (placeholderCount < pathCount)
+		{
+			placeholderCount *= 2;
+		}
+
+		std::string placeholders = "?";
+		QueryParameters parameters;
+		for (size_t j = 0; j < placeholderCount; j++)
+		{
+			if (j > 0)
+			{
+				placeholders += ",?";
+			}
+			parameters.emplace_back(paths[i + std::min(j, pathCount - 1)]);
+		}
+
+		utility::append(
+			files, doGetAll<StorageFile>("WHERE file.path IN (" + placeholders + ")", parameters));
+	}
+	return files;
 }
 
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const
 {
 	CppSQLite3Query q = executeQuery(
-		"SELECT content FROM filecontent WHERE id = '" + std::to_string(fileId) + "';");
-	if (!q.eof())
+		"SELECT content FROM filecontent WHERE id = " + std::to_string(fileId) +
+		" ORDER BY first_line;");
+
+	std::string text;
+	while (!q.eof())
 	{
-		return TextAccess::createFromString(q.getStringField(0, ""));
+		text += decompressFileContentBlock(q, 0);
+		q.nextRow();
 	}
 
-	return TextAccess::createFromString("");
+	return TextAccess::createFromString(text);
 }
 
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::wstring& filePath) const
 {
 	try
 	{
-		CppSQLite3Query q = executeQuery(
+		CppSQLite3Statement stmt = m_database.compileStatement(
 			"SELECT filecontent.content "
 			"FROM filecontent "
 			"INNER JOIN file ON filecontent.id = file.id "
-			"WHERE file.path = '" +
-			utility::encodeToUtf8(filePath) + "';");
+			"WHERE file.path = ? "
+			"ORDER BY filecontent.first_line;");
+		stmt.bind(1, utility::encodeToUtf8(filePath).c_str());
+		CppSQLite3Query q = executeQuery(stmt);
 
-		if (!q.eof())
+		std::string text;
+		while (!q.eof())
 		{
-			return TextAccess::createFromString(q.getStringField(0, ""));
+			text += decompressFileContentBlock(q, 0);
+			q.nextRow();
 		}
+		return TextAccess::createFromString(text);
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -884,6 +1076,145 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
 	return TextAccess::createFromString("");
 }
 
+std::vector<std::string> SqliteIndexStorage::getFileContentLinesById(
+	Id fileId, size_t firstLineNumber, size_t lastLineNumber) const
+{
+	std::vector<std::string> lines;
+	if (fileId == 0 || firstLineNumber == 0 || firstLineNumber > lastLineNumber)
+	{
+		return lines;
+	}
+
+	try
+	{
+		CachedStatement statement(
+			this,
+			"SELECT first_line, content FROM filecontent "
+			"WHERE id = ? AND first_line <= ? AND first_line + line_count > ? "
+			"ORDER BY first_line;");
+		CppSQLite3Query q = executeQuery(
+			statement.get(),
+			{static_cast<long long>(fileId),
+			 static_cast<long long>(lastLineNumber),
+			 static_cast<long long>(firstLineNumber)});
+
+		while (!q.eof())
+		{
+			size_t lineNumber = q.getIntField(0, 0);
+			std::shared_ptr<TextAccess> block = TextAccess::createFromString(
+				decompressFileContentBlock(q, 1));
+			for (const std::string& line: block->getAllLines())
+			{
+				if (lineNumber >= firstLineNumber && lineNumber <= lastLineNumber)
+				{
+					lines.push_back(line);
+				}
+				lineNumber++;
+			}
+			q.nextRow();
+		}
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		lines.clear();
+	}
+
+	if (lines.size() != lastLineNumber - firstLineNumber + 1)
+	{
+		lines.clear();
+	}
+	return lines;
+}
+
+bool SqliteIndexStorage::hasFileContent(Id fileId) const
+{
+	if (fileId == 0)
+	{
+		return false;
+	}
+
+	try
+	{
+		CachedStatement statement(
+			this, "SELECT EXISTS(SELECT 1 FROM filecontent WHERE id = ?);");
+		CppSQLite3Query q = executeQuery(statement.get(), {static_cast<long long>(fileId)});
+		return !q.eof() && q.getIntField(0, 0) != 0;
+	}
+	catch (CppSQLite3Exception& e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+
+	return false;
+}
+
+std::map<FilePath, FileFingerprint> SqliteIndexStorage::getFileFingerprints() const
+{
+	std::map<FilePath, FileFingerprint> fingerprints;
+
+	CppSQLite3Query q = executeQuery("SELECT path, content_size, content_hash FROM file;");
+	while (!q.eof())
+	{
+		const std::string filePath = q.getStringField(0, "");
+		const unsigned long long size = q.getInt64Field(1, 0);
+		const std::string hash = q.getStringField(2, "");
+
+		fingerprints.emplace(
+			FilePath(utility::decodeFromUtf8(filePath)), FileFingerprint::fromStored(size, hash));
+		q.nextRow();
+	}
+
+	return fingerprints;
+}
+
+void SqliteIndexStorage::addImportFileDependencies(const std::vector<Id>& importEdgeIds)
+{
+	if (importEdgeIds.empty())
+	{
+		return;
+	}
+
+	// the location of an imported element may be recorded after the import edge, so the files of
+	// imported elements are resolved once all data has been injected. only the name tokens of
+	// explicitly defined elements are joined, which are recorded at their definitions, while uses
+	// in other files are recorded as qualifiers or on the referencing edges
+	BoundIdList idList(this, importEdgeIds);
+	CachedStatement statement(
+		this,
+		"INSERT OR IGNORE INTO file_dependency(source_file_id, target_file_id, type) "
+		"SELECT DISTINCT edge.source_node_id, source_location.file_node_id, edge.type FROM edge "
+		"INNER JOIN symbol ON symbol.id = edge.target_node_id "
+		"INNER JOIN occurrence ON occurrence.element_id = edge.target_node_id "
+		"INNER JOIN source_location ON source_location.id = occurrence.source_location_id "
+		"WHERE edge.id IN (" + idList.getSql() + ") AND edge.type = " +
+			std::to_string(Edge::typeToInt(Edge::EDGE_IMPORT)) + " AND symbol.definition_kind = " +
+			std::to_string(definitionKindToInt(DEFINITION_EXPLICIT)) +
+			" AND source_location.type = " + std::to_string(locationTypeToInt(LOCATION_TOKEN)) +
+			" AND source_location.file_node_id != edge.source_node_id;");
+	executeQuery(statement.get(), idList.getParameters());
+}
+
+std::vector<std::pair<Id, Id>> SqliteIndexStorage::getFileDependencies() const
+{
+	std::vector<std::pair<Id, Id>> dependencies;
+
+	CppSQLite3Query q = executeQuery("SELECT source_file_id, target_file_id FROM file_dependency;");
+	while (!q.eof())
+	{
+		const Id sourceFileId = q.getIntField(0, 0);
+		const Id targetFileId = q.getIntField(1, 0);
+
+		if (sourceFileId != 0 && targetFileId != 0)
+		{
+			dependencies.emplace_back(sourceFileId, targetFileId);
+		}
+		q.nextRow();
+	}
+
+	return dependencies;
+}
+
 void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed)
 {
 	executeStatement(
@@ -891,11 +1222,18 @@ void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed)
 		" WHERE id == " + std::to_string(fileId) + ";");
 }
 
+void SqliteIndexStorage::setFileInterfaceHash(Id fileId, unsigned long long interfaceHash)
+{
+	executeStatement(
+		"UPDATE file SET interface_hash = '" + interfaceHashToString(interfaceHash) +
+		"' WHERE id == " + std::to_string(fileId) + ";");
+}
+
 void SqliteIndexStorage::setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete)
 {
 	bool fileHasErrors = doGetFirst<StorageSourceLocation>(
-							 "WHERE file_node_id == " + std::to_string(fileId) +
-							 " AND type == " + std::to_string(locationTypeToInt(LOCATION_ERROR)))
+							 "WHERE file_node_id == ? AND type == ?",
+							 {fileId, locationTypeToInt(LOCATION_ERROR)})
 							 .id;
 	if (fileHasErrors != complete)
 	{
@@ -913,7 +1251,26 @@ void SqliteIndexStorage::setNodeType(int type, Id nodeId)
 }
 
 std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFile(
-	const FilePath& filePath, const std::string& query) const
+	const FilePath& filePath) const
+{
+	return getSourceLocationsForFile(filePath, "", {});
+}
+
+std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForLinesInFile(
+	const FilePath& filePath, size_t startLine, size_t endLine) const
+{
+	return getSourceLocationsForFile(
+		filePath, "AND start_line <= ? AND end_line >= ?", {endLine, startLine});
+}
+
+std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsOfTypeInFile(
+	const FilePath& filePath, LocationType type) const
+{
+	return getSourceLocationsForFile(filePath, "AND type == ?", {locationTypeToInt(type)});
+}
+
+std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFile(
+	const FilePath& filePath, const std::string& query, const QueryParameters& parameters) const
 {
 	std::shared_ptr<SourceLocationFile> ret = std::make_shared<SourceLocationFile>(
 		filePath, L"", true, false, false);
@@ -928,8 +1285,10 @@ std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFil
 	ret->setIsComplete(file.complete);
 	ret->setIsIndexed(file.indexed);
 
+	QueryParameters fileParameters = {file.id};
+	fileParameters.insert(fileParameters.end(), parameters.begin(), parameters.end());
 	std::vector<StorageSourceLocation> sourceLocations = doGetAll<StorageSourceLocation>(
-		"WHERE file_node_id == " + std::to_string(file.id) + " " + query);
+		"WHERE file_node_id == ? " + query, fileParameters);
 
 	std::vector<Id> sourceLocationIds;
 	sourceLocationIds.reserve(sourceLocations.size());
@@ -961,22 +1320,6 @@ std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFil
 	return ret;
 }
 
-std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForLinesInFile(
-	const FilePath& filePath, size_t startLine, size_t endLine) const
-{
-	return getSourceLocationsForFile(
-		filePath,
-		"AND start_line <= " + std::to_string(endLine) +
-			" AND end_line >= " + std::to_string(startLine));
-}
-
-std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsOfTypeInFile(
-	const FilePath& filePath, LocationType type) const
-{
-	return getSourceLocationsForFile(
-		filePath, "AND type == " + std::to_string(locationTypeToInt(type)));
-}
-
 std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocationsForElementIds(
 	const std::vector<Id>& elementIds) const
 {
@@ -988,13 +1331,15 @@ std::shared_ptr<SourceLocationCollection> SqliteIndexStorage::getSourceLocations
 		sourceLocationIdToElementIds[occurrence.sourceLocationId].push_back(occurrence.elementId);
 	}
 
-	CppSQLite3Query q = executeQuery(
+	BoundIdList idList(this, sourceLocationIds);
+	CachedStatement statement(
+		this,
 		"SELECT source_location.id, file.path, source_location.start_line, "
 		"source_location.start_column, "
 		"source_location.end_line, source_location.end_column, source_location.type "
 		"FROM source_location INNER JOIN file ON (file.id = source_location.file_node_id) "
-		"WHERE source_location.id IN (" +
-		utility::join(utility::toStrings(sourceLocationIds), ',') + ");");
+		"WHERE source_location.id IN (" + idList.getSql() + ");");
+	CppSQLite3Query q = executeQuery(statement.get(), idList.getParameters());
 
 	std::shared_ptr<SourceLocationCollection> ret = std::make_shared<SourceLocationCollection>();
 
@@ -1037,34 +1382,38 @@ std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationId(I
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForLocationIds(
 	const std::vector<Id>& locationIds) const
 {
+	BoundIdList idList(this, locationIds);
 	return doGetAll<StorageOccurrence>(
-		"WHERE source_location_id IN (" + utility::join(utility::toStrings(locationIds), ',') + ")");
+		"WHERE source_location_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 std::vector<StorageOccurrence> SqliteIndexStorage::getOccurrencesForElementIds(
 	const std::vector<Id>& elementIds) const
 {
+	BoundIdList idList(this, elementIds);
 	return doGetAll<StorageOccurrence>(
-		"WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+		"WHERE element_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 StorageComponentAccess SqliteIndexStorage::getComponentAccessByNodeId(Id nodeId) const
 {
-	return doGetFirst<StorageComponentAccess>("WHERE node_id == " + std::to_string(nodeId));
+	return doGetFirst<StorageComponentAccess>("WHERE node_id == ?", {nodeId});
 }
 
 std::vector<StorageComponentAccess> SqliteIndexStorage::getComponentAccessesByNodeIds(
 	const std::vector<Id>& nodeIds) const
 {
+	BoundIdList idList(this, nodeIds);
 	return doGetAll<StorageComponentAccess>(
-		"WHERE node_id IN (" + utility::join(utility::toStrings(nodeIds), ',') + ")");
+		"WHERE node_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 std::vector<StorageElementComponent> SqliteIndexStorage::getElementComponentsByElementIds(
 	const std::vector<Id>& elementIds) const
 {
+	BoundIdList idList(this, elementIds);
 	return doGetAll<StorageElementComponent>(
-		"WHERE element_id IN (" + utility::join(utility::toStrings(elementIds), ',') + ")");
+		"WHERE element_id IN (" + idList.getSql() + ")", idList.getParameters());
 }
 
 std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const
@@ -1160,6 +1509,53 @@ int SqliteIndexStorage::getErrorCount() const
 		"SELECT COUNT(*) FROM error INNER JOIN occurrence ON (error.id = occurrence.element_id);", 0);
 }
 
+Id SqliteIndexStorage::getNextElementId() const
+{
+	CachedStatement statement(this, "SELECT MAX(id) FROM element;");
+	return executeStatementScalar(statement.get(), 0) + 1;
+}
+
+void SqliteIndexStorage::addElements(Id firstId, size_t count)
+{
+	std::vector<Id> ids(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		ids[i] = firstId + i;
+	}
+	m_insertElementBatchStatement.execute(ids, this);
+}
+
+bool SqliteIndexStorage::addFileContent(Id fileId, const std::vector<std::string>& lines)
+{
+	size_t firstLine = 1;
+	while (firstLine <= lines.size())
+	{
+		std::string text;
+		size_t lineCount = 0;
+		while (firstLine + lineCount <= lines.size() && text.size() < s_fileContentBlockSize)
+		{
+			text += lines[firstLine + lineCount - 1];
+			lineCount++;
+		}
+
+		const QByteArray block = qCompress(
+			reinterpret_cast<const unsigned char*>(text.data()), static_cast<int>(text.size()));
+
+		m_insertFileContentStmt.bind(1, int(fileId));
+		m_insertFileContentStmt.bind(2, int(firstLine));
+		m_insertFileContentStmt.bind(3, int(lineCount));
+		m_insertFileContentStmt.bind(
+			4, reinterpret_cast<const unsigned char*>(block.constData()), block.size());
+		if (!executeStatement(m_insertFileContentStmt))
+		{
+			return false;
+		}
+
+		firstLine += lineCount;
+	}
+	return true;
+}
+
 std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices() const
 {
 	std::vector<std::pair<int, SqliteDatabaseIndex>> indices;
@@ -1176,9 +1572,11 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
 		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex("source_location_file_node_id_index", "source_location(file_node_id)")));
 	indices.push_back(std::make_pair(
-		STORAGE_MODE_WRITE, SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)")));
-	indices.push_back(
-		std::make_pair(STORAGE_MODE_WRITE, SqliteDatabaseIndex("file_path_index", "file(path)")));
+		STORAGE_MODE_WRITE | STORAGE_MODE_BULK_WRITE,
+		SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)")));
+	indices.push_back(std::make_pair(
+		STORAGE_MODE_WRITE | STORAGE_MODE_BULK_WRITE,
+		SqliteDatabaseIndex("file_path_index", "file(path)")));
 	indices.push_back(std::make_pair(
 		STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex("occurrence_element_id_index", "occurrence(element_id)")));
@@ -1206,6 +1604,10 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
 		STORAGE_MODE_CLEAR,
 		SqliteDatabaseIndex(
 			"occurrence_source_location_foreign_key_index", "occurrence(source_location_id)")));
+	indices.push_back(std::make_pair(
+		STORAGE_MODE_CLEAR,
+		SqliteDatabaseIndex(
+			"file_dependency_target_foreign_key_index", "file_dependency(target_file_id)")));
 
 	return indices;
 }
@@ -1214,12 +1616,14 @@ void SqliteIndexStorage::clearTables()
 {
 	try
 	{
+		m_database.execDML("DROP TABLE IF EXISTS main.indexing_cost;");
 		m_database.execDML("DROP TABLE IF EXISTS main.error;");
 		m_database.execDML("DROP TABLE IF EXISTS main.component_access;");
 		m_database.execDML("DROP TABLE IF EXISTS main.occurrence;");
 		m_database.execDML("DROP TABLE IF EXISTS main.source_location;");
 		m_database.execDML("DROP TABLE IF EXISTS main.local_symbol;");
 		m_database.execDML("DROP TABLE IF EXISTS main.filecontent;");
+		m_database.execDML("DROP TABLE IF EXISTS main.file_dependency;");
 		m_database.execDML("DROP TABLE IF EXISTS main.file;");
 		m_database.execDML("DROP TABLE IF EXISTS main.symbol;");
 		m_database.execDML("DROP TABLE IF EXISTS main.node;");
@@ -1227,6 +1631,7 @@ void SqliteIndexStorage::clearTables()
 		m_database.execDML("DROP TABLE IF EXISTS main.element_component;");
 		m_database.execDML("DROP TABLE IF EXISTS main.element;");
 		m_database.execDML("DROP TABLE IF EXISTS main.meta;");
+		m_database.execDML("DROP TABLE IF EXISTS main.element_id_to_clear;");
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -1238,6 +1643,9 @@ void SqliteIndexStorage::setupTables()
 {
 	try
 	{
+		// left behind by interrupted clearings of older versions, which did not use a temp table
+		m_database.execDML("DROP TABLE IF EXISTS main.element_id_to_clear;");
+
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS element("
 			"id INTEGER, "
@@ -1288,14 +1696,19 @@ void SqliteIndexStorage::setupTables()
 			"indexed INTEGER, "
 			"complete INTEGER, "
 			"line_count INTEGER, "
+			"content_size INTEGER, "
+			"content_hash TEXT, "
+			"interface_hash TEXT, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
 		m_database.execDML(
 			"CREATE TABLE IF NOT EXISTS filecontent("
-			"id INTERGER, "
-			"content TEXT, "
-			"PRIMARY KEY(id), "
+			"id INTEGER NOT NULL, "
+			"first_line INTEGER NOT NULL, "
+			"line_count INTEGER NOT NULL, "
+			"content BLOB, "
+			"PRIMARY KEY(id, first_line), "
 			"FOREIGN KEY(id) REFERENCES file(id)"
 			"ON DELETE CASCADE "
 			"ON UPDATE CASCADE);");
@@ -1343,6 +1756,26 @@ void SqliteIndexStorage::setupTables()
 			"translation_unit TEXT, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
+
+		// file level include and import relations, used to find the files affected by a change
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS file_dependency("
+			"source_file_id INTEGER NOT NULL, "
+			"target_file_id INTEGER NOT NULL, "
+			"type INTEGER NOT NULL, "
+			"PRIMARY KEY(source_file_id, target_file_id, type), "
+			"FOREIGN KEY(source_file_id) REFERENCES node(id) ON DELETE CASCADE, "
+			"FOREIGN KEY(target_file_id) REFERENCES node(id) ON DELETE CASCADE"
+			") WITHOUT ROWID;");
+
+		// not bound to the file table, so the costs survive clearing a file for re-indexing
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS indexing_cost("
+			"path TEXT NOT NULL, "
+			"indexing_time_ms INTEGER, "
+			"peak_memory_kb INTEGER, "
+			"result_size_kb INTEGER, "
+			"PRIMARY KEY(path));");
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -1375,6 +1808,15 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 				stmt.bind(int(index) * 4 + 4, int(edge.targetNodeId));
 			},
 			m_database);
+		m_insertFileDependencyBatchStatement.compile(
+			"INSERT OR IGNORE INTO file_dependency(source_file_id, target_file_id, type) VALUES",
+			3,
+			[](CppSQLite3Statement& stmt, const StorageEdge& edge, size_t index) {
+				stmt.bind(int(index) * 3 + 1, int(edge.sourceNodeId));
+				stmt.bind(int(index) * 3 + 2, int(edge.targetNodeId));
+				stmt.bind(int(index) * 3 + 3, int(edge.type));
+			},
+			m_database);
 		m_insertSymbolBatchStatement.compile(
 			"INSERT OR IGNORE INTO symbol(id, definition_kind) VALUES",
 			2,
@@ -1412,6 +1854,13 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 				stmt.bind(int(index) * 2 + 2, int(occurrence.sourceLocationId));
 			},
 			m_database);
+		m_insertElementBatchStatement.compile(
+			"INSERT INTO element(id) VALUES",
+			1,
+			[](CppSQLite3Statement& stmt, const Id& id, size_t index) {
+				stmt.bind(int(index) + 1, int(id));
+			},
+			m_database);
 		m_insertComponentAccessBatchStatement.compile(
 			"INSERT OR IGNORE INTO component_access(node_id, type) VALUES",
 			2,
@@ -1426,9 +1875,10 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 			"INSERT INTO element_component(id, element_id, type, data) VALUES(NULL, ?, ?, ?);");
 		m_insertFileStmt = m_database.compileStatement(
 			"INSERT INTO file(id, path, language, modification_time, indexed, complete, "
-			"line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
+			"line_count, content_size, content_hash, interface_hash) "
+			"VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?);");
 		m_insertFileContentStmt = m_database.compileStatement(
-			"INSERT INTO filecontent(id, content) VALUES(?, ?);");
+			"INSERT INTO filecontent(id, first_line, line_count, content) VALUES(?, ?, ?, ?);");
 		m_checkErrorExistsStmt = m_database.compileStatement(
 			"SELECT id FROM error WHERE "
 			"message = ? AND "
@@ -1437,6 +1887,9 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 		m_insertErrorStmt = m_database.compileStatement(
 			"INSERT INTO error(id, message, fatal, indexed, translation_unit) "
 			"VALUES(?, ?, ?, ?, ?);");
+		m_insertIndexingCostStmt = m_database.compileStatement(
+			"INSERT OR REPLACE INTO indexing_cost(path, indexing_time_ms, peak_memory_kb, "
+			"result_size_kb) VALUES(?, ?, ?, ?);");
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -1450,10 +1903,13 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 
 template <>
 void SqliteIndexStorage::forEach<StorageEdge>(
-	const std::string& query, std::function<void(StorageEdge&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageEdge&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT id, type, source_node_id, target_node_id FROM edge " + query + ";");
+	CachedStatement statement(
+		this, "SELECT id, type, source_node_id, target_node_id FROM edge " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1473,9 +1929,12 @@ void SqliteIndexStorage::forEach<StorageEdge>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageNode>(
-	const std::string& query, std::function<void(StorageNode&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageNode&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, type, serialized_name FROM node " + query + ";");
+	CachedStatement statement(this, "SELECT id, type, serialized_name FROM node " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1494,9 +1953,12 @@ void SqliteIndexStorage::forEach<StorageNode>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageSymbol>(
-	const std::string& query, std::function<void(StorageSymbol&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageSymbol&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, definition_kind FROM symbol " + query + ";");
+	CachedStatement statement(this, "SELECT id, definition_kind FROM symbol " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1514,10 +1976,15 @@ void SqliteIndexStorage::forEach<StorageSymbol>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageFile>(
-	const std::string& query, std::function<void(StorageFile&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageFile&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT id, path, language, modification_time, indexed, complete FROM file " + query + ";");
+	CachedStatement statement(
+		this,
+		"SELECT id, path, language, modification_time, indexed, complete, interface_hash FROM file " +
+		query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1527,16 +1994,19 @@ void SqliteIndexStorage::forEach<StorageFile>(
 		const std::string modificationTime = q.getStringField(3, "");
 		const bool indexed = q.getIntField(4, 0);
 		const bool complete = q.getIntField(5, 0);
+		const std::string interfaceHash = q.getStringField(6, "");
 
 		if (id != 0)
 		{
-			func(StorageFile(
+			StorageFile file(
 				id,
 				utility::decodeFromUtf8(filePath),
 				utility::decodeFromUtf8(languageIdentifier),
 				modificationTime,
 				indexed,
-				complete));
+				complete);
+			file.interfaceHash = interfaceHashFromString(interfaceHash);
+			func(std::move(file));
 		}
 		q.nextRow();
 	}
@@ -1544,9 +2014,12 @@ void SqliteIndexStorage::forEach<StorageFile>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageLocalSymbol>(
-	const std::string& query, std::function<void(StorageLocalSymbol&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageLocalSymbol&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT id, name FROM local_symbol " + query + ";");
+	CachedStatement statement(this, "SELECT id, name FROM local_symbol " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1564,12 +2037,16 @@ void SqliteIndexStorage::forEach<StorageLocalSymbol>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageSourceLocation>(
-	const std::string& query, std::function<void(StorageSourceLocation&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageSourceLocation&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
+	CachedStatement statement(
+		this,
 		"SELECT id, file_node_id, start_line, start_column, end_line, end_column, type FROM "
 		"source_location " +
 		query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1594,10 +2071,13 @@ void SqliteIndexStorage::forEach<StorageSourceLocation>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageOccurrence>(
-	const std::string& query, std::function<void(StorageOccurrence&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageOccurrence&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT element_id, source_location_id FROM occurrence " + query + ";");
+	CachedStatement statement(
+		this, "SELECT element_id, source_location_id FROM occurrence " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1615,9 +2095,12 @@ void SqliteIndexStorage::forEach<StorageOccurrence>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageComponentAccess>(
-	const std::string& query, std::function<void(StorageComponentAccess&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageComponentAccess&&)> func) const
 {
-	CppSQLite3Query q = executeQuery("SELECT node_id, type FROM component_access " + query + ";");
+	CachedStatement statement(this, "SELECT node_id, type FROM component_access " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1635,10 +2118,13 @@ void SqliteIndexStorage::forEach<StorageComponentAccess>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageElementComponent>(
-	const std::string& query, std::function<void(StorageElementComponent&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageElementComponent&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT element_id, type, data FROM element_component " + query + ";");
+	CachedStatement statement(
+		this, "SELECT element_id, type, data FROM element_component " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1657,10 +2143,13 @@ void SqliteIndexStorage::forEach<StorageElementComponent>(
 
 template <>
 void SqliteIndexStorage::forEach<StorageError>(
-	const std::string& query, std::function<void(StorageError&&)> func) const
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageError&&)> func) const
 {
-	CppSQLite3Query q = executeQuery(
-		"SELECT id, message, fatal, indexed, translation_unit FROM error " + query + ";");
+	CachedStatement statement(
+		this, "SELECT id, message, fatal, indexed, translation_unit FROM error " + query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
 
 	while (!q.eof())
 	{
@@ -1683,3 +2172,38 @@ void SqliteIndexStorage::forEach<StorageError>(
 		q.nextRow();
 	}
 }
+
+template <>
+void SqliteIndexStorage::forEach<StorageIndexingCost>(
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageIndexingCost&&)> func) const
+{
+	// databases written by custom indexers don't record indexing costs
+	if (!m_database.tableExists("indexing_cost"))
+	{
+		return;
+	}
+
+	CachedStatement statement(
+		this,
+		"SELECT path, indexing_time_ms, peak_memory_kb, result_size_kb FROM indexing_cost " +
+		query + ";");
+	CppSQLite3Query q = executeQuery(statement.get(), parameters);
+
+	while (!q.eof())
+	{
+		const std::string filePath = q.getStringField(0, "");
+		const int indexingTimeMS = q.getIntField(1, 0);
+		const int peakMemoryKB = q.getIntField(2, 0);
+		const int resultSizeKB = q.getIntField(3, 0);
+
+		if (!filePath.empty())
+		{
+			func(StorageIndexingCost(
+				utility::decodeFromUtf8(filePath), indexingTimeMS, peakMemoryKB, resultSizeKB));
+		}
+
+		q.nextRow();
+	}
+}
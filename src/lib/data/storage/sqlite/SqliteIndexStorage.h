@@ -1,11 +1,13 @@
 #ifndef SQLITE_INDEX_STORAGE_H
 #define SQLITE_INDEX_STORAGE_H
 
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "ErrorInfo.h"
+#include "FileFingerprint.h"
 #include "LocationType.h"
 #include "LowMemoryStringMap.h"
 #include "SqliteDatabaseIndex.h"
@@ -15,6 +17,7 @@
 #include "StorageElementComponent.h"
 #include "StorageError.h"
 #include "StorageFile.h"
+#include "StorageIndexingCost.h"
 #include "StorageLocalSymbol.h"
 #include "StorageNode.h"
 #include "StorageOccurrence.h"
@@ -38,18 +41,31 @@ public:
 	{
 		STORAGE_MODE_READ = 1,
 		STORAGE_MODE_WRITE = 2,
-		STORAGE_MODE_CLEAR = 4
+		STORAGE_MODE_CLEAR = 4,
+		// writing into an empty database, foreign keys are not enforced until the mode changes
+		STORAGE_MODE_BULK_WRITE = 8
 	};
 
 	SqliteIndexStorage(const FilePath& dbFilePath);
 
 	virtual size_t getStaticVersion() const;
 
+	// creates the indices needed by the mode and drops all others, needs to be called outside of a
+	// transaction to switch the enforcement of foreign keys
 	void setMode(const StorageModeType mode);
 
+	// the temporary indices map the elements written since the last mode switch to their ids, so
+	// they are outdated once elements get removed
+	void clearTemporaryIndices();
+
 	std::string getProjectSettingsText() const;
 	void setProjectSettingsText(std::string text);
 
+	// changed headers that got indexed without their dependents, mapped to their previous interface
+	// hash, until a refresh has checked whether the dependents need to be indexed as well
+	std::map<FilePath, unsigned long long> getPendingInterfaceHashes() const;
+	void setPendingInterfaceHashes(const std::map<FilePath, unsigned long long>& interfaceHashes);
+
 	Id addNode(const StorageNodeData& data);
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes);
 	bool addSymbol(const StorageSymbol& data);
@@ -58,7 +74,7 @@ public:
 	Id addEdge(const StorageEdgeData& data);
 	std::vector<Id> addEdges(const std::vector<StorageEdge>& edges);
 	Id addLocalSymbol(const StorageLocalSymbolData& data);
-	std::vector<Id> addLocalSymbols(const std::set<StorageLocalSymbol>& symbols);
+	std::vector<Id> addLocalSymbols(const std::vector<StorageLocalSymbol>& symbols);
 	Id addSourceLocation(const StorageSourceLocationData& data);
 	std::vector<Id> addSourceLocations(const std::vector<StorageSourceLocation>& locations);
 	bool addOccurrence(const StorageOccurrence& data);
@@ -68,14 +84,22 @@ public:
 	void addElementComponent(const StorageElementComponent& component);
 	void addElementComponents(const std::vector<StorageElementComponent>& components);
 	StorageError addError(const StorageErrorData& data);
+	void addIndexingCosts(const std::vector<StorageIndexingCost>& costs);
 
 	void removeElement(Id id);
 	void removeElements(const std::vector<Id>& ids);
+	// removes the file data but keeps the file nodes and the edges pointing to them
+	void removeFilesKeepingNodes(const std::vector<Id>& fileIds);
 	void removeOccurrence(const StorageOccurrence& occurrence);
 	void removeOccurrences(const std::vector<StorageOccurrence>& occurrences);
 	void removeElementsWithoutOccurrences(const std::vector<Id>& elementIds);
+	// keepEdgesOfOtherFiles keeps edges that are also located in other files and edges without
+	// location that point to elements of other files, which are not recorded again if these files
+	// get indexed without the files depending on them
 	void removeElementsWithLocationInFiles(
-		const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback);
+		const std::vector<Id>& fileIds,
+		bool keepEdgesOfOtherFiles,
+		std::function<void(int)> updateStatusCallback);
 
 	void removeAllErrors();
 
@@ -107,15 +131,28 @@ public:
 	StorageFile getFileByPath(const std::wstring& filePath) const;
 
 	std::vector<StorageFile> getFilesByPaths(const std::vector<FilePath>& filePaths) const;
+	// file contents are stored in compressed blocks of whole lines
 	std::shared_ptr<TextAccess> getFileContentByPath(const std::wstring& filePath) const;
 	std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
+	// only the blocks holding the lines are decompressed, empty if the range is not stored
+	std::vector<std::string> getFileContentLinesById(
+		Id fileId, size_t firstLineNumber, size_t lastLineNumber) const;
+	bool hasFileContent(Id fileId) const;
+	// fingerprints of the file contents at the time they were stored, invalid for non-indexed files
+	std::map<FilePath, FileFingerprint> getFileFingerprints() const;
+
+	// resolves the files of the elements imported by the given edges, call this after injecting
+	// new data
+	void addImportFileDependencies(const std::vector<Id>& importEdgeIds);
+	// pairs of dependent and depended on file ids, collected from include and import edges
+	std::vector<std::pair<Id, Id>> getFileDependencies() const;
 
 	void setFileIndexed(Id fileId, bool indexed);
+	void setFileInterfaceHash(Id fileId, unsigned long long interfaceHash);
 	void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
 	void setNodeType(int type, Id nodeId);
 
-	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(
-		const FilePath& filePath, const std::string& query = "") const;
+	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(const FilePath& filePath) const;
 	std::shared_ptr<SourceLocationFile> getSourceLocationsForLinesInFile(
 		const FilePath& filePath, size_t startLine, size_t endLine) const;
 	std::shared_ptr<SourceLocationFile> getSourceLocationsOfTypeInFile(
@@ -148,7 +185,7 @@ public:
 	{
 		if (id != 0)
 		{
-			return doGetFirst<ResultType>("WHERE id == " + std::to_string(id));
+			return doGetFirst<ResultType>("WHERE id == ?", {id});
 		}
 		return ResultType();
 	}
@@ -158,8 +195,9 @@ public:
 	{
 		if (ids.size())
 		{
+			BoundIdList idList(this, ids);
 			return doGetAll<ResultType>(
-				"WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")");
+				"WHERE id IN (" + idList.getSql() + ")", idList.getParameters());
 		}
 		return std::vector<ResultType>();
 	}
@@ -167,13 +205,13 @@ public:
 	template <typename StorageType>
 	void forEach(std::function<void(StorageType&&)> func) const
 	{
-		forEach("", func);
+		forEach("", {}, func);
 	}
 
 	template <typename StorageType>
 	void forEachOfType(int type, std::function<void(StorageType&&)> func) const
 	{
-		forEach("WHERE type == " + std::to_string(type), func);
+		forEach("WHERE type == ?", {type}, func);
 	}
 
 	template <typename StorageType>
@@ -181,7 +219,8 @@ public:
 	{
 		if (ids.size())
 		{
-			forEach("WHERE id IN (" + utility::join(utility::toStrings(ids), ',') + ")", func);
+			BoundIdList idList(this, ids);
+			forEach("WHERE id IN (" + idList.getSql() + ")", idList.getParameters(), func);
 		}
 	}
 
@@ -235,25 +274,35 @@ private:
 		uint8_t type;
 	};
 
+	// new elements get consecutive ids and are inserted in one batch ahead of their rows
+	Id getNextElementId() const;
+	void addElements(Id firstId, size_t count);
+
+	bool addFileContent(Id fileId, const std::vector<std::string>& lines);
+
 	std::vector<std::pair<int, SqliteDatabaseIndex>> getIndices() const;
 
 	virtual void clearTables();
 	virtual void setupTables();
 	virtual void setupPrecompiledStatements();
 
+	// queries bind their values to '?' placeholders, so the query text stays the same and the
+	// prepared statement can be reused
 	template <typename ResultType>
-	std::vector<ResultType> doGetAll(const std::string& query) const
+	std::vector<ResultType> doGetAll(
+		const std::string& query, const QueryParameters& parameters = {}) const
 	{
 		std::vector<ResultType> elements;
-		forEach<ResultType>(
-			query, [&elements](ResultType&& element) { elements.emplace_back(element); });
+		forEach<ResultType>(query, parameters, [&elements](ResultType&& element) {
+			elements.emplace_back(element);
+		});
 		return elements;
 	}
 
 	template <typename ResultType>
-	ResultType doGetFirst(const std::string& query) const
+	ResultType doGetFirst(const std::string& query, const QueryParameters& parameters = {}) const
 	{
-		std::vector<ResultType> results = doGetAll<ResultType>(query + " LIMIT 1");
+		std::vector<ResultType> results = doGetAll<ResultType>(query + " LIMIT 1", parameters);
 		if (results.size() > 0)
 		{
 			return results[0];
@@ -261,8 +310,16 @@ private:
 		return ResultType();
 	}
 
+	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(
+		const FilePath& filePath,
+		const std::string& query,
+		const QueryParameters& parameters) const;
+
 	template <typename StorageType>
-	void forEach(const std::string& query, std::function<void(StorageType&&)> func) const;
+	void forEach(
+		const std::string& query,
+		const QueryParameters& parameters,
+		std::function<void(StorageType&&)> func) const;
 
 	LowMemoryStringMap<std::string, uint32_t, 0> m_tempNodeNameIndex;
 	LowMemoryStringMap<std::wstring, uint32_t, 0> m_tempWNodeNameIndex;
@@ -352,8 +409,10 @@ private:
 		std::function<void(CppSQLite3Statement& stmt, const StorageType&, size_t)> m_bindValuesFunc;
 	};
 
+	InsertBatchStatement<Id> m_insertElementBatchStatement;
 	InsertBatchStatement<StorageNode> m_insertNodeBatchStatement;
 	InsertBatchStatement<StorageEdge> m_insertEdgeBatchStatement;
+	InsertBatchStatement<StorageEdge> m_insertFileDependencyBatchStatement;
 	InsertBatchStatement<StorageSymbol> m_insertSymbolBatchStatement;
 	InsertBatchStatement<StorageLocalSymbol> m_insertLocalSymbolBatchStatement;
 	InsertBatchStatement<StorageSourceLocationData> m_insertSourceLocationBatchStatement;
@@ -366,37 +425,63 @@ private:
 	CppSQLite3Statement m_insertFileContentStmt;
 	CppSQLite3Statement m_checkErrorExistsStmt;
 	CppSQLite3Statement m_insertErrorStmt;
+	CppSQLite3Statement m_insertIndexingCostStmt;
 };
 
 template <>
 void SqliteIndexStorage::forEach<StorageEdge>(
-	const std::string& query, std::function<void(StorageEdge&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageEdge&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageNode>(
-	const std::string& query, std::function<void(StorageNode&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageNode&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageSymbol>(
-	const std::string& query, std::function<void(StorageSymbol&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageSymbol&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageFile>(
-	const std::string& query, std::function<void(StorageFile&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageFile&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageLocalSymbol>(
-	const std::string& query, std::function<void(StorageLocalSymbol&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageLocalSymbol&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageSourceLocation>(
-	const std::string& query, std::function<void(StorageSourceLocation&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageSourceLocation&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageOccurrence>(
-	const std::string& query, std::function<void(StorageOccurrence&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageOccurrence&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageComponentAccess>(
-	const std::string& query, std::function<void(StorageComponentAccess&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageComponentAccess&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageElementComponent>(
-	const std::string& query, std::function<void(StorageElementComponent&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageElementComponent&&)> func) const;
 template <>
 void SqliteIndexStorage::forEach<StorageError>(
-	const std::string& query, std::function<void(StorageError&&)> func) const;
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageError&&)> func) const;
+template <>
+void SqliteIndexStorage::forEach<StorageIndexingCost>(
+	const std::string& query,
+	const QueryParameters& parameters,
+	std::function<void(StorageIndexingCost&&)> func) const;
 
 #endif	  // SQLITE_INDEX_STORAGE_H
@@ -1,10 +1,213 @@
 #include "SqliteStorage.h"
 
+#include <algorithm>
+
 #include "FileSystem.h"
 #include "TimeStamp.h"
 #include "logging.h"
 #include "utilityString.h"
 
+namespace
+{
+// ids bound to placeholders per statement, well below the limit of 999 variables
+const size_t s_maxBoundIdCount = 256;
+// texts that are not cached anymore, so queries that still inline values cannot grow the cache
+const size_t s_maxCachedStatementCount = 512;
+
+bool isPragmaValue(const std::string& value, const std::vector<std::string>& allowedValues)
+{
+	if (std::find(allowedValues.begin(), allowedValues.end(), value) != allowedValues.end())
+	{
+		return true;
+	}
+
+	LOG_WARNING("Storage profile value \"" + value + "\" is not supported and is ignored.");
+	return false;
+}
+
+FilePath getDbCompanionFilePath(const FilePath& dbFilePath, const std::wstring& suffix)
+{
+	return FilePath(dbFilePath.wstr() + suffix);
+}
+
+const std::vector<std::wstring> s_dbCompanionFileSuffixes = {L"-journal", L"-wal", L"-shm"};
+}	 // namespace
+
+SqliteStorage::QueryParameter::QueryParameter(long long value): intValue(value) {}
+
+SqliteStorage::QueryParameter::QueryParameter(std::string value)
+	: textValue(std::move(value)), isText(true)
+{
+}
+
+SqliteStorage::CachedStatement::CachedStatement(
+	const SqliteStorage* storage, const std::string& statement)
+	: m_storage(storage), m_text(statement)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_storage->m_cacheMutex);
+		auto it = m_storage->m_cachedStatements.find(m_text);
+		if (it != m_storage->m_cachedStatements.end())
+		{
+			// copying hands over the compiled statement
+			m_statement = it->second;
+			m_storage->m_cachedStatements.erase(it);
+			return;
+		}
+	}
+
+	{
+		try
+		{
+			m_statement = m_storage->m_database.compileStatement(m_text.c_str());
+		}
+		catch (CppSQLite3Exception e)
+		{
+			LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+		}
+	}
+}
+
+SqliteStorage::CachedStatement::~CachedStatement()
+{
+	try
+	{
+		m_statement.reset();
+	}
+	catch (CppSQLite3Exception e)
+	{
+		// the error was already reported by the query that ran the statement
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_storage->m_cacheMutex);
+	if (m_storage->m_cachedStatements.size() < s_maxCachedStatementCount &&
+		m_storage->m_cachedStatements.find(m_text) == m_storage->m_cachedStatements.end())
+	{
+		m_storage->m_cachedStatements[m_text] = m_statement;
+	}
+}
+
+CppSQLite3Statement& SqliteStorage::CachedStatement::get()
+{
+	return m_statement;
+}
+
+SqliteStorage::BoundIdList::BoundIdList(const SqliteStorage* storage, const std::vector<Id>& ids)
+	: m_storage(storage)
+{
+	if (ids.size() <= s_maxBoundIdCount)
+	{
+		size_t placeholderCount = 1;
+		while (placeholderCount < ids.size())
+		{
+			placeholderCount *= 2;
+		}
+
+		// repeating an id does not change the result
+		m_parameters.reserve(placeholderCount);
+		for (size_t i = 0; i < placeholderCount; i++)
+		{
+			m_parameters.emplace_back(ids.empty() ? 0 : ids[std::min(i, ids.size() - 1)]);
+		}
+		return;
+	}
+
+	// one table per list in use, so lists can be nested and used by several threads at once
+	m_usesTable = true;
+	{
+		std::lock_guard<std::mutex> lock(m_storage->m_cacheMutex);
+		std::vector<bool>& usedIdTables = m_storage->m_usedIdTables;
+		m_tableIndex = std::find(usedIdTables.begin(), usedIdTables.end(), false) -
+			usedIdTables.begin();
+		if (m_tableIndex == usedIdTables.size())
+		{
+			m_storage->executeStatement(
+				"CREATE TEMP TABLE IF NOT EXISTS " + getTableName() + "(id INTEGER PRIMARY KEY);");
+			usedIdTables.push_back(true);
+		}
+		usedIdTables[m_tableIndex] = true;
+	}
+
+	std::string values = "(?)";
+	for (size_t i = 1; i < s_maxBoundIdCount; i++)
+	{
+		values += ",(?)";
+	}
+
+	try
+	{
+		size_t i = 0;
+		{
+			CachedStatement statement(
+				m_storage,
+				"INSERT OR IGNORE INTO " + getTableName() + "(id) VALUES " + values + ";");
+			for (; i + s_maxBoundIdCount <= ids.size(); i += s_maxBoundIdCount)
+			{
+				for (size_t j = 0; j < s_maxBoundIdCount; j++)
+				{
+					statement.get().bind(int(j + 1), int(ids[i + j]));
+				}
+				m_storage->executeStatement(statement.get());
+			}
+		}
+
+		CachedStatement statement(
+			m_storage, "INSERT OR IGNORE INTO " + getTableName() + "(id) VALUES (?);");
+		for (; i < ids.size(); i++)
+		{
+			statement.get().bind(1, int(ids[i]));
+			m_storage->executeStatement(statement.get());
+		}
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+}
+
+SqliteStorage::BoundIdList::~BoundIdList()
+{
+	if (m_usesTable)
+	{
+		{
+			CachedStatement statement(m_storage, "DELETE FROM " + getTableName() + ";");
+			m_storage->executeStatement(statement.get());
+		}
+
+		std::lock_guard<std::mutex> lock(m_storage->m_cacheMutex);
+		m_storage->m_usedIdTables[m_tableIndex] = false;
+	}
+}
+
+std::string SqliteStorage::BoundIdList::getSql() const
+{
+	if (m_usesTable)
+	{
+		return "SELECT id FROM " + getTableName();
+	}
+
+	std::string sql = "?";
+	for (size_t i = 1; i < m_parameters.size(); i++)
+	{
+		sql += ",?";
+	}
+	return sql;
+}
+
+SqliteStorage::QueryParameters SqliteStorage::BoundIdList::getParameters(
+	const QueryParameters& parameters) const
+{
+	QueryParameters allParameters = m_parameters;
+	allParameters.insert(allParameters.end(), parameters.begin(), parameters.end());
+	return allParameters;
+}
+
+std::string SqliteStorage::BoundIdList::getTableName() const
+{
+	return "temp.query_id_" + std::to_string(m_tableIndex);
+}
+
 SqliteStorage::SqliteStorage(const FilePath& dbFilePath): m_dbFilePath(dbFilePath.getCanonical())
 {
 	if (!m_dbFilePath.getParentDirectory().empty() && !m_dbFilePath.getParentDirectory().exists())
@@ -15,10 +218,17 @@ SqliteStorage::SqliteStorage(const FilePath& dbFilePath): m_dbFilePath(dbFilePat
 	m_database.open(utility::encodeToUtf8(m_dbFilePath.wstr()).c_str());
 
 	executeStatement("PRAGMA foreign_keys=ON;");
+	executeStatement("PRAGMA temp_store=" + m_tempStore + ";");
 }
 
 SqliteStorage::~SqliteStorage()
 {
+	// open statements keep the database from closing
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		m_cachedStatements.clear();
+	}
+
 	try
 	{
 		m_database.close();
@@ -49,6 +259,10 @@ void SqliteStorage::setup()
 void SqliteStorage::clear()
 {
 	executeStatement("PRAGMA foreign_keys=OFF;");
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		m_cachedStatements.clear();
+	}
 	clearMetaTable();
 	clearTables();
 
@@ -74,21 +288,189 @@ void SqliteStorage::setVersion(size_t version)
 
 void SqliteStorage::beginTransaction()
 {
-	executeStatement("BEGIN TRANSACTION;");
+	if (m_transactionDepth == 0)
+	{
+		executeStatement("BEGIN TRANSACTION;");
+	}
+	else
+	{
+		executeStatement("SAVEPOINT nested_" + std::to_string(m_transactionDepth) + ";");
+	}
+	m_transactionDepth++;
 }
 
 void SqliteStorage::commitTransaction()
 {
-	executeStatement("COMMIT TRANSACTION;");
+	if (m_transactionDepth == 0)
+	{
+		LOG_ERROR("Cannot commit transaction, no transaction is open.");
+		return;
+	}
+
+	m_transactionDepth--;
+	if (m_transactionDepth == 0)
+	{
+		executeStatement("COMMIT TRANSACTION;");
+	}
+	else
+	{
+		executeStatement("RELEASE nested_" + std::to_string(m_transactionDepth) + ";");
+	}
 }
 
 void SqliteStorage::rollbackTransaction()
 {
-	executeStatement("ROLLBACK TRANSACTION;");
+	if (m_transactionDepth == 0)
+	{
+		LOG_ERROR("Cannot roll back transaction, no transaction is open.");
+		return;
+	}
+
+	m_transactionDepth--;
+	if (m_transactionDepth == 0)
+	{
+		executeStatement("ROLLBACK TRANSACTION;");
+	}
+	else
+	{
+		const std::string savepoint = "nested_" + std::to_string(m_transactionDepth);
+		executeStatement("ROLLBACK TO " + savepoint + ";");
+		executeStatement("RELEASE " + savepoint + ";");
+	}
+}
+
+bool SqliteStorage::isInTransaction() const
+{
+	return m_transactionDepth > 0;
+}
+
+size_t SqliteStorage::getTransactionDepth() const
+{
+	return m_transactionDepth;
+}
+
+bool SqliteStorage::enableWriteAheadLog()
+{
+	try
+	{
+		CppSQLite3Query q = m_database.execQuery("PRAGMA journal_mode=WAL;");
+		if (!q.eof())
+		{
+			m_journalMode = utility::toLowerCase(std::string(q.getStringField(0, "")));
+		}
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+	return m_journalMode == "wal";
+}
+
+void SqliteStorage::applyProfile(const SqliteStorageProfile& profile)
+{
+	const bool applyAll = !m_profileApplied;
+
+	// only takes effect before the first table is created, so it is set ahead of the journal mode
+	if (profile.pageSize > 0 && (applyAll || profile.pageSize != m_profile.pageSize))
+	{
+		executeStatement("PRAGMA page_size=" + std::to_string(profile.pageSize) + ";");
+	}
+
+	std::string journalMode = utility::toLowerCase(profile.journalMode);
+	if (m_writeAheadLogDisabled && journalMode == "wal")
+	{
+		journalMode = "delete";
+	}
+	if (!isInTransaction() && journalMode != m_journalMode &&
+		isPragmaValue(journalMode, {"delete", "truncate", "persist", "memory", "wal", "off"}))
+	{
+		setJournalMode(journalMode);
+	}
+
+	const std::string synchronous = utility::toLowerCase(profile.synchronous);
+	if ((applyAll || synchronous != utility::toLowerCase(m_profile.synchronous)) &&
+		isPragmaValue(synchronous, {"off", "normal", "full"}))
+	{
+		executeStatement("PRAGMA synchronous=" + synchronous + ";");
+	}
+
+	// negative cache sizes are given in kibibytes instead of pages
+	if (profile.cacheSizeKB > 0 && (applyAll || profile.cacheSizeKB != m_profile.cacheSizeKB))
+	{
+		executeStatement("PRAGMA cache_size=-" + std::to_string(profile.cacheSizeKB) + ";");
+	}
+
+	if (profile.mmapSizeMB >= 0 && (applyAll || profile.mmapSizeMB != m_profile.mmapSizeMB))
+	{
+		executeStatement(
+			"PRAGMA mmap_size=" + std::to_string(static_cast<long long>(profile.mmapSizeMB) << 20) +
+			";");
+	}
+
+	// changing the temp store drops all temporary tables and fails within a transaction
+	const std::string tempStore = utility::toLowerCase(profile.tempStore);
+	if (!isInTransaction() && tempStore != m_tempStore &&
+		isPragmaValue(tempStore, {"default", "file", "memory"}))
+	{
+		std::lock_guard<std::mutex> lock(m_cacheMutex);
+		if (std::find(m_usedIdTables.begin(), m_usedIdTables.end(), true) == m_usedIdTables.end() &&
+			executeStatement("PRAGMA temp_store=" + tempStore + ";"))
+		{
+			m_tempStore = tempStore;
+			m_usedIdTables.clear();
+		}
+	}
+
+	m_profile = profile;
+	m_profileApplied = true;
+}
+
+void SqliteStorage::disableWriteAheadLog()
+{
+	m_writeAheadLogDisabled = true;
+
+	// leaving the write-ahead log checkpoints it into the database file and removes it
+	if (!isInTransaction() && m_journalMode != "delete")
+	{
+		setJournalMode("delete");
+	}
+}
+
+const SqliteStorageProfile& SqliteStorage::getProfile() const
+{
+	return m_profile;
+}
+
+void SqliteStorage::setJournalMode(const std::string& journalMode)
+{
+	try
+	{
+		CppSQLite3Query q = m_database.execQuery(
+			("PRAGMA journal_mode=" + journalMode + ";").c_str());
+		if (!q.eof())
+		{
+			m_journalMode = utility::toLowerCase(std::string(q.getStringField(0, "")));
+		}
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+
+	if (m_journalMode != journalMode)
+	{
+		LOG_WARNING("Storage journal mode stays \"" + m_journalMode + "\".");
+	}
 }
 
 void SqliteStorage::optimizeMemory() const
 {
+	// vacuuming is not possible within a transaction and would rewrite the whole database anyway
+	if (isInTransaction())
+	{
+		return;
+	}
+
 	executeStatement("VACUUM;");
 }
 
@@ -123,6 +505,64 @@ TimeStamp SqliteStorage::getTime() const
 	return TimeStamp(getMetaValue("timestamp"));
 }
 
+bool SqliteStorage::removeDbFiles(const FilePath& dbFilePath)
+{
+	FileSystem::remove(dbFilePath);
+	if (dbFilePath.recheckExists())
+	{
+		return false;
+	}
+
+	for (const std::wstring& suffix: s_dbCompanionFileSuffixes)
+	{
+		FileSystem::remove(getDbCompanionFilePath(dbFilePath, suffix));
+	}
+	return true;
+}
+
+bool SqliteStorage::renameDbFiles(const FilePath& from, const FilePath& to)
+{
+	// a journal left behind by a crash would otherwise be applied to the wrong database
+	for (const std::wstring& suffix: s_dbCompanionFileSuffixes)
+	{
+		FileSystem::remove(getDbCompanionFilePath(to, suffix));
+	}
+
+	if (!FileSystem::rename(from, to))
+	{
+		return false;
+	}
+
+	for (const std::wstring& suffix: s_dbCompanionFileSuffixes)
+	{
+		const FilePath companionFilePath = getDbCompanionFilePath(from, suffix);
+		if (companionFilePath.recheckExists())
+		{
+			FileSystem::rename(companionFilePath, getDbCompanionFilePath(to, suffix));
+		}
+	}
+	return true;
+}
+
+bool SqliteStorage::copyDbFiles(const FilePath& from, const FilePath& to)
+{
+	removeDbFiles(to);
+
+	if (!FileSystem::copyFile(from, to))
+	{
+		return false;
+	}
+
+	// committed data that is not checkpointed yet only exists in the write-ahead log, the shared
+	// memory file gets rebuilt from it when the copy is opened
+	const FilePath walFilePath = getDbCompanionFilePath(from, L"-wal");
+	if (walFilePath.recheckExists())
+	{
+		FileSystem::copyFile(walFilePath, getDbCompanionFilePath(to, L"-wal"));
+	}
+	return true;
+}
+
 void SqliteStorage::setupMetaTable()
 {
 	try
@@ -248,6 +688,31 @@ CppSQLite3Query SqliteStorage::executeQuery(CppSQLite3Statement& statement) cons
 	return CppSQLite3Query();
 }
 
+CppSQLite3Query SqliteStorage::executeQuery(
+	CppSQLite3Statement& statement, const QueryParameters& parameters) const
+{
+	try
+	{
+		for (size_t i = 0; i < parameters.size(); i++)
+		{
+			if (parameters[i].isText)
+			{
+				statement.bind(int(i + 1), parameters[i].textValue.c_str());
+			}
+			else
+			{
+				statement.bind(int(i + 1), int(parameters[i].intValue));
+			}
+		}
+		return statement.execQuery();
+	}
+	catch (CppSQLite3Exception e)
+	{
+		LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+	}
+	return CppSQLite3Query();
+}
+
 bool SqliteStorage::hasTable(const std::string& tableName) const
 {
 	CppSQLite3Query q = executeQuery(
@@ -1,10 +1,17 @@
 #ifndef SQLITE_STORAGE_H
 #define SQLITE_STORAGE_H
 
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 #include "CppSQLite3.h"
 
 #include "FilePath.h"
 #include "SqliteDatabaseIndex.h"
+#include "SqliteStorageProfile.h"
+#include "types.h"
 
 class SqliteStorageMigration;
 class TimeStamp;
@@ -21,9 +28,24 @@ public:
 	size_t getVersion() const;
 	void setVersion(size_t version);
 
+	// nested transactions are kept as savepoints of the outermost one
 	void beginTransaction();
 	void commitTransaction();
 	void rollbackTransaction();
+	bool isInTransaction() const;
+	size_t getTransactionDepth() const;
+
+	// lets other connections keep reading the last committed state while this one writes
+	bool enableWriteAheadLog();
+	// keeps all committed data in the database file, so it can be renamed or copied while this
+	// connection is still open. profiles that use a write-ahead log get a rollback journal instead.
+	void disableWriteAheadLog();
+
+	// only the settings that differ from the last applied profile are changed. the journal mode and
+	// temp store are kept while a transaction is open and changed by the next profile applied
+	// outside of one.
+	void applyProfile(const SqliteStorageProfile& profile);
+	const SqliteStorageProfile& getProfile() const;
 
 	void optimizeMemory() const;
 
@@ -35,7 +57,72 @@ public:
 	void setTime();
 	TimeStamp getTime() const;
 
+	// the journal and write-ahead log files next to a database belong to it and are handled along
+	static bool removeDbFiles(const FilePath& dbFilePath);
+	static bool renameDbFiles(const FilePath& from, const FilePath& to);
+	static bool copyDbFiles(const FilePath& from, const FilePath& to);
+
 protected:
+	// value bound to a '?' placeholder of a query, integers are bound as int like they are read
+	struct QueryParameter
+	{
+		QueryParameter(long long value);
+		QueryParameter(std::string value);
+
+		long long intValue = 0;
+		std::string textValue;
+		bool isText = false;
+	};
+	typedef std::vector<QueryParameter> QueryParameters;
+
+	// statement taken from the cache of prepared queries, so each query text is only parsed and
+	// planned once. the statement is reset and handed back to the cache when the handle goes out of
+	// scope, nested or concurrent uses of the same text get a statement of their own.
+	class CachedStatement
+	{
+	public:
+		CachedStatement(const SqliteStorage* storage, const std::string& statement);
+		~CachedStatement();
+
+		CachedStatement(const CachedStatement&) = delete;
+		CachedStatement& operator=(const CachedStatement&) = delete;
+
+		CppSQLite3Statement& get();
+
+	private:
+		const SqliteStorage* m_storage;
+		const std::string m_text;
+		CppSQLite3Statement m_statement;
+	};
+
+	// list of ids bound to a query instead of being inlined into its text. short lists are bound to
+	// placeholders, whose count is rounded up to a power of two so only few query texts exist. long
+	// lists are written to a temporary table of their own that is emptied and handed back when the
+	// handle goes out of scope.
+	class BoundIdList
+	{
+	public:
+		BoundIdList(const SqliteStorage* storage, const std::vector<Id>& ids);
+		~BoundIdList();
+
+		BoundIdList(const BoundIdList&) = delete;
+		BoundIdList& operator=(const BoundIdList&) = delete;
+
+		// to be used as "IN (<sql>)"
+		std::string getSql() const;
+
+		// values of the placeholders in the sql, followed by the given ones
+		QueryParameters getParameters(const QueryParameters& parameters = {}) const;
+
+	private:
+		std::string getTableName() const;
+
+		const SqliteStorage* m_storage;
+		QueryParameters m_parameters;
+		bool m_usesTable = false;
+		size_t m_tableIndex = 0;
+	};
+
 	void setupMetaTable();
 	void clearMetaTable();
 
@@ -45,6 +132,8 @@ protected:
 	int executeStatementScalar(CppSQLite3Statement& statement, const int nullValue) const;
 	CppSQLite3Query executeQuery(const std::string& statement) const;
 	CppSQLite3Query executeQuery(CppSQLite3Statement& statement) const;
+	CppSQLite3Query executeQuery(
+		CppSQLite3Statement& statement, const QueryParameters& parameters) const;
 
 	bool hasTable(const std::string& tableName) const;
 
@@ -55,6 +144,8 @@ protected:
 	FilePath m_dbFilePath;
 
 private:
+	void setJournalMode(const std::string& journalMode);
+
 	virtual size_t getStaticVersion() const = 0;
 	virtual void clearTables() = 0;
 	virtual void setupTables() = 0;
@@ -63,6 +154,18 @@ private:
 	std::vector<std::pair<int, SqliteDatabaseIndex>> m_indices;
 
 	bool m_precompiledStatementsInitialized = false;
+	size_t m_transactionDepth = 0;
+
+	SqliteStorageProfile m_profile;
+	bool m_profileApplied = false;
+	std::string m_journalMode;
+	bool m_writeAheadLogDisabled = false;
+	std::string m_tempStore = "memory";
+
+	// the storage is read from several threads, so the cache and the id tables are guarded
+	mutable std::mutex m_cacheMutex;
+	mutable std::map<std::string, CppSQLite3Statement> m_cachedStatements;
+	mutable std::vector<bool> m_usedIdTables;
 
 	friend SqliteStorageMigration;
 };
@@ -0,0 +1,71 @@
+#include "SqliteStorageProfile.h"
+
+std::string sqliteStorageProfileTypeToString(SqliteStorageProfileType type)
+{
+	switch (type)
+	{
+	case SqliteStorageProfileType::BULK_INDEXING:
+		return "bulk_indexing";
+	case SqliteStorageProfileType::INTERACTIVE:
+		return "interactive";
+	case SqliteStorageProfileType::LOW_MEMORY:
+		return "low_memory";
+	}
+
+	return "interactive";
+}
+
+SqliteStorageProfileType stringToSqliteStorageProfileType(const std::string& value)
+{
+	if (value == sqliteStorageProfileTypeToString(SqliteStorageProfileType::BULK_INDEXING))
+		return SqliteStorageProfileType::BULK_INDEXING;
+	if (value == sqliteStorageProfileTypeToString(SqliteStorageProfileType::INTERACTIVE))
+		return SqliteStorageProfileType::INTERACTIVE;
+	if (value == sqliteStorageProfileTypeToString(SqliteStorageProfileType::LOW_MEMORY))
+		return SqliteStorageProfileType::LOW_MEMORY;
+
+	return SqliteStorageProfileType::INTERACTIVE;
+}
+
+SqliteStorageProfile SqliteStorageProfile::getDefault(SqliteStorageProfileType type)
+{
+	SqliteStorageProfile profile;
+	profile.journalMode = "wal";
+	profile.tempStore = "memory";
+	profile.pageSize = 4096;
+
+	switch (type)
+	{
+	case SqliteStorageProfileType::BULK_INDEXING:
+		// a crash while indexing discards the index anyway, so commits skip syncing to disk
+		profile.synchronous = "off";
+		profile.cacheSizeKB = 256 * 1024;
+		profile.mmapSizeMB = 256;
+		break;
+	case SqliteStorageProfileType::INTERACTIVE:
+		profile.synchronous = "normal";
+		profile.cacheSizeKB = 64 * 1024;
+		profile.mmapSizeMB = 256;
+		break;
+	case SqliteStorageProfileType::LOW_MEMORY:
+		profile.synchronous = "normal";
+		profile.cacheSizeKB = 2 * 1024;
+		profile.mmapSizeMB = 0;
+		profile.tempStore = "file";
+		break;
+	}
+
+	return profile;
+}
+
+bool SqliteStorageProfile::operator==(const SqliteStorageProfile& other) const
+{
+	return journalMode == other.journalMode && synchronous == other.synchronous &&
+		cacheSizeKB == other.cacheSizeKB && mmapSizeMB == other.mmapSizeMB &&
+		tempStore == other.tempStore && pageSize == other.pageSize;
+}
+
+bool SqliteStorageProfile::operator!=(const SqliteStorageProfile& other) const
+{
+	return !(*this == other);
+}
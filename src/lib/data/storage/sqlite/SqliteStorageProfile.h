@@ -0,0 +1,36 @@
+#ifndef SQLITE_STORAGE_PROFILE_H
+#define SQLITE_STORAGE_PROFILE_H
+
+#include <string>
+
+enum class SqliteStorageProfileType
+{
+	BULK_INDEXING,
+	INTERACTIVE,
+	LOW_MEMORY
+};
+
+std::string sqliteStorageProfileTypeToString(SqliteStorageProfileType type);
+SqliteStorageProfileType stringToSqliteStorageProfileType(const std::string& value);
+
+// connection settings of a sqlite database, tuned for one way of using it
+struct SqliteStorageProfile
+{
+	static SqliteStorageProfile getDefault(SqliteStorageProfileType type);
+
+	bool operator==(const SqliteStorageProfile& other) const;
+	bool operator!=(const SqliteStorageProfile& other) const;
+
+	// delete, truncate, persist, memory, wal or off
+	std::string journalMode;
+	// off, normal or full
+	std::string synchronous;
+	int cacheSizeKB = 0;
+	int mmapSizeMB = 0;
+	// default, file or memory
+	std::string tempStore;
+	// only used when the database file is created, 0 keeps the default
+	int pageSize = 0;
+};
+
+#endif	  // SQLITE_STORAGE_PROFILE_H
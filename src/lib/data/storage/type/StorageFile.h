@@ -14,6 +14,7 @@ struct StorageFile
 		, modificationTime("")
 		, indexed(true)
 		, complete(true)
+		, interfaceHash(0)
 	{
 	}
 
@@ -30,6 +31,7 @@ struct StorageFile
 		, modificationTime(std::move(modificationTime))
 		, indexed(indexed)
 		, complete(complete)
+		, interfaceHash(0)
 	{
 	}
 
@@ -44,6 +46,8 @@ struct StorageFile
 	std::string modificationTime;
 	bool indexed;
 	bool complete;
+	// combined hash of the declarations other files can depend on, 0 if it was not recorded
+	unsigned long long interfaceHash;
 };
 
 #endif	  // STORAGE_FILE_H
@@ -0,0 +1,26 @@
+#ifndef STORAGE_INDEXING_COST_H
+#define STORAGE_INDEXING_COST_H
+
+#include <string>
+
+// resources used for indexing a translation unit, used for scheduling the next refresh
+struct StorageIndexingCost
+{
+	StorageIndexingCost(): filePath(L""), indexingTimeMS(0), peakMemoryKB(0), resultSizeKB(0) {}
+
+	StorageIndexingCost(
+		std::wstring filePath, size_t indexingTimeMS, size_t peakMemoryKB, size_t resultSizeKB)
+		: filePath(std::move(filePath))
+		, indexingTimeMS(indexingTimeMS)
+		, peakMemoryKB(peakMemoryKB)
+		, resultSizeKB(resultSizeKB)
+	{
+	}
+
+	std::wstring filePath;
+	size_t indexingTimeMS;
+	size_t peakMemoryKB;	// 0 if indexed in a thread of the app
+	size_t resultSizeKB;
+};
+
+#endif	  // STORAGE_INDEXING_COST_H
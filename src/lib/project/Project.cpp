@@ -5,12 +5,17 @@
 #include "DialogView.h"
 #include "IndexerCommand.h"
 #include "IndexerCommandCustom.h"
+#include "IndexerComposite.h"
+#include "IndexingBenchmark.h"
+#include "IntermediateStorage.h"
+#include "LanguagePackageManager.h"
 #include "PersistentStorage.h"
 #include "ProjectSettings.h"
 #include "RefreshInfoGenerator.h"
 #include "SourceGroup.h"
 #include "SourceGroupFactory.h"
 #include "SourceGroupStatusType.h"
+#include "SqliteStorage.h"
 #include "StorageCache.h"
 #include "StorageProvider.h"
 #include "TaskBuildIndex.h"
@@ -22,8 +27,10 @@
 #include "TaskMergeStorages.h"
 #include "TaskParseWrapper.h"
 
+#include "FileInfo.h"
 #include "FilePath.h"
 #include "FileSystem.h"
+#include "FileWatcher.h"
 #include "MessageErrorCountClear.h"
 #include "MessageIndexingFinished.h"
 #include "MessageIndexingShowDialog.h"
@@ -41,6 +48,7 @@
 #include "TaskReturnSuccessIf.h"
 #include "TaskSetValue.h"
 #include "TextAccess.h"
+#include "TimeStamp.h"
 #include "utility.h"
 #include "utilityApp.h"
 #include "utilityFile.h"
@@ -67,6 +75,11 @@ FilePath Project::getProjectSettingsFilePath() const
 	return m_settings->getFilePath();
 }
 
+FilePath Project::getDBFilePath() const
+{
+	return m_settings->getDBFilePath();
+}
+
 std::string Project::getDescription() const
 {
 	return m_settings->getDescription();
@@ -115,6 +128,8 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 		return;
 	}
 
+	m_fileWatcher.reset();
+
 	m_storageCache->clear();
 	m_storageCache->setSubject(
 		std::weak_ptr<StorageAccess>());	// TODO: check if this is really required.
@@ -153,7 +168,7 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 				else
 				{
 					LOG_INFO("Discarding temporary indexing data on user's decision");
-					FileSystem::remove(tempDbPath);
+					SqliteStorage::removeDbFiles(tempDbPath);
 				}
 			}
 			else
@@ -161,7 +176,7 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 				LOG_INFO(
 					"Switching to temporary indexing data because no other persistent data was "
 					"found");
-				FileSystem::rename(tempDbPath, dbPath);
+				SqliteStorage::renameDbFiles(tempDbPath, dbPath);
 			}
 		}
 	}
@@ -224,6 +239,8 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 		m_storage->buildCaches();
 		m_storageCache->setSubject(m_storage);
 
+		startFileWatcher();
+
 		if (m_hasGUI)
 		{
 			MessageIndexingFinished().dispatch();
@@ -430,21 +447,38 @@ void Project::refresh(
 
 RefreshInfo Project::getRefreshInfo(RefreshMode mode) const
 {
+	const TimeStamp start = TimeStamp::now();
+
+	RefreshInfo info;
 	switch (mode)
 	{
 	case REFRESH_NONE:
-		return RefreshInfo();
+		return info;
 
 	case REFRESH_UPDATED_FILES:
-		return RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+		info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+		break;
 
 	case REFRESH_UPDATED_AND_INCOMPLETE_FILES:
-		return RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage);
+		info = RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage);
+		break;
 
 	case REFRESH_ALL_FILES:
 	default:
-		return RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
+		info = RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
+		break;
 	}
+
+	const double duration = TimeStamp::durationSeconds(start);
+	IndexingBenchmark::getInstance()->addPhaseTime("refresh_planning", duration);
+
+	LOG_INFO(
+		"Refresh planning took " + TimeStamp::secondsToString(duration) + ": " +
+		std::to_string(info.filesToIndex.size()) + " files to index, " +
+		std::to_string(info.filesToClear.size() + info.nonIndexedFilesToClear.size()) +
+		" files to clear");
+
+	return info;
 }
 
 void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogView)
@@ -543,26 +577,68 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	const FilePath indexDbFilePath = m_settings->getDBFilePath();
 	const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
 
+	std::shared_ptr<PersistentStorage> tempStorage;
+	bool snapshotRefresh = false;
+
 	if (info.mode != REFRESH_ALL_FILES)
 	{
-		// store the indexed data into the temp db but keep the current state to allow browsing
-		// while indexing
-		FileSystem::copyFile(indexDbFilePath, tempIndexDbFilePath);
+		if (ApplicationSettings::getInstance()->getSnapshotRefreshEnabled())
+		{
+			// write the changes into a single transaction on the index db itself, browsing keeps
+			// reading the last committed state, so the cost only depends on the size of the change
+			tempStorage = std::make_shared<PersistentStorage>(
+				indexDbFilePath, m_storage->getBookmarkDbFilePath());
+			tempStorage->setup();
+			snapshotRefresh = tempStorage->beginRefreshTransaction();
+
+			if (!snapshotRefresh)
+			{
+				LOG_WARNING("Unable to refresh index database in place, falling back to a copy.");
+				tempStorage.reset();
+			}
+		}
+
+		if (!snapshotRefresh)
+		{
+			// store the indexed data into the temp db but keep the current state to allow browsing
+			// while indexing
+			SqliteStorage::copyDbFiles(indexDbFilePath, tempIndexDbFilePath);
+		}
+	}
+
+	if (!tempStorage)
+	{
+		// the temp db gets renamed while the indexing tasks still hold it, so it must not keep
+		// committed data in a write-ahead log next to it
+		tempStorage = std::make_shared<PersistentStorage>(
+			tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
+		tempStorage->disableWriteAheadLog();
+		tempStorage->setup();
 	}
 
-	std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
-		tempIndexDbFilePath, m_storage->getBookmarkDbFilePath());
-	tempStorage->setup();
+	// only needed to finish a snapshot refresh, the temp db is swapped in by its file
+	std::shared_ptr<PersistentStorage> refreshStorage;
+	if (snapshotRefresh)
+	{
+		refreshStorage = tempStorage;
+	}
 
 	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
 
 	if (info.mode != REFRESH_ALL_FILES &&
 		(info.filesToClear.size() || info.nonIndexedFilesToClear.size()))
 	{
+		std::set<FilePath> keptFileNodePaths;
+		for (const auto& p: info.interfaceHashes)
+		{
+			keptFileNodePaths.insert(p.first);
+		}
+
 		taskSequential->addTask(std::make_shared<TaskCleanStorage>(
 			tempStorage,
 			dialogView,
 			utility::toVector(utility::concat(info.filesToClear, info.nonIndexedFilesToClear)),
+			keptFileNodePaths,
 			info.mode == REFRESH_UPDATED_AND_INCOMPLETE_FILES));
 	}
 
@@ -570,6 +646,10 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		TextAccess::createFromFile(getProjectSettingsFilePath())->getText());
 	tempStorage->updateVersion();
 
+	// kept with the indexed data, so the dependents of headers indexed on their own are still
+	// checked by the next refresh if this one stops before its second pass
+	tempStorage->setPendingInterfaceHashes(info.interfaceHashes);
+
 	std::unique_ptr<CombinedIndexerCommandProvider> indexerCommandProvider =
 		std::make_unique<CombinedIndexerCommandProvider>();
 	std::unique_ptr<CombinedIndexerCommandProvider> customIndexerCommandProvider =
@@ -621,7 +701,14 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		const int adjustedIndexerThreadCount = std::min<int>(
 			indexerThreadCount, static_cast<int>(indexerCommandProvider->size()));
 
-		std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+		// most of the memory budget goes to the storages waiting to be merged and injected, the rest
+		// to the results the indexers keep queued until the app picks them up
+		const size_t storageMemoryBudget = static_cast<size_t>(std::max(
+			0, ApplicationSettings::getInstance()->getStorageMemoryBudget())) * 1048576;
+		const size_t indexerQueueByteBudget = storageMemoryBudget / 4;
+
+		std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>(
+			storageMemoryBudget - indexerQueueByteBudget);
 		// add tasks for setting some variables on the blackboard that are used during indexing
 		taskSequential->addTask(
 			std::make_shared<TaskSetValue<bool>>("indexer_threads_started", false));
@@ -642,17 +729,32 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			}
 		}
 
+		// a full refresh fills an empty database, the indices are built once it is complete
 		std::shared_ptr<TaskParseWrapper> taskParserWrapper = std::make_shared<TaskParseWrapper>(
-			tempStorage, dialogView);
+			tempStorage,
+			dialogView,
+			info.mode == REFRESH_ALL_FILES ? SqliteIndexStorage::STORAGE_MODE_BULK_WRITE
+										   : SqliteIndexStorage::STORAGE_MODE_WRITE);
 		taskSequential->addTask(taskParserWrapper);
 
 		std::shared_ptr<TaskGroupParallel> taskParallelIndexing =
 			std::make_shared<TaskGroupParallel>();
 		taskParserWrapper->setTask(taskParallelIndexing);
 
+		// the current database still holds the indexing costs recorded during the previous refresh
+		std::vector<StorageIndexingCost> recordedIndexingCosts;
+		if (!m_storage->isIncompatible())
+		{
+			recordedIndexingCosts = m_storage->getIndexingCosts();
+		}
+
 		// add task for refilling the indexer command queue
 		taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
-			m_appUUID, std::move(indexerCommandProvider), 20));
+			m_appUUID,
+			std::move(indexerCommandProvider),
+			20,
+			recordedIndexingCosts,
+			adjustedIndexerThreadCount));
 
 		// add task for indexing
 		bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() &&
@@ -664,24 +766,34 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			std::make_shared<TaskBuildIndex>(
-				adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess)));
-
-		// add task for merging the intermediate storages
-		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
-			// block until there are indexers running
-			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
-				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
-					"indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
-			// merge until all indexers stopped and nothing left to merge
-			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
-				->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-					std::make_shared<TaskMergeStorages>(storageProvider),
-					std::make_shared<TaskReturnSuccessIf<bool>>(
-						"indexer_threads_stopped",
-						TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
-						false)))));
+				adjustedIndexerThreadCount,
+				storageProvider,
+				dialogView,
+				m_appUUID,
+				multiProcess,
+				indexerQueueByteBudget)));
+
+		// add tasks for merging the intermediate storages in parallel
+		const int mergerCount = std::max(1, adjustedIndexerThreadCount / 4);
+		for (int i = 0; i < mergerCount; i++)
+		{
+			taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+				// block until there are indexers running
+				std::make_shared<TaskDecoratorRepeat>(
+					TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+					->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
+						"indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
+				// merge until all indexers stopped and nothing left to merge, the merge task waits
+				// for new storages itself
+				std::make_shared<TaskDecoratorRepeat>(
+					TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 0)
+					->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+						std::make_shared<TaskMergeStorages>(storageProvider),
+						std::make_shared<TaskReturnSuccessIf<bool>>(
+							"indexer_threads_stopped",
+							TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
+							false)))));
+		}
 
 		// add task for injecting the intermediate storages into the persistent storage
 		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -736,22 +848,96 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("keep_database"),
-			std::make_shared<TaskLambda>([dialogView, this]() {
-				Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([dialogView, this]() {
-								   swapToTempStorage(dialogView);
-							   }));
+			std::make_shared<TaskLambda>([dialogView, refreshStorage, this]() {
+				Task::dispatch(
+					TabId::app(),
+					std::make_shared<TaskLambda>([dialogView, refreshStorage, this]() {
+						if (refreshStorage)
+						{
+							commitRefreshStorage(refreshStorage);
+						}
+						else
+						{
+							swapToTempStorage(dialogView);
+						}
+					}));
 			})),
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("discard_database"),
-			std::make_shared<TaskLambda>([this]() {
+			std::make_shared<TaskLambda>([refreshStorage, this]() {
 				Task::dispatch(
-					TabId::app(), std::make_shared<TaskLambda>([this]() { discardTempStorage(); }));
+					TabId::app(),
+					std::make_shared<TaskLambda>([refreshStorage, this]() {
+						if (refreshStorage)
+						{
+							discardRefreshStorage(refreshStorage);
+						}
+						else
+						{
+							discardTempStorage();
+						}
+					}));
 			}))));
 
-	taskSequential->addTask(std::make_shared<TaskLambda>([dialogView, this]() {
-		m_refreshStage = RefreshStageType::NONE;
-		MessageIndexingFinished().dispatch();
-	}));
+	if (info.interfaceHashes.empty())
+	{
+		taskSequential->addTask(std::make_shared<TaskLambda>([dialogView, this]() {
+			m_refreshStage = RefreshStageType::NONE;
+			MessageIndexingFinished().dispatch();
+		}));
+	}
+	else
+	{
+		// the dependents of the changed headers are only indexed once the new interface hashes of
+		// the headers are stored, so indexing only finishes after that second pass
+		const std::map<FilePath, unsigned long long> interfaceHashes = info.interfaceHashes;
+		const bool shallow = info.shallow;
+
+		taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+			std::make_shared<TaskGroupSequence>()->addChildTasks(
+				std::make_shared<TaskFindKeyOnBlackboard>("refresh_database"),
+				std::make_shared<TaskLambda>([this]() {
+					m_refreshStage = RefreshStageType::NONE;
+					MessageIndexingFinished().dispatch();
+				})),
+			std::make_shared<TaskGroupSequence>()->addChildTasks(
+				std::make_shared<TaskFindKeyOnBlackboard>("keep_database"),
+				std::make_shared<TaskReturnSuccessIf<bool>>(
+					"interrupted_indexing", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false),
+				std::make_shared<TaskLambda>([interfaceHashes, shallow, dialogView, this]() {
+					Task::dispatch(
+						TabId::app(),
+						std::make_shared<TaskLambda>([interfaceHashes, shallow, dialogView, this]() {
+							m_refreshStage = RefreshStageType::NONE;
+
+							RefreshInfo dependentsInfo =
+								RefreshInfoGenerator::getRefreshInfoForChangedInterfaces(
+									m_sourceGroups, m_storage, interfaceHashes);
+							dependentsInfo.shallow = shallow;
+
+							LOG_INFO(
+								"Interface of " + std::to_string(interfaceHashes.size()) +
+								" changed headers checked: " +
+								std::to_string(dependentsInfo.filesToIndex.size()) +
+								" dependent files to index");
+
+							if (dependentsInfo.filesToIndex.empty() &&
+								dependentsInfo.filesToClear.empty())
+							{
+								m_storage->setPendingInterfaceHashes({});
+								MessageIndexingFinished().dispatch();
+							}
+							else
+							{
+								buildIndex(dependentsInfo, dialogView);
+							}
+						}));
+				})),
+			std::make_shared<TaskLambda>([this]() {
+				m_refreshStage = RefreshStageType::NONE;
+				MessageIndexingFinished().dispatch();
+			})));
+	}
 
 	taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -776,13 +962,191 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	MessageIndexingStarted().dispatch();
 }
 
+void Project::refreshWatchedFiles()
+{
+	// the changes stay collected while busy and get refreshed once indexing finished
+	if (!m_fileWatcher || m_refreshStage != RefreshStageType::NONE ||
+		m_state != PROJECT_STATE_LOADED)
+	{
+		return;
+	}
+
+	bool overflowed = false;
+	const std::set<FilePath> changedFilePaths = m_fileWatcher->takeChangedFilePaths(overflowed);
+
+	RefreshInfo info;
+	if (overflowed)
+	{
+		LOG_WARNING("File watcher missed changes, checking all files.");
+		info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+	}
+	else
+	{
+		std::set<FilePath> modifiedFilePaths;
+		for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+		{
+			if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
+			{
+				utility::append(
+					modifiedFilePaths, sourceGroup->filterToContainedFilePaths(changedFilePaths));
+			}
+		}
+
+		if (modifiedFilePaths.empty())
+		{
+			return;
+		}
+
+		info = RefreshInfoGenerator::getRefreshInfoForModifiedFiles(
+			m_sourceGroups, m_storage, modifiedFilePaths);
+	}
+
+	if (info.filesToClear.empty() && info.nonIndexedFilesToClear.empty() &&
+		info.filesToIndex.empty())
+	{
+		return;
+	}
+
+	LOG_INFO(
+		"Refreshing " + std::to_string(changedFilePaths.size()) + " watched files: " +
+		std::to_string(info.filesToIndex.size()) + " files to index");
+
+	buildIndex(info, std::make_shared<DialogView>(DialogView::UseCase::INDEXING, nullptr));
+}
+
+bool Project::hasWatchedFileChanges() const
+{
+	return m_fileWatcher && m_fileWatcher->hasChanges();
+}
+
+bool Project::reindexFile(const FilePath& filePath)
+{
+	if (m_refreshStage != RefreshStageType::NONE)
+	{
+		MessageStatus(L"Cannot re-index file while indexing.", true, false).dispatch();
+		return false;
+	}
+
+	if (m_state != PROJECT_STATE_LOADED)
+	{
+		MessageStatus(
+			L"Cannot re-index file, the project needs to be refreshed first.", true, false)
+			.dispatch();
+		return false;
+	}
+
+	const std::vector<std::shared_ptr<IndexerCommand>> indexerCommands =
+		getIndexerCommandsForFile(filePath);
+	if (indexerCommands.empty())
+	{
+		MessageStatus(
+			L"Cannot re-index file on its own, it is not part of a source group that supports "
+			L"partial clearing: " +
+				filePath.wstr(),
+			true,
+			false)
+			.dispatch();
+		return false;
+	}
+
+	m_refreshStage = RefreshStageType::INDEXING;
+	MessageStatus(L"Re-indexing file: " + filePath.wstr(), false, true).dispatch();
+
+	Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([filePath, indexerCommands, this]() {
+		const TimeStamp start = TimeStamp::now();
+
+		// the indexers are kept, so they only get set up once for all saved files
+		if (!m_indexer)
+		{
+			m_indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
+		}
+
+		// a header is recorded by each source file that includes it, so all of them are indexed
+		// again and all files they record get cleared
+		std::set<FilePath> filesToClear = {filePath};
+		std::vector<std::shared_ptr<IntermediateStorage>> intermediateStorages;
+		for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+		{
+			std::shared_ptr<IntermediateStorage> intermediateStorage = m_indexer->index(
+				indexerCommand);
+			if (!intermediateStorage)
+			{
+				intermediateStorages.clear();
+				break;
+			}
+
+			intermediateStorages.push_back(intermediateStorage);
+			filesToClear.insert(indexerCommand->getSourceFilePath());
+		}
+		utility::append(filesToClear, m_storage->getReferencing({filePath}));
+
+		// the data is replaced through a connection of its own, browsing keeps reading the last
+		// committed state until the storage gets reloaded like after a snapshot refresh
+		bool replaced = false;
+		if (!intermediateStorages.empty())
+		{
+			std::shared_ptr<PersistentStorage> reindexStorage = std::make_shared<PersistentStorage>(
+				m_settings->getDBFilePath(), m_settings->getBookmarkDBFilePath());
+			reindexStorage->setup();
+
+			if (reindexStorage->beginRefreshTransaction())
+			{
+				replaced = reindexStorage->replaceFileElements(filesToClear, intermediateStorages);
+				if (replaced)
+				{
+					reindexStorage->commitRefreshTransaction();
+				}
+				else
+				{
+					reindexStorage->rollbackRefreshTransaction();
+				}
+			}
+			else
+			{
+				LOG_WARNING(
+					"Unable to re-index file, the index database cannot be written in place.");
+			}
+		}
+
+		if (replaced)
+		{
+			reloadStorage();
+			m_storageCache->clear();
+		}
+
+		m_refreshStage = RefreshStageType::NONE;
+
+		if (replaced)
+		{
+			const double duration = TimeStamp::durationSeconds(start);
+			LOG_INFO(
+				L"Re-indexed " + filePath.wstr() + L" with " +
+				std::to_wstring(indexerCommands.size()) + L" source files in " +
+				utility::decodeFromUtf8(TimeStamp::secondsToString(duration)));
+			MessageStatus(
+				L"Re-indexed file: " + filePath.wstr() + L"; " +
+					utility::decodeFromUtf8(TimeStamp::secondsToString(duration)),
+				false,
+				false)
+				.dispatch();
+		}
+		else
+		{
+			MessageStatus(L"Re-indexing file failed: " + filePath.wstr(), true, false).dispatch();
+		}
+
+		MessageIndexingFinished().dispatch();
+	}));
+
+	return true;
+}
+
 void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
 {
 	LOG_INFO("Switching to temporary indexing data");
 
 	const FilePath indexDbFilePath = m_settings->getDBFilePath();
 	const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
-	const FilePath bookmarkDbFilePath = m_settings->getBookmarkDBFilePath();
 
 	m_storage.reset();
 
@@ -792,13 +1156,38 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
 		return;
 	}
 
-	m_storage = std::make_shared<PersistentStorage>(indexDbFilePath, bookmarkDbFilePath);
+	reloadStorage();
+}
+
+void Project::commitRefreshStorage(std::shared_ptr<PersistentStorage> refreshStorage)
+{
+	LOG_INFO("Committing refreshed indexing data");
+
+	refreshStorage->commitRefreshTransaction();
+
+	reloadStorage();
+}
+
+void Project::discardRefreshStorage(std::shared_ptr<PersistentStorage> refreshStorage)
+{
+	LOG_INFO("Discarding refreshed indexing data");
+
+	refreshStorage->rollbackRefreshTransaction();
+}
+
+void Project::reloadStorage()
+{
+	m_storage = std::make_shared<PersistentStorage>(
+		m_settings->getDBFilePath(), m_settings->getBookmarkDBFilePath());
 	m_storage->setup();
 
 	// std::shared_ptr<DialogView> dialogView =
 	// Application::getInstance()->getDialogView(DialogView::UseCase::INDEXING);
 	// dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building caches");
-	m_storage->buildCaches();
+	{
+		IndexingBenchmark::ScopedPhase phase("cache_build");
+		m_storage->buildCaches();
+	}
 	// dialogView->hideUnknownProgressDialog();
 
 	m_storageCache->setSubject(m_storage);
@@ -810,12 +1199,17 @@ bool Project::swapToTempStorageFile(
 	const FilePath& tempIndexDbFilePath,
 	std::shared_ptr<DialogView> dialogView)
 {
+	bool swapped = false;
 	try
 	{
-		FileSystem::remove(indexDbFilePath);
-		FileSystem::rename(tempIndexDbFilePath, indexDbFilePath);
+		swapped = SqliteStorage::removeDbFiles(indexDbFilePath) &&
+			SqliteStorage::renameDbFiles(tempIndexDbFilePath, indexDbFilePath);
 	}
 	catch (std::exception& /*e*/)
+	{
+	}
+
+	if (!swapped)
 	{
 		if (m_hasGUI)
 		{
@@ -837,7 +1231,7 @@ void Project::discardTempStorage()
 	if (tempIndexDbPath.exists())
 	{
 		LOG_INFO("Discarding temporary indexing data");
-		FileSystem::remove(tempIndexDbPath);
+		SqliteStorage::removeDbFiles(tempIndexDbPath);
 	}
 }
 
@@ -857,3 +1251,90 @@ bool Project::hasCxxSourceGroup() const
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 	return false;
 }
+
+std::vector<std::shared_ptr<IndexerCommand>> Project::getIndexerCommandsForFile(
+	const FilePath& filePath) const
+{
+	// headers get indexed through all source files that include them
+	RefreshInfo info;
+	info.mode = REFRESH_UPDATED_FILES;
+	info.filesToIndex = m_storage->getReferencing({filePath});
+	info.filesToIndex.insert(filePath);
+
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	{
+		if (sourceGroup->getStatus() != SOURCE_GROUP_STATUS_ENABLED)
+		{
+			continue;
+		}
+
+		for (const std::shared_ptr<IndexerCommand>& indexerCommand:
+			 sourceGroup->getIndexerCommands(info))
+		{
+			// custom commands run external processes that write into their own database
+			if (!sourceGroup->allowsPartialClearing() ||
+				indexerCommand->getIndexerCommandType() == INDEXER_COMMAND_CUSTOM)
+			{
+				return {};
+			}
+			indexerCommands.push_back(indexerCommand);
+		}
+	}
+
+	return indexerCommands;
+}
+
+void Project::startFileWatcher()
+{
+	m_fileWatcher.reset();
+
+	if (!m_hasGUI || !FileWatcher::isSupported() ||
+		!ApplicationSettings::getInstance()->getFileWatchingEnabled())
+	{
+		return;
+	}
+
+	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	{
+		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED &&
+			!sourceGroup->allowsPartialClearing())
+		{
+			LOG_INFO("Not watching files, the project contains a source group that cannot be "
+					 "partially cleared.");
+			return;
+		}
+	}
+
+	// only the directories of indexed files are watched, new sub directories get added on the fly
+	std::set<FilePath> filePaths;
+	for (const FileInfo& info: m_storage->getFileInfoForAllFiles())
+	{
+		filePaths.insert(info.path);
+	}
+
+	std::set<FilePath> directoryPaths;
+	for (const std::shared_ptr<SourceGroup>& sourceGroup: m_sourceGroups)
+	{
+		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
+		{
+			for (const FilePath& filePath: sourceGroup->filterToContainedFilePaths(filePaths))
+			{
+				directoryPaths.insert(filePath.getParentDirectory());
+			}
+		}
+	}
+
+	m_fileWatcher = std::make_unique<FileWatcher>(
+		ApplicationSettings::getInstance()->getFileWatchingDebounceMilliseconds(),
+		[]() { MessageRefresh().watchedFilesOnly().dispatch(); });
+
+	if (m_fileWatcher->start(directoryPaths))
+	{
+		LOG_INFO("Watching " + std::to_string(directoryPaths.size()) + " directories for changes");
+	}
+	else
+	{
+		m_fileWatcher.reset();
+	}
+}
@@ -12,6 +12,9 @@
 struct FileInfo;
 class DialogView;
 class FilePath;
+class FileWatcher;
+class IndexerCommand;
+class IndexerComposite;
 class PersistentStorage;
 class ProjectSettings;
 class StorageCache;
@@ -27,6 +30,7 @@ public:
 	virtual ~Project();
 
 	FilePath getProjectSettingsFilePath() const;
+	FilePath getDBFilePath() const;
 	std::string getDescription() const;
 
 	bool isLoaded() const;
@@ -44,6 +48,14 @@ public:
 
 	void buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogView);
 
+	// refreshes the files changed since the last call without showing any dialogs
+	void refreshWatchedFiles();
+	bool hasWatchedFileChanges() const;
+
+	// indexes the translation units of the file in this process and writes the result into the
+	// loaded storage in a background task, returns false if the file cannot be indexed on its own
+	bool reindexFile(const FilePath& filePath);
+
 private:
 	enum ProjectStateType
 	{
@@ -71,9 +83,18 @@ private:
 		const FilePath& tempIndexDbFilePath,
 		std::shared_ptr<DialogView> dialogView);
 	void discardTempStorage();
+	void commitRefreshStorage(std::shared_ptr<PersistentStorage> refreshStorage);
+	void discardRefreshStorage(std::shared_ptr<PersistentStorage> refreshStorage);
+	void reloadStorage();
 
 	bool hasCxxSourceGroup() const;
 
+	void startFileWatcher();
+
+	// returns no commands if one of the files cannot be indexed on its own
+	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommandsForFile(
+		const FilePath& filePath) const;
+
 	std::shared_ptr<ProjectSettings> m_settings;
 	StorageCache* const m_storageCache;
 
@@ -83,6 +104,9 @@ private:
 	std::shared_ptr<PersistentStorage> m_storage;
 	std::vector<std::shared_ptr<SourceGroup>> m_sourceGroups;
 
+	std::unique_ptr<FileWatcher> m_fileWatcher;
+	std::shared_ptr<IndexerComposite> m_indexer;
+
 	std::string m_appUUID;
 	bool m_hasGUI;
 };
@@ -1,6 +1,7 @@
 #ifndef REFRESH_INFO_H
 #define REFRESH_INFO_H
 
+#include <map>
 #include <set>
 
 #include "FilePath.h"
@@ -19,6 +20,10 @@ struct RefreshInfo
 	std::set<FilePath> filesToClear;
 	std::set<FilePath> nonIndexedFilesToClear;
 
+	// changed headers that get indexed again without their dependents, mapped to their previous
+	// interface hash. their file nodes are kept, the dependents follow if the interface changed.
+	std::map<FilePath, unsigned long long> interfaceHashes;
+
 	RefreshMode mode = REFRESH_NONE;
 	bool shallow = false;
 };
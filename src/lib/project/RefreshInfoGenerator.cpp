@@ -1,13 +1,18 @@
 #include "RefreshInfoGenerator.h"
 
+#include <mutex>
+#include <thread>
+
+#include "ApplicationSettings.h"
+#include "FileFingerprint.h"
 #include "FileInfo.h"
 #include "FileSystem.h"
 #include "PersistentStorage.h"
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
-#include "TextAccess.h"
 #include "utility.h"
+#include "utilityApp.h"
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
@@ -22,64 +27,280 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	{
 		const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
 
-		std::set<FilePath> alreadyKnownPaths;
+		// checking source and header files
+		checkFilesFromStorage(
+			fileInfosFromStorage,
+			getAlreadyKnownFilePaths(sourceGroups, fileInfosFromStorage),
+			storage,
+			unchangedIndexedFilePaths,
+			unchangedNonindexedFilePaths,
+			changedFilePaths);
+	}
+
+	return getRefreshInfoForChangedFiles(
+		changedFilePaths, unchangedIndexedFilePaths, getAllSourceFilePaths(sourceGroups), storage);
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForModifiedFiles(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage,
+	const std::set<FilePath>& modifiedFilePaths)
+{
+	// 1) Only the modified files are checked, all other files known by the storage are unchanged
+	std::set<FilePath> unchangedIndexedFilePaths;
+	std::set<FilePath> unchangedNonindexedFilePaths;
+	std::set<FilePath> changedFilePaths;
+
+	{
+		std::vector<FileInfo> modifiedFileInfosFromStorage;
+		for (const FileInfo& info: storage->getFileInfoForAllFiles())
 		{
-			const std::set<FilePath> filePathsFromStorage = utility::toSet(
-				utility::convert<FileInfo, FilePath>(
-					fileInfosFromStorage, [](const FileInfo& info) { return info.path; }));
+			if (modifiedFilePaths.find(info.path) != modifiedFilePaths.end())
+			{
+				modifiedFileInfosFromStorage.push_back(info);
+			}
+			else if (storage->getFilePathIndexed(info.path))
+			{
+				unchangedIndexedFilePaths.insert(info.path);
+			}
+			else
+			{
+				unchangedNonindexedFilePaths.insert(info.path);
+			}
+		}
+
+		checkFilesFromStorage(
+			modifiedFileInfosFromStorage,
+			getAlreadyKnownFilePaths(sourceGroups, modifiedFileInfosFromStorage),
+			storage,
+			unchangedIndexedFilePaths,
+			unchangedNonindexedFilePaths,
+			changedFilePaths);
+	}
+
+	return getRefreshInfoForChangedFiles(
+		changedFilePaths, unchangedIndexedFilePaths, getAllSourceFilePaths(sourceGroups), storage);
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForChangedInterfaces(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage,
+	const std::map<FilePath, unsigned long long>& previousInterfaceHashes)
+{
+	const std::set<FilePath> changedInterfaceFilePaths = getChangedInterfaceFilePaths(
+		previousInterfaceHashes, storage->getInterfaceHashesForAllFiles());
 
-			for (std::shared_ptr<SourceGroup> sourceGroup: sourceGroups)
+	if (changedInterfaceFilePaths.empty())
+	{
+		RefreshInfo info;
+		info.mode = REFRESH_UPDATED_FILES;
+		return info;
+	}
+
+	const std::set<FilePath> allSourceFilePathsFromSourcegroups = getAllSourceFilePaths(sourceGroups);
+
+	// all other files are up to date, so only the cleared source files need to be indexed
+	RefreshInfo info = getRefreshInfoForClearedFiles(
+		storage->getReferencing(changedInterfaceFilePaths),
+		allSourceFilePathsFromSourcegroups,
+		allSourceFilePathsFromSourcegroups,
+		storage);
+	info.mode = REFRESH_UPDATED_FILES;
+
+	// the changed headers themselves have just been indexed
+	for (const FilePath& path: changedInterfaceFilePaths)
+	{
+		info.filesToClear.erase(path);
+		info.nonIndexedFilesToClear.erase(path);
+	}
+
+	return info;
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+	std::shared_ptr<const PersistentStorage> storage)
+{
+	RefreshInfo info = getRefreshInfoForUpdatedFiles(sourceGroups, storage);
+	info.mode = REFRESH_UPDATED_AND_INCOMPLETE_FILES;
+
+	std::set<FilePath> incompleteFiles;
+	{
+		const std::set<FilePath> filesToClear = utility::concat(
+			info.filesToClear, info.nonIndexedFilesToClear);
+		for (const FilePath& path: storage->getIncompleteFiles())
+		{
+			if (filesToClear.find(path) == filesToClear.end())
 			{
-				if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
-				{
-					utility::append(
-						alreadyKnownPaths,
-						sourceGroup->filterToContainedFilePaths(filePathsFromStorage));
-				}
+				incompleteFiles.insert(path);
 			}
 		}
+	}
 
-		// checking source and header files
-		for (const FileInfo& info: fileInfosFromStorage)
+	if (!incompleteFiles.empty())
+	{
+		utility::append(incompleteFiles, storage->getReferencing(incompleteFiles));
+
+		std::set<FilePath> staticSourceFilePaths = getAllSourceFilePaths(sourceGroups);
+		for (const FilePath& path: incompleteFiles)
 		{
-			if (alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && info.path.exists())
+			staticSourceFilePaths.erase(path);
+
+			if (storage->getFilePathIndexed(path))
 			{
-				if (storage->getFilePathIndexed(info.path))
-				{
-					if (didFileChange(info, storage))
-					{
-						changedFilePaths.insert(info.path);
-					}
-					else
-					{
-						unchangedIndexedFilePaths.insert(info.path);
-					}
-				}
-				else
-				{
-					changedFilePaths.insert(info.path);
-				}
+				info.filesToClear.insert(path);
 			}
-			else if (!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage))
+			else
 			{
-				unchangedNonindexedFilePaths.insert(info.path);
+				info.nonIndexedFilesToClear.insert(path);
 			}
-			else	// file has been removed
+		}
+
+		for (const std::shared_ptr<const SourceGroup>& sourceGroup: sourceGroups)
+		{
+			if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
 			{
-				changedFilePaths.insert(info.path);
+				utility::append(
+					info.filesToIndex,
+					sourceGroup->filterToContainedSourceFilePath(staticSourceFilePaths));
 			}
 		}
 	}
 
-	const std::set<FilePath> allSourceFilePathsFromSourcegroups = getAllSourceFilePaths(sourceGroups);
+	return info;
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForAllFiles(
+	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups)
+{
+	RefreshInfo info;
+	info.mode = REFRESH_ALL_FILES;
+	info.filesToIndex = getAllSourceFilePaths(sourceGroups);
+	return info;
+}
 
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForChangedFiles(
+	const std::set<FilePath>& changedFilePaths,
+	const std::set<FilePath>& unchangedIndexedFilePaths,
+	const std::set<FilePath>& allSourceFilePathsFromSourcegroups,
+	std::shared_ptr<const PersistentStorage> storage)
+{
 	// 2) Figure out which files need to be cleared
-	// 2.1) Add all changed files
-	std::set<FilePath> filesToClear = changedFilePaths;
+	// 2.1) Add all changed files. If enabled, changed headers with a recorded interface hash are
+	// only indexed again on their own for now, their dependents follow once the new interface hash
+	// is known.
+	std::set<FilePath> filesToClear;
+	std::map<FilePath, unsigned long long> interfaceHashes;
+	std::set<FilePath> pendingInterfaceFilePaths;
+	{
+		const bool interfaceHashRefresh =
+			ApplicationSettings::getInstance()->getInterfaceHashRefreshEnabled();
+		const std::map<FilePath, unsigned long long> storedInterfaceHashes =
+			storage->getInterfaceHashesForAllFiles();
+		std::map<FilePath, unsigned long long> pendingInterfaceHashes =
+			storage->getPendingInterfaceHashes();
+
+		for (const FilePath& path: changedFilePaths)
+		{
+			auto it = storedInterfaceHashes.find(path);
+			if (interfaceHashRefresh && it != storedInterfaceHashes.end() &&
+				allSourceFilePathsFromSourcegroups.find(path) ==
+					allSourceFilePathsFromSourcegroups.end() &&
+				path.exists())
+			{
+				// the dependents of a pending header still match its interface before that refresh
+				auto pendingIt = pendingInterfaceHashes.find(path);
+				interfaceHashes.emplace(
+					path,
+					pendingIt != pendingInterfaceHashes.end() ? pendingIt->second : it->second);
+			}
+			else
+			{
+				filesToClear.insert(path);
+			}
+			pendingInterfaceHashes.erase(path);
+		}
+
+		// 2.1.1) Headers that an earlier refresh indexed on their own, without getting to check
+		// their dependents, e.g. because it got interrupted
+		pendingInterfaceFilePaths = getChangedInterfaceFilePaths(
+			pendingInterfaceHashes, storedInterfaceHashes);
+	}
 
-	// 2.2) Add files that are reference the changed files
-	utility::append(filesToClear, storage->getReferencing(changedFilePaths));
+	// 2.2) Add files that are reference the changed files or the headers with pending dependents
+	utility::append(filesToClear, storage->getReferencing(filesToClear));
+	utility::append(filesToClear, storage->getReferencing(pendingInterfaceFilePaths));
 
+	// 2.2.1) Headers are indexed while indexing a source file that includes them, so each changed
+	// header needs one such source file to be cleared as well
+	for (auto it = interfaceHashes.begin(); it != interfaceHashes.end();)
+	{
+		// the dependents are cleared anyways if the header depends on another changed file
+		if (filesToClear.find(it->first) != filesToClear.end())
+		{
+			it = interfaceHashes.erase(it);
+			continue;
+		}
+
+		const std::set<FilePath> referencingFilePaths = storage->getReferencing({it->first});
+
+		FilePath referencingSourceFilePath;
+		for (const FilePath& path: referencingFilePaths)
+		{
+			if (allSourceFilePathsFromSourcegroups.find(path) !=
+				allSourceFilePathsFromSourcegroups.end())
+			{
+				referencingSourceFilePath = path;
+				if (filesToClear.find(path) != filesToClear.end())
+				{
+					break;
+				}
+			}
+		}
+
+		if (referencingSourceFilePath.empty())
+		{
+			filesToClear.insert(it->first);
+			utility::append(filesToClear, referencingFilePaths);
+			it = interfaceHashes.erase(it);
+			continue;
+		}
+
+		filesToClear.insert(referencingSourceFilePath);
+		filesToClear.insert(it->first);
+		it++;
+	}
+
+	RefreshInfo info = getRefreshInfoForClearedFiles(
+		filesToClear, allSourceFilePathsFromSourcegroups, unchangedIndexedFilePaths, storage);
+	info.mode = REFRESH_UPDATED_FILES;
+	info.interfaceHashes = interfaceHashes;
+	return info;
+}
+
+std::set<FilePath> RefreshInfoGenerator::getChangedInterfaceFilePaths(
+	const std::map<FilePath, unsigned long long>& previousInterfaceHashes,
+	const std::map<FilePath, unsigned long long>& interfaceHashes)
+{
+	// a header without a new interface hash was not recorded, so it counts as changed as well
+	std::set<FilePath> changedInterfaceFilePaths;
+	for (const auto& p: previousInterfaceHashes)
+	{
+		auto it = interfaceHashes.find(p.first);
+		if (it == interfaceHashes.end() || it->second != p.second)
+		{
+			changedInterfaceFilePaths.insert(p.first);
+		}
+	}
+	return changedInterfaceFilePaths;
+}
+
+RefreshInfo RefreshInfoGenerator::getRefreshInfoForClearedFiles(
+	std::set<FilePath> filesToClear,
+	const std::set<FilePath>& allSourceFilePathsFromSourcegroups,
+	const std::set<FilePath>& unchangedIndexedFilePaths,
+	std::shared_ptr<const PersistentStorage> storage)
+{
 	// 2.3) Handle files that are referenced by the files that will be cleared. These will be
 	// re-indexed on the fly. However, we do not
 	//		need to clear files that are also referenced by unchanged source files, because
@@ -129,7 +350,6 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 
 	// 4) Store and return this information
 	RefreshInfo info;
-	info.mode = REFRESH_UPDATED_FILES;
 	info.filesToIndex = filesToIndex;
 	for (const FilePath fileToClear: filesToClear)
 	{
@@ -146,66 +366,23 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	return info;
 }
 
-RefreshInfo RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(
+std::set<FilePath> RefreshInfoGenerator::getAlreadyKnownFilePaths(
 	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
-	std::shared_ptr<const PersistentStorage> storage)
+	const std::vector<FileInfo>& fileInfosFromStorage)
 {
-	RefreshInfo info = getRefreshInfoForUpdatedFiles(sourceGroups, storage);
-	info.mode = REFRESH_UPDATED_AND_INCOMPLETE_FILES;
-
-	std::set<FilePath> incompleteFiles;
-	{
-		const std::set<FilePath> filesToClear = utility::concat(
-			info.filesToClear, info.nonIndexedFilesToClear);
-		for (const FilePath& path: storage->getIncompleteFiles())
-		{
-			if (filesToClear.find(path) == filesToClear.end())
-			{
-				incompleteFiles.insert(path);
-			}
-		}
-	}
+	const std::set<FilePath> filePathsFromStorage = utility::toSet(utility::convert<FileInfo, FilePath>(
+		fileInfosFromStorage, [](const FileInfo& info) { return info.path; }));
 
-	if (!incompleteFiles.empty())
+	std::set<FilePath> alreadyKnownPaths;
+	for (std::shared_ptr<SourceGroup> sourceGroup: sourceGroups)
 	{
-		utility::append(incompleteFiles, storage->getReferencing(incompleteFiles));
-
-		std::set<FilePath> staticSourceFilePaths = getAllSourceFilePaths(sourceGroups);
-		for (const FilePath& path: incompleteFiles)
-		{
-			staticSourceFilePaths.erase(path);
-
-			if (storage->getFilePathIndexed(path))
-			{
-				info.filesToClear.insert(path);
-			}
-			else
-			{
-				info.nonIndexedFilesToClear.insert(path);
-			}
-		}
-
-		for (const std::shared_ptr<const SourceGroup>& sourceGroup: sourceGroups)
+		if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
 		{
-			if (sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED)
-			{
-				utility::append(
-					info.filesToIndex,
-					sourceGroup->filterToContainedSourceFilePath(staticSourceFilePaths));
-			}
+			utility::append(
+				alreadyKnownPaths, sourceGroup->filterToContainedFilePaths(filePathsFromStorage));
 		}
 	}
-
-	return info;
-}
-
-RefreshInfo RefreshInfoGenerator::getRefreshInfoForAllFiles(
-	const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups)
-{
-	RefreshInfo info;
-	info.mode = REFRESH_ALL_FILES;
-	info.filesToIndex = getAllSourceFilePaths(sourceGroups);
-	return info;
+	return alreadyKnownPaths;
 }
 
 std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
@@ -230,36 +407,92 @@ std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(
 	return allSourceFilePaths;
 }
 
-bool RefreshInfoGenerator::didFileChange(
-	const FileInfo& info, std::shared_ptr<const PersistentStorage> storage)
+void RefreshInfoGenerator::checkFilesFromStorage(
+	const std::vector<FileInfo>& fileInfosFromStorage,
+	const std::set<FilePath>& alreadyKnownPaths,
+	std::shared_ptr<const PersistentStorage> storage,
+	std::set<FilePath>& unchangedIndexedFilePaths,
+	std::set<FilePath>& unchangedNonindexedFilePaths,
+	std::set<FilePath>& changedFilePaths)
 {
-	FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
-	if (diskFileInfo.lastWriteTime > info.lastWriteTime)
+	const std::map<FilePath, FileFingerprint> storedFingerprints =
+		storage->getFileFingerprintsForAllFiles();
+
+	std::mutex filePathsMutex;
+
+	// the files are checked on all cores, because each of them needs at least one stat call and
+	// touched files need to be hashed
+	std::vector<std::shared_ptr<std::thread>> threads;
+	for (const std::vector<FileInfo>& part:
+		 utility::splitToEqualySizedParts(fileInfosFromStorage, utility::getIdealThreadCount()))
 	{
-		if (!storage->hasContentForFile(info.path))
-		{
-			return true;
-		}
+		threads.push_back(std::make_shared<std::thread>(
+			[&](const std::vector<FileInfo>& infos) {
+				std::set<FilePath> unchangedIndexed;
+				std::set<FilePath> unchangedNonindexed;
+				std::set<FilePath> changed;
+
+				for (const FileInfo& info: infos)
+				{
+					const FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
+					const bool indexed = storage->getFilePathIndexed(info.path);
+
+					auto it = storedFingerprints.find(info.path);
+					auto didChange = [&]() {
+						return didFileChange(
+							info,
+							diskFileInfo,
+							it != storedFingerprints.end() ? it->second : FileFingerprint());
+					};
 
-		std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-		std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
+					if (alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() &&
+						!diskFileInfo.path.empty())
+					{
+						if (indexed && !didChange())
+						{
+							unchangedIndexed.insert(info.path);
+						}
+						else
+						{
+							changed.insert(info.path);
+						}
+					}
+					else if (!indexed && !didChange())
+					{
+						unchangedNonindexed.insert(info.path);
+					}
+					else	// file has been removed
+					{
+						changed.insert(info.path);
+					}
+				}
 
-		const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-		const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
+				std::lock_guard<std::mutex> lock(filePathsMutex);
+				utility::append(unchangedIndexedFilePaths, unchangedIndexed);
+				utility::append(unchangedNonindexedFilePaths, unchangedNonindexed);
+				utility::append(changedFilePaths, changed);
+			},
+			part));
+	}
+	for (std::shared_ptr<std::thread> thread: threads)
+	{
+		thread->join();
+	}
+}
 
-		if (diskFileLines.size() != storedFileLines.size())
+bool RefreshInfoGenerator::didFileChange(
+	const FileInfo& info, const FileInfo& diskFileInfo, const FileFingerprint& storedFingerprint)
+{
+	if (diskFileInfo.lastWriteTime > info.lastWriteTime)
+	{
+		// a touched file only gets read if its size still matches the stored one
+		if (!storedFingerprint.isValid() ||
+			FileSystem::getFileByteSize(diskFileInfo.path) != storedFingerprint.getSize())
 		{
 			return true;
 		}
 
-		for (size_t i = 0; i < diskFileLines.size(); i++)
-		{
-			if (diskFileLines[i] != storedFileLines[i])
-			{
-				return true;
-			}
-		}
-		return false;
+		return FileFingerprint::fromFile(diskFileInfo.path) != storedFingerprint;
 	}
 	return false;
 }
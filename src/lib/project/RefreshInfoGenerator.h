@@ -1,10 +1,12 @@
 #ifndef REFRESH_INFO_GENERATOR_H
 #define REFRESH_INFO_GENERATOR_H
 
+#include <map>
 #include <memory>
 #include <set>
 #include <vector>
 
+class FileFingerprint;
 struct FileInfo;
 class FilePath;
 class PersistentStorage;
@@ -18,6 +20,19 @@ public:
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
 		std::shared_ptr<const PersistentStorage> storage);
 
+	// only checks the given files, all other files known by the storage are considered unchanged
+	static RefreshInfo getRefreshInfoForModifiedFiles(
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage,
+		const std::set<FilePath>& modifiedFilePaths);
+
+	// dependents of the headers whose interface hash differs from the previous one after indexing
+	// them on their own
+	static RefreshInfo getRefreshInfoForChangedInterfaces(
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		std::shared_ptr<const PersistentStorage> storage,
+		const std::map<FilePath, unsigned long long>& previousInterfaceHashes);
+
 	static RefreshInfo getRefreshInfoForIncompleteFiles(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
 		std::shared_ptr<const PersistentStorage> storage);
@@ -26,10 +41,39 @@ public:
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
 private:
+	static RefreshInfo getRefreshInfoForChangedFiles(
+		const std::set<FilePath>& changedFilePaths,
+		const std::set<FilePath>& unchangedIndexedFilePaths,
+		const std::set<FilePath>& allSourceFilePathsFromSourcegroups,
+		std::shared_ptr<const PersistentStorage> storage);
+
+	static std::set<FilePath> getChangedInterfaceFilePaths(
+		const std::map<FilePath, unsigned long long>& previousInterfaceHashes,
+		const std::map<FilePath, unsigned long long>& interfaceHashes);
+
+	static RefreshInfo getRefreshInfoForClearedFiles(
+		std::set<FilePath> filesToClear,
+		const std::set<FilePath>& allSourceFilePathsFromSourcegroups,
+		const std::set<FilePath>& unchangedIndexedFilePaths,
+		std::shared_ptr<const PersistentStorage> storage);
+
+	static std::set<FilePath> getAlreadyKnownFilePaths(
+		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+		const std::vector<FileInfo>& fileInfosFromStorage);
+
 	static std::set<FilePath> getAllSourceFilePaths(
 		const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
-	static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+	static void checkFilesFromStorage(
+		const std::vector<FileInfo>& fileInfosFromStorage,
+		const std::set<FilePath>& alreadyKnownPaths,
+		std::shared_ptr<const PersistentStorage> storage,
+		std::set<FilePath>& unchangedIndexedFilePaths,
+		std::set<FilePath>& unchangedNonindexedFilePaths,
+		std::set<FilePath>& changedFilePaths);
+
+	static bool didFileChange(
+		const FileInfo& info, const FileInfo& diskFileInfo, const FileFingerprint& storedFingerprint);
 };
 
 #endif	  // REFRESH_INFO_GENERATOR_H
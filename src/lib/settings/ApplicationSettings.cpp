@@ -389,6 +389,126 @@ void ApplicationSettings::setMultiProcessIndexingEnabled(bool enabled)
 	setValue<bool>("indexing/multi_process_indexing", enabled);
 }
 
+int ApplicationSettings::getIndexerProcessMaximumTranslationUnitCount() const
+{
+	return getValue<int>("indexing/indexer_process_maximum_translation_unit_count", 0);
+}
+
+void ApplicationSettings::setIndexerProcessMaximumTranslationUnitCount(int count)
+{
+	setValue<int>("indexing/indexer_process_maximum_translation_unit_count", count);
+}
+
+int ApplicationSettings::getIndexerProcessMaximumMemory() const
+{
+	return getValue<int>("indexing/indexer_process_maximum_memory", 4096);
+}
+
+void ApplicationSettings::setIndexerProcessMaximumMemory(int size)
+{
+	setValue<int>("indexing/indexer_process_maximum_memory", size);
+}
+
+int ApplicationSettings::getStorageMemoryBudget() const
+{
+	return getValue<int>("indexing/storage_memory_budget", 2048);
+}
+
+void ApplicationSettings::setStorageMemoryBudget(int size)
+{
+	setValue<int>("indexing/storage_memory_budget", size);
+}
+
+bool ApplicationSettings::getSharedHeaderIndexingEnabled() const
+{
+	return getValue<bool>("indexing/shared_header_indexing", false);
+}
+
+void ApplicationSettings::setSharedHeaderIndexingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/shared_header_indexing", enabled);
+}
+
+bool ApplicationSettings::getSnapshotRefreshEnabled() const
+{
+	return getValue<bool>("indexing/snapshot_refresh", true);
+}
+
+void ApplicationSettings::setSnapshotRefreshEnabled(bool enabled)
+{
+	setValue<bool>("indexing/snapshot_refresh", enabled);
+}
+
+bool ApplicationSettings::getInterfaceHashRefreshEnabled() const
+{
+	return getValue<bool>("indexing/interface_hash_refresh", false);
+}
+
+void ApplicationSettings::setInterfaceHashRefreshEnabled(bool enabled)
+{
+	setValue<bool>("indexing/interface_hash_refresh", enabled);
+}
+
+bool ApplicationSettings::getFileWatchingEnabled() const
+{
+	return getValue<bool>("indexing/file_watching", false);
+}
+
+void ApplicationSettings::setFileWatchingEnabled(bool enabled)
+{
+	setValue<bool>("indexing/file_watching", enabled);
+}
+
+int ApplicationSettings::getFileWatchingDebounceMilliseconds() const
+{
+	return getValue<int>("indexing/file_watching_debounce_ms", 1000);
+}
+
+void ApplicationSettings::setFileWatchingDebounceMilliseconds(int milliseconds)
+{
+	setValue<int>("indexing/file_watching_debounce_ms", milliseconds);
+}
+
+SqliteStorageProfile ApplicationSettings::getStorageProfile(SqliteStorageProfileType type) const
+{
+	const std::string key = "storage/" + sqliteStorageProfileTypeToString(type) + "/";
+	const SqliteStorageProfile defaultProfile = SqliteStorageProfile::getDefault(type);
+
+	SqliteStorageProfile profile;
+	profile.journalMode = getValue<std::string>(key + "journal_mode", defaultProfile.journalMode);
+	profile.synchronous = getValue<std::string>(key + "synchronous", defaultProfile.synchronous);
+	profile.cacheSizeKB = getValue<int>(key + "cache_size_kb", defaultProfile.cacheSizeKB);
+	profile.mmapSizeMB = getValue<int>(key + "mmap_size_mb", defaultProfile.mmapSizeMB);
+	profile.tempStore = getValue<std::string>(key + "temp_store", defaultProfile.tempStore);
+	profile.pageSize = getValue<int>(key + "page_size", defaultProfile.pageSize);
+	return profile;
+}
+
+void ApplicationSettings::setStorageProfile(
+	SqliteStorageProfileType type, const SqliteStorageProfile& profile)
+{
+	const std::string key = "storage/" + sqliteStorageProfileTypeToString(type) + "/";
+
+	setValue<std::string>(key + "journal_mode", profile.journalMode);
+	setValue<std::string>(key + "synchronous", profile.synchronous);
+	setValue<int>(key + "cache_size_kb", profile.cacheSizeKB);
+	setValue<int>(key + "mmap_size_mb", profile.mmapSizeMB);
+	setValue<std::string>(key + "temp_store", profile.tempStore);
+	setValue<int>(key + "page_size", profile.pageSize);
+}
+
+SqliteStorageProfileType ApplicationSettings::getStorageBrowseProfileType() const
+{
+	return stringToSqliteStorageProfileType(getValue<std::string>(
+		"storage/browse_profile",
+		sqliteStorageProfileTypeToString(SqliteStorageProfileType::INTERACTIVE)));
+}
+
+void ApplicationSettings::setStorageBrowseProfileType(SqliteStorageProfileType type)
+{
+	setValue<std::string>("storage/browse_profile", sqliteStorageProfileTypeToString(type));
+}
+
 FilePath ApplicationSettings::getJavaPath() const
 {
 	return FilePath(getValue<std::wstring>("indexing/java/java_path", L""));
@@ -5,6 +5,7 @@
 
 #include "GroupType.h"
 #include "Settings.h"
+#include "SqliteStorageProfile.h"
 
 class TimeStamp;
 class Version;
@@ -98,6 +99,39 @@ public:
 	bool getMultiProcessIndexingEnabled() const;
 	void setMultiProcessIndexingEnabled(bool enabled);
 
+	int getIndexerProcessMaximumTranslationUnitCount() const;
+	void setIndexerProcessMaximumTranslationUnitCount(int count);
+
+	int getIndexerProcessMaximumMemory() const;
+	void setIndexerProcessMaximumMemory(int size);
+
+	// megabytes the indexing results may take while waiting to be merged and injected
+	int getStorageMemoryBudget() const;
+	void setStorageMemoryBudget(int size);
+
+	bool getSharedHeaderIndexingEnabled() const;
+	void setSharedHeaderIndexingEnabled(bool enabled);
+
+	bool getSnapshotRefreshEnabled() const;
+	void setSnapshotRefreshEnabled(bool enabled);
+
+	// dependents of a changed header are only indexed again if its interface hash changed
+	bool getInterfaceHashRefreshEnabled() const;
+	void setInterfaceHashRefreshEnabled(bool enabled);
+
+	bool getFileWatchingEnabled() const;
+	void setFileWatchingEnabled(bool enabled);
+
+	int getFileWatchingDebounceMilliseconds() const;
+	void setFileWatchingDebounceMilliseconds(int milliseconds);
+
+	// database settings used while indexing results are injected and while browsing the project
+	SqliteStorageProfile getStorageProfile(SqliteStorageProfileType type) const;
+	void setStorageProfile(SqliteStorageProfileType type, const SqliteStorageProfile& profile);
+
+	SqliteStorageProfileType getStorageBrowseProfileType() const;
+	void setStorageBrowseProfileType(SqliteStorageProfileType type);
+
 	FilePath getJavaPath() const;
 	void setJavaPath(const FilePath& path);
 
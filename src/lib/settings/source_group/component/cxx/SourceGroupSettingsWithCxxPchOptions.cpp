@@ -33,7 +33,8 @@ bool SourceGroupSettingsWithCxxPchOptions::equals(const SourceGroupSettingsBase*
 	return (
 		otherPtr && m_pchInputFilePath == otherPtr->m_pchInputFilePath &&
 		utility::isPermutation(m_pchFlags, otherPtr->m_pchFlags) &&
-		m_useCompilerFlags == otherPtr->m_useCompilerFlags);
+		m_useCompilerFlags == otherPtr->m_useCompilerFlags &&
+		m_useAutomaticPch == otherPtr->m_useAutomaticPch);
 }
 
 void SourceGroupSettingsWithCxxPchOptions::load(const ConfigManager* config, const std::string& key)
@@ -42,6 +43,7 @@ void SourceGroupSettingsWithCxxPchOptions::load(const ConfigManager* config, con
 		config->getValueOrDefault(key + "/pch_input_file_path", FilePath(L"")));
 	setPchFlags(config->getValuesOrDefaults(key + "/pch_flags/pch_flag", std::vector<std::wstring>()));
 	setUseCompilerFlags(config->getValueOrDefault(key + "/pch_flags/use_compiler_flags", false));
+	setUseAutomaticPch(config->getValueOrDefault(key + "/use_automatic_pch", false));
 }
 
 void SourceGroupSettingsWithCxxPchOptions::save(ConfigManager* config, const std::string& key)
@@ -49,6 +51,7 @@ void SourceGroupSettingsWithCxxPchOptions::save(ConfigManager* config, const std
 	config->setValue(key + "/pch_input_file_path", getPchInputFilePath().wstr());
 	config->setValues(key + "/pch_flags/pch_flag", getPchFlags());
 	config->setValue(key + "/pch_flags/use_compiler_flags", getUseCompilerFlags());
+	config->setValue(key + "/use_automatic_pch", getUseAutomaticPch());
 }
 
 bool SourceGroupSettingsWithCxxPchOptions::getUseCompilerFlags() const
@@ -61,6 +64,16 @@ void SourceGroupSettingsWithCxxPchOptions::setUseCompilerFlags(bool useCompilerF
 	m_useCompilerFlags = useCompilerFlags;
 }
 
+bool SourceGroupSettingsWithCxxPchOptions::getUseAutomaticPch() const
+{
+	return m_useAutomaticPch;
+}
+
+void SourceGroupSettingsWithCxxPchOptions::setUseAutomaticPch(bool useAutomaticPch)
+{
+	m_useAutomaticPch = useAutomaticPch;
+}
+
 std::vector<std::wstring> SourceGroupSettingsWithCxxPchOptions::getPchFlags() const
 {
 	return m_pchFlags;
@@ -21,6 +21,11 @@ public:
 	bool getUseCompilerFlags() const;
 	void setUseCompilerFlags(bool useCompilerFlags);
 
+	// generate a precompiled header for the includes shared by most source files if no precompiled
+	// header input file is set
+	bool getUseAutomaticPch() const;
+	void setUseAutomaticPch(bool useAutomaticPch);
+
 protected:
 	bool equals(const SourceGroupSettingsBase* other) const override;
 
@@ -31,6 +36,7 @@ private:
 	FilePath m_pchInputFilePath;
 	std::vector<std::wstring> m_pchFlags;
 	bool m_useCompilerFlags = true;
+	bool m_useAutomaticPch = false;
 };
 
 #endif	  // SOURCE_GROUP_SETTINGS_WITH_CXX_PCH_OPTIONS_H
@@ -0,0 +1,126 @@
+#ifndef HASH_INDEX_H
+#define HASH_INDEX_H
+
+#include <cstdint>
+#include <vector>
+
+// open addressing hash table that maps hashes to positions in a separately stored vector. the
+// elements are not copied into the index, so each key is kept in memory only once and inserting
+// does not allocate apart from the occasional growth of the slot array.
+class HashIndex
+{
+public:
+	static const size_t s_notFound = static_cast<size_t>(-1);
+
+	static size_t combineHash(size_t seed, size_t value);
+
+	HashIndex();
+
+	size_t size() const;
+	void clear();
+
+	// isEqual is called with the stored position of each element that shares the hash
+	template <typename EqualityCheck>
+	size_t find(size_t hash, EqualityCheck isEqual) const;
+
+	// the position must not be indexed yet
+	void insert(size_t hash, size_t position);
+
+private:
+	struct Slot
+	{
+		uint32_t hash;
+		uint32_t position;	  // stored position + 1, 0 marks an empty slot
+	};
+
+	void grow();
+
+	std::vector<Slot> m_slots;
+	size_t m_size;
+};
+
+inline size_t HashIndex::combineHash(size_t seed, size_t value)
+{
+	return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+inline HashIndex::HashIndex(): m_size(0) {}
+
+inline size_t HashIndex::size() const
+{
+	return m_size;
+}
+
+inline void HashIndex::clear()
+{
+	m_slots.clear();
+	m_size = 0;
+}
+
+template <typename EqualityCheck>
+size_t HashIndex::find(size_t hash, EqualityCheck isEqual) const
+{
+	if (m_slots.empty())
+	{
+		return s_notFound;
+	}
+
+	const uint32_t shortHash = static_cast<uint32_t>(hash);
+	const size_t mask = m_slots.size() - 1;
+	for (size_t i = shortHash & mask;; i = (i + 1) & mask)
+	{
+		const Slot& slot = m_slots[i];
+		if (!slot.position)
+		{
+			return s_notFound;
+		}
+
+		if (slot.hash == shortHash && isEqual(slot.position - 1))
+		{
+			return slot.position - 1;
+		}
+	}
+}
+
+inline void HashIndex::insert(size_t hash, size_t position)
+{
+	// keep the load factor below 1/2 so probe sequences stay short
+	if ((m_size + 1) * 2 > m_slots.size())
+	{
+		grow();
+	}
+
+	const uint32_t shortHash = static_cast<uint32_t>(hash);
+	const size_t mask = m_slots.size() - 1;
+	size_t i = shortHash & mask;
+	while (m_slots[i].position)
+	{
+		i = (i + 1) & mask;
+	}
+
+	m_slots[i].hash = shortHash;
+	m_slots[i].position = static_cast<uint32_t>(position + 1);
+	m_size++;
+}
+
+inline void HashIndex::grow()
+{
+	std::vector<Slot> oldSlots(m_slots.empty() ? 16 : m_slots.size() * 2, Slot {0, 0});
+	oldSlots.swap(m_slots);
+
+	const size_t mask = m_slots.size() - 1;
+	for (const Slot& slot: oldSlots)
+	{
+		if (slot.position)
+		{
+			size_t i = slot.hash & mask;
+			while (m_slots[i].position)
+			{
+				i = (i + 1) & mask;
+			}
+			m_slots[i] = slot;
+		}
+	}
+}
+
+#endif	  // HASH_INDEX_H
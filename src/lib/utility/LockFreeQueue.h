@@ -0,0 +1,76 @@
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+
+// Unbounded queue for multiple producer threads and a single consumer thread. Pushing never blocks,
+// popping is only allowed from one thread at a time.
+template <typename T>
+class LockFreeQueue
+{
+public:
+	LockFreeQueue();
+	~LockFreeQueue();
+
+	LockFreeQueue(const LockFreeQueue&) = delete;
+	LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+	void push(T value);
+
+	// returns false if no element was ready, which includes an element whose push has not finished
+	// linking it, even if later pushes already returned
+	bool pop(T& value);
+
+private:
+	struct Node
+	{
+		Node(): next(nullptr) {}
+		Node(T value): next(nullptr), value(std::move(value)) {}
+
+		std::atomic<Node*> next;
+		T value;
+	};
+
+	std::atomic<Node*> m_head;
+	Node* m_tail;
+};
+
+template <typename T>
+LockFreeQueue<T>::LockFreeQueue(): m_head(new Node()), m_tail(m_head.load())
+{
+}
+
+template <typename T>
+LockFreeQueue<T>::~LockFreeQueue()
+{
+	T value;
+	while (pop(value))
+		;
+
+	delete m_tail;
+}
+
+template <typename T>
+void LockFreeQueue<T>::push(T value)
+{
+	Node* node = new Node(std::move(value));
+	Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+	previous->next.store(node, std::memory_order_release);
+}
+
+template <typename T>
+bool LockFreeQueue<T>::pop(T& value)
+{
+	Node* next = m_tail->next.load(std::memory_order_acquire);
+	if (!next)
+	{
+		return false;
+	}
+
+	value = std::move(next->value);
+	delete m_tail;
+	m_tail = next;
+	return true;
+}
+
+#endif	  // LOCK_FREE_QUEUE_H
@@ -22,27 +22,27 @@ public:
 	std::string dayOfWeek() const;
 	std::string dayOfWeekShort() const;
 
-	inline bool operator==(const TimeStamp& rhs)
+	inline bool operator==(const TimeStamp& rhs) const
 	{
 		return m_time == rhs.m_time;
 	}
-	inline bool operator!=(const TimeStamp& rhs)
+	inline bool operator!=(const TimeStamp& rhs) const
 	{
 		return m_time != rhs.m_time;
 	}
-	inline bool operator<(const TimeStamp& rhs)
+	inline bool operator<(const TimeStamp& rhs) const
 	{
 		return m_time < rhs.m_time;
 	}
-	inline bool operator>(const TimeStamp& rhs)
+	inline bool operator>(const TimeStamp& rhs) const
 	{
 		return m_time > rhs.m_time;
 	}
-	inline bool operator<=(const TimeStamp& rhs)
+	inline bool operator<=(const TimeStamp& rhs) const
 	{
 		return m_time <= rhs.m_time;
 	}
-	inline bool operator>=(const TimeStamp& rhs)
+	inline bool operator>=(const TimeStamp& rhs) const
 	{
 		return m_time >= rhs.m_time;
 	}
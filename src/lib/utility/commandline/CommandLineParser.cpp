@@ -250,4 +250,24 @@ bool CommandLineParser::getShallowIndexingRequested() const
 	return m_shallowIndexingRequested;
 }
 
+const FilePath& CommandLineParser::getReindexFilePath() const
+{
+	return m_reindexFile;
+}
+
+void CommandLineParser::setReindexFile(const FilePath& filePath)
+{
+	m_reindexFile = filePath.getAbsolute().makeCanonical();
+}
+
+const FilePath& CommandLineParser::getBenchmarkReportFilePath() const
+{
+	return m_benchmarkReportFile;
+}
+
+void CommandLineParser::setBenchmarkReportFile(const FilePath& filePath)
+{
+	m_benchmarkReportFile = filePath.getAbsolute();
+}
+
 }	 // namespace commandline
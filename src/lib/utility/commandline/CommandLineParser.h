@@ -42,6 +42,12 @@ public:
 	RefreshMode getRefreshMode() const;
 	bool getShallowIndexingRequested() const;
 
+	const FilePath& getReindexFilePath() const;
+	void setReindexFile(const FilePath& filePath);
+
+	const FilePath& getBenchmarkReportFilePath() const;
+	void setBenchmarkReportFile(const FilePath& filePath);
+
 private:
 	void processProjectfile();
 	void printHelp() const;
@@ -56,6 +62,8 @@ private:
 	FilePath m_projectFile;
 	RefreshMode m_refreshMode = REFRESH_UPDATED_FILES;
 	bool m_shallowIndexingRequested = false;
+	FilePath m_reindexFile;
+	FilePath m_benchmarkReportFile;
 
 	bool m_quit = false;
 	bool m_withoutGUI = false;
@@ -87,6 +87,17 @@ void CommandlineCommandConfig::setup()
 		"use-processes,p",
 		po::value<bool>(),
 		"Enable C/C++ Indexer threads to run in different processes. <true/false>")(
+		"indexer-process-max-tus",
+		po::value<int>(),
+		"Restart an indexer process after it indexed this many translation units (0 for no "
+		"limit)")(
+		"indexer-process-max-memory",
+		po::value<int>(),
+		"Restart an indexer process once its memory usage exceeds this many MB (0 for no limit)")(
+		"storage-memory-budget",
+		po::value<int>(),
+		"Let indexers wait while their results waiting to be stored take this many MB (0 for no "
+		"limit)")(
 		"logging-enabled,l", po::value<bool>(), "Enable file/console logging <true/false>")(
 		"verbose-indexer-logging-enabled,L",
 		po::value<bool>(),
@@ -148,6 +159,10 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 		std::cout << "Sourcetrail Settings:\n"
 				  << "\n  indexer-threads: " << settings->getIndexerThreadCount()
 				  << "\n  use-processes: " << settings->getMultiProcessIndexingEnabled()
+				  << "\n  indexer-process-max-tus: "
+				  << settings->getIndexerProcessMaximumTranslationUnitCount()
+				  << "\n  indexer-process-max-memory: " << settings->getIndexerProcessMaximumMemory()
+				  << "\n  storage-memory-budget: " << settings->getStorageMemoryBudget()
 				  << "\n  logging-enabled: " << settings->getLoggingEnabled()
 				  << "\n  verbose-indexer-logging-enabled: "
 				  << settings->getVerboseIndexerLoggingEnabled()
@@ -161,6 +176,18 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 
 	parseAndSetValue(
 		&ApplicationSettings::setMultiProcessIndexingEnabled, "use-processes", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexerProcessMaximumTranslationUnitCount,
+		"indexer-process-max-tus",
+		settings,
+		vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexerProcessMaximumMemory,
+		"indexer-process-max-memory",
+		settings,
+		vm);
+	parseAndSetValue(
+		&ApplicationSettings::setStorageMemoryBudget, "storage-memory-budget", settings, vm);
 	parseAndSetValue(&ApplicationSettings::setLoggingEnabled, "logging-enabled", settings, vm);
 	parseAndSetValue(
 		&ApplicationSettings::setVerboseIndexerLoggingEnabled,
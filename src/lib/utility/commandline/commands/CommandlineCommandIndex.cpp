@@ -23,6 +23,12 @@ void CommandlineCommandIndex::setup()
 		"incomplete,i", "Also reindex incomplete files (files with errors)")(
 		"full,f", "Index full project (omit to only index new/changed files)")(
 		"shallow,s", "Build a shallow index is supported by the project")(
+		"file",
+		po::value<std::string>(),
+		"Only re-index the translation unit of this file within the running process")(
+		"benchmark-report",
+		po::value<std::string>(),
+		"Write the time spent in each indexing phase to this json file")(
 		"project-file", po::value<std::string>(), "Project file to index (.srctrlprj)");
 
 	m_options.add(options);
@@ -67,6 +73,16 @@ CommandlineCommand::ReturnStatus CommandlineCommandIndex::parse(std::vector<std:
 		m_parser->setShallowIndexingRequested();
 	}
 
+	if (vm.count("file"))
+	{
+		m_parser->setReindexFile(FilePath(vm["file"].as<std::string>()));
+	}
+
+	if (vm.count("benchmark-report"))
+	{
+		m_parser->setBenchmarkReportFile(FilePath(vm["benchmark-report"].as<std::string>()));
+	}
+
 	if (vm.count("project-file"))
 	{
 		m_parser->setProjectFile(FilePath(vm["project-file"].as<std::string>()));
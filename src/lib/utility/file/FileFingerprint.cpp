@@ -0,0 +1,138 @@
+#include "FileFingerprint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "FilePath.h"
+
+namespace
+{
+const uint64_t s_prime1 = 0x9e3779b185ebca87ULL;
+const uint64_t s_prime2 = 0xc2b2ae3d27d4eb4fULL;
+
+uint64_t rotateLeft(uint64_t value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t mixWord(uint64_t hash, uint64_t word)
+{
+	hash ^= rotateLeft(word * s_prime2, 31) * s_prime1;
+	return rotateLeft(hash, 27) * s_prime1 + s_prime2;
+}
+
+// consumes the content 8 bytes at a time, so hashing is bound by memory bandwidth
+uint64_t hashBytes(const char* data, size_t size)
+{
+	uint64_t hash = s_prime2 ^ (size * s_prime1);
+
+	size_t i = 0;
+	for (; i + 8 <= size; i += 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data + i, 8);
+		hash = mixWord(hash, word);
+	}
+
+	uint64_t tail = 0;
+	std::memcpy(&tail, data + i, size - i);
+	hash = mixWord(hash, tail);
+
+	hash ^= hash >> 33;
+	hash *= s_prime2;
+	hash ^= hash >> 29;
+	return hash;
+}
+}	 // namespace
+
+FileFingerprint FileFingerprint::fromFile(const FilePath& filePath)
+{
+	std::ifstream file(filePath.str(), std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+	{
+		return FileFingerprint();
+	}
+
+	const std::streamoff size = file.tellg();
+	if (size < 0)
+	{
+		return FileFingerprint();
+	}
+
+	std::string content(static_cast<size_t>(size), '\0');
+	file.seekg(0);
+	if (!file.read(&content[0], size))
+	{
+		return FileFingerprint();
+	}
+
+	return fromContent(content.data(), content.size());
+}
+
+FileFingerprint FileFingerprint::fromContent(const char* data, size_t size)
+{
+	return FileFingerprint(size, hashBytes(data, size));
+}
+
+FileFingerprint FileFingerprint::fromStored(unsigned long long size, const std::string& hash)
+{
+	if (hash.empty())
+	{
+		return FileFingerprint();
+	}
+
+	try
+	{
+		return FileFingerprint(size, std::stoull(hash, nullptr, 16));
+	}
+	catch (...)
+	{
+		return FileFingerprint();
+	}
+}
+
+FileFingerprint::FileFingerprint(): m_valid(false), m_size(0), m_hash(0) {}
+
+bool FileFingerprint::isValid() const
+{
+	return m_valid;
+}
+
+unsigned long long FileFingerprint::getSize() const
+{
+	return m_size;
+}
+
+uint64_t FileFingerprint::getHash() const
+{
+	return m_hash;
+}
+
+std::string FileFingerprint::getHashString() const
+{
+	if (!m_valid)
+	{
+		return "";
+	}
+
+	char buffer[17];
+	std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(m_hash));
+	return buffer;
+}
+
+bool FileFingerprint::operator==(const FileFingerprint& other) const
+{
+	// invalid fingerprints never match, so unknown content always counts as changed
+	return m_valid && other.m_valid && m_size == other.m_size && m_hash == other.m_hash;
+}
+
+bool FileFingerprint::operator!=(const FileFingerprint& other) const
+{
+	return !(*this == other);
+}
+
+FileFingerprint::FileFingerprint(unsigned long long size, uint64_t hash)
+	: m_valid(true), m_size(size), m_hash(hash)
+{
+}
@@ -0,0 +1,37 @@
+#ifndef FILE_FINGERPRINT_H
+#define FILE_FINGERPRINT_H
+
+#include <cstdint>
+#include <string>
+
+class FilePath;
+
+// size and hash of the raw bytes of a file, compared instead of the file content to detect changes
+class FileFingerprint
+{
+public:
+	static FileFingerprint fromFile(const FilePath& filePath);
+	static FileFingerprint fromContent(const char* data, size_t size);
+
+	// the hash is stored as a hex string, because sqlite bindings only take 32 bit integers
+	static FileFingerprint fromStored(unsigned long long size, const std::string& hash);
+
+	FileFingerprint();
+
+	bool isValid() const;
+	unsigned long long getSize() const;
+	uint64_t getHash() const;
+	std::string getHashString() const;
+
+	bool operator==(const FileFingerprint& other) const;
+	bool operator!=(const FileFingerprint& other) const;
+
+private:
+	FileFingerprint(unsigned long long size, uint64_t hash);
+
+	bool m_valid;
+	unsigned long long m_size;
+	uint64_t m_hash;
+};
+
+#endif	  // FILE_FINGERPRINT_H
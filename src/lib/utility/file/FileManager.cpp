@@ -22,15 +22,9 @@ void FileManager::update(
 	m_allSourceFilePaths.clear();
 
 	for (const FileInfo& fileInfo:
-		 FileSystem::getFileInfosFromPaths(m_sourcePaths, m_sourceExtensions))
+		 FileSystem::getFileInfosFromPaths(m_sourcePaths, m_sourceExtensions, true, m_excludeFilters))
 	{
-		const FilePath& filePath = fileInfo.path;
-		if (isExcluded(filePath))
-		{
-			continue;
-		}
-
-		m_allSourceFilePaths.insert(filePath);
+		m_allSourceFilePaths.insert(fileInfo.path);
 	}
 }
 
@@ -53,16 +47,3 @@ std::set<FilePath> FileManager::getAllSourceFilePaths() const
 {
 	return m_allSourceFilePaths;
 }
-
-bool FileManager::isExcluded(const FilePath& filePath) const
-{
-	for (const FilePathFilter& filter: m_excludeFilters)
-	{
-		if (filter.isMatching(filePath))
-		{
-			return true;
-		}
-	}
-
-	return false;
-}
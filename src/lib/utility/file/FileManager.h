@@ -30,8 +30,6 @@ public:
 	std::set<FilePath> getAllSourceFilePaths() const;
 
 private:
-	bool isExcluded(const FilePath& filePath) const;
-
 	std::vector<FilePath> m_sourcePaths;
 	std::vector<FilePathFilter> m_excludeFilters;
 	std::vector<std::wstring> m_sourceExtensions;
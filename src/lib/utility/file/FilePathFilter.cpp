@@ -1,5 +1,7 @@
 #include "FilePathFilter.h"
 
+#include "utilityString.h"
+
 FilePathFilter::FilePathFilter(const std::wstring& filterString)
 	: m_filterString(filterString), m_filterRegex(convertFilterStringToRegex(filterString))
 {
@@ -17,6 +19,14 @@ bool FilePathFilter::isMatching(const FilePath& filePath) const
 	return std::regex_match(s, match, m_filterRegex);
 }
 
+bool FilePathFilter::isMatchingAllContainedPaths(const FilePath& directoryPath) const
+{
+	// a trailing "**" matches any suffix, so the directory content matches as soon as the directory
+	// itself does
+	return utility::isPostfix<std::wstring>(L"**", m_filterString) &&
+		isMatching(FilePath(directoryPath.wstr() + L"/"));
+}
+
 bool FilePathFilter::operator<(const FilePathFilter& other) const
 {
 	return m_filterString.compare(other.m_filterString) < 0;
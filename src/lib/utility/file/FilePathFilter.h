@@ -15,6 +15,9 @@ public:
 
 	bool isMatching(const FilePath& filePath) const;
 
+	// true if all paths within the directory match, so it does not need to be visited at all
+	bool isMatchingAllContainedPaths(const FilePath& directoryPath) const;
+
 	bool operator<(const FilePathFilter& other) const;
 
 private:
@@ -64,3 +64,8 @@ bool FileRegister::hasFilePath(const FilePath& filePath) const
 {
 	return m_hasFilePathCache.getValue(filePath.wstr());
 }
+
+bool FileRegister::claimFilePath(const FilePath& filePath)
+{
+	return true;
+}
@@ -19,8 +19,13 @@ public:
 
 	virtual bool hasFilePath(const FilePath& filePath) const;
 
-private:
+	// returns false if the contents of the file are recorded by another translation unit
+	virtual bool claimFilePath(const FilePath& filePath);
+
+protected:
 	const FilePath& m_currentPath;
+
+private:
 	const std::set<FilePath> m_indexedPaths;
 	const std::set<FilePathFilter> m_excludeFilters;
 	mutable UnorderedCache<std::wstring, bool> m_hasFilePathCache;
@@ -1,11 +1,17 @@
 #include "FileSystem.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <set>
+#include <thread>
 
 #include <boost/date_time.hpp>
 #include <boost/date_time/c_local_time_adjustor.hpp>
 #include <boost/filesystem.hpp>
 
+#include "utility.h"
+#include "utilityApp.h"
 #include "utilityString.h"
 
 std::vector<FilePath> FileSystem::getFilePathsFromDirectory(
@@ -54,7 +60,8 @@ FileInfo FileSystem::getFileInfoForPath(const FilePath& filePath)
 std::vector<FileInfo> FileSystem::getFileInfosFromPaths(
 	const std::vector<FilePath>& paths,
 	const std::vector<std::wstring>& fileExtensions,
-	bool followSymLinks)
+	bool followSymLinks,
+	const std::vector<FilePathFilter>& excludeFilters)
 {
 	std::set<std::wstring> ext;
 	for (const std::wstring& e: fileExtensions)
@@ -62,80 +69,176 @@ std::vector<FileInfo> FileSystem::getFileInfosFromPaths(
 		ext.insert(utility::toLowerCase(e));
 	}
 
-	std::set<boost::filesystem::path> symlinkDirs;
-	std::set<boost::filesystem::path> filePaths;
+	auto hasExtension = [&ext](const boost::filesystem::path& p) {
+		return ext.empty() || ext.find(utility::toLowerCase(p.extension().wstring())) != ext.end();
+	};
 
-	std::vector<FileInfo> files;
+	auto isExcluded = [&excludeFilters](const FilePath& filePath) {
+		for (const FilePathFilter& filter: excludeFilters)
+		{
+			if (filter.isMatching(filePath))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	auto isExcludedDirectory = [&excludeFilters](const FilePath& directoryPath) {
+		for (const FilePathFilter& filter: excludeFilters)
+		{
+			if (filter.isMatchingAllContainedPaths(directoryPath))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	// canonical path and info of each found file
+	std::vector<std::pair<boost::filesystem::path, FileInfo>> files;
+	std::vector<boost::filesystem::path> directories;
 
 	for (const FilePath& path: paths)
 	{
 		if (path.isDirectory())
 		{
-			boost::filesystem::recursive_directory_iterator it(
-				path.getPath(), boost::filesystem::symlink_option::recurse);
-			boost::filesystem::recursive_directory_iterator endit;
+			if (!isExcludedDirectory(path))
+			{
+				directories.push_back(path.getPath());
+			}
+		}
+		else if (path.exists() && hasExtension(path.getPath()))
+		{
+			const FilePath canonicalPath = path.getCanonical();
+			if (!isExcluded(canonicalPath))
+			{
+				files.emplace_back(canonicalPath.getPath(), getFileInfoForPath(canonicalPath));
+			}
+		}
+	}
+
+	// each thread lists one directory at a time and pushes the found subdirectories back onto the
+	// shared stack, so deep and wide trees both keep all threads busy
+	std::mutex mutex;
+	std::condition_variable directoriesChanged;
+	size_t busyThreadCount = 0;
+	std::set<boost::filesystem::path> symlinkDirs;
+
+	auto walkDirectories = [&]() {
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			directoriesChanged.wait(
+				lock, [&]() { return !directories.empty() || busyThreadCount == 0; });
+			if (directories.empty())
+			{
+				return;
+			}
+
+			const boost::filesystem::path directory = directories.back();
+			directories.pop_back();
+			busyThreadCount++;
+			lock.unlock();
+
+			std::vector<boost::filesystem::path> subDirectories;
+			std::vector<std::pair<boost::filesystem::path, FileInfo>> directoryFiles;
+
 			boost::system::error_code ec;
-			for (; it != endit; it.increment(ec))
+			for (boost::filesystem::directory_iterator it(directory, ec), endit; it != endit;
+				 it.increment(ec))
 			{
-				if (boost::filesystem::is_symlink(*it))
+				const boost::filesystem::path& entryPath = it->path();
+				const bool isDirectory = boost::filesystem::is_directory(entryPath, ec);
+
+				if (boost::filesystem::is_symlink(entryPath, ec))
 				{
 					if (!followSymLinks)
 					{
-						it.no_push();
 						continue;
 					}
 
 					// check for self-referencing symlinks
-					boost::filesystem::path p = boost::filesystem::read_symlink(*it);
-					if (p.filename() == p.string() && p.filename() == it->path().filename())
+					const boost::filesystem::path p = boost::filesystem::read_symlink(entryPath, ec);
+					if (p.filename() == p.string() && p.filename() == entryPath.filename())
 					{
 						continue;
 					}
 
 					// check for duplicates when following directory symlinks
-					if (boost::filesystem::is_directory(*it))
+					if (isDirectory)
 					{
-						boost::filesystem::path absDir = boost::filesystem::canonical(
-							p, it->path().parent_path());
+						const boost::filesystem::path absDir = boost::filesystem::canonical(
+							p, entryPath.parent_path(), ec);
 
-						if (symlinkDirs.find(absDir) != symlinkDirs.end())
+						std::lock_guard<std::mutex> symlinkLock(mutex);
+						if (!symlinkDirs.insert(absDir).second)
 						{
-							it.no_push();
 							continue;
 						}
-
-						symlinkDirs.insert(absDir);
 					}
 				}
 
-				if (boost::filesystem::is_regular_file(*it) &&
-					(ext.empty() ||
-					 ext.find(utility::toLowerCase(it->path().extension().wstring())) != ext.end()))
+				if (isDirectory)
 				{
-					boost::filesystem::path p = boost::filesystem::canonical(it->path());
-					if (filePaths.find(p) != filePaths.end())
+					if (!isExcludedDirectory(FilePath(entryPath.wstring())))
 					{
-						continue;
+						subDirectories.push_back(entryPath);
+					}
+				}
+				else if (boost::filesystem::is_regular_file(entryPath, ec) && hasExtension(entryPath))
+				{
+					const FilePath filePath(entryPath.wstring());
+					if (!isExcluded(filePath))
+					{
+						directoryFiles.emplace_back(
+							boost::filesystem::canonical(entryPath, ec), getFileInfoForPath(filePath));
 					}
-					filePaths.insert(p);
-					files.push_back(getFileInfoForPath(FilePath(it->path().wstring())));
 				}
 			}
+
+			lock.lock();
+			busyThreadCount--;
+			utility::append(directories, subDirectories);
+			utility::append(files, directoryFiles);
+			directoriesChanged.notify_all();
 		}
-		else if (path.exists() && (ext.empty() || ext.find(utility::toLowerCase(path.extension())) != ext.end()))
+	};
+
+	if (!directories.empty())
+	{
+		std::vector<std::shared_ptr<std::thread>> threads;
+		for (int i = 0; i < utility::getIdealThreadCount(); i++)
 		{
-			const FilePath canonicalPath = path.getCanonical();
-			boost::filesystem::path p = canonicalPath.getPath();
-			if (filePaths.find(p) != filePaths.end())
-			{
-				continue;
-			}
-			filePaths.insert(p);
-			files.push_back(getFileInfoForPath(canonicalPath));
+			threads.push_back(std::make_shared<std::thread>(walkDirectories));
+		}
+		for (std::shared_ptr<std::thread> thread: threads)
+		{
+			thread->join();
 		}
 	}
 
-	return files;
+	// files reachable through several symlinks are only returned once, sorting first keeps the
+	// returned path independent of the order in which the threads found them
+	std::sort(
+		files.begin(),
+		files.end(),
+		[](const std::pair<boost::filesystem::path, FileInfo>& a,
+		   const std::pair<boost::filesystem::path, FileInfo>& b) {
+			return a.second.path < b.second.path;
+		});
+
+	std::set<boost::filesystem::path> filePaths;
+	std::vector<FileInfo> fileInfos;
+	for (std::pair<boost::filesystem::path, FileInfo>& file: files)
+	{
+		if (filePaths.insert(file.first).second)
+		{
+			fileInfos.push_back(std::move(file.second));
+		}
+	}
+
+	return fileInfos;
 }
 
 std::set<FilePath> FileSystem::getSymLinkedDirectories(const FilePath& path)
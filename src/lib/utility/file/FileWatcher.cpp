@@ -0,0 +1,238 @@
+#include "FileWatcher.h"
+
+#ifdef __linux__
+#	include <cerrno>
+#	include <poll.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+#endif
+
+#include "FileSystem.h"
+#include "TimeStamp.h"
+#include "logging.h"
+#include "utilityString.h"
+
+namespace
+{
+#ifdef __linux__
+const uint32_t s_watchMask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+	IN_DELETE_SELF | IN_ONLYDIR;
+#endif
+}	 // namespace
+
+bool FileWatcher::isSupported()
+{
+#ifdef __linux__
+	return true;
+#else
+	return false;
+#endif
+}
+
+FileWatcher::FileWatcher(size_t debounceMilliseconds, std::function<void()> onFilesChanged)
+	: m_debounceMilliseconds(debounceMilliseconds)
+	, m_onFilesChanged(onFilesChanged)
+	, m_running(false)
+	, m_fileDescriptor(-1)
+	, m_overflowed(false)
+	, m_reported(false)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+	stop();
+}
+
+bool FileWatcher::start(const std::set<FilePath>& directoryPaths)
+{
+	stop();
+
+#ifdef __linux__
+	m_fileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_fileDescriptor < 0)
+	{
+		LOG_WARNING("Unable to initialize inotify, changed files are not detected.");
+		return false;
+	}
+
+	for (const FilePath& directoryPath: directoryPaths)
+	{
+		addWatch(directoryPath, false);
+	}
+
+	m_running = true;
+	m_thread = std::make_unique<std::thread>(&FileWatcher::run, this);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void FileWatcher::stop()
+{
+	m_running = false;
+	if (m_thread)
+	{
+		m_thread->join();
+		m_thread.reset();
+	}
+
+#ifdef __linux__
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+#endif
+
+	m_watchedDirectories.clear();
+
+	std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+	m_changedFilePaths.clear();
+	m_overflowed = false;
+	m_reported = false;
+}
+
+std::set<FilePath> FileWatcher::takeChangedFilePaths(bool& overflowed)
+{
+	std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+	overflowed = m_overflowed;
+	m_overflowed = false;
+	m_reported = false;
+
+	std::set<FilePath> changedFilePaths;
+	changedFilePaths.swap(m_changedFilePaths);
+	return changedFilePaths;
+}
+
+void FileWatcher::run()
+{
+#ifdef __linux__
+	TimeStamp lastChange = TimeStamp::now();
+
+	alignas(inotify_event) char buffer[16384];
+
+	while (m_running)
+	{
+		pollfd pollDescriptor = {m_fileDescriptor, POLLIN, 0};
+		if (poll(&pollDescriptor, 1, 100) > 0 && (pollDescriptor.revents & POLLIN))
+		{
+			ssize_t length = 0;
+			while ((length = read(m_fileDescriptor, buffer, sizeof(buffer))) > 0)
+			{
+				for (char* it = buffer; it < buffer + length;)
+				{
+					const inotify_event* event = reinterpret_cast<const inotify_event*>(it);
+					it += sizeof(inotify_event) + event->len;
+
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+						m_overflowed = true;
+						continue;
+					}
+
+					auto directoryIt = m_watchedDirectories.find(event->wd);
+					if (directoryIt == m_watchedDirectories.end())
+					{
+						continue;
+					}
+
+					if (event->mask & (IN_DELETE_SELF | IN_IGNORED))
+					{
+						m_watchedDirectories.erase(directoryIt);
+						continue;
+					}
+
+					if (!event->len)
+					{
+						continue;
+					}
+
+					const FilePath filePath = directoryIt->second.getConcatenated(
+						utility::decodeFromUtf8(event->name));
+
+					if (event->mask & IN_ISDIR)
+					{
+						// files may have been added before the new directory got watched
+						if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						{
+							addWatch(filePath, true);
+							for (const FilePath& path: FileSystem::getFilePathsFromDirectory(filePath))
+							{
+								addChangedFilePath(path);
+							}
+						}
+						continue;
+					}
+
+					addChangedFilePath(filePath);
+				}
+
+				lastChange = TimeStamp::now();
+			}
+		}
+
+		if (TimeStamp::now().deltaMS(lastChange) >= m_debounceMilliseconds && reportChanges())
+		{
+			m_onFilesChanged();
+		}
+	}
+#endif
+}
+
+void FileWatcher::addWatch(const FilePath& directoryPath, bool recursive)
+{
+#ifdef __linux__
+	std::vector<FilePath> directoryPaths;
+	if (recursive)
+	{
+		directoryPaths = FileSystem::getRecursiveSubDirectories(directoryPath);
+	}
+	directoryPaths.insert(directoryPaths.begin(), directoryPath);
+
+	for (const FilePath& path: directoryPaths)
+	{
+		const int watchDescriptor = inotify_add_watch(
+			m_fileDescriptor, path.str().c_str(), s_watchMask);
+		if (watchDescriptor < 0)
+		{
+			if (errno == ENOSPC)
+			{
+				LOG_WARNING(
+					"Reached the maximum number of inotify watches, changes in " + path.str() +
+					" are not detected.");
+				return;
+			}
+			continue;
+		}
+
+		m_watchedDirectories[watchDescriptor] = path;
+	}
+#endif
+}
+
+void FileWatcher::addChangedFilePath(const FilePath& filePath)
+{
+	std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+	m_changedFilePaths.insert(filePath);
+}
+
+bool FileWatcher::hasChanges()
+{
+	std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+	return m_overflowed || !m_changedFilePaths.empty();
+}
+
+bool FileWatcher::reportChanges()
+{
+	std::lock_guard<std::mutex> lock(m_changedFilePathsMutex);
+	if (m_reported || (!m_overflowed && m_changedFilePaths.empty()))
+	{
+		return false;
+	}
+
+	m_reported = true;
+	return true;
+}
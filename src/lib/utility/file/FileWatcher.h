@@ -0,0 +1,57 @@
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "FilePath.h"
+
+// collects changed files in the watched directories on a separate thread. the callback is called
+// on that thread once no change arrived for the debounce interval, so bursts like a branch checkout
+// end up in a single batch. it is not called again before the changes got taken, so changes
+// arriving while a refresh is running get collected into the next batch. only implemented with
+// inotify on linux.
+class FileWatcher
+{
+public:
+	static bool isSupported();
+
+	FileWatcher(size_t debounceMilliseconds, std::function<void()> onFilesChanged);
+	~FileWatcher();
+
+	// new sub directories of the watched directories are watched as well
+	bool start(const std::set<FilePath>& directoryPaths);
+	void stop();
+
+	// overflowed is set if changes got lost, so all files need to be checked again
+	std::set<FilePath> takeChangedFilePaths(bool& overflowed);
+	bool hasChanges();
+
+private:
+	void run();
+	void addWatch(const FilePath& directoryPath, bool recursive);
+	void addChangedFilePath(const FilePath& filePath);
+	bool reportChanges();
+
+	const size_t m_debounceMilliseconds;
+	std::function<void()> m_onFilesChanged;
+
+	std::atomic<bool> m_running;
+	std::unique_ptr<std::thread> m_thread;
+
+	int m_fileDescriptor;
+	std::map<int, FilePath> m_watchedDirectories;	 // only accessed by the watcher thread once started
+
+	std::mutex m_changedFilePathsMutex;
+	std::set<FilePath> m_changedFilePaths;
+	bool m_overflowed;
+	// set once the callback was called until the changes get taken
+	bool m_reported;
+};
+
+#endif	  // FILE_WATCHER_H
@@ -1,16 +1,20 @@
 #include "SharedMemory.h"
 
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
 #include "SharedMemoryGarbageCollector.h"
 #include "logging.h"
 
 const char* SharedMemory::s_memoryNamePrefix = "srctrlmem_";
 const char* SharedMemory::s_mutexNamePrefix = "srctrlmtx_";
+const char* SharedMemory::s_conditionNamePrefix = "srctrlcnd_";
 
 SharedMemory::ScopedAccess::ScopedAccess(SharedMemory* memory)
 	: boost::interprocess::scoped_lock<boost::interprocess::named_mutex>(memory->getMutex())
 	//, m_memory(boost::interprocess::open_only, memory->getMemoryName().c_str())
 	, m_memoryName(memory->getMemoryName())
 	, m_minimumMemorySize(memory->getInitialMemorySize())
+	, m_condition(memory->getCondition())
 {
 	try
 	{
@@ -84,6 +88,27 @@ void SharedMemory::ScopedAccess::shrinkToFitMemory()
 		boost::interprocess::open_only, m_memoryName.c_str());
 }
 
+void SharedMemory::ScopedAccess::notifyAll()
+{
+	m_condition.notify_all();
+}
+
+bool SharedMemory::ScopedAccess::waitForNotification(size_t timeoutMS)
+{
+	// unmap while waiting, the memory may get grown by the notifying process
+	m_memory = boost::interprocess::managed_shared_memory();
+
+	const bool notified = m_condition.timed_wait(
+		*this,
+		boost::posix_time::microsec_clock::universal_time() +
+			boost::posix_time::milliseconds(timeoutMS));
+
+	m_memory = boost::interprocess::managed_shared_memory(
+		boost::interprocess::open_only, m_memoryName.c_str());
+
+	return notified;
+}
+
 std::string SharedMemory::ScopedAccess::logString() const
 {
 	std::string log = m_memoryName + " -";
@@ -122,6 +147,7 @@ void SharedMemory::deleteSharedMemory(const std::string& name)
 {
 	boost::interprocess::shared_memory_object::remove((s_memoryNamePrefix + name).c_str());
 	boost::interprocess::named_mutex::remove((s_mutexNamePrefix + name).c_str());
+	boost::interprocess::named_condition::remove((s_conditionNamePrefix + name).c_str());
 }
 
 SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, AccessMode mode)
@@ -154,6 +180,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::create_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::create_only, getConditionName().c_str(), permissions);
 		}
 		break;
 
@@ -161,6 +189,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 			boost::interprocess::managed_shared_memory(
 				boost::interprocess::open_only, getMemoryName().c_str());
 			boost::interprocess::named_mutex(boost::interprocess::open_only, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_only, getConditionName().c_str());
 			unlockMutex = false;
 			break;
 
@@ -177,6 +207,8 @@ SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, Ac
 				permissions);
 			boost::interprocess::named_mutex(
 				boost::interprocess::open_or_create, getMutexName().c_str());
+			boost::interprocess::named_condition(
+				boost::interprocess::open_or_create, getConditionName().c_str(), permissions);
 		}
 		break;
 		}
@@ -265,6 +297,11 @@ std::string SharedMemory::getMutexName() const
 	return s_mutexNamePrefix + m_name;
 }
 
+std::string SharedMemory::getConditionName() const
+{
+	return s_conditionNamePrefix + m_name;
+}
+
 boost::interprocess::named_mutex& SharedMemory::getMutex()
 {
 	if (!m_mutex)
@@ -276,6 +313,17 @@ boost::interprocess::named_mutex& SharedMemory::getMutex()
 	return *m_mutex.get();
 }
 
+boost::interprocess::named_condition& SharedMemory::getCondition()
+{
+	if (!m_condition)
+	{
+		m_condition = std::make_shared<boost::interprocess::named_condition>(
+			boost::interprocess::open_only, getConditionName().c_str());
+	}
+
+	return *m_condition.get();
+}
+
 size_t SharedMemory::getInitialMemorySize() const
 {
 	return m_initialMemorySize;
@@ -1,6 +1,7 @@
 #ifndef SHARED_MEMORY_H
 #define SHARED_MEMORY_H
 
+#include <chrono>
 #include <string>
 
 #include <boost/interprocess/containers/deque.hpp>
@@ -9,6 +10,7 @@
 #include <boost/interprocess/containers/string.hpp>
 #include <boost/interprocess/containers/vector.hpp>
 #include <boost/interprocess/managed_shared_memory.hpp>
+#include <boost/interprocess/sync/named_condition.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
 #include <boost/interprocess/sync/scoped_lock.hpp>
 
@@ -64,6 +66,35 @@ public:
 		void growMemory(size_t size);
 		void shrinkToFitMemory();
 
+		// wakes up all processes and threads waiting for a notification on this memory
+		void notifyAll();
+
+		// releases lock and mapping until notified or timed out, returns false on timeout.
+		// pointers to values need to be accessed again afterwards.
+		bool waitForNotification(size_t timeoutMS);
+
+		// waits for notifications until the predicate holds, returns false on timeout
+		template <typename Predicate>
+		bool waitForNotification(size_t timeoutMS, Predicate predicate)
+		{
+			const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+				std::chrono::milliseconds(timeoutMS);
+
+			while (!predicate())
+			{
+				const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+				if (now >= end)
+				{
+					return false;
+				}
+
+				waitForNotification(static_cast<size_t>(
+					std::chrono::duration_cast<std::chrono::milliseconds>(end - now).count() + 1));
+			}
+
+			return true;
+		}
+
 		template <typename T>
 		T* accessValue(const std::string& key)
 		{
@@ -100,6 +131,7 @@ public:
 		boost::interprocess::managed_shared_memory m_memory;
 		std::string m_memoryName;
 		size_t m_minimumMemorySize;
+		boost::interprocess::named_condition& m_condition;
 	};
 
 	bool checkSharedMutex();
@@ -107,15 +139,19 @@ public:
 private:
 	static const char* s_memoryNamePrefix;
 	static const char* s_mutexNamePrefix;
+	static const char* s_conditionNamePrefix;
 
 	std::string getMemoryName() const;
 	std::string getMutexName() const;
+	std::string getConditionName() const;
 
 	boost::interprocess::named_mutex& getMutex();
+	boost::interprocess::named_condition& getCondition();
 
 	size_t getInitialMemorySize() const;
 
 	std::shared_ptr<boost::interprocess::named_mutex> m_mutex;
+	std::shared_ptr<boost::interprocess::named_condition> m_condition;
 	std::string m_name;
 	AccessMode m_mode;
 
@@ -11,7 +11,7 @@ public:
 		return "MessageRefresh";
 	}
 
-	MessageRefresh(): all(false) {}
+	MessageRefresh(): all(false), watchedFiles(false) {}
 
 	MessageRefresh& refreshAll()
 	{
@@ -19,15 +19,27 @@ public:
 		return *this;
 	}
 
+	// only refreshes the files reported by the file watcher of the project
+	MessageRefresh& watchedFilesOnly()
+	{
+		watchedFiles = true;
+		return *this;
+	}
+
 	void print(std::wostream& os) const override
 	{
 		if (all)
 		{
 			os << "all";
 		}
+		else if (watchedFiles)
+		{
+			os << "watched files";
+		}
 	}
 
 	bool all;
+	bool watchedFiles;
 };
 
 #endif	  // MESSAGE_REFRESH_H
@@ -0,0 +1,25 @@
+#ifndef MESSAGE_REINDEX_FILE_H
+#define MESSAGE_REINDEX_FILE_H
+
+#include "FilePath.h"
+#include "Message.h"
+
+class MessageReindexFile: public Message<MessageReindexFile>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageReindexFile";
+	}
+
+	MessageReindexFile(const FilePath& filePath): filePath(filePath) {}
+
+	void print(std::wostream& os) const override
+	{
+		os << filePath.wstr();
+	}
+
+	const FilePath filePath;
+};
+
+#endif	  // MESSAGE_REINDEX_FILE_H
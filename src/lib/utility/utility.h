@@ -44,6 +44,10 @@ void append(std::unordered_set<T>& a, const std::unordered_set<T>& b);
 template <typename T>
 std::vector<T> unique(const std::vector<T>& a);
 
+// sorts like a std::set would and keeps only the first inserted of all equivalent elements
+template <typename T>
+void sortAndRemoveDuplicates(std::vector<T>& v);
+
 template <typename T>
 std::vector<T> toVector(const std::deque<T>& d);
 
@@ -228,6 +232,16 @@ std::vector<T> utility::unique(const std::vector<T>& a)
 	return r;
 }
 
+template <typename T>
+void utility::sortAndRemoveDuplicates(std::vector<T>& v)
+{
+	std::stable_sort(v.begin(), v.end());
+	v.erase(
+		std::unique(
+			v.begin(), v.end(), [](const T& a, const T& b) { return !(a < b) && !(b < a); }),
+		v.end());
+}
+
 template <typename T>
 std::vector<T> utility::toVector(const std::deque<T>& d)
 {
@@ -2,19 +2,32 @@
 
 #include "CxxParser.h"
 #include "FileRegister.h"
+#include "SharedHeaderFileRegister.h"
 
 void IndexerCxx::doIndex(
 	std::shared_ptr<IndexerCommandCxx> indexerCommand,
 	std::shared_ptr<ParserClientImpl> parserClient,
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo)
 {
-	CxxParser parser(
-		parserClient,
-		std::make_shared<FileRegister>(
+	std::shared_ptr<FileRegister> fileRegister;
+	if (m_indexerStateInfo->indexedHeaderManager)
+	{
+		fileRegister = std::make_shared<SharedHeaderFileRegister>(
 			indexerCommand->getSourceFilePath(),
 			indexerCommand->getIndexedPaths(),
-			indexerCommand->getExcludeFilters()),
-		m_indexerStateInfo);
+			indexerCommand->getExcludeFilters(),
+			m_indexerStateInfo->indexedHeaderManager,
+			SharedHeaderFileRegister::getPreprocessorContextHash(indexerCommand->getCompilerFlags()));
+	}
+	else
+	{
+		fileRegister = std::make_shared<FileRegister>(
+			indexerCommand->getSourceFilePath(),
+			indexerCommand->getIndexedPaths(),
+			indexerCommand->getExcludeFilters());
+	}
+
+	CxxParser parser(parserClient, fileRegister, m_indexerStateInfo);
 
 	parser.buildIndex(indexerCommand);
 }
@@ -0,0 +1,288 @@
+#include "SharedHeaderFileRegister.h"
+
+#include <cctype>
+#include <functional>
+
+#include "InterprocessIndexedHeaderManager.h"
+#include "TextAccess.h"
+#include "utilityString.h"
+
+std::string SharedHeaderFileRegister::getPreprocessorContextHash(
+	const std::vector<std::wstring>& compilerFlags)
+{
+	// only flags that change predefined or user defined macros are relevant, other flags like the
+	// source file or output paths differ for every translation unit
+	const std::vector<std::wstring> relevantPrefixes = {
+		L"-D", L"-U", L"-std", L"--std", L"-x", L"-include", L"-imacros", L"-target", L"--target", L"-f", L"-m"};
+	const std::vector<std::wstring> flagsWithValue = {
+		L"-D", L"-U", L"-x", L"-include", L"-imacros", L"-target"};
+
+	std::wstring context;
+	bool appendNextFlag = false;
+	for (const std::wstring& flag: compilerFlags)
+	{
+		bool relevant = appendNextFlag;
+		appendNextFlag = false;
+
+		for (const std::wstring& prefix: relevantPrefixes)
+		{
+			if (utility::isPrefix(prefix, flag))
+			{
+				relevant = true;
+				break;
+			}
+		}
+
+		for (const std::wstring& flagWithValue: flagsWithValue)
+		{
+			if (flag == flagWithValue)
+			{
+				appendNextFlag = true;
+				break;
+			}
+		}
+
+		if (relevant)
+		{
+			context += flag + L'\n';
+		}
+	}
+
+	return std::to_string(std::hash<std::wstring>()(context));
+}
+
+SharedHeaderFileRegister::SharedHeaderFileRegister(
+	const FilePath& currentPath,
+	const std::set<FilePath>& indexedPaths,
+	const std::set<FilePathFilter>& excludeFilters,
+	std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager,
+	const std::string& preprocessorContextHash)
+	: FileRegister(currentPath, indexedPaths, excludeFilters)
+	, m_indexedHeaderManager(indexedHeaderManager)
+	, m_preprocessorContextHash(preprocessorContextHash)
+{
+}
+
+bool SharedHeaderFileRegister::claimFilePath(const FilePath& filePath)
+{
+	if (filePath == m_currentPath)
+	{
+		return true;
+	}
+
+	auto it = m_claimedFilePaths.find(filePath);
+	if (it != m_claimedFilePaths.end())
+	{
+		return it->second;
+	}
+
+	bool claimed = true;
+	if (isIndependentOfIncludingFile(TextAccess::createFromFile(filePath)))
+	{
+		claimed = m_indexedHeaderManager->claimHeader(
+			m_preprocessorContextHash + ':' + utility::encodeToUtf8(filePath.wstr()));
+	}
+
+	m_claimedFilePaths.emplace(filePath, claimed);
+	return claimed;
+}
+
+bool SharedHeaderFileRegister::isIndependentOfIncludingFile(std::shared_ptr<TextAccess> textAccess)
+{
+	const std::vector<std::string> lines = getCodeLines(textAccess->getAllLines());
+
+	// the first line has to be either "#pragma once" or "#ifndef X" directly followed by
+	// "#define X"
+	std::string guardName;
+	size_t lineIndex = 0;
+	if (!lines.empty() &&
+		getDirectiveTokens(lines[0]) == std::vector<std::string>({"pragma", "once"}))
+	{
+		lineIndex = 1;
+	}
+	else if (lines.size() >= 2)
+	{
+		const std::vector<std::string> ifndefTokens = getDirectiveTokens(lines[0]);
+		const std::vector<std::string> defineTokens = getDirectiveTokens(lines[1]);
+		if (ifndefTokens.size() == 2 && ifndefTokens[0] == "ifndef" && defineTokens.size() >= 2 &&
+			defineTokens[0] == "define" && defineTokens[1] == ifndefTokens[1])
+		{
+			guardName = ifndefTokens[1];
+			lineIndex = 2;
+		}
+	}
+
+	if (lineIndex == 0)
+	{
+		return false;
+	}
+
+	std::set<std::string> definedMacros = {"defined", guardName};
+	for (size_t i = lineIndex; i < lines.size(); i++)
+	{
+		const std::vector<std::string> tokens = getDirectiveTokens(lines[i]);
+		if (tokens.size() >= 2 && tokens[0] == "define")
+		{
+			definedMacros.insert(tokens[1]);
+		}
+	}
+
+	// conditions may only test macros defined by this header or predefined by the compiler, which
+	// are covered by the preprocessor context. macros of the including file may change the contents
+	for (size_t i = lineIndex; i < lines.size(); i++)
+	{
+		const std::vector<std::string> tokens = getDirectiveTokens(lines[i]);
+		if (tokens.empty())
+		{
+			continue;
+		}
+
+		if (tokens[0] == "if" || tokens[0] == "ifdef" || tokens[0] == "ifndef" ||
+			tokens[0] == "elif")
+		{
+			for (size_t j = 1; j < tokens.size(); j++)
+			{
+				const std::string& token = tokens[j];
+				const bool reserved = token.size() > 1 && token[0] == '_' &&
+					(token[1] == '_' || std::isupper(static_cast<unsigned char>(token[1])));
+				if (!reserved && definedMacros.find(token) == definedMacros.end())
+				{
+					return false;
+				}
+			}
+		}
+		else if (tokens[0] == "include" || tokens[0] == "include_next" || tokens[0] == "import")
+		{
+			// the file of a computed include depends on macros as well
+			const std::string argument = utility::trim(
+				lines[i].substr(lines[i].find(tokens[0]) + tokens[0].size()));
+			if (argument.empty() || (argument[0] != '<' && argument[0] != '"'))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+std::vector<std::string> SharedHeaderFileRegister::getCodeLines(
+	const std::vector<std::string>& lines)
+{
+	// comments are removed, continued lines are joined and empty lines are skipped
+	std::vector<std::string> codeLines;
+	std::string codeLine;
+	bool inBlockComment = false;
+	for (const std::string& line: lines)
+	{
+		char quote = 0;
+		for (size_t i = 0; i < line.size(); i++)
+		{
+			const char c = line[i];
+			const char next = i + 1 < line.size() ? line[i + 1] : 0;
+			if (inBlockComment)
+			{
+				if (c == '*' && next == '/')
+				{
+					inBlockComment = false;
+					codeLine += ' ';
+					i++;
+				}
+			}
+			else if (quote)
+			{
+				codeLine += c;
+				if (c == '\\' && next)
+				{
+					codeLine += next;
+					i++;
+				}
+				else if (c == quote)
+				{
+					quote = 0;
+				}
+			}
+			else if (c == '/' && next == '*')
+			{
+				inBlockComment = true;
+				i++;
+			}
+			else if (c == '/' && next == '/')
+			{
+				break;
+			}
+			else
+			{
+				if (c == '"' || c == '\'')
+				{
+					quote = c;
+				}
+				codeLine += (c == '\t' || c == '\r' || c == '\n') ? ' ' : c;
+			}
+		}
+
+		codeLine = utility::trim(codeLine);
+		if (!codeLine.empty() && codeLine.back() == '\\')
+		{
+			codeLine.pop_back();
+			continue;
+		}
+
+		if (!codeLine.empty())
+		{
+			codeLines.push_back(codeLine);
+		}
+		codeLine.clear();
+	}
+
+	if (!codeLine.empty())
+	{
+		codeLines.push_back(codeLine);
+	}
+
+	return codeLines;
+}
+
+std::vector<std::string> SharedHeaderFileRegister::getDirectiveTokens(const std::string& codeLine)
+{
+	// returns the directive name followed by all identifiers, numbers and strings are skipped
+	std::vector<std::string> tokens;
+	if (codeLine.empty() || codeLine[0] != '#')
+	{
+		return tokens;
+	}
+
+	for (size_t i = 1; i < codeLine.size();)
+	{
+		const char c = codeLine[i];
+		if (c == '"' || c == '\'')
+		{
+			i = codeLine.find(c, i + 1);
+			if (i == std::string::npos)
+			{
+				break;
+			}
+			i++;
+		}
+		else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+		{
+			const size_t start = i;
+			while (i < codeLine.size() &&
+				   (std::isalnum(static_cast<unsigned char>(codeLine[i])) || codeLine[i] == '_' ||
+					codeLine[i] == '.'))
+			{
+				i++;
+			}
+
+			if (!std::isdigit(static_cast<unsigned char>(c)))
+			{
+				tokens.push_back(codeLine.substr(start, i - start));
+			}
+		}
+		else
+		{
+			i++;
+		}
+	}
+	return tokens;
+}
@@ -0,0 +1,43 @@
+#ifndef SHARED_HEADER_FILE_REGISTER_H
+#define SHARED_HEADER_FILE_REGISTER_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "FileRegister.h"
+
+class InterprocessIndexedHeaderManager;
+class TextAccess;
+
+// FileRegister that lets only the first translation unit of a refresh record the contents of a
+// header. Headers are keyed by path and by the preprocessor relevant compiler flags. Headers without
+// include guard or with conditions on macros of the including file are always recorded.
+class SharedHeaderFileRegister: public FileRegister
+{
+public:
+	static std::string getPreprocessorContextHash(const std::vector<std::wstring>& compilerFlags);
+
+	SharedHeaderFileRegister(
+		const FilePath& currentPath,
+		const std::set<FilePath>& indexedPaths,
+		const std::set<FilePathFilter>& excludeFilters,
+		std::shared_ptr<InterprocessIndexedHeaderManager> indexedHeaderManager,
+		const std::string& preprocessorContextHash);
+
+	// true if the header has an include guard and its contents do not depend on macros defined by
+	// the including file
+	static bool isIndependentOfIncludingFile(std::shared_ptr<TextAccess> textAccess);
+
+	bool claimFilePath(const FilePath& filePath) override;
+
+private:
+	static std::vector<std::string> getCodeLines(const std::vector<std::string>& lines);
+	static std::vector<std::string> getDirectiveTokens(const std::string& codeLine);
+
+	std::shared_ptr<InterprocessIndexedHeaderManager> m_indexedHeaderManager;
+	const std::string m_preprocessorContextHash;
+	std::map<FilePath, bool> m_claimedFilePaths;
+};
+
+#endif	  // SHARED_HEADER_FILE_REGISTER_H
@@ -153,7 +153,8 @@ bool CanonicalFilePathCache::isProjectFile(
 		return it->second;
 	}
 
-	bool ret = m_fileRegister->hasFilePath(getCanonicalFilePath(fileId, sourceManager));
+	const FilePath filePath = getCanonicalFilePath(fileId, sourceManager);
+	bool ret = m_fileRegister->hasFilePath(filePath) && m_fileRegister->claimFilePath(filePath);
 	m_isProjectFileMap.emplace(fileId, ret);
 	return ret;
 }
@@ -5,6 +5,7 @@
 #include <clang/Basic/SourceManager.h>
 #include <clang/Lex/Preprocessor.h>
 
+#include "ApplicationSettings.h"
 #include "CanonicalFilePathCache.h"
 #include "CxxAstVisitor.h"
 #include "CxxAstVisitorComponentContext.h"
@@ -18,7 +19,10 @@
 
 CxxAstVisitorComponentIndexer::CxxAstVisitorComponentIndexer(
 	CxxAstVisitor* astVisitor, clang::ASTContext* astContext, std::shared_ptr<ParserClient> client)
-	: CxxAstVisitorComponent(astVisitor), m_astContext(astContext), m_client(client)
+	: CxxAstVisitorComponent(astVisitor)
+	, m_astContext(astContext)
+	, m_client(client)
+	, m_recordInterfaceHashes(ApplicationSettings::getInstance()->getInterfaceHashRefreshEnabled())
 {
 }
 
@@ -197,6 +201,22 @@ void CxxAstVisitorComponentIndexer::visitTagDecl(clang::TagDecl* d)
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(symbolId, definitionKind);
 
+		recordInterfaceComponent(d, location, [d]() {
+			std::string details = d->isThisDeclarationADefinition() ? "definition" : "";
+			if (const clang::CXXRecordDecl* recordDecl =
+					clang::dyn_cast_or_null<clang::CXXRecordDecl>(d))
+			{
+				if (recordDecl->isThisDeclarationADefinition())
+				{
+					for (const clang::CXXBaseSpecifier& base: recordDecl->bases())
+					{
+						details += ' ' + base.getType().getAsString();
+					}
+				}
+			}
+			return details;
+		});
+
 		if (clang::EnumDecl* enumDecl = clang::dyn_cast_or_null<clang::EnumDecl>(d))
 		{
 			recordTemplateMemberSpecialization(
@@ -260,6 +280,7 @@ void CxxAstVisitorComponentIndexer::visitVarDecl(clang::VarDecl* d)
 			m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 			m_client->recordDefinitionKind(
 				symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+			recordInterfaceComponent(d, location, [d]() { return d->getType().getAsString(); });
 
 			recordTemplateMemberSpecialization(
 				d->getMemberSpecializationInfo(), symbolId, location, symbolKind);
@@ -311,6 +332,7 @@ void CxxAstVisitorComponentIndexer::visitFieldDecl(clang::FieldDecl* d)
 		m_client->recordAccessKind(fieldId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
 			fieldId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+		recordInterfaceComponent(d, location, [d]() { return d->getType().getAsString(); });
 
 		if (clang::CXXRecordDecl* declaringRecordDecl =
 				clang::dyn_cast_or_null<clang::CXXRecordDecl>(d->getParent()))
@@ -354,6 +376,16 @@ void CxxAstVisitorComponentIndexer::visitFunctionDecl(clang::FunctionDecl* d)
 			m_client->recordLocation(symbolId, getSignatureLocation(d), ParseLocationType::SIGNATURE);
 		}
 
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()), [d]() {
+			std::string details = d->getType().getAsString();
+			if (const clang::CXXMethodDecl* methodDecl =
+					clang::dyn_cast_or_null<clang::CXXMethodDecl>(d))
+			{
+				details += methodDecl->isVirtual() ? " virtual" : "";
+			}
+			return details;
+		});
+
 		if (d->isFunctionTemplateSpecialization())
 		{
 			if (clang::isa<clang::ClassTemplateSpecializationDecl>(d->getParent()) &&
@@ -443,6 +475,7 @@ void CxxAstVisitorComponentIndexer::visitEnumConstantDecl(clang::EnumConstantDec
 			symbolId, getParseLocation(d->getLocation()), ParseLocationType::TOKEN);
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()));
 	}
 }
 
@@ -459,6 +492,7 @@ void CxxAstVisitorComponentIndexer::visitNamespaceDecl(clang::NamespaceDecl* d)
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()));
 	}
 }
 
@@ -479,6 +513,9 @@ void CxxAstVisitorComponentIndexer::visitNamespaceAliasDecl(clang::NamespaceAlia
 			getOrCreateSymbolId(d->getAliasedNamespace()),
 			symbolId,
 			getParseLocation(d->getTargetNameLoc()));
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()), [d]() {
+			return d->getAliasedNamespace()->getQualifiedNameAsString();
+		});
 
 		// TODO: record other namespace as undefined
 	}
@@ -499,6 +536,9 @@ void CxxAstVisitorComponentIndexer::visitTypedefDecl(clang::TypedefDecl* d)
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()), [d]() {
+			return d->getUnderlyingType().getAsString();
+		});
 	}
 }
 
@@ -517,6 +557,9 @@ void CxxAstVisitorComponentIndexer::visitTypeAliasDecl(clang::TypeAliasDecl* d)
 		m_client->recordAccessKind(symbolId, utility::convertAccessSpecifier(d->getAccess()));
 		m_client->recordDefinitionKind(
 			symbolId, utility::isImplicit(d) ? DEFINITION_IMPLICIT : DEFINITION_EXPLICIT);
+		recordInterfaceComponent(d, getParseLocation(d->getLocation()), [d]() {
+			return d->getUnderlyingType().getAsString();
+		});
 	}
 }
 
@@ -528,6 +571,9 @@ void CxxAstVisitorComponentIndexer::visitUsingDirectiveDecl(clang::UsingDirectiv
 		m_client->recordSymbolKind(symbolId, SYMBOL_NAMESPACE);
 
 		const ParseLocation location = getParseLocation(d->getLocation());
+		recordInterfaceComponent(d, location, [d]() {
+			return d->getNominatedNamespaceAsWritten()->getQualifiedNameAsString();
+		});
 
 		m_client->recordReference(
 			REFERENCE_USAGE,
@@ -549,6 +595,7 @@ void CxxAstVisitorComponentIndexer::visitUsingDecl(clang::UsingDecl* d)
 	if (getAstVisitor()->shouldVisitDecl(d))
 	{
 		const ParseLocation location = getParseLocation(d->getLocation());
+		recordInterfaceComponent(d, location);
 
 		m_client->recordReference(
 			REFERENCE_USAGE,
@@ -861,6 +908,25 @@ void CxxAstVisitorComponentIndexer::visitConstructorInitializer(clang::CXXCtorIn
 	}
 }
 
+void CxxAstVisitorComponentIndexer::recordInterfaceComponent(
+	const clang::NamedDecl* d,
+	const ParseLocation& location,
+	const std::function<std::string()>& getDetails)
+{
+	// implicit declarations and template instantiations depend on the translation unit that
+	// indexes the file, and declarations within function bodies are not visible to other files
+	if (!m_recordInterfaceHashes || !location.fileId || utility::isImplicit(d) ||
+		d->getParentFunctionOrMethod())
+	{
+		return;
+	}
+
+	m_client->recordInterfaceComponent(
+		location.fileId,
+		std::string(d->getDeclKindName()) + ' ' + d->getQualifiedNameAsString() + ' ' +
+			std::to_string(d->getAccessUnsafe()) + ' ' + (getDetails ? getDetails() : ""));
+}
+
 void CxxAstVisitorComponentIndexer::recordTemplateMemberSpecialization(
 	const clang::MemberSpecializationInfo* memberSpecializationInfo,
 	Id contextId,
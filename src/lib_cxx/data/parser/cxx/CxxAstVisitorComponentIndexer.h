@@ -1,6 +1,7 @@
 #ifndef CXX_AST_VISITOR_COMPONENT_INDEXER_H
 #define CXX_AST_VISITOR_COMPONENT_INDEXER_H
 
+#include <functional>
 #include <unordered_map>
 
 #include "CxxAstVisitorComponent.h"
@@ -53,6 +54,12 @@ public:
 	void visitConstructorInitializer(clang::CXXCtorInitializer* init);
 
 private:
+	// adds what dependent files can see of the declaration to the interface hash of its file, the
+	// details are only built while interface hashes are recorded
+	void recordInterfaceComponent(
+		const clang::NamedDecl* d,
+		const ParseLocation& location,
+		const std::function<std::string()>& getDetails = nullptr);
 	void recordTemplateMemberSpecialization(
 		const clang::MemberSpecializationInfo* memberSpecializationInfo,
 		Id contextId,
@@ -77,6 +84,7 @@ private:
 
 	clang::ASTContext* m_astContext;
 	std::shared_ptr<ParserClient> m_client;
+	const bool m_recordInterfaceHashes;
 
 	std::map<const clang::NamedDecl*, Id> m_declSymbolIds;
 	std::map<const clang::Type*, Id> m_typeSymbolIds;
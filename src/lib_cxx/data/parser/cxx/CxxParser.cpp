@@ -138,6 +138,27 @@ void CxxParser::buildIndex(std::shared_ptr<IndexerCommandCxx> indexerCommand)
 	{
 		args.erase(args.begin());
 	}
+	for (size_t i = 0; i + 1 < args.size(); i++)
+	{
+		if (args[i] != L"-include-pch")
+		{
+			continue;
+		}
+
+		FilePath pchPath(args[i + 1]);
+		if (!pchPath.isAbsolute())
+		{
+			pchPath = indexerCommand->getWorkingDirectory().getConcatenated(pchPath);
+		}
+
+		// a missing precompiled header would stop parsing of the whole translation unit
+		if (!pchPath.exists())
+		{
+			LOG_WARNING(L"Ignoring missing precompiled header \"" + args[i + 1] + L"\"");
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			i--;
+		}
+	}
 	compileCommand.CommandLine = getCommandlineArgumentsEssential(args);
 	compileCommand.CommandLine = prependSyntaxOnlyToolArgs(compileCommand.CommandLine);
 
@@ -1,9 +1,11 @@
 #include "PreprocessorCallbacks.h"
 
 #include <clang/Basic/IdentifierTable.h>
+#include <clang/Basic/TokenKinds.h>
 #include <clang/Driver/Util.h>
 #include <clang/Lex/MacroArgs.h>
 
+#include "ApplicationSettings.h"
 #include "CanonicalFilePathCache.h"
 #include "ParseLocation.h"
 #include "ParserClient.h"
@@ -11,6 +13,29 @@
 
 #include "utilityString.h"
 
+namespace
+{
+std::string getTokenSpelling(const clang::Token& token)
+{
+	if (const clang::IdentifierInfo* identifierInfo = token.getIdentifierInfo())
+	{
+		return identifierInfo->getName().str();
+	}
+
+	if (token.isLiteral() && token.getLiteralData())
+	{
+		return std::string(token.getLiteralData(), token.getLength());
+	}
+
+	if (const char* punctuator = clang::tok::getPunctuatorSpelling(token.getKind()))
+	{
+		return punctuator;
+	}
+
+	return clang::tok::getTokenName(token.getKind());
+}
+}	 // namespace
+
 PreprocessorCallbacks::PreprocessorCallbacks(
 	clang::SourceManager& sourceManager,
 	std::shared_ptr<ParserClient> client,
@@ -18,6 +43,7 @@ PreprocessorCallbacks::PreprocessorCallbacks(
 	: m_sourceManager(sourceManager)
 	, m_client(client)
 	, m_canonicalFilePathCache(canonicalFilePathCache)
+	, m_recordInterfaceHashes(ApplicationSettings::getInstance()->getInterfaceHashRefreshEnabled())
 {
 }
 
@@ -76,6 +102,12 @@ void PreprocessorCallbacks::InclusionDirective(
 			includedFileSymbolId,
 			m_currentFileSymbolId,
 			getParseLocation(fileNameRange.getAsRange()));
+
+		if (m_recordInterfaceHashes && m_currentPathIsProjectFile)
+		{
+			m_client->recordInterfaceComponent(
+				m_currentFileSymbolId, "#include " + utility::encodeToUtf8(includedFilePath.wstr()));
+		}
 	}
 }
 
@@ -102,6 +134,29 @@ void PreprocessorCallbacks::MacroDefined(
 			symbolId, getParseLocation(macroNameToken), ParseLocationType::TOKEN);
 		m_client->recordLocation(
 			symbolId, getParseLocation(macroDirective->getMacroInfo()), ParseLocationType::SCOPE);
+
+		if (!m_recordInterfaceHashes)
+		{
+			return;
+		}
+
+		// the whole definition is part of the interface, because every token may affect dependents
+		const clang::MacroInfo* macroInfo = macroDirective->getMacroInfo();
+		std::string component = "#define " + macroNameToken.getIdentifierInfo()->getName().str();
+		if (macroInfo->isFunctionLike())
+		{
+			component += '(';
+			for (const clang::IdentifierInfo* param: macroInfo->params())
+			{
+				component += param->getName().str() + ',';
+			}
+			component += macroInfo->isVariadic() ? "...)" : ")";
+		}
+		for (const clang::Token& token: macroInfo->tokens())
+		{
+			component += ' ' + getTokenSpelling(token);
+		}
+		m_client->recordInterfaceComponent(getParseLocation(macroNameToken).fileId, component);
 	}
 }
 
@@ -111,6 +166,13 @@ void PreprocessorCallbacks::MacroUndefined(
 	const clang::MacroDirective* macroUndefinition)
 {
 	onMacroUsage(macroNameToken);
+
+	if (m_recordInterfaceHashes && m_currentPathIsProjectFile)
+	{
+		m_client->recordInterfaceComponent(
+			getParseLocation(macroNameToken).fileId,
+			"#undef " + macroNameToken.getIdentifierInfo()->getName().str());
+	}
 }
 
 void PreprocessorCallbacks::Defined(
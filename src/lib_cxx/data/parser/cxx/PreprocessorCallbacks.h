@@ -80,6 +80,7 @@ private:
 	const clang::SourceManager& m_sourceManager;
 	std::shared_ptr<ParserClient> m_client;
 	std::shared_ptr<CanonicalFilePathCache> m_canonicalFilePathCache;
+	const bool m_recordInterfaceHashes;
 
 	Id m_currentFileSymbolId;
 	bool m_currentPathIsProjectFile = false;
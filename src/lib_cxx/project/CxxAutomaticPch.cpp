@@ -0,0 +1,309 @@
+#include "CxxAutomaticPch.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <map>
+
+#include "DialogView.h"
+#include "FileSystem.h"
+#include "IntermediateStorage.h"
+#include "ParserClientImpl.h"
+#include "TaskLambda.h"
+#include "logging.h"
+#include "utilitySourceGroupCxx.h"
+#include "utilityString.h"
+
+const std::wstring CxxAutomaticPch::s_fileNamePrefix = L"automatic_pch_";
+
+std::shared_ptr<CxxAutomaticPch> CxxAutomaticPch::create(
+	const std::vector<SourceFile>& sourceFiles, const FilePath& pchDirectoryPath)
+{
+	// group the source files by everything that influences the preprocessor state
+	std::map<std::wstring, std::vector<const SourceFile*>> groups;
+	for (const SourceFile& sourceFile: sourceFiles)
+	{
+		std::wstring key = sourceFile.workingDirectory.wstr() + L'\n' +
+			sourceFile.path.extension() + L'\n';
+		for (const std::wstring& flag: getNormalizedCompilerFlags(sourceFile.compilerFlags, sourceFile.path))
+		{
+			key += flag + L'\n';
+		}
+		groups[key].push_back(&sourceFile);
+	}
+
+	const std::pair<const std::wstring, std::vector<const SourceFile*>>* largestGroup = nullptr;
+	for (const auto& group: groups)
+	{
+		if (!largestGroup || group.second.size() > largestGroup->second.size())
+		{
+			largestGroup = &group;
+		}
+	}
+
+	if (!largestGroup || largestGroup->second.size() < 2)
+	{
+		return nullptr;
+	}
+
+	std::vector<std::pair<const SourceFile*, std::vector<std::string>>> candidates;
+	for (const SourceFile* sourceFile: largestGroup->second)
+	{
+		candidates.emplace_back(sourceFile, getLeadingSystemIncludes(sourceFile->path));
+	}
+
+	// extend the prefix by the most common next include as long as enough source files share it
+	const size_t minimumSourceFileCount = std::max<size_t>(2, (candidates.size() + 1) / 2);
+	std::vector<std::string> includes;
+	while (true)
+	{
+		std::map<std::string, size_t> nextIncludeCounts;
+		for (const auto& candidate: candidates)
+		{
+			if (candidate.second.size() > includes.size())
+			{
+				nextIncludeCounts[candidate.second[includes.size()]]++;
+			}
+		}
+
+		auto it = std::max_element(
+			nextIncludeCounts.begin(),
+			nextIncludeCounts.end(),
+			[](const std::pair<const std::string, size_t>& a,
+			   const std::pair<const std::string, size_t>& b) { return a.second < b.second; });
+		if (it == nextIncludeCounts.end() || it->second < minimumSourceFileCount)
+		{
+			break;
+		}
+
+		const std::string include = it->first;
+		candidates.erase(
+			std::remove_if(
+				candidates.begin(),
+				candidates.end(),
+				[&](const std::pair<const SourceFile*, std::vector<std::string>>& candidate) {
+					return candidate.second.size() <= includes.size() ||
+						candidate.second[includes.size()] != include;
+				}),
+			candidates.end());
+		includes.push_back(include);
+	}
+
+	if (includes.empty())
+	{
+		return nullptr;
+	}
+
+	std::wstring hashInput = largestGroup->first;
+	for (const std::string& include: includes)
+	{
+		hashInput += utility::decodeFromUtf8(include) + L'\n';
+	}
+	const std::wstring fileName = s_fileNamePrefix +
+		std::to_wstring(std::hash<std::wstring>()(hashInput));
+
+	const SourceFile* firstSourceFile = candidates.front().first;
+
+	std::shared_ptr<CxxAutomaticPch> pch = std::make_shared<CxxAutomaticPch>();
+	pch->m_inputFilePath = pchDirectoryPath.getConcatenated(
+		fileName + (firstSourceFile->path.extension() == L".c" ? L".h" : L".hpp"));
+	pch->m_outputFilePath = pchDirectoryPath.getConcatenated(fileName + L".pch");
+	pch->m_workingDirectory = firstSourceFile->workingDirectory;
+	pch->m_includes = includes;
+	pch->m_compilerFlags = getNormalizedCompilerFlags(
+		firstSourceFile->compilerFlags, firstSourceFile->path);
+	for (const auto& candidate: candidates)
+	{
+		pch->m_sourceFilePaths.insert(candidate.first->path);
+	}
+
+	LOG_INFO_STREAM(
+		<< "Automatic precompiled header with " << includes.size() << " includes is used by "
+		<< candidates.size() << " of " << sourceFiles.size() << " source files.");
+
+	return pch;
+}
+
+std::vector<std::string> CxxAutomaticPch::getLeadingSystemIncludes(const FilePath& sourceFilePath)
+{
+	std::vector<std::string> includes;
+
+	std::ifstream file(sourceFilePath.str());
+	if (!file.is_open())
+	{
+		return includes;
+	}
+
+	// stop at the first line that is neither empty, a comment or an angled include, anything else
+	// may change the preprocessor state of the following includes
+	bool inBlockComment = false;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::replace(line.begin(), line.end(), '\t', ' ');
+		line = utility::trim(line);
+
+		if (inBlockComment)
+		{
+			const size_t pos = line.find("*/");
+			if (pos == std::string::npos)
+			{
+				continue;
+			}
+			inBlockComment = false;
+			line = utility::trim(line.substr(pos + 2));
+		}
+
+		if (utility::isPrefix<std::string>("/*", line))
+		{
+			const size_t pos = line.find("*/", 2);
+			if (pos == std::string::npos)
+			{
+				inBlockComment = true;
+				continue;
+			}
+			line = utility::trim(line.substr(pos + 2));
+		}
+
+		if (line.empty() || utility::isPrefix<std::string>("//", line))
+		{
+			continue;
+		}
+
+		if (!utility::isPrefix<std::string>("#", line))
+		{
+			break;
+		}
+
+		line = utility::trim(line.substr(1));
+		if (!utility::isPrefix<std::string>("include", line))
+		{
+			break;
+		}
+
+		line = utility::trim(line.substr(7));
+		const size_t end = line.find('>');
+		if (!utility::isPrefix<std::string>("<", line) || end == std::string::npos)
+		{
+			break;
+		}
+
+		includes.push_back("#include " + line.substr(0, end + 1));
+	}
+
+	return includes;
+}
+
+std::vector<std::wstring> CxxAutomaticPch::getNormalizedCompilerFlags(
+	const std::vector<std::wstring>& compilerFlags, const FilePath& sourceFilePath)
+{
+	const std::wstring sourceFileName = sourceFilePath.fileName();
+
+	// remove compiler, source file and output related flags that differ between source files
+	std::vector<std::wstring> normalizedFlags;
+	for (size_t i = 0; i < compilerFlags.size(); i++)
+	{
+		const std::wstring& flag = compilerFlags[i];
+
+		if (i == 0 && !utility::isPrefix<std::wstring>(L"-", flag))
+		{
+			continue;
+		}
+
+		if (flag == L"-c" || flag == L"-MD" || flag == L"-MMD")
+		{
+			continue;
+		}
+
+		if (flag == L"-o" || flag == L"-MF" || flag == L"-MT" || flag == L"-MQ")
+		{
+			i++;
+			continue;
+		}
+
+		if ((utility::isPrefix<std::wstring>(L"-o", flag) &&
+			 !utility::isPrefix<std::wstring>(L"-objc", flag)) ||
+			(!utility::isPrefix<std::wstring>(L"-", flag) && FilePath(flag).fileName() == sourceFileName))
+		{
+			continue;
+		}
+
+		normalizedFlags.push_back(flag);
+	}
+
+	return normalizedFlags;
+}
+
+bool CxxAutomaticPch::isCompatible(const FilePath& sourceFilePath) const
+{
+	return m_sourceFilePaths.find(sourceFilePath) != m_sourceFilePaths.end();
+}
+
+std::vector<std::wstring> CxxAutomaticPch::getIncludePchFlags() const
+{
+	return {L"-fallow-pch-with-compiler-errors", L"-include-pch", m_outputFilePath.wstr()};
+}
+
+std::shared_ptr<Task> CxxAutomaticPch::createBuildTask(std::shared_ptr<DialogView> dialogView) const
+{
+	const FilePath inputFilePath = m_inputFilePath;
+	const FilePath outputFilePath = m_outputFilePath;
+	const FilePath workingDirectory = m_workingDirectory;
+	const std::vector<std::string> includes = m_includes;
+
+	std::vector<std::wstring> compilerFlags = m_compilerFlags;
+	compilerFlags.push_back(L"-x");
+	compilerFlags.push_back(inputFilePath.extension() == L".h" ? L"c-header" : L"c++-header");
+	compilerFlags.push_back(inputFilePath.wstr());
+	compilerFlags.push_back(L"-emit-pch");
+	compilerFlags.push_back(L"-o");
+	compilerFlags.push_back(outputFilePath.wstr());
+
+	return std::make_shared<TaskLambda>(
+		[dialogView, inputFilePath, outputFilePath, workingDirectory, includes, compilerFlags]() {
+			dialogView->showUnknownProgressDialog(
+				L"Preparing Indexing", L"Processing Precompiled Headers");
+
+			const FilePath directoryPath = outputFilePath.getParentDirectory();
+			if (!directoryPath.exists())
+			{
+				FileSystem::createDirectory(directoryPath);
+			}
+
+			// the precompiled header is rebuilt on every refresh, since included files may have changed
+			for (const FilePath& filePath: FileSystem::getFilePathsFromDirectory(directoryPath))
+			{
+				if (utility::isPrefix(s_fileNamePrefix, filePath.fileName()))
+				{
+					FileSystem::remove(filePath);
+				}
+			}
+
+			{
+				std::ofstream inputFile(inputFilePath.str());
+				for (const std::string& include: includes)
+				{
+					inputFile << include << '\n';
+				}
+			}
+
+			LOG_INFO(
+				L"Generating automatic precompiled header at location \"" + outputFilePath.wstr() +
+				L"\"");
+
+			// only the precompiled header is needed, the source files using it record what they reference
+			std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+			utility::generatePch(
+				inputFilePath,
+				compilerFlags,
+				workingDirectory,
+				std::make_shared<ParserClientImpl>(storage.get()));
+
+			if (!outputFilePath.exists())
+			{
+				LOG_WARNING(
+					L"Automatic precompiled header could not be generated, source files are indexed "
+					L"without it.");
+			}
+		});
+}
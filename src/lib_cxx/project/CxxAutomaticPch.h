@@ -0,0 +1,52 @@
+#ifndef CXX_AUTOMATIC_PCH_H
+#define CXX_AUTOMATIC_PCH_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+class DialogView;
+class Task;
+
+// Precompiled header for the leading system includes that most source files of a source group have
+// in common. Only source files with the same preprocessor relevant flags and working directory as
+// the precompiled header are compatible. The file names contain a hash of flags and includes, so
+// the precompiled header gets replaced when either changes.
+class CxxAutomaticPch
+{
+public:
+	struct SourceFile
+	{
+		FilePath path;
+		FilePath workingDirectory;
+		std::vector<std::wstring> compilerFlags;
+	};
+
+	// returns nullptr if not enough source files share a common include prefix
+	static std::shared_ptr<CxxAutomaticPch> create(
+		const std::vector<SourceFile>& sourceFiles, const FilePath& pchDirectoryPath);
+
+	static std::vector<std::string> getLeadingSystemIncludes(const FilePath& sourceFilePath);
+	static std::vector<std::wstring> getNormalizedCompilerFlags(
+		const std::vector<std::wstring>& compilerFlags, const FilePath& sourceFilePath);
+
+	bool isCompatible(const FilePath& sourceFilePath) const;
+	std::vector<std::wstring> getIncludePchFlags() const;
+
+	std::shared_ptr<Task> createBuildTask(std::shared_ptr<DialogView> dialogView) const;
+
+private:
+	static const std::wstring s_fileNamePrefix;
+
+	FilePath m_inputFilePath;
+	FilePath m_outputFilePath;
+	FilePath m_workingDirectory;
+	std::vector<std::string> m_includes;
+	std::vector<std::wstring> m_compilerFlags;
+	std::set<FilePath> m_sourceFilePaths;
+};
+
+#endif	  // CXX_AUTOMATIC_PCH_H
@@ -6,6 +6,7 @@
 #include "Application.h"
 #include "ApplicationSettings.h"
 #include "ClangInvocationInfo.h"
+#include "CxxAutomaticPch.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxIndexerCommandProvider.h"
 #include "IndexerCommandCxx.h"
@@ -108,6 +109,7 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 		m_settings->getExcludeFiltersExpandedAndAbsolute());
 	const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
 
+	std::vector<CxxAutomaticPch::SourceFile> sourceFilesToIndex;
 	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
 	{
 		FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
@@ -134,16 +136,35 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 				utility::append(cdbFlags, includePchFlags);
 			}
 
-			provider->addCommand(std::make_shared<IndexerCommandCxx>(
-				sourcePath,
-				utility::concat(indexedHeaderPaths, {sourcePath}),
-				excludeFilters,
-				std::set<FilePathFilter>(),
-				FilePath(utility::decodeFromUtf8(command.Directory)),
-				utility::concat(cdbFlags, compilerFlags)));
+			sourceFilesToIndex.push_back({sourcePath,
+										  FilePath(utility::decodeFromUtf8(command.Directory)),
+										  utility::concat(cdbFlags, compilerFlags)});
 		}
 	}
 
+	m_automaticPch.reset();
+	if (m_settings->getUseAutomaticPch() && m_settings->getPchInputFilePath().empty())
+	{
+		m_automaticPch = CxxAutomaticPch::create(
+			sourceFilesToIndex, m_settings->getPchDependenciesDirectoryPath());
+	}
+
+	for (CxxAutomaticPch::SourceFile& sourceFile: sourceFilesToIndex)
+	{
+		if (m_automaticPch && m_automaticPch->isCompatible(sourceFile.path))
+		{
+			utility::append(sourceFile.compilerFlags, m_automaticPch->getIncludePchFlags());
+		}
+
+		provider->addCommand(std::make_shared<IndexerCommandCxx>(
+			sourceFile.path,
+			utility::concat(indexedHeaderPaths, {sourceFile.path}),
+			excludeFilters,
+			std::set<FilePathFilter>(),
+			sourceFile.workingDirectory,
+			sourceFile.compilerFlags));
+	}
+
 	provider->logStats();
 
 	return provider;
@@ -160,6 +181,10 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 {
 	if (m_settings->getPchInputFilePath().empty())
 	{
+		if (m_automaticPch)
+		{
+			return m_automaticPch->createBuildTask(dialogView);
+		}
 		return std::make_shared<TaskLambda>([]() {});
 	}
 
@@ -7,6 +7,7 @@
 
 #include "SourceGroup.h"
 
+class CxxAutomaticPch;
 class FilePath;
 namespace clang
 {
@@ -41,6 +42,9 @@ private:
 	std::vector<std::wstring> getBaseCompilerFlags() const;
 
 	std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
+
+	// determined when creating the indexer commands and built by the pre index task
+	mutable std::shared_ptr<CxxAutomaticPch> m_automaticPch;
 };
 
 #endif	  // SOURCE_GROUP_CXX_CDB_H
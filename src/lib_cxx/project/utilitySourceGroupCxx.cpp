@@ -21,6 +21,41 @@
 
 namespace utility
 {
+void generatePch(
+	const FilePath& pchInputFilePath,
+	const std::vector<std::wstring>& compilerFlags,
+	const FilePath& workingDirectory,
+	std::shared_ptr<ParserClientImpl> client)
+{
+	CxxParser::initializeLLVM();
+
+	std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
+		pchInputFilePath, std::set<FilePath> {pchInputFilePath}, std::set<FilePathFilter> {});
+
+	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
+		std::make_shared<CanonicalFilePathCache>(fileRegister);
+
+	clang::tooling::CompileCommand pchCommand;
+	pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
+	pchCommand.Directory = workingDirectory.str();
+	// DON'T use "-fsyntax-only" here because it will cause the output file to be erased
+	pchCommand.CommandLine = utility::concat(
+		{"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
+
+	CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
+	clang::tooling::ClangTool tool(
+		compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
+	GeneratePCHAction* action = new GeneratePCHAction(client, canonicalFilePathCache);
+
+	llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options = new clang::DiagnosticOptions();
+	CxxDiagnosticConsumer diagnostics(
+		llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
+
+	tool.setDiagnosticConsumer(&diagnostics);
+	tool.clearArgumentsAdjusters();
+	tool.run(new SingleFrontendActionFactory(action));
+}
+
 std::shared_ptr<Task> createBuildPchTask(
 	const SourceGroupSettingsWithCxxPchOptions* settings,
 	std::vector<std::wstring> compilerFlags,
@@ -60,43 +95,17 @@ std::shared_ptr<Task> createBuildPchTask(
 				L"Generating precompiled header output for input file \"" +
 				pchInputFilePath.wstr() + L"\" at location \"" + pchOutputFilePath.wstr() + L"\"");
 
-			CxxParser::initializeLLVM();
-
 			if (!pchOutputFilePath.getParentDirectory().exists())
 			{
 				FileSystem::createDirectory(pchOutputFilePath.getParentDirectory());
 			}
 
 			std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
-			std::shared_ptr<ParserClientImpl> client = std::make_shared<ParserClientImpl>(
-				storage.get());
-
-			std::shared_ptr<FileRegister> fileRegister = std::make_shared<FileRegister>(
-				pchInputFilePath, std::set<FilePath> {pchInputFilePath}, std::set<FilePathFilter> {});
-
-			std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache =
-				std::make_shared<CanonicalFilePathCache>(fileRegister);
-
-			clang::tooling::CompileCommand pchCommand;
-			pchCommand.Filename = utility::encodeToUtf8(pchInputFilePath.fileName());
-			pchCommand.Directory = pchOutputFilePath.getParentDirectory().str();
-			// DON'T use "-fsyntax-only" here because it will cause the output file to be erased
-			pchCommand.CommandLine = utility::concat(
-				{"clang-tool"}, CxxParser::getCommandlineArgumentsEssential(compilerFlags));
-
-			CxxCompilationDatabaseSingle compilationDatabase(pchCommand);
-			clang::tooling::ClangTool tool(
-				compilationDatabase, {utility::encodeToUtf8(pchInputFilePath.wstr())});
-			GeneratePCHAction* action = new GeneratePCHAction(client, canonicalFilePathCache);
-
-			llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> options =
-				new clang::DiagnosticOptions();
-			CxxDiagnosticConsumer diagnostics(
-				llvm::errs(), &*options, client, canonicalFilePathCache, pchInputFilePath, true);
-
-			tool.setDiagnosticConsumer(&diagnostics);
-			tool.clearArgumentsAdjusters();
-			tool.run(new SingleFrontendActionFactory(action));
+			generatePch(
+				pchInputFilePath,
+				compilerFlags,
+				pchOutputFilePath.getParentDirectory(),
+				std::make_shared<ParserClientImpl>(storage.get()));
 
 			storageProvider->insert(storage);
 		});
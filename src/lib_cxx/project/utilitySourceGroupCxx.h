@@ -15,12 +15,20 @@ class JSONCompilationDatabase;
 
 class DialogView;
 class FilePath;
+class ParserClientImpl;
 class SourceGroupSettingsWithCxxPchOptions;
 class StorageProvider;
 class Task;
 
 namespace utility
 {
+// compilerFlags need to contain the input file, "-emit-pch" and the output file
+void generatePch(
+	const FilePath& pchInputFilePath,
+	const std::vector<std::wstring>& compilerFlags,
+	const FilePath& workingDirectory,
+	std::shared_ptr<ParserClientImpl> client);
+
 std::shared_ptr<Task> createBuildPchTask(
 	const SourceGroupSettingsWithCxxPchOptions* settings,
 	std::vector<std::wstring> compilerFlags,
@@ -56,18 +56,39 @@ void QtProjectWizardContentCxxPchFlags::populate(QGridLayout* layout, int& row)
 	m_list = new QtStringListBox(this, labelText);
 	layout->addWidget(m_list, row, QtProjectWizardWindow::BACK_COL);
 	row++;
+
+	if (m_isCDB)
+	{
+		m_useAutomaticPch = new QCheckBox(QStringLiteral(
+			"Generate a precompiled header for the system includes shared by most source files"));
+		m_useAutomaticPch->setToolTip(QStringLiteral(
+			"Only used if no precompiled header input file is set. Source files with different "
+			"flags or includes are indexed without precompiled header."));
+		layout->addWidget(m_useAutomaticPch, row, QtProjectWizardWindow::BACK_COL);
+		row++;
+	}
 }
 
 void QtProjectWizardContentCxxPchFlags::load()
 {
 	m_useCompilerFlags->setChecked(m_settings->getUseCompilerFlags());
 	m_list->setStrings(m_settings->getPchFlags());
+
+	if (m_useAutomaticPch)
+	{
+		m_useAutomaticPch->setChecked(m_settings->getUseAutomaticPch());
+	}
 }
 
 void QtProjectWizardContentCxxPchFlags::save()
 {
 	m_settings->setUseCompilerFlags(m_useCompilerFlags->isChecked());
 	m_settings->setPchFlags(m_list->getStrings());
+
+	if (m_useAutomaticPch)
+	{
+		m_settings->setUseAutomaticPch(m_useAutomaticPch->isChecked());
+	}
 }
 
 bool QtProjectWizardContentCxxPchFlags::check()
@@ -29,6 +29,7 @@ private:
 	const bool m_isCDB;
 
 	QCheckBox* m_useCompilerFlags;
+	QCheckBox* m_useAutomaticPch = nullptr;
 	QtStringListBox* m_list;
 };
 
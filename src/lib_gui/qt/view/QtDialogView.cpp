@@ -236,6 +236,18 @@ void QtDialogView::updateIndexingDialog(
 	});
 }
 
+void QtDialogView::updateIndexingMemoryUsage(size_t byteSize, size_t byteBudget)
+{
+	m_onQtThread([=]() {
+		QtIndexingProgressDialog* window = dynamic_cast<QtIndexingProgressDialog*>(
+			m_windowStack.getTopWindow());
+		if (window)
+		{
+			window->updateMemoryUsage(byteSize, byteBudget);
+		}
+	});
+}
+
 void QtDialogView::updateCustomIndexingDialog(
 	size_t startedFileCount,
 	size_t finishedFileCount,
@@ -260,6 +272,8 @@ DatabasePolicy QtDialogView::finishedIndexingDialog(
 	size_t completedFileCount,
 	size_t totalFileCount,
 	float time,
+	float makespan,
+	float predictedMakespan,
 	ErrorCountInfo errorInfo,
 	bool interrupted,
 	bool shallow)
@@ -277,6 +291,8 @@ DatabasePolicy QtDialogView::finishedIndexingDialog(
 			completedFileCount,
 			totalFileCount,
 			time,
+			makespan,
+			predictedMakespan,
 			interrupted,
 			shallow);
 		window->updateErrorCount(errorInfo.total, errorInfo.fatal);
@@ -50,6 +50,7 @@ public:
 		size_t finishedFileCount,
 		size_t totalFileCount,
 		const std::vector<FilePath>& sourcePaths) override;
+	void updateIndexingMemoryUsage(size_t byteSize, size_t byteBudget) override;
 	void updateCustomIndexingDialog(
 		size_t startedFileCount,
 		size_t finishedFileCount,
@@ -61,6 +62,8 @@ public:
 		size_t completedFileCount,
 		size_t totalFileCount,
 		float time,
+		float makespan,
+		float predictedMakespan,
 		ErrorCountInfo errorInfo,
 		bool interrupted,
 		bool shallow) override;
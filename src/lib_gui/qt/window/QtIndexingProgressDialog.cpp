@@ -6,7 +6,10 @@
 #include "MessageIndexingInterrupted.h"
 
 QtIndexingProgressDialog::QtIndexingProgressDialog(bool hideable, QWidget* parent)
-	: QtProgressBarDialog(0.38f, true, parent), m_filePathLabel(nullptr), m_errorWidget(nullptr)
+	: QtProgressBarDialog(0.38f, true, parent)
+	, m_filePathLabel(nullptr)
+	, m_memoryLabel(nullptr)
+	, m_errorWidget(nullptr)
 {
 	setSizeGripStyle(false);
 
@@ -17,6 +20,12 @@ QtIndexingProgressDialog::QtIndexingProgressDialog(bool hideable, QWidget* paren
 	m_filePathLabel->setAlignment(Qt::AlignRight);
 	m_layout->addWidget(m_filePathLabel);
 
+	m_memoryLabel = new QLabel();
+	m_memoryLabel->setObjectName(QStringLiteral("filePath"));
+	m_memoryLabel->setAlignment(Qt::AlignRight);
+	m_memoryLabel->hide();
+	m_layout->addWidget(m_memoryLabel);
+
 	m_layout->addSpacing(12);
 	m_errorWidget = QtIndexingDialog::createErrorWidget(m_layout);
 
@@ -71,6 +80,19 @@ void QtIndexingProgressDialog::updateIndexingProgress(
 	updateProgress(progress);
 }
 
+void QtIndexingProgressDialog::updateMemoryUsage(size_t byteSize, size_t byteBudget)
+{
+	if (!m_memoryLabel || !byteBudget)
+	{
+		return;
+	}
+
+	m_memoryLabel->setText(
+		"Results waiting: " + QString::number(byteSize / 1048576) + "/" +
+		QString::number(byteBudget / 1048576) + " MB");
+	m_memoryLabel->show();
+}
+
 void QtIndexingProgressDialog::updateErrorCount(size_t errorCount, size_t fatalCount)
 {
 	if (m_errorWidget && errorCount)
@@ -14,6 +14,7 @@ public:
 	QSize sizeHint() const override;
 
 	void updateIndexingProgress(size_t fileCount, size_t totalFileCount, const FilePath& sourcePath);
+	void updateMemoryUsage(size_t byteSize, size_t byteBudget);
 	void updateErrorCount(size_t errorCount, size_t fatalCount);
 
 protected:
@@ -25,6 +26,7 @@ private:
 	void onStopPressed();
 
 	QLabel* m_filePathLabel;
+	QLabel* m_memoryLabel;
 	QWidget* m_errorWidget;
 	QString m_sourcePath;
 };
@@ -14,6 +14,8 @@ QtIndexingReportDialog::QtIndexingReportDialog(
 	size_t completedFileCount,
 	size_t totalFileCount,
 	float time,
+	float makespan,
+	float predictedMakespan,
 	bool interrupted,
 	bool shallow,
 	QWidget* parent)
@@ -48,6 +50,16 @@ QtIndexingReportDialog::QtIndexingReportDialog(
 	QtIndexingDialog::createMessageLabel(m_layout)->setText(
 		QStringLiteral("Time:   ") + QString::fromStdString(TimeStamp::secondsToString(time)));
 
+	if (makespan > 0.0f && predictedMakespan > 0.0f)
+	{
+		QtIndexingDialog::createMessageLabel(m_layout)->setText(
+			QStringLiteral("Indexer makespan:   ") +
+			QString::fromStdString(TimeStamp::secondsToString(makespan)) +
+			QStringLiteral(" (predicted ") +
+			QString::fromStdString(TimeStamp::secondsToString(predictedMakespan)) +
+			QStringLiteral(")"));
+	}
+
 	m_layout->addSpacing(12);
 	m_errorWidget = QtIndexingDialog::createErrorWidget(m_layout);
 
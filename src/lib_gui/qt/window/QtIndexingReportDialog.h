@@ -17,6 +17,8 @@ public:
 		size_t completedFileCount,
 		size_t totalFileCount,
 		float time,
+		float makespan,
+		float predictedMakespan,
 		bool interrupted,
 		bool shallow,
 		QWidget* parent = 0);
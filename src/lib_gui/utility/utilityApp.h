@@ -26,6 +26,9 @@ int executeProcessAndGetExitCode(
 void killRunningProcesses();
 int getIdealThreadCount();
 
+// resident set size of the current process in bytes, 0 if unknown
+size_t getResidentMemorySize();
+
 OsType getOsType();
 std::string getOsTypeString();
 ApplicationArchitectureType getApplicationArchitectureType();
@@ -121,3 +121,10 @@ TEST_CASE("file path filter finds slash if backslash was provided")
 
 	REQUIRE(filter.isMatching(FilePath(L"folder/test.h")));
 }
+
+TEST_CASE("file path filter matches all contained paths of directory only with trailing wildcards")
+{
+	REQUIRE(FilePathFilter(L"**/build/**").isMatchingAllContainedPaths(FilePath(L"src/build")));
+	REQUIRE(!FilePathFilter(L"**/build/**").isMatchingAllContainedPaths(FilePath(L"src/lib")));
+	REQUIRE(!FilePathFilter(L"**/build/*.h").isMatchingAllContainedPaths(FilePath(L"src/build")));
+}
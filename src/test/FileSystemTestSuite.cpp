@@ -143,3 +143,23 @@ TEST_CASE("find symlinked directories")
 	REQUIRE(dirs.size() == 2);
 #endif
 }
+
+TEST_CASE("find file infos without excluded files and directories")
+{
+#ifndef _WIN32
+	std::vector<FilePath> directoryPaths;
+	directoryPaths.push_back(FilePath(L"./data/FileSystemTestSuite"));
+
+	std::vector<FileInfo> files = FileSystem::getFileInfosFromPaths(
+		directoryPaths,
+		{L".h", L".hpp", L".cpp"},
+		false,
+		{FilePathFilter(L"**/Settings/**"), FilePathFilter(L"**.hpp")});
+
+	REQUIRE(files.size() == 4);
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/main.cpp"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/tictactoe.h"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/src/test.cpp"));
+	REQUIRE(isInFileInfos(files, L"./data/FileSystemTestSuite/src/test.h"));
+#endif
+}
@@ -0,0 +1,196 @@
+#include "catch.hpp"
+
+#ifdef __linux__
+
+#	include <atomic>
+#	include <chrono>
+#	include <condition_variable>
+#	include <fstream>
+#	include <functional>
+#	include <mutex>
+#	include <thread>
+
+#	include "FileSystem.h"
+#	include "FileWatcher.h"
+
+namespace
+{
+FilePath m_rootFolder = FilePath(L"data/FileWatcherTestSuite");
+
+void cleanup()
+{
+	if (m_rootFolder.recheckExists())
+	{
+		for (const FilePath& path: FileSystem::getFilePathsFromDirectory(m_rootFolder))
+		{
+			FileSystem::remove(path);
+		}
+
+		std::vector<FilePath> directoryPaths = FileSystem::getRecursiveSubDirectories(m_rootFolder);
+		for (auto it = directoryPaths.rbegin(); it != directoryPaths.rend(); it++)
+		{
+			FileSystem::remove(*it);
+		}
+		FileSystem::remove(m_rootFolder);
+	}
+	FileSystem::createDirectory(m_rootFolder);
+}
+
+FilePath writeFile(const std::wstring& fileName)
+{
+	const FilePath filePath = m_rootFolder.getConcatenated(fileName);
+	std::ofstream file;
+	file.open(filePath.str());
+	file << "int a;\n";
+	file.close();
+	return filePath;
+}
+
+bool waitFor(const std::function<bool()>& condition)
+{
+	for (int i = 0; i < 500 && !condition(); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	return condition();
+}
+}	 // namespace
+
+TEST_CASE("file watcher reports a burst of changes once after the debounce interval")
+{
+	cleanup();
+
+	std::atomic<int> reportCount(0);
+	FileWatcher watcher(200, [&reportCount]() { reportCount++; });
+	REQUIRE(watcher.start({m_rootFolder}));
+
+	for (int i = 0; i < 10; i++)
+	{
+		writeFile(L"file_" + std::to_wstring(i) + L".cpp");
+	}
+
+	REQUIRE(waitFor([&reportCount]() { return reportCount > 0; }));
+
+	bool overflowed = true;
+	REQUIRE(watcher.takeChangedFilePaths(overflowed).size() == 10);
+	REQUIRE(!overflowed);
+	REQUIRE(reportCount == 1);
+
+	watcher.stop();
+	cleanup();
+}
+
+TEST_CASE("file watcher collects changes until the reported changes got taken")
+{
+	cleanup();
+
+	std::atomic<int> reportCount(0);
+	FileWatcher watcher(50, [&reportCount]() { reportCount++; });
+	REQUIRE(watcher.start({m_rootFolder}));
+
+	writeFile(L"first.cpp");
+	REQUIRE(waitFor([&reportCount]() { return reportCount > 0; }));
+
+	// a refresh is still running and did not take the changes
+	writeFile(L"second.cpp");
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+	REQUIRE(reportCount == 1);
+	REQUIRE(watcher.hasChanges());
+
+	bool overflowed = false;
+	const std::set<FilePath> filePaths = watcher.takeChangedFilePaths(overflowed);
+	REQUIRE(filePaths.size() == 2);
+	REQUIRE(filePaths.count(m_rootFolder.getConcatenated(L"second.cpp")) == 1);
+	REQUIRE(!watcher.hasChanges());
+
+	writeFile(L"third.cpp");
+	REQUIRE(waitFor([&reportCount]() { return reportCount > 1; }));
+	REQUIRE(watcher.takeChangedFilePaths(overflowed).size() == 1);
+
+	watcher.stop();
+	cleanup();
+}
+
+TEST_CASE("file watcher reports files in newly created directories")
+{
+	cleanup();
+
+	std::atomic<int> reportCount(0);
+	FileWatcher watcher(100, [&reportCount]() { reportCount++; });
+	REQUIRE(watcher.start({m_rootFolder}));
+
+	FileSystem::createDirectory(m_rootFolder.getConcatenated(L"new/sub"));
+	const FilePath filePath = writeFile(L"new/sub/file.cpp");
+
+	REQUIRE(waitFor([&reportCount]() { return reportCount > 0; }));
+
+	bool overflowed = false;
+	REQUIRE(watcher.takeChangedFilePaths(overflowed).count(filePath) == 1);
+
+	// the new directories are watched from now on
+	const FilePath otherFilePath = writeFile(L"new/sub/other.cpp");
+	REQUIRE(waitFor([&reportCount]() { return reportCount > 1; }));
+	REQUIRE(watcher.takeChangedFilePaths(overflowed).count(otherFilePath) == 1);
+
+	watcher.stop();
+	cleanup();
+}
+
+TEST_CASE("file watcher reports an overflow of the event queue")
+{
+	int maximumQueuedEvents = 0;
+	std::ifstream limitFile("/proc/sys/fs/inotify/max_queued_events");
+	if (!(limitFile >> maximumQueuedEvents) || maximumQueuedEvents > 100000)
+	{
+		WARN("inotify event queue limit unknown or too large, skipping");
+		return;
+	}
+
+	cleanup();
+
+	// blocks the watcher thread in the first callback, so the kernel queue fills up meanwhile
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool reported = false;
+	bool released = false;
+
+	FileWatcher watcher(10, [&]() {
+		std::unique_lock<std::mutex> lock(mutex);
+		reported = true;
+		condition.notify_all();
+		condition.wait(lock, [&released]() { return released; });
+	});
+	REQUIRE(watcher.start({m_rootFolder}));
+
+	writeFile(L"first.cpp");
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		REQUIRE(condition.wait_for(
+			lock, std::chrono::seconds(5), [&reported]() { return reported; }));
+	}
+
+	// each write causes at least a close write event
+	for (int i = 0; i <= maximumQueuedEvents; i++)
+	{
+		writeFile(L"file_" + std::to_wstring(i % 100) + L".cpp");
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		released = true;
+	}
+	condition.notify_all();
+
+	bool overflowed = false;
+	REQUIRE(waitFor([&]() {
+		bool takenOverflowed = false;
+		watcher.takeChangedFilePaths(takenOverflowed);
+		overflowed = overflowed || takenOverflowed;
+		return overflowed;
+	}));
+
+	watcher.stop();
+	cleanup();
+}
+
+#endif	  // __linux__
@@ -0,0 +1,128 @@
+#include "catch.hpp"
+
+#include <vector>
+
+#include "FlatIntermediateStorage.h"
+#include "IntermediateStorage.h"
+
+namespace
+{
+std::shared_ptr<IntermediateStorage> writeAndRead(const IntermediateStorage& storage)
+{
+	FlatIntermediateStorage flatStorage(storage);
+	std::vector<uint64_t> buffer((flatStorage.getByteSize() + 7) / 8);
+	flatStorage.write(reinterpret_cast<char*>(buffer.data()));
+	return FlatIntermediateStorage::read(
+		reinterpret_cast<const char*>(buffer.data()), flatStorage.getByteSize());
+}
+}	 // namespace
+
+TEST_CASE("flat intermediate storage restores empty storage")
+{
+	IntermediateStorage storage;
+	std::shared_ptr<IntermediateStorage> result = writeAndRead(storage);
+
+	REQUIRE(result);
+	REQUIRE(result->getStorageNodes().empty());
+	REQUIRE(result->getStorageSourceLocations().empty());
+	REQUIRE(result->getNextId() == storage.getNextId());
+}
+
+TEST_CASE("flat intermediate storage restores all elements")
+{
+	IntermediateStorage storage;
+	const Id fileId = storage.addNode(StorageNodeData(1, L"fileä中")).first;
+	storage.addFile(StorageFile(fileId, L"/path/to/file.cpp", L"cpp", "", true, false));
+	storage.addFileInterfaceHash(fileId, 0xfedcba9876543210ULL);
+	const Id nodeId = storage.addNode(StorageNodeData(2, L"foo")).first;
+	storage.addSymbol(StorageSymbol(nodeId, 3));
+	const Id edgeId = storage.addEdge(StorageEdgeData(4, fileId, nodeId));
+	const Id localSymbolId = storage.addLocalSymbol(StorageLocalSymbolData(L"local"));
+	const Id locationId = storage.addSourceLocation(StorageSourceLocationData(fileId, 12, 5, 14, 1, 2));
+	storage.addSourceLocation(StorageSourceLocationData(fileId, 3, 7, 3, 9, 1));
+	storage.addOccurrence(StorageOccurrence(nodeId, locationId));
+	storage.addComponentAccess(StorageComponentAccess(edgeId, 1));
+	storage.addElementComponent(StorageElementComponent(edgeId, 1, L"component"));
+	storage.addError(StorageErrorData(L"error", L"/path/to/file.cpp", true, false));
+	storage.addIndexingCosts({StorageIndexingCost(L"/path/to/file.cpp", 1200, 300000, 42)});
+
+	std::shared_ptr<IntermediateStorage> result = writeAndRead(storage);
+	REQUIRE(result);
+
+	REQUIRE(result->getStorageNodes().size() == 2);
+	REQUIRE(result->getStorageNodes()[0].serializedName == L"fileä中");
+	REQUIRE(result->getStorageNodes()[1].type == 2);
+
+	REQUIRE(result->getStorageFiles().size() == 1);
+	REQUIRE(result->getStorageFiles()[0].filePath == L"/path/to/file.cpp");
+	REQUIRE(result->getStorageFiles()[0].indexed);
+	REQUIRE(!result->getStorageFiles()[0].complete);
+	REQUIRE(result->getStorageFiles()[0].interfaceHash == 0xfedcba9876543210ULL);
+
+	REQUIRE(result->getStorageSymbols().size() == 1);
+	REQUIRE(result->getStorageSymbols()[0].definitionKind == 3);
+
+	REQUIRE(result->getStorageEdges().size() == 1);
+	REQUIRE(result->getStorageEdges()[0].sourceNodeId == fileId);
+	REQUIRE(result->getStorageEdges()[0].targetNodeId == nodeId);
+
+	REQUIRE(result->getStorageLocalSymbols().size() == 1);
+	REQUIRE(result->getStorageLocalSymbols().begin()->id == localSymbolId);
+	REQUIRE(result->getStorageLocalSymbols().begin()->name == L"local");
+
+	REQUIRE(result->getStorageSourceLocations().size() == 2);
+	auto it = storage.getStorageSourceLocations().begin();
+	for (const StorageSourceLocation& location: result->getStorageSourceLocations())
+	{
+		REQUIRE(location.id == it->id);
+		REQUIRE(location.fileNodeId == it->fileNodeId);
+		REQUIRE(location.startLine == it->startLine);
+		REQUIRE(location.startCol == it->startCol);
+		REQUIRE(location.endLine == it->endLine);
+		REQUIRE(location.endCol == it->endCol);
+		REQUIRE(location.type == it->type);
+		it++;
+	}
+
+	REQUIRE(result->getStorageOccurrences().size() == 1);
+	REQUIRE(result->getComponentAccesses().size() == 1);
+	REQUIRE(result->getElementComponents().size() == 1);
+	REQUIRE(result->getElementComponents().begin()->data == L"component");
+
+	REQUIRE(result->getErrors().size() == 1);
+	REQUIRE(result->getErrors()[0].message == L"error");
+	REQUIRE(result->getErrors()[0].fatal);
+
+	REQUIRE(result->getIndexingCosts().size() == 1);
+	REQUIRE(result->getIndexingCosts()[0].filePath == L"/path/to/file.cpp");
+	REQUIRE(result->getIndexingCosts()[0].indexingTimeMS == 1200);
+	REQUIRE(result->getIndexingCosts()[0].peakMemoryKB == 300000);
+	REQUIRE(result->getIndexingCosts()[0].resultSizeKB == 42);
+
+	REQUIRE(result->getNextId() == storage.getNextId());
+}
+
+TEST_CASE("flat intermediate storage rejects invalid data")
+{
+	std::vector<uint64_t> buffer(64, 0);
+	REQUIRE(!FlatIntermediateStorage::read(reinterpret_cast<const char*>(buffer.data()), 8));
+	REQUIRE(!FlatIntermediateStorage::read(
+		reinterpret_cast<const char*>(buffer.data()), buffer.size() * 8));
+}
+
+TEST_CASE("flat intermediate storage stores equal strings once")
+{
+	const std::wstring filePath = L"/path/to/" + std::wstring(1000, L'a') + L".cpp";
+
+	IntermediateStorage storage;
+	storage.addError(StorageErrorData(L"error", filePath, true, false));
+	const size_t byteSize = FlatIntermediateStorage(storage).getByteSize();
+
+	storage.addIndexingCosts({StorageIndexingCost(filePath, 1200, 300000, 42)});
+	REQUIRE(FlatIntermediateStorage(storage).getByteSize() - byteSize < filePath.size());
+
+	std::shared_ptr<IntermediateStorage> result = writeAndRead(storage);
+	REQUIRE(result);
+	REQUIRE(result->getErrors()[0].translationUnit == filePath);
+	REQUIRE(result->getIndexingCosts()[0].filePath == filePath);
+}
@@ -0,0 +1,32 @@
+#include "catch.hpp"
+
+#include "IndexingCostModel.h"
+
+TEST_CASE("indexing cost model schedules longest expected indexing time first")
+{
+	IndexingCostModel model(
+		{StorageIndexingCost(L"data/a.cpp", 100, 0, 0), StorageIndexingCost(L"data/b.cpp", 300, 0, 0)});
+
+	// the unrecorded file is estimated with the average time per byte of the recorded files
+	std::vector<FilePath> filePaths = model.getScheduledSourceFilePaths(
+		{FilePath(L"data/a.cpp"), FilePath(L"data/b.cpp"), FilePath(L"data/c.cpp")});
+
+	REQUIRE(filePaths.size() == 3);
+	REQUIRE(filePaths[0].wstr() == L"data/b.cpp");
+	REQUIRE(filePaths[1].wstr() == L"data/c.cpp");
+	REQUIRE(filePaths[2].wstr() == L"data/a.cpp");
+
+	REQUIRE(model.getPredictedMakespanMS(1) == 600);
+	REQUIRE(model.getPredictedMakespanMS(2) == 300);
+}
+
+TEST_CASE("indexing cost model predicts nothing without recorded indexing times")
+{
+	IndexingCostModel model({StorageIndexingCost(L"data/a.cpp", 100, 0, 0)});
+
+	std::vector<FilePath> filePaths = model.getScheduledSourceFilePaths(
+		{FilePath(L"data/b.cpp"), FilePath(L"data/c.cpp")});
+
+	REQUIRE(filePaths.size() == 2);
+	REQUIRE(model.getPredictedMakespanMS(2) == 0);
+}
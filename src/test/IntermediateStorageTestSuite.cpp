@@ -0,0 +1,129 @@
+#include "catch.hpp"
+
+#include <map>
+#include <set>
+
+#include "IntermediateStorage.h"
+#include "TimeStamp.h"
+
+namespace
+{
+// roughly shaped like a large translation unit: long qualified names that share their prefixes and
+// many more source locations and occurrences than nodes, most of which get recorded repeatedly
+struct RecordedTranslationUnit
+{
+	RecordedTranslationUnit(size_t nodeCount, size_t locationCount)
+	{
+		for (size_t i = 0; i < nodeCount; i++)
+		{
+			nodes.emplace_back(
+				1,
+				L"\tsnamespace_" + std::to_wstring(i % 50) + L"\tsclass_" +
+					std::to_wstring(i % 1000) + L"\tsmember_" + std::to_wstring(i) + L"\tp() const");
+		}
+
+		for (size_t i = 0; i < locationCount; i++)
+		{
+			const size_t line = (i * 7919) % (locationCount / 4 + 1);
+			locations.emplace_back(1 + i % 20, line, i % 80, line, i % 80 + 10, 1);
+		}
+	}
+
+	std::vector<StorageNodeData> nodes;
+	std::vector<StorageSourceLocationData> locations;
+};
+
+float recordWithIntermediateStorage(const RecordedTranslationUnit& unit)
+{
+	TimeStamp start = TimeStamp::now();
+
+	IntermediateStorage storage;
+	std::vector<Id> nodeIds;
+	for (const StorageNodeData& node: unit.nodes)
+	{
+		nodeIds.push_back(storage.addNode(node).first);
+	}
+	for (size_t i = 0; i < unit.locations.size(); i++)
+	{
+		const Id locationId = storage.addSourceLocation(unit.locations[i]);
+		storage.addOccurrence(StorageOccurrence(nodeIds[i % nodeIds.size()], locationId));
+		storage.addNode(unit.nodes[i % unit.nodes.size()]);
+	}
+	storage.getStorageOccurrences();
+
+	return static_cast<float>(TimeStamp::durationSeconds(start));
+}
+
+float recordWithOrderedContainers(const RecordedTranslationUnit& unit)
+{
+	TimeStamp start = TimeStamp::now();
+
+	Id nextId = 1;
+	std::map<StorageNodeData, Id> nodes;
+	std::set<StorageSourceLocation> locations;
+	std::set<StorageOccurrence> occurrences;
+
+	std::vector<Id> nodeIds;
+	for (const StorageNodeData& node: unit.nodes)
+	{
+		nodeIds.push_back(nodes.emplace(node, nextId++).first->second);
+	}
+	for (size_t i = 0; i < unit.locations.size(); i++)
+	{
+		auto it = locations.find(StorageSourceLocation(0, unit.locations[i]));
+		if (it == locations.end())
+		{
+			it = locations.emplace(nextId++, unit.locations[i]).first;
+		}
+		occurrences.emplace(nodeIds[i % nodeIds.size()], it->id);
+		nodes.find(unit.nodes[i % unit.nodes.size()]);
+	}
+
+	return static_cast<float>(TimeStamp::durationSeconds(start));
+}
+}	 // namespace
+
+TEST_CASE("intermediate storage deduplicates and sorts recorded data")
+{
+	IntermediateStorage storage;
+
+	const Id nodeId = storage.addNode(StorageNodeData(1, L"b")).first;
+	REQUIRE(storage.addNode(StorageNodeData(4, L"b")) == std::make_pair(nodeId, false));
+	REQUIRE(storage.getStorageNodes().size() == 1);
+	REQUIRE(storage.getStorageNodes()[0].type == 4);
+
+	const Id laterLocationId = storage.addSourceLocation(
+		StorageSourceLocationData(1, 5, 1, 5, 3, 1));
+	const Id earlierLocationId = storage.addSourceLocation(
+		StorageSourceLocationData(1, 2, 1, 2, 3, 1));
+	storage.addOccurrence(StorageOccurrence(nodeId, laterLocationId));
+	storage.addOccurrence(StorageOccurrence(nodeId, earlierLocationId));
+	storage.addOccurrence(StorageOccurrence(nodeId, laterLocationId));
+
+	REQUIRE(storage.getSourceLocationCount() == 2);
+	REQUIRE(storage.getStorageSourceLocations().size() == 2);
+	REQUIRE(storage.getStorageSourceLocations()[0].id == earlierLocationId);
+	REQUIRE(storage.getStorageOccurrences().size() == 2);
+
+	// ids stay the same after the data got sorted
+	REQUIRE(
+		storage.addSourceLocation(StorageSourceLocationData(1, 5, 1, 5, 3, 1)) == laterLocationId);
+
+	const Id edgeId = storage.addEdge(StorageEdgeData(1, nodeId, nodeId));
+	REQUIRE(storage.addEdge(StorageEdgeData(1, nodeId, nodeId)) == edgeId);
+}
+
+TEST_CASE(
+	"intermediate storage records large translation unit compared to ordered containers",
+	"[.benchmark]")
+{
+	const RecordedTranslationUnit unit(200000, 2000000);
+
+	const float orderedSeconds = recordWithOrderedContainers(unit);
+	const float hashedSeconds = recordWithIntermediateStorage(unit);
+
+	WARN(
+		"ordered containers: " << TimeStamp::secondsToString(orderedSeconds)
+							   << ", intermediate storage: "
+							   << TimeStamp::secondsToString(hashedSeconds));
+}
@@ -0,0 +1,179 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include <atomic>
+#	include <chrono>
+#	include <thread>
+
+#	include "InProcessIntermediateStorageManager.h"
+#	include "IndexerBase.h"
+#	include "IndexerCommandCxx.h"
+#	include "IntermediateStorage.h"
+#	include "InterprocessIndexer.h"
+#	include "InterprocessIndexerCommandManager.h"
+#	include "InterprocessIndexingStatusManager.h"
+#	include "LanguagePackage.h"
+#	include "LanguagePackageManager.h"
+#	include "TimeStamp.h"
+#	include "utilityUuid.h"
+
+namespace
+{
+// stands in for the clang indexer, so only the handoff between the indexing stages is measured
+class TestIndexer: public IndexerBase
+{
+public:
+	IndexerCommandType getSupportedIndexerCommandType() const override
+	{
+		return IndexerCommandCxx::getStaticIndexerCommandType();
+	}
+
+	std::shared_ptr<IntermediateStorage> index(
+		std::shared_ptr<IndexerCommand> indexerCommand) override
+	{
+		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		storage->addNode(
+			StorageNodeData(1, L"\ts" + indexerCommand->getSourceFilePath().wstr() + L"\tp"));
+		return storage;
+	}
+
+	void interrupt() override {}
+
+	void setIndexedHeaderManager(std::shared_ptr<InterprocessIndexedHeaderManager>) override {}
+};
+
+class TestLanguagePackage: public LanguagePackage
+{
+public:
+	std::vector<std::shared_ptr<IndexerBase>> instantiateSupportedIndexers() const override
+	{
+		return {std::make_shared<TestIndexer>()};
+	}
+};
+
+// runs the indexer threads on many small files while the app side refills the command queue and
+// fetches the results like TaskFillIndexerCommandsQueue and TaskBuildIndex do. the app side either
+// waits for notifications or sleeps for the intervals it used before. returns the fetched count.
+size_t runIndexing(size_t fileCount, size_t indexerCount, bool waitForNotifications)
+{
+	const std::string uuid = utility::getUuidString();
+	const size_t maximumQueueSize = 20;
+
+	LanguagePackageManager::getInstance()->addPackage(std::make_shared<TestLanguagePackage>());
+
+	InterprocessIndexerCommandManager commandManager(uuid, 0, true);
+	InterprocessIndexingStatusManager statusManager(uuid, 0, true);
+	std::shared_ptr<InProcessIntermediateStorageManager> storageManager =
+		std::make_shared<InProcessIntermediateStorageManager>();
+
+	std::atomic<size_t> runningIndexerCount(indexerCount);
+	std::vector<std::thread> indexerThreads;
+	for (size_t i = 0; i < indexerCount; i++)
+	{
+		indexerThreads.emplace_back([&, i]() {
+			{
+				InterprocessIndexer indexer(uuid, i + 1, storageManager, 0);
+				indexer.work();
+			}
+			runningIndexerCount--;
+		});
+	}
+
+	std::thread fillerThread([&]() {
+		size_t pushedCount = 0;
+		while (pushedCount < fileCount)
+		{
+			const size_t refillAmount = maximumQueueSize - commandManager.indexerCommandCount();
+
+			std::vector<std::shared_ptr<IndexerCommand>> commands;
+			while (pushedCount < fileCount && commands.size() < refillAmount)
+			{
+				commands.push_back(std::make_shared<IndexerCommandCxx>(
+					FilePath(L"file_" + std::to_wstring(pushedCount++) + L".cpp"),
+					std::set<FilePath>(),
+					std::set<FilePathFilter>(),
+					std::set<FilePathFilter>(),
+					FilePath(),
+					std::vector<std::wstring>()));
+			}
+			if (!commands.empty())
+			{
+				commandManager.pushIndexerCommands(commands);
+			}
+
+			if (waitForNotifications)
+			{
+				commandManager.waitForIndexerCommandCountBelow(maximumQueueSize / 2 + 1, 200);
+			}
+			else
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			}
+		}
+		commandManager.setIndexerCommandQueueClosed(true);
+	});
+
+	size_t fetchedCount = 0;
+	while (true)
+	{
+		if (storageManager->popIntermediateStorage())
+		{
+			fetchedCount++;
+			continue;
+		}
+
+		// the indexers only stop once the queue got closed and all results were pushed
+		if (!runningIndexerCount)
+		{
+			break;
+		}
+
+		if (waitForNotifications)
+		{
+			statusManager.waitForIndexingStatusChange(50);
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		}
+	}
+
+	fillerThread.join();
+	for (std::thread& thread: indexerThreads)
+	{
+		thread.join();
+	}
+
+	LanguagePackageManager::destroyInstance();
+
+	return fetchedCount;
+}
+}	 // namespace
+
+TEST_CASE("interprocess indexer hands over the results of all queued commands")
+{
+	REQUIRE(runIndexing(50, 2, true) == 50);
+}
+
+TEST_CASE("interprocess indexer hands over many small files", "[.benchmark]")
+{
+	const size_t fileCount = 1000;
+	const size_t indexerCount = 4;
+
+	const TimeStamp pollingStart = TimeStamp::now();
+	REQUIRE(runIndexing(fileCount, indexerCount, false) == fileCount);
+	const double pollingSeconds = TimeStamp::durationSeconds(pollingStart);
+
+	const TimeStamp waitingStart = TimeStamp::now();
+	REQUIRE(runIndexing(fileCount, indexerCount, true) == fileCount);
+	const double waitingSeconds = TimeStamp::durationSeconds(waitingStart);
+
+	WARN(
+		fileCount << " files with " << indexerCount << " indexers, fixed sleeps: " << pollingSeconds
+				  << " s, notifications: " << waitingSeconds << " s");
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
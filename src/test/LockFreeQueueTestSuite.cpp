@@ -0,0 +1,64 @@
+#include "catch.hpp"
+
+#include <thread>
+#include <vector>
+
+#include "LockFreeQueue.h"
+
+TEST_CASE("lock free queue pops elements in insertion order")
+{
+	LockFreeQueue<int> queue;
+	int value = 0;
+
+	REQUIRE(!queue.pop(value));
+
+	queue.push(1);
+	queue.push(2);
+
+	REQUIRE(queue.pop(value));
+	REQUIRE(value == 1);
+	REQUIRE(queue.pop(value));
+	REQUIRE(value == 2);
+	REQUIRE(!queue.pop(value));
+}
+
+TEST_CASE("lock free queue receives elements of all producers")
+{
+	LockFreeQueue<int> queue;
+
+	const int producerCount = 4;
+	const int valueCount = 1000;
+
+	std::vector<std::thread> producers;
+	for (int i = 0; i < producerCount; i++)
+	{
+		producers.emplace_back([&queue, i]() {
+			for (int j = 0; j < valueCount; j++)
+			{
+				queue.push(i * valueCount + j);
+			}
+		});
+	}
+
+	std::vector<int> lastValues(producerCount, -1);
+	int poppedCount = 0;
+	while (poppedCount < producerCount * valueCount)
+	{
+		int value = 0;
+		if (queue.pop(value))
+		{
+			// values of a single producer keep their order
+			REQUIRE(value % valueCount > lastValues[value / valueCount]);
+			lastValues[value / valueCount] = value % valueCount;
+			poppedCount++;
+		}
+	}
+
+	for (std::thread& producer: producers)
+	{
+		producer.join();
+	}
+
+	int value = 0;
+	REQUIRE(!queue.pop(value));
+}
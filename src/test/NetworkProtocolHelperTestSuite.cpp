@@ -69,3 +69,21 @@ TEST_CASE("parse message")
 	REQUIRE(networkMessage.column == 0);
 	REQUIRE(networkMessage.valid == false);
 }
+
+TEST_CASE("parse reindex file message")
+{
+	const std::wstring filePath = L"C:/Users/Manuel/imporant/file/location/fileName.cpp";
+
+	const std::wstring message = L"reindexFile>>" + filePath + L"<EOM>";
+	REQUIRE(
+		NetworkProtocolHelper::getMessageType(message) ==
+		NetworkProtocolHelper::MESSAGE_TYPE::REINDEX_FILE);
+
+	NetworkProtocolHelper::ReindexFileMessage networkMessage =
+		NetworkProtocolHelper::parseReindexFileMessage(message);
+	REQUIRE(networkMessage.filePath.wstr() == filePath);
+	REQUIRE(networkMessage.valid == true);
+
+	networkMessage = NetworkProtocolHelper::parseReindexFileMessage(L"reindexFile>><EOM>");
+	REQUIRE(networkMessage.valid == false);
+}
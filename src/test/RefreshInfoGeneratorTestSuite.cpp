@@ -2,6 +2,7 @@
 
 #include <QDateTime>
 
+#include "ApplicationSettings.h"
 #include "FileSystem.h"
 #include "PersistentStorage.h"
 #include "ProjectSettings.h"
@@ -1070,3 +1071,244 @@ TEST_CASE(
 	}
 	cleanup();
 }
+
+TEST_CASE("refresh info for updated files compares content of touched files")
+{
+	cleanup();
+	{
+		const FilePath sourceFilePath = m_sourceFolder.getConcatenated(L"touched_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(
+			std::shared_ptr<SourceGroupTest>(new SourceGroupTest({sourceFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		// the file content gets stored along with an outdated modification time
+		addFileToFileSystem(sourceFilePath);
+		addVeryOldFileToStorage(sourceFilePath, true, true, storage);
+
+		storage->buildCaches();
+
+		const RefreshInfo touchedRefreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+		REQUIRE(0 == touchedRefreshInfo.filesToClear.size());
+		REQUIRE(0 == touchedRefreshInfo.filesToIndex.size());
+
+		{
+			std::ofstream file;
+			file.open(sourceFilePath.str());
+			file << "This is some file context.\n";	   // same size, different content
+			file.close();
+		}
+
+		const RefreshInfo changedRefreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+		REQUIRE(1 == changedRefreshInfo.filesToClear.size());
+		REQUIRE(1 == changedRefreshInfo.filesToIndex.size());
+	}
+	cleanup();
+}
+
+TEST_CASE("refresh info for updated files indexes changed header with interface hash on its own")
+{
+	cleanup();
+	ApplicationSettings::getInstance()->setInterfaceHashRefreshEnabled(true);
+	{
+		const FilePath headerFilePath = m_sourceFolder.getConcatenated(L"changed_file.h");
+		const FilePath firstSourceFilePath = m_sourceFolder.getConcatenated(L"first_file.cpp");
+		const FilePath secondSourceFilePath = m_sourceFolder.getConcatenated(L"second_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(new SourceGroupTest(
+			{firstSourceFilePath, secondSourceFilePath},
+			{firstSourceFilePath, secondSourceFilePath, headerFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		const Id headerFileId = addVeryOldFileToStorage(headerFilePath, true, true, storage);
+		addFileToFileSystem(headerFilePath);
+		const Id firstSourceFileId = addVeryNewFileToStorage(
+			firstSourceFilePath, true, true, storage);
+		addFileToFileSystem(firstSourceFilePath);
+		const Id secondSourceFileId = addVeryNewFileToStorage(
+			secondSourceFilePath, true, true, storage);
+		addFileToFileSystem(secondSourceFilePath);
+
+		StorageFile headerFile(
+			headerFileId, headerFilePath.wstr(), L"someLanguage", "", true, true);
+		headerFile.interfaceHash = 42;
+		storage->addFile(headerFile);
+
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, firstSourceFileId, headerFileId));
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, secondSourceFileId, headerFileId));
+
+		storage->buildCaches();
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		REQUIRE(1 == refreshInfo.interfaceHashes.size());
+		REQUIRE(42 == refreshInfo.interfaceHashes.at(headerFilePath));
+		REQUIRE(2 == refreshInfo.filesToClear.size());
+		REQUIRE(1 == refreshInfo.filesToIndex.size());
+		REQUIRE(utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToClear), headerFilePath));
+
+		REQUIRE(RefreshInfoGenerator::getRefreshInfoForChangedInterfaces(
+					sourceGroups, storage, refreshInfo.interfaceHashes)
+					.filesToIndex.empty());
+
+		headerFile.interfaceHash = 43;
+		storage->addFile(headerFile);
+
+		const RefreshInfo dependentsRefreshInfo =
+			RefreshInfoGenerator::getRefreshInfoForChangedInterfaces(
+				sourceGroups, storage, refreshInfo.interfaceHashes);
+
+		REQUIRE(2 == dependentsRefreshInfo.filesToClear.size());
+		REQUIRE(2 == dependentsRefreshInfo.filesToIndex.size());
+		REQUIRE(!utility::containsElement<FilePath>(
+			utility::toVector(dependentsRefreshInfo.filesToClear), headerFilePath));
+	}
+	ApplicationSettings::getInstance()->setInterfaceHashRefreshEnabled(false);
+	cleanup();
+}
+
+TEST_CASE("refresh info for updated files clears dependents of changed header with interface hash")
+{
+	cleanup();
+	{
+		const FilePath headerFilePath = m_sourceFolder.getConcatenated(L"changed_file.h");
+		const FilePath firstSourceFilePath = m_sourceFolder.getConcatenated(L"first_file.cpp");
+		const FilePath secondSourceFilePath = m_sourceFolder.getConcatenated(L"second_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(new SourceGroupTest(
+			{firstSourceFilePath, secondSourceFilePath},
+			{firstSourceFilePath, secondSourceFilePath, headerFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		const Id headerFileId = addVeryOldFileToStorage(headerFilePath, true, true, storage);
+		addFileToFileSystem(headerFilePath);
+		const Id firstSourceFileId = addVeryNewFileToStorage(
+			firstSourceFilePath, true, true, storage);
+		addFileToFileSystem(firstSourceFilePath);
+		const Id secondSourceFileId = addVeryNewFileToStorage(
+			secondSourceFilePath, true, true, storage);
+		addFileToFileSystem(secondSourceFilePath);
+
+		StorageFile headerFile(
+			headerFileId, headerFilePath.wstr(), L"someLanguage", "", true, true);
+		headerFile.interfaceHash = 42;
+		storage->addFile(headerFile);
+
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, firstSourceFileId, headerFileId));
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, secondSourceFileId, headerFileId));
+
+		storage->buildCaches();
+
+		// indexing dependents only if the interface changed is not enabled by default
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		REQUIRE(refreshInfo.interfaceHashes.empty());
+		REQUIRE(3 == refreshInfo.filesToClear.size());
+		REQUIRE(2 == refreshInfo.filesToIndex.size());
+	}
+	cleanup();
+}
+
+TEST_CASE("refresh info for updated files clears dependents of header with pending interface check")
+{
+	cleanup();
+	{
+		const FilePath headerFilePath = m_sourceFolder.getConcatenated(L"header_file.h");
+		const FilePath firstSourceFilePath = m_sourceFolder.getConcatenated(L"first_file.cpp");
+		const FilePath secondSourceFilePath = m_sourceFolder.getConcatenated(L"second_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(new SourceGroupTest(
+			{firstSourceFilePath, secondSourceFilePath},
+			{firstSourceFilePath, secondSourceFilePath, headerFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		// the header was indexed on its own, then the refresh stopped before its second pass
+		const Id headerFileId = addVeryNewFileToStorage(headerFilePath, true, true, storage);
+		addFileToFileSystem(headerFilePath);
+		const Id firstSourceFileId = addVeryNewFileToStorage(
+			firstSourceFilePath, true, true, storage);
+		addFileToFileSystem(firstSourceFilePath);
+		const Id secondSourceFileId = addVeryNewFileToStorage(
+			secondSourceFilePath, true, true, storage);
+		addFileToFileSystem(secondSourceFilePath);
+
+		StorageFile headerFile(
+			headerFileId, headerFilePath.wstr(), L"someLanguage", "", true, true);
+		headerFile.interfaceHash = 43;
+		storage->addFile(headerFile);
+		storage->setPendingInterfaceHashes({{headerFilePath, 42}});
+		REQUIRE(42 == storage->getPendingInterfaceHashes().at(headerFilePath));
+
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, firstSourceFileId, headerFileId));
+		storage->addEdge(StorageEdgeData(Edge::EDGE_INCLUDE, secondSourceFileId, headerFileId));
+
+		storage->buildCaches();
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		REQUIRE(2 == refreshInfo.filesToClear.size());
+		REQUIRE(2 == refreshInfo.filesToIndex.size());
+		REQUIRE(!utility::containsElement<FilePath>(
+			utility::toVector(refreshInfo.filesToClear), headerFilePath));
+
+		// the dependents are up to date if the interface stayed the same
+		storage->setPendingInterfaceHashes({{headerFilePath, 43}});
+		REQUIRE(RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(sourceGroups, storage)
+					.filesToClear.empty());
+	}
+	cleanup();
+}
+
+TEST_CASE("refresh info for modified files only checks the modified files")
+{
+	cleanup();
+	{
+		const FilePath modifiedFilePath = m_sourceFolder.getConcatenated(L"modified_file.cpp");
+		const FilePath otherFilePath = m_sourceFolder.getConcatenated(L"other_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(new SourceGroupTest(
+			{modifiedFilePath, otherFilePath}, {modifiedFilePath, otherFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		addVeryOldFileToStorage(modifiedFilePath, true, true, storage);
+		addFileToFileSystem(modifiedFilePath);
+		addVeryOldFileToStorage(otherFilePath, true, true, storage);
+		addFileToFileSystem(otherFilePath);
+
+		storage->buildCaches();
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForModifiedFiles(
+			sourceGroups, storage, {modifiedFilePath});
+
+		REQUIRE(1 == refreshInfo.filesToClear.size());
+		REQUIRE(1 == refreshInfo.filesToIndex.size());
+		REQUIRE(modifiedFilePath == *refreshInfo.filesToIndex.begin());
+	}
+	cleanup();
+}
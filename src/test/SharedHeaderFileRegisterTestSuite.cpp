@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include "SharedHeaderFileRegister.h"
+#	include "TextAccess.h"
+
+namespace
+{
+bool isIndependentOfIncludingFile(const std::string& text)
+{
+	return SharedHeaderFileRegister::isIndependentOfIncludingFile(
+		TextAccess::createFromString(text));
+}
+}	 // namespace
+
+TEST_CASE("shared header register accepts header with pragma once")
+{
+	REQUIRE(isIndependentOfIncludingFile(
+		"// comment\n"
+		"#pragma once\n"
+		"class A {};\n"));
+}
+
+TEST_CASE("shared header register accepts header with include guard")
+{
+	REQUIRE(isIndependentOfIncludingFile(
+		"/* license\n"
+		"   text */\n"
+		"#ifndef A_H\n"
+		"#  define A_H\n"
+		"#include <vector>\n"
+		"#include \"b.h\"\n"
+		"class A {};\n"
+		"#endif // A_H\n"));
+}
+
+TEST_CASE("shared header register rejects header without include guard")
+{
+	REQUIRE(!isIndependentOfIncludingFile("class A {};\n"));
+	REQUIRE(!isIndependentOfIncludingFile(
+		"class B;\n"
+		"#ifndef A_H\n"
+		"#define A_H\n"
+		"#endif\n"));
+	REQUIRE(!isIndependentOfIncludingFile(
+		"#ifndef A_H\n"
+		"#define B_H\n"
+		"#endif\n"));
+}
+
+TEST_CASE("shared header register accepts conditions on macros of the header or the compiler")
+{
+	REQUIRE(isIndependentOfIncludingFile(
+		"#ifndef A_H\n"
+		"#define A_H\n"
+		"#define A_VERSION 2\n"
+		"#if A_VERSION > 1 && defined(__cplusplus) && __cplusplus >= 201103L\n"
+		"class A {};\n"
+		"#elif defined(_WIN32)\n"
+		"#endif\n"
+		"#endif\n"));
+}
+
+TEST_CASE("shared header register rejects conditions on macros of the including file")
+{
+	REQUIRE(!isIndependentOfIncludingFile(
+		"#pragma once\n"
+		"#ifdef USE_FLOAT\n"
+		"typedef float real;\n"
+		"#endif\n"));
+	REQUIRE(!isIndependentOfIncludingFile(
+		"#ifndef A_H\n"
+		"#define A_H\n"
+		"#if A_VERSION > \\\n"
+		"	1\n"
+		"#endif\n"
+		"#endif\n"));
+}
+
+TEST_CASE("shared header register ignores conditions in comments")
+{
+	REQUIRE(isIndependentOfIncludingFile(
+		"#pragma once\n"
+		"// #ifdef USE_FLOAT\n"
+		"/*\n"
+		"#ifdef USE_FLOAT\n"
+		"*/\n"
+		"const char* s = \"/*\";\n"));
+}
+
+TEST_CASE("shared header register rejects computed includes")
+{
+	REQUIRE(!isIndependentOfIncludingFile(
+		"#pragma once\n"
+		"#include CONFIG_HEADER\n"));
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -96,3 +96,46 @@ TEST_CASE("shared memory")
 		}
 	}
 }
+
+TEST_CASE("shared memory wait for notification times out without notification")
+{
+	SharedMemory memory("memory", 1000, SharedMemory::CREATE_AND_DELETE);
+
+	SharedMemory::ScopedAccess access(&memory);
+	REQUIRE(!access.waitForNotification(10));
+	REQUIRE(access.getMemorySize() == 1000);
+}
+
+TEST_CASE("shared memory wait for notification wakes up on notification")
+{
+	SharedMemory memory("memory", 1000, SharedMemory::CREATE_AND_DELETE);
+
+	{
+		SharedMemory::ScopedAccess access(&memory);
+		*access.accessValue<int>("count") = 0;
+	}
+
+	std::thread producer([]() {
+		SharedMemory memory("memory", 0, SharedMemory::OPEN_ONLY);
+		for (int i = 0; i < 10; i++)
+		{
+			SharedMemory::ScopedAccess access(&memory);
+			*access.accessValue<int>("count") += 1;
+			access.notifyAll();
+		}
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	{
+		SharedMemory::ScopedAccess access(&memory);
+		while (*access.accessValue<int>("count") < 10)
+		{
+			access.waitForNotification(10000);
+		}
+	}
+	const auto duration = std::chrono::steady_clock::now() - start;
+
+	producer.join();
+
+	REQUIRE(duration < std::chrono::seconds(5));
+}
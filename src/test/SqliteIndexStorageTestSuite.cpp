@@ -1,7 +1,349 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include "Edge.h"
+#include "FileDependencyIndex.h"
 #include "FileSystem.h"
 #include "SqliteIndexStorage.h"
+#include "TextAccess.h"
+#include "TimeStamp.h"
+
+namespace
+{
+// runs queries the way the storage did before it bound its parameters, with the values inlined into
+// the query text, which has to be parsed and planned again for each call
+class InlinedQueryIndexStorage: public SqliteIndexStorage
+{
+public:
+	InlinedQueryIndexStorage(const FilePath& dbFilePath): SqliteIndexStorage(dbFilePath) {}
+
+	std::vector<StorageNode> getNodesByIdsInlined(const std::vector<Id>& ids) const
+	{
+		std::vector<StorageNode> nodes;
+		CppSQLite3Query q = executeQuery(
+			"SELECT id, type, serialized_name FROM node WHERE id IN (" +
+			utility::join(utility::toStrings(ids), ',') + ");");
+		while (!q.eof())
+		{
+			nodes.emplace_back(
+				q.getIntField(0, 0),
+				q.getIntField(1, -1),
+				utility::decodeFromUtf8(q.getStringField(2, "")));
+			q.nextRow();
+		}
+		return nodes;
+	}
+
+	std::vector<StorageEdge> getEdgesBySourceIdsInlined(const std::vector<Id>& sourceIds) const
+	{
+		std::vector<StorageEdge> edges;
+		CppSQLite3Query q = executeQuery(
+			"SELECT id, type, source_node_id, target_node_id FROM edge WHERE source_node_id IN (" +
+			utility::join(utility::toStrings(sourceIds), ',') + ");");
+		while (!q.eof())
+		{
+			edges.emplace_back(
+				q.getIntField(0, 0),
+				q.getIntField(1, -1),
+				q.getIntField(2, 0),
+				q.getIntField(3, 0));
+			q.nextRow();
+		}
+		return edges;
+	}
+
+	std::vector<StorageOccurrence> getOccurrencesForElementIdsInlined(
+		const std::vector<Id>& elementIds) const
+	{
+		std::vector<StorageOccurrence> occurrences;
+		CppSQLite3Query q = executeQuery(
+			"SELECT element_id, source_location_id FROM occurrence WHERE element_id IN (" +
+			utility::join(utility::toStrings(elementIds), ',') + ");");
+		while (!q.eof())
+		{
+			occurrences.emplace_back(q.getIntField(0, 0), q.getIntField(1, 0));
+			q.nextRow();
+		}
+		return occurrences;
+	}
+};
+
+// clears files the way the storage did before it started from the rows of the cleared files, with
+// statements that pass over whole tables
+class FullPassIndexStorage: public SqliteIndexStorage
+{
+public:
+	FullPassIndexStorage(const FilePath& dbFilePath): SqliteIndexStorage(dbFilePath) {}
+
+	void removeElementsWithLocationInFilesByFullPasses(
+		const std::vector<Id>& fileIds, bool keepEdgesOfOtherFiles)
+	{
+		const std::string fileIdList = utility::join(utility::toStrings(fileIds), ',');
+		const std::string occurrenceInOtherFile =
+			"SELECT * FROM occurrence INNER JOIN source_location ON "
+			"(occurrence.source_location_id = source_location.id) "
+			"WHERE source_location.file_node_id NOT IN (" +
+			fileIdList + ")";
+
+		std::string keptEdgeCondition;
+		std::string keptOutgoingEdgeCondition;
+		if (keepEdgesOfOtherFiles)
+		{
+			keptEdgeCondition = " AND NOT EXISTS (" + occurrenceInOtherFile +
+				" AND occurrence.element_id = element.id)";
+			keptOutgoingEdgeCondition = " AND NOT EXISTS (" + occurrenceInOtherFile +
+				" AND occurrence.element_id = edge.id) AND (EXISTS (SELECT * FROM occurrence "
+				"WHERE occurrence.element_id = edge.id) OR NOT EXISTS (" +
+				occurrenceInOtherFile + " AND occurrence.element_id = edge.target_node_id))";
+		}
+
+		const std::vector<std::string> statements = {
+			"CREATE TABLE IF NOT EXISTS element_id_to_clear(id INTEGER NOT NULL, PRIMARY KEY(id));",
+			"INSERT INTO element_id_to_clear SELECT occurrence.element_id FROM occurrence "
+			"INNER JOIN source_location ON (occurrence.source_location_id = source_location.id) "
+			"WHERE source_location.file_node_id IN (" +
+				fileIdList + ") GROUP BY (occurrence.element_id)",
+			"DELETE FROM element WHERE element.id IN (SELECT element_id_to_clear.id FROM "
+			"element_id_to_clear INNER JOIN edge ON (element_id_to_clear.id = edge.id))" +
+				keptEdgeCondition,
+			"DELETE FROM element WHERE element.id IN (SELECT edge.id FROM edge WHERE "
+			"edge.source_node_id IN (SELECT id FROM element_id_to_clear)" +
+				keptOutgoingEdgeCondition + ")",
+			"DELETE FROM element_id_to_clear WHERE id NOT IN (SELECT id FROM element)",
+			"DELETE FROM element_id_to_clear WHERE id IN (SELECT id FROM file)",
+			"DELETE FROM source_location WHERE file_node_id IN (" + fileIdList + ");",
+			"DELETE FROM element_id_to_clear WHERE id IN (SELECT element_id_to_clear.id FROM "
+			"element_id_to_clear INNER JOIN occurrence ON "
+			"element_id_to_clear.id = occurrence.element_id)",
+			"DELETE FROM element_id_to_clear WHERE id IN (SELECT target_node_id FROM edge)",
+			"DELETE FROM element WHERE EXISTS (SELECT * FROM element_id_to_clear WHERE "
+			"element.id = element_id_to_clear.id)",
+			"DROP TABLE IF EXISTS main.element_id_to_clear;"};
+
+		for (const std::string& statement: statements)
+		{
+			executeStatement(statement);
+		}
+	}
+
+	// older versions kept the ids to clear in a persistent table that stays when interrupted
+	void addInterruptedClearTable()
+	{
+		executeStatement(
+			"CREATE TABLE main.element_id_to_clear(id INTEGER NOT NULL, PRIMARY KEY(id));");
+		executeStatement("INSERT INTO main.element_id_to_clear VALUES (1), (2);");
+	}
+
+	bool hasInterruptedClearTable() const
+	{
+		return hasTable("element_id_to_clear");
+	}
+};
+
+// reads back the connection settings the database currently uses
+class ProfiledIndexStorage: public SqliteIndexStorage
+{
+public:
+	ProfiledIndexStorage(const FilePath& dbFilePath): SqliteIndexStorage(dbFilePath) {}
+
+	std::string getPragma(const std::string& name) const
+	{
+		CppSQLite3Query q = executeQuery("PRAGMA " + name + ";");
+		return q.eof() ? "" : q.getStringField(0, "");
+	}
+};
+
+// nodes with a fixed number of outgoing edges and one location each, nodes of different batches
+// are not merged
+std::vector<Id> addConnectedNodes(
+	SqliteIndexStorage& storage, size_t nodeCount, size_t edgesPerNode, size_t batch = 0)
+{
+	const std::wstring prefix = std::to_wstring(batch) + L"_";
+	std::vector<StorageNode> nodes;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		nodes.emplace_back(0, 0, L"node_" + prefix + std::to_wstring(i));
+	}
+
+	storage.beginTransaction();
+	const Id fileId = storage.addNode(StorageNodeData(0, L"file_" + prefix));
+	const std::vector<Id> nodeIds = storage.addNodes(nodes);
+
+	std::vector<StorageEdge> edges;
+	std::vector<StorageSourceLocation> locations;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		for (size_t j = 1; j <= edgesPerNode; j++)
+		{
+			edges.emplace_back(
+				0, Edge::typeToInt(Edge::EDGE_CALL), nodeIds[i], nodeIds[(i * 31 + j) % nodeCount]);
+		}
+		locations.emplace_back(0, StorageSourceLocationData(fileId, i + 1, 1, i + 1, 5, 0));
+	}
+	storage.addEdges(edges);
+
+	const std::vector<Id> locationIds = storage.addSourceLocations(locations);
+	std::vector<StorageOccurrence> occurrences;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		occurrences.emplace_back(nodeIds[i], locationIds[i]);
+	}
+	storage.addOccurrences(occurrences);
+	storage.commitTransaction();
+	return nodeIds;
+}
+
+// three files with nodes located in one or two of them, edges located in several files and edges
+// without location, the ids are the same for each empty storage the files are added to
+std::vector<Id> addFilesWithSharedElements(SqliteIndexStorage& storage)
+{
+	storage.beginTransaction();
+	std::vector<Id> fileIds;
+	for (const std::wstring& fileName: {L"a.cpp", L"b.cpp", L"c.cpp"})
+	{
+		const Id fileId = storage.addNode(StorageNodeData(0, fileName));
+		storage.addFile(StorageFile(fileId, fileName, L"cpp", "", false, true));
+		fileIds.push_back(fileId);
+	}
+
+	size_t lineNumber = 1;
+	const auto addLocation = [&storage, &lineNumber](Id elementId, Id fileId) {
+		const Id locationId = storage.addSourceLocation(
+			StorageSourceLocationData(fileId, lineNumber, 1, lineNumber, 5, 0));
+		storage.addOccurrence(StorageOccurrence(elementId, locationId));
+		lineNumber++;
+	};
+
+	const Id onlyA = storage.addNode(StorageNodeData(0, L"only_a"));
+	const Id inAAndB = storage.addNode(StorageNodeData(0, L"in_a_and_b"));
+	const Id onlyB = storage.addNode(StorageNodeData(0, L"only_b"));
+	const Id onlyC = storage.addNode(StorageNodeData(0, L"only_c"));
+	const Id nowhere = storage.addNode(StorageNodeData(0, L"nowhere"));
+	const Id alsoNowhere = storage.addNode(StorageNodeData(0, L"also_nowhere"));
+	addLocation(fileIds[0], fileIds[0]);
+	addLocation(onlyA, fileIds[0]);
+	addLocation(inAAndB, fileIds[0]);
+	addLocation(inAAndB, fileIds[1]);
+	addLocation(onlyB, fileIds[1]);
+	addLocation(onlyC, fileIds[2]);
+
+	const int call = Edge::typeToInt(Edge::EDGE_CALL);
+	addLocation(storage.addEdge(StorageEdgeData(call, onlyA, onlyB)), fileIds[0]);
+	const Id sharedEdgeId = storage.addEdge(StorageEdgeData(call, inAAndB, onlyB));
+	addLocation(sharedEdgeId, fileIds[0]);
+	addLocation(sharedEdgeId, fileIds[1]);
+	addLocation(storage.addEdge(StorageEdgeData(call, onlyB, onlyA)), fileIds[1]);
+	addLocation(storage.addEdge(StorageEdgeData(call, onlyA, onlyC)), fileIds[2]);
+	storage.addEdge(StorageEdgeData(call, onlyA, nowhere));
+	storage.addEdge(StorageEdgeData(call, inAAndB, onlyC));
+	storage.addEdge(StorageEdgeData(call, nowhere, alsoNowhere));
+	storage.addEdge(StorageEdgeData(call, onlyC, inAAndB));
+	storage.commitTransaction();
+
+	return fileIds;
+}
+
+// rows of the element tables as text, so the contents of two databases can be compared
+std::vector<std::string> getElementRows(const SqliteIndexStorage& storage)
+{
+	std::vector<std::string> rows;
+	for (const StorageNode& node: storage.getAll<StorageNode>())
+	{
+		rows.push_back(
+			"node " + std::to_string(node.id) + " " + utility::encodeToUtf8(node.serializedName));
+	}
+	for (const StorageEdge& edge: storage.getAll<StorageEdge>())
+	{
+		rows.push_back(
+			"edge " + std::to_string(edge.id) + " " + std::to_string(edge.sourceNodeId) + " " +
+			std::to_string(edge.targetNodeId));
+	}
+	for (const StorageSourceLocation& location: storage.getAll<StorageSourceLocation>())
+	{
+		rows.push_back(
+			"location " + std::to_string(location.id) + " " +
+			std::to_string(location.fileNodeId) + " " + std::to_string(location.startLine));
+	}
+	for (const StorageOccurrence& occurrence: storage.getAll<StorageOccurrence>())
+	{
+		rows.push_back(
+			"occurrence " + std::to_string(occurrence.elementId) + " " +
+			std::to_string(occurrence.sourceLocationId));
+	}
+	std::sort(rows.begin(), rows.end());
+	return rows;
+}
+
+// named values measured for one variant of a benchmark, in the order they are reported
+typedef std::vector<std::pair<std::string, std::string>> BenchmarkResults;
+
+// runs each variant of a benchmark on an empty database and reports its results, timings are not
+// compared by the test because they depend on the machine running it
+void runStorageBenchmark(
+	const std::vector<std::string>& variantNames,
+	std::function<BenchmarkResults(size_t variantIndex, const FilePath& databasePath)> runVariant)
+{
+	const FilePath databasePath(L"data/SQLiteTestSuite/benchmark.sqlite");
+	for (size_t i = 0; i < variantNames.size(); i++)
+	{
+		FileSystem::remove(databasePath);
+		const BenchmarkResults results = runVariant(i, databasePath);
+		FileSystem::remove(databasePath);
+
+		std::string report = variantNames[i] + ":";
+		for (size_t j = 0; j < results.size(); j++)
+		{
+			report += (j == 0 ? " " : ", ") + results[j].first + " " + results[j].second;
+		}
+		WARN(report);
+	}
+}
+
+std::string measureSeconds(std::function<void()> func)
+{
+	const TimeStamp start = TimeStamp::now();
+	func();
+	return TimeStamp::secondsToString(TimeStamp::durationSeconds(start));
+}
+
+// source file of functions that differ in their names and numbers, the last line has no line break
+std::string writeSourceFile(const FilePath& filePath, size_t lineCount, size_t seed = 0)
+{
+	const std::vector<std::string> lines = {
+		"int function_$(int value)", "{", "\treturn value * $ + function_$(value - 1);", "}"};
+
+	std::string text;
+	for (size_t i = 0; i < lineCount; i++)
+	{
+		const std::string number = std::to_string(seed * lineCount + i);
+		text += utility::replace(lines[i % lines.size()], "$", number);
+		if (i + 1 < lineCount)
+		{
+			text += "\n";
+		}
+	}
+
+	std::ofstream file(filePath.str(), std::ios::binary);
+	file << text;
+	return text;
+}
+
+std::set<Id> getIds(const std::vector<StorageEdge>& edges)
+{
+	std::set<Id> ids;
+	for (const StorageEdge& edge: edges)
+	{
+		ids.insert(edge.id);
+	}
+	return ids;
+}
+}	 // namespace
 
 TEST_CASE("storage adds node successfully")
 {
@@ -76,3 +418,762 @@ TEST_CASE("storage removes edge successfully")
 
 	REQUIRE(0 == edgeCount);
 }
+
+TEST_CASE("storage keeps last committed state readable during refresh transaction")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	int nodeCountDuringRefresh = -1;
+	int nodeCountAfterRefresh = -1;
+	{
+		SqliteIndexStorage reader(databasePath);
+		reader.setup();
+
+		SqliteIndexStorage writer(databasePath);
+		writer.setup();
+		REQUIRE(writer.enableWriteAheadLog());
+		writer.beginTransaction();
+		writer.addNode(StorageNodeData(0, L"a"));
+
+		// nested transactions only become visible with the outermost one
+		writer.beginTransaction();
+		writer.addNode(StorageNodeData(0, L"b"));
+		writer.commitTransaction();
+
+		writer.beginTransaction();
+		writer.addNode(StorageNodeData(0, L"c"));
+		writer.rollbackTransaction();
+
+		nodeCountDuringRefresh = reader.getNodeCount();
+		writer.commitTransaction();
+		nodeCountAfterRefresh = reader.getNodeCount();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(0 == nodeCountDuringRefresh);
+	REQUIRE(2 == nodeCountAfterRefresh);
+}
+
+TEST_CASE("storage swaps in a temporary database that is still open")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath tempDatabasePath(L"data/SQLiteTestSuite/test_temp.sqlite");
+	std::string tempJournalMode;
+	int nodeCountAfterSwap = -1;
+	{
+		std::shared_ptr<SqliteIndexStorage> storage = std::make_shared<SqliteIndexStorage>(
+			databasePath);
+		storage->setup();
+		REQUIRE(storage->enableWriteAheadLog());
+		storage->addNode(StorageNodeData(0, L"a"));
+
+		// the database is still open for browsing, so the node is only in its write-ahead log
+		REQUIRE(SqliteStorage::copyDbFiles(databasePath, tempDatabasePath));
+
+		ProfiledIndexStorage tempStorage(tempDatabasePath);
+		tempStorage.applyProfile(
+			SqliteStorageProfile::getDefault(SqliteStorageProfileType::INTERACTIVE));
+		tempStorage.disableWriteAheadLog();
+		tempStorage.setup();
+		tempStorage.applyProfile(
+			SqliteStorageProfile::getDefault(SqliteStorageProfileType::BULK_INDEXING));
+		tempStorage.beginTransaction();
+		tempStorage.addNode(StorageNodeData(0, L"b"));
+		tempStorage.commitTransaction();
+		tempJournalMode = tempStorage.getPragma("journal_mode");
+
+		// the indexing tasks still hold the temporary database while it gets swapped in
+		storage.reset();
+		REQUIRE(SqliteStorage::removeDbFiles(databasePath));
+		REQUIRE(SqliteStorage::renameDbFiles(tempDatabasePath, databasePath));
+
+		SqliteIndexStorage swappedStorage(databasePath);
+		swappedStorage.setup();
+		nodeCountAfterSwap = swappedStorage.getNodeCount();
+	}
+	REQUIRE(!tempDatabasePath.recheckExists());
+	REQUIRE(!FilePath(tempDatabasePath.wstr() + L"-wal").recheckExists());
+	SqliteStorage::removeDbFiles(databasePath);
+
+	REQUIRE("delete" == tempJournalMode);
+	REQUIRE(2 == nodeCountAfterSwap);
+}
+
+TEST_CASE("storage keeps file dependencies of include and import edges")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<std::pair<Id, Id>> dependencies;
+	std::vector<std::pair<Id, Id>> dependenciesAfterRemoval;
+	Id a = 0;
+	Id b = 0;
+	Id c = 0;
+	Id d = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		a = storage.addNode(StorageNodeData(0, L"a"));
+		b = storage.addNode(StorageNodeData(0, L"b"));
+		c = storage.addNode(StorageNodeData(0, L"c"));
+		d = storage.addNode(StorageNodeData(0, L"d"));
+		const Id importedId = storage.addNode(StorageNodeData(0, L"c_class"));
+		storage.addSymbol(StorageSymbol(importedId, definitionKindToInt(DEFINITION_EXPLICIT)));
+		storage.addOccurrence(StorageOccurrence(
+			importedId,
+			storage.addSourceLocation(
+				StorageSourceLocationData(c, 1, 1, 1, 5, locationTypeToInt(LOCATION_TOKEN)))));
+		storage.addOccurrence(StorageOccurrence(
+			importedId,
+			storage.addSourceLocation(
+				StorageSourceLocationData(c, 1, 1, 3, 1, locationTypeToInt(LOCATION_SCOPE)))));
+
+		// the imported class is only used in this file, which does not define it
+		storage.addOccurrence(StorageOccurrence(
+			importedId,
+			storage.addSourceLocation(
+				StorageSourceLocationData(d, 4, 1, 4, 5, locationTypeToInt(LOCATION_QUALIFIER)))));
+
+		storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_INCLUDE), a, b));
+		const Id importEdgeId =
+			storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_IMPORT), b, importedId));
+
+		// only the given import edges are resolved
+		storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_IMPORT), a, importedId));
+		storage.addImportFileDependencies({importEdgeId});
+		storage.commitTransaction();
+		dependencies = storage.getFileDependencies();
+
+		storage.removeElement(c);
+		dependenciesAfterRemoval = storage.getFileDependencies();
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(dependencies.size() == 2);
+	REQUIRE(dependenciesAfterRemoval.size() == 1);
+
+	FileDependencyIndex index;
+	index.build(dependencies);
+	REQUIRE(index.getDependentFileIds({c}) == std::set<Id>({a, b}));
+	REQUIRE(index.getDependencyFileIds({a}) == std::set<Id>({b, c}));
+	REQUIRE(index.getDependencyFileIds({c}).empty());
+	REQUIRE(index.getDependentFileIds({d}).empty());
+}
+
+TEST_CASE("storage keeps edges of elements that are located in files that are not cleared if asked")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<int> edgeCounts;
+	std::vector<Id> removedClassIds;
+	for (bool keepEdgesOfOtherFiles: {false, true})
+	{
+		FileSystem::remove(databasePath);
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		storage.beginTransaction();
+		const Id clearedFileId = storage.addNode(StorageNodeData(0, L"a.h"));
+		const Id keptFileId = storage.addNode(StorageNodeData(0, L"a.cpp"));
+
+		const Id namespaceId = storage.addNode(StorageNodeData(0, L"n"));
+		const Id functionId = storage.addNode(StorageNodeData(0, L"n::f"));
+		const Id classId = storage.addNode(StorageNodeData(0, L"n::C"));
+		storage.addOccurrence(StorageOccurrence(
+			namespaceId,
+			storage.addSourceLocation(StorageSourceLocationData(clearedFileId, 1, 1, 1, 5, 0))));
+		storage.addOccurrence(StorageOccurrence(
+			namespaceId,
+			storage.addSourceLocation(StorageSourceLocationData(keptFileId, 1, 1, 1, 5, 0))));
+		storage.addOccurrence(StorageOccurrence(
+			functionId,
+			storage.addSourceLocation(StorageSourceLocationData(keptFileId, 2, 1, 2, 5, 0))));
+		storage.addOccurrence(StorageOccurrence(
+			classId,
+			storage.addSourceLocation(StorageSourceLocationData(clearedFileId, 2, 1, 2, 5, 0))));
+
+		// member edges have no location, only the one to the function defined in a.cpp stays
+		storage.addEdge(
+			StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), namespaceId, functionId));
+		storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), namespaceId, classId));
+
+		const Id usageId = storage.addEdge(
+			StorageEdgeData(Edge::typeToInt(Edge::EDGE_USAGE), namespaceId, functionId));
+		storage.addOccurrence(StorageOccurrence(
+			usageId,
+			storage.addSourceLocation(StorageSourceLocationData(clearedFileId, 3, 1, 3, 5, 0))));
+		storage.addOccurrence(StorageOccurrence(
+			usageId,
+			storage.addSourceLocation(StorageSourceLocationData(keptFileId, 3, 1, 3, 5, 0))));
+
+		storage.removeElementsWithLocationInFiles({clearedFileId}, keepEdgesOfOtherFiles, nullptr);
+		storage.commitTransaction();
+
+		edgeCounts.push_back(storage.getEdgeCount());
+		removedClassIds.push_back(storage.getNodeById(classId).id);
+	}
+	FileSystem::remove(databasePath);
+
+	// by default all edges of the namespace go, as its other file is cleared as well
+	REQUIRE(0 == edgeCounts[0]);
+	REQUIRE(2 == edgeCounts[1]);
+	REQUIRE(0 == removedClassIds[0]);
+	REQUIRE(0 == removedClassIds[1]);
+}
+
+TEST_CASE("storage binds id lists of any size like inlined ids")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	std::vector<Id> nodeIds;
+	std::set<Id> boundEdgeIds;
+	std::set<Id> inlinedEdgeIds;
+	size_t nodeCount = 0;
+	size_t nestedEdgeCount = 0;
+	size_t inlinedNestedEdgeCount = 0;
+	{
+		InlinedQueryIndexStorage storage(databasePath);
+		storage.setup();
+		nodeIds = addConnectedNodes(storage, 1000, 3);
+
+		// more ids than fit into one batch of the temporary id table
+		const std::vector<Id> sourceIds(nodeIds.begin(), nodeIds.begin() + 700);
+		boundEdgeIds = getIds(storage.getEdgesBySourceIds(sourceIds));
+		inlinedEdgeIds = getIds(storage.getEdgesBySourceIdsInlined(sourceIds));
+		nodeCount = storage.getAllByIds<StorageNode>(nodeIds).size();
+
+		// queries running while the results of another one are read use an id table of their own
+		storage.forEachByIds<StorageNode>(sourceIds, [&](StorageNode&& node) {
+			nestedEdgeCount += storage.getEdgesBySourceIds({node.id}).size();
+			inlinedNestedEdgeCount += storage.getEdgesBySourceIdsInlined({node.id}).size();
+		});
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(boundEdgeIds.size() == 2100);
+	REQUIRE(boundEdgeIds == inlinedEdgeIds);
+	REQUIRE(nodeCount == nodeIds.size());
+	REQUIRE(nestedEdgeCount == 2100);
+	REQUIRE(nestedEdgeCount == inlinedNestedEdgeCount);
+}
+
+TEST_CASE("storage binds id lists of queries running in several threads")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	size_t queryCount = 0;
+	size_t wrongQueryCount = 0;
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+		const std::vector<Id> nodeIds = addConnectedNodes(storage, 1000, 3);
+
+		// each thread uses long lists of other ids, so lists sharing an id table would mix them up
+		std::vector<std::thread> threads;
+		std::mutex countMutex;
+		for (size_t i = 0; i < 4; i++)
+		{
+			threads.emplace_back([&, i]() {
+				const std::vector<Id> sourceIds(
+					nodeIds.begin() + i * 150, nodeIds.begin() + i * 200 + 300);
+				for (size_t j = 0; j < 20; j++)
+				{
+					const size_t edgeCount = storage.getEdgesBySourceIds(sourceIds).size();
+					std::lock_guard<std::mutex> lock(countMutex);
+					queryCount++;
+					wrongQueryCount += edgeCount != 3 * sourceIds.size();
+				}
+			});
+		}
+		for (std::thread& thread: threads)
+		{
+			thread.join();
+		}
+	}
+	FileSystem::remove(databasePath);
+
+	REQUIRE(queryCount == 80);
+	REQUIRE(wrongQueryCount == 0);
+}
+
+TEST_CASE("storage finds files by paths that contain quotes")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+
+		std::vector<FilePath> filePaths;
+		for (size_t i = 0; i < 300; i++)
+		{
+			filePaths.emplace_back(L"data/it's_" + std::to_wstring(i) + L".cpp");
+			const Id fileId = storage.addNode(StorageNodeData(0, filePaths.back().wstr()));
+			storage.addFile(StorageFile(fileId, filePaths.back().wstr(), L"cpp", "", false, true));
+		}
+
+		REQUIRE(storage.getFilesByPaths(filePaths).size() == 300);
+		REQUIRE(storage.getFilesByPaths({filePaths[7], filePaths[7]}).size() == 1);
+		REQUIRE(storage.getFilesByPaths({FilePath(L"data/other.cpp")}).empty());
+	}
+	FileSystem::remove(databasePath);
+}
+
+TEST_CASE("storage reports activation query times with inlined and prepared ids", "[.benchmark]")
+{
+	std::vector<size_t> counts;
+	runStorageBenchmark(
+		{"inlined queries", "prepared queries"},
+		[&counts](size_t variantIndex, const FilePath& databasePath) {
+			InlinedQueryIndexStorage storage(databasePath);
+			storage.setup();
+			const std::vector<Id> nodeIds = addConnectedNodes(storage, 200000, 5);
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+			// activating a symbol reads the node and then the nodes and occurrences of its
+			// neighbours
+			const size_t activationCount = 5000;
+			std::vector<Id> activeIds;
+			std::vector<std::vector<Id>> neighbourIds;
+			for (size_t i = 0; i < activationCount; i++)
+			{
+				activeIds.push_back(nodeIds[(i * 7919) % nodeIds.size()]);
+				neighbourIds.emplace_back();
+				for (size_t j = 0; j < 20; j++)
+				{
+					neighbourIds.back().push_back(nodeIds[(i * 7919 + j * 31) % nodeIds.size()]);
+				}
+			}
+			// and the graph of a symbol with many references
+			const std::vector<Id> largeIdList(nodeIds.begin(), nodeIds.begin() + 50000);
+
+			size_t count = 0;
+			const std::string seconds = measureSeconds([&]() {
+				for (size_t i = 0; i < activationCount; i++)
+				{
+					if (variantIndex == 0)
+					{
+						count += storage.getNodesByIdsInlined({activeIds[i]}).size();
+						count += storage.getNodesByIdsInlined(neighbourIds[i]).size();
+						count += storage.getOccurrencesForElementIdsInlined(neighbourIds[i]).size();
+					}
+					else
+					{
+						count += storage.getNodeById(activeIds[i]).id != 0;
+						count += storage.getAllByIds<StorageNode>(neighbourIds[i]).size();
+						count += storage.getOccurrencesForElementIds(neighbourIds[i]).size();
+					}
+				}
+				if (variantIndex == 0)
+				{
+					count += storage.getNodesByIdsInlined(largeIdList).size();
+					count += storage.getOccurrencesForElementIdsInlined(largeIdList).size();
+				}
+				else
+				{
+					count += storage.getAllByIds<StorageNode>(largeIdList).size();
+					count += storage.getOccurrencesForElementIds(largeIdList).size();
+				}
+			});
+			counts.push_back(count);
+			return BenchmarkResults({{"activations", seconds}});
+		});
+	REQUIRE(counts[0] == counts[1]);
+}
+
+TEST_CASE("storage applies the settings of a profile")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	{
+		ProfiledIndexStorage storage(databasePath);
+
+		SqliteStorageProfile lowMemoryProfile = SqliteStorageProfile::getDefault(
+			SqliteStorageProfileType::LOW_MEMORY);
+		lowMemoryProfile.pageSize = 8192;
+		storage.applyProfile(lowMemoryProfile);
+		storage.setup();
+		storage.addNode(StorageNodeData(0, L"a"));
+
+		REQUIRE("8192" == storage.getPragma("page_size"));
+		REQUIRE("wal" == storage.getPragma("journal_mode"));
+		REQUIRE("1" == storage.getPragma("synchronous"));
+		REQUIRE("-2048" == storage.getPragma("cache_size"));
+		REQUIRE("0" == storage.getPragma("mmap_size"));
+		REQUIRE("1" == storage.getPragma("temp_store"));
+
+		storage.applyProfile(
+			SqliteStorageProfile::getDefault(SqliteStorageProfileType::BULK_INDEXING));
+
+		REQUIRE("8192" == storage.getPragma("page_size"));
+		REQUIRE("0" == storage.getPragma("synchronous"));
+		REQUIRE("-262144" == storage.getPragma("cache_size"));
+		REQUIRE("268435456" == storage.getPragma("mmap_size"));
+		REQUIRE("2" == storage.getPragma("temp_store"));
+
+		SqliteStorageProfile journalProfile = storage.getProfile();
+		journalProfile.journalMode = "DELETE";
+		journalProfile.synchronous = "fast";
+
+		storage.beginTransaction();
+		storage.applyProfile(journalProfile);
+		REQUIRE("wal" == storage.getPragma("journal_mode"));
+		storage.commitTransaction();
+
+		storage.applyProfile(journalProfile);
+		REQUIRE("delete" == storage.getPragma("journal_mode"));
+		REQUIRE("0" == storage.getPragma("synchronous"));
+		REQUIRE(1 == storage.getNodeCount());
+	}
+	FileSystem::remove(databasePath);
+}
+
+TEST_CASE("storage reports injection and browsing times of each profile", "[.benchmark]")
+{
+	const std::vector<std::pair<std::string, SqliteStorageProfileType>> profiles = {
+		{"bulk indexing", SqliteStorageProfileType::BULK_INDEXING},
+		{"interactive", SqliteStorageProfileType::INTERACTIVE},
+		{"low memory", SqliteStorageProfileType::LOW_MEMORY}};
+
+	// the sqlite defaults with rollback journal and full syncs come first
+	std::vector<std::string> variantNames = {"sqlite defaults"};
+	for (const auto& profile: profiles)
+	{
+		variantNames.push_back(profile.first);
+	}
+
+	runStorageBenchmark(
+		variantNames,
+		[&profiles](size_t variantIndex, const FilePath& databasePath) {
+			ProfiledIndexStorage storage(databasePath);
+			if (variantIndex > 0)
+			{
+				storage.applyProfile(
+					SqliteStorageProfile::getDefault(profiles[variantIndex - 1].second));
+			}
+			storage.setup();
+
+			// indexing results are injected in one small transaction per translation unit
+			std::vector<Id> nodeIds;
+			const std::string injectionSeconds = measureSeconds([&]() {
+				for (size_t i = 0; i < 5000; i++)
+				{
+					const std::vector<Id> batchIds = addConnectedNodes(storage, 40, 5, i);
+					nodeIds.insert(nodeIds.end(), batchIds.begin(), batchIds.end());
+				}
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+			});
+
+			size_t count = 0;
+			const std::string browseSeconds = measureSeconds([&]() {
+				for (size_t i = 0; i < 20000; i++)
+				{
+					std::vector<Id> ids;
+					for (size_t j = 0; j < 20; j++)
+					{
+						ids.push_back(nodeIds[(i * 7919 + j * 104729) % nodeIds.size()]);
+					}
+					count += storage.getAllByIds<StorageNode>(ids).size();
+					count += storage.getOccurrencesForElementIds(ids).size();
+				}
+			});
+			REQUIRE(count == 20000 * 40);
+
+			return BenchmarkResults(
+				{{"injection", injectionSeconds}, {"browsing", browseSeconds}});
+		});
+}
+
+TEST_CASE("storage writes into an empty database without enforcing foreign keys in bulk mode")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	{
+		ProfiledIndexStorage storage(databasePath);
+		storage.setup();
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_BULK_WRITE);
+		REQUIRE("0" == storage.getPragma("foreign_keys"));
+
+		const std::vector<Id> nodeIds = addConnectedNodes(storage, 100, 3);
+		const std::vector<Id> moreNodeIds = addConnectedNodes(storage, 100, 3, 1);
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		REQUIRE("1" == storage.getPragma("foreign_keys"));
+
+		// new elements are numbered in the order they are added
+		for (size_t i = 1; i < nodeIds.size(); i++)
+		{
+			REQUIRE(nodeIds[i - 1] + 1 == nodeIds[i]);
+		}
+		REQUIRE(nodeIds.back() < moreNodeIds.front());
+
+		REQUIRE(2 * 101 == storage.getNodeCount());
+		REQUIRE(600 == storage.getEdgeCount());
+		REQUIRE(3 == storage.getEdgesBySourceId(moreNodeIds[5]).size());
+		REQUIRE(1 == storage.getOccurrencesForElementIds({nodeIds[7]}).size());
+
+		// foreign keys are enforced again, so removing a node removes its edges
+		const size_t incomingEdgeCount = storage.getEdgesByTargetId(nodeIds[0]).size();
+		storage.removeElement(nodeIds[0]);
+		REQUIRE(600 - 3 - incomingEdgeCount == storage.getEdgeCount());
+	}
+	FileSystem::remove(databasePath);
+}
+
+TEST_CASE("storage reports injection times of write and bulk write mode", "[.benchmark]")
+{
+	const std::vector<SqliteIndexStorage::StorageModeType> modes = {
+		SqliteIndexStorage::STORAGE_MODE_WRITE, SqliteIndexStorage::STORAGE_MODE_BULK_WRITE};
+
+	runStorageBenchmark(
+		{"write mode", "bulk write mode"},
+		[&modes](size_t variantIndex, const FilePath& databasePath) {
+			SqliteIndexStorage storage(databasePath);
+			storage.applyProfile(
+				SqliteStorageProfile::getDefault(SqliteStorageProfileType::BULK_INDEXING));
+			storage.setup();
+			storage.setMode(modes[variantIndex]);
+
+			const std::string injectionSeconds = measureSeconds([&storage]() {
+				for (size_t i = 0; i < 200; i++)
+				{
+					addConnectedNodes(storage, 1000, 5, i);
+				}
+			});
+			const std::string indexSeconds = measureSeconds(
+				[&storage]() { storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ); });
+			REQUIRE(200 * 1001 == storage.getNodeCount());
+
+			return BenchmarkResults({{"injection", injectionSeconds}, {"indices", indexSeconds}});
+		});
+}
+
+TEST_CASE("storage clears the same elements of files as full passes over the tables")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	const std::vector<std::vector<size_t>> clearedFileIndices = {{0}, {1}, {2}, {0, 2}, {0, 1, 2}};
+	for (const std::vector<size_t>& fileIndices: clearedFileIndices)
+	{
+		// full passes and the rewrite, without and with keeping edges of other files
+		std::vector<std::vector<std::string>> rows;
+		for (size_t i = 0; i < 4; i++)
+		{
+			const bool keepEdgesOfOtherFiles = i >= 2;
+			FileSystem::remove(databasePath);
+			{
+				FullPassIndexStorage storage(databasePath);
+				storage.setup();
+				const std::vector<Id> fileIds = addFilesWithSharedElements(storage);
+
+				std::vector<Id> clearedFileIds;
+				for (size_t fileIndex: fileIndices)
+				{
+					clearedFileIds.push_back(fileIds[fileIndex]);
+				}
+
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+				storage.beginTransaction();
+				if (i % 2 == 0)
+				{
+					storage.removeElementsWithLocationInFilesByFullPasses(
+						clearedFileIds, keepEdgesOfOtherFiles);
+				}
+				else
+				{
+					std::vector<int> progress;
+					storage.removeElementsWithLocationInFiles(
+						clearedFileIds, keepEdgesOfOtherFiles, [&progress](int value) {
+							progress.push_back(value);
+						});
+					REQUIRE(std::is_sorted(progress.begin(), progress.end()));
+				}
+				storage.commitTransaction();
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+
+				rows.push_back(getElementRows(storage));
+			}
+		}
+		REQUIRE(rows[0] == rows[1]);
+		REQUIRE(rows[2] == rows[3]);
+	}
+	FileSystem::remove(databasePath);
+}
+
+TEST_CASE("storage drops the table of ids that interrupted clearings of older versions left")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FileSystem::remove(databasePath);
+	std::vector<Id> fileIds;
+	{
+		FullPassIndexStorage storage(databasePath);
+		storage.setup();
+		fileIds = addFilesWithSharedElements(storage);
+		storage.addInterruptedClearTable();
+		REQUIRE(storage.hasInterruptedClearTable());
+	}
+	{
+		FullPassIndexStorage storage(databasePath);
+		storage.setup();
+		REQUIRE(!storage.hasInterruptedClearTable());
+
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+		storage.removeElementsWithLocationInFiles({fileIds[0]}, false, nullptr);
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		REQUIRE(2 == storage.getAllByIds<StorageNode>({fileIds[1], fileIds[2]}).size());
+	}
+	FileSystem::remove(databasePath);
+}
+
+TEST_CASE(
+	"storage reports clearing times of full passes and of starting from the files", "[.benchmark]")
+{
+	runStorageBenchmark(
+		{"full passes", "from cleared files"},
+		[](size_t variantIndex, const FilePath& databasePath) {
+			FullPassIndexStorage storage(databasePath);
+			storage.applyProfile(
+				SqliteStorageProfile::getDefault(SqliteStorageProfileType::BULK_INDEXING));
+			storage.setup();
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_BULK_WRITE);
+
+			// one file node per batch
+			std::vector<Id> fileIds;
+			for (size_t i = 0; i < 2000; i++)
+			{
+				fileIds.push_back(addConnectedNodes(storage, 100, 5, i).front() - 1);
+			}
+			storage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+
+			const std::vector<Id> clearedFileIds(fileIds.begin(), fileIds.begin() + 10);
+			const std::string seconds = measureSeconds([&]() {
+				storage.beginTransaction();
+				if (variantIndex == 0)
+				{
+					storage.removeElementsWithLocationInFilesByFullPasses(clearedFileIds, false);
+				}
+				else
+				{
+					storage.removeElementsWithLocationInFiles(clearedFileIds, false, nullptr);
+				}
+				storage.commitTransaction();
+			});
+
+			REQUIRE(2000 * 101 - 10 * 100 == storage.getNodeCount());
+			REQUIRE(1990 * 500 == storage.getEdgeCount());
+			REQUIRE(1990 * 100 == storage.getSourceLocationCount());
+
+			return BenchmarkResults({{"clearing", seconds}});
+		});
+}
+
+TEST_CASE("storage reads back stored file content and ranges of its lines")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath filePath(L"data/SQLiteTestSuite/content.cpp");
+
+	// long enough to be stored in several blocks
+	writeSourceFile(filePath, 5000);
+	std::shared_ptr<TextAccess> expected = TextAccess::createFromFile(filePath);
+	const std::string text = expected->getText();
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+
+		const Id fileId = storage.addNode(StorageNodeData(0, filePath.wstr()));
+		REQUIRE(storage.addFile(StorageFile(fileId, filePath.wstr(), L"cpp", "", true, true)));
+
+		REQUIRE(text == storage.getFileContentById(fileId)->getText());
+		REQUIRE(text == storage.getFileContentByPath(filePath.wstr())->getText());
+		REQUIRE(storage.hasFileContent(fileId));
+		REQUIRE(!storage.hasFileContent(fileId + 1));
+
+		const std::vector<std::pair<unsigned int, unsigned int>> ranges = {
+			{1, 1}, {1, 5000}, {17, 19}, {1000, 1800}, {4999, 5000}, {5000, 5000}};
+		for (const std::pair<unsigned int, unsigned int>& range: ranges)
+		{
+			REQUIRE(
+				expected->getLines(range.first, range.second) ==
+				storage.getFileContentLinesById(fileId, range.first, range.second));
+		}
+
+		REQUIRE(storage.getFileContentLinesById(fileId, 0, 1).empty());
+		REQUIRE(storage.getFileContentLinesById(fileId, 4999, 5001).empty());
+		REQUIRE(storage.getFileContentLinesById(fileId + 1, 1, 1).empty());
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(filePath);
+}
+
+TEST_CASE("storage reads back file content of paths that contain quotes")
+{
+	FilePath databasePath(L"data/SQLiteTestSuite/test.sqlite");
+	FilePath filePath(L"data/SQLiteTestSuite/it's content.cpp");
+
+	writeSourceFile(filePath, 20);
+	std::shared_ptr<TextAccess> expected = TextAccess::createFromFile(filePath);
+	{
+		SqliteIndexStorage storage(databasePath);
+		storage.setup();
+
+		const Id fileId = storage.addNode(StorageNodeData(0, filePath.wstr()));
+		REQUIRE(storage.addFile(StorageFile(fileId, filePath.wstr(), L"cpp", "", true, true)));
+
+		REQUIRE(expected->getText() == storage.getFileContentByPath(filePath.wstr())->getText());
+		REQUIRE(!storage.getFileContentByPath(L"data/SQLiteTestSuite/it's other.cpp")
+					 ->getLineCount());
+		REQUIRE(expected->getLines(3, 5) == storage.getFileContentLinesById(fileId, 3, 5));
+	}
+	FileSystem::remove(databasePath);
+	FileSystem::remove(filePath);
+}
+
+TEST_CASE("storage reports size and snippet reading times of file contents", "[.benchmark]")
+{
+	const size_t fileCount = 200;
+	const size_t lineCount = 5000;
+
+	runStorageBenchmark(
+		{"whole file reads", "line range reads"},
+		[fileCount, lineCount](size_t variantIndex, const FilePath& databasePath) {
+			std::vector<FilePath> filePaths;
+			std::vector<Id> fileIds;
+			unsigned long long textByteSize = 0;
+			{
+				SqliteIndexStorage storage(databasePath);
+				storage.setup();
+				storage.beginTransaction();
+				for (size_t i = 0; i < fileCount; i++)
+				{
+					filePaths.emplace_back(
+						L"data/SQLiteTestSuite/content_" + std::to_wstring(i) + L".cpp");
+					textByteSize += writeSourceFile(filePaths.back(), lineCount, i).size();
+
+					const Id fileId = storage.addNode(StorageNodeData(0, filePaths.back().wstr()));
+					storage.addFile(
+						StorageFile(fileId, filePaths.back().wstr(), L"cpp", "", true, true));
+					fileIds.push_back(fileId);
+				}
+				storage.commitTransaction();
+			}
+			const unsigned long long databaseByteSize = FileSystem::getFileByteSize(databasePath);
+
+			// reading starts from a new connection, so no pages are cached
+			SqliteIndexStorage storage(databasePath);
+			storage.setup();
+			const std::string seconds = measureSeconds([&]() {
+				for (size_t i = 0; i < fileCount; i++)
+				{
+					const size_t firstLine = (i * 997) % (lineCount - 2) + 1;
+					const std::vector<std::string> lines = variantIndex == 0
+						? storage.getFileContentByPath(filePaths[i].wstr())
+							  ->getLines(
+								  static_cast<unsigned int>(firstLine),
+								  static_cast<unsigned int>(firstLine + 2))
+						: storage.getFileContentLinesById(fileIds[i], firstLine, firstLine + 2);
+					REQUIRE(3 == lines.size());
+				}
+			});
+
+			for (const FilePath& filePath: filePaths)
+			{
+				FileSystem::remove(filePath);
+			}
+
+			return BenchmarkResults(
+				{{"text", std::to_string(textByteSize / 1024) + " KB"},
+				 {"database", std::to_string(databaseByteSize / 1024) + " KB"},
+				 {"reading", seconds}});
+		});
+}
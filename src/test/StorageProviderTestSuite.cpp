@@ -0,0 +1,104 @@
+#include "catch.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InProcessIntermediateStorageManager.h"
+#include "StorageProvider.h"
+
+namespace
+{
+std::shared_ptr<IntermediateStorage> createStorage(size_t nodeCount)
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		storage->addNode(StorageNodeData(1, L"\tsnode_" + std::to_wstring(i) + L"\tp"));
+		storage->addSourceLocation(StorageSourceLocationData(1, i + 1, 1, i + 1, 10, 1));
+	}
+	return storage;
+}
+}	 // namespace
+
+TEST_CASE("storage provider tracks the byte size of its storages")
+{
+	StorageProvider provider;
+
+	std::shared_ptr<IntermediateStorage> storage = createStorage(10);
+	provider.insert(storage);
+	provider.insert(createStorage(20));
+
+	REQUIRE(provider.getByteSize() > 0);
+	REQUIRE_FALSE(provider.isOverBudget());
+
+	provider.consumeStorageToInject(true);
+	provider.consumeStorageToInject(true);
+
+	REQUIRE(provider.getStorageCount() == 0);
+	REQUIRE(provider.getByteSize() == 0);
+}
+
+TEST_CASE("storage provider injects small storages once most of its byte budget is used")
+{
+	std::shared_ptr<IntermediateStorage> storage = createStorage(100);
+	const size_t byteSize = storage->getByteSize(sizeof(std::wstring));
+
+	StorageProvider provider(byteSize + 1);
+	provider.insert(createStorage(1));
+
+	// a small storage waits to get merged while the budget has room
+	REQUIRE_FALSE(provider.consumeStorageToInject(false));
+
+	provider.insert(storage);
+
+	REQUIRE(provider.isOverBudget());
+	REQUIRE(provider.consumeStorageToInject(false) == storage);
+	REQUIRE_FALSE(provider.isOverBudget());
+}
+
+TEST_CASE("in process storage manager only counts storages that can be popped")
+{
+	InProcessIntermediateStorageManager manager;
+	StorageProvider provider;
+
+	const size_t producerCount = 4;
+	const size_t storageCount = 200;
+
+	std::vector<std::thread> producers;
+	for (size_t i = 0; i < producerCount; i++)
+	{
+		producers.emplace_back([&manager]() {
+			for (size_t j = 0; j < storageCount; j++)
+			{
+				manager.pushIntermediateStorage(createStorage(2), FilePath(L"file.cpp"));
+			}
+		});
+	}
+
+	size_t poppedCount = 0;
+	while (poppedCount < producerCount * storageCount)
+	{
+		REQUIRE(manager.getIntermediateStorageCount() <= producerCount * storageCount - poppedCount);
+		if (manager.getIntermediateStorageCount() > 0)
+		{
+			// the push of an earlier storage may not be linked yet, then it is popped later
+			std::shared_ptr<IntermediateStorage> storage = manager.popIntermediateStorage();
+			if (storage)
+			{
+				provider.insert(storage);
+				poppedCount++;
+			}
+		}
+	}
+
+	for (std::thread& producer: producers)
+	{
+		producer.join();
+	}
+
+	REQUIRE(!manager.popIntermediateStorage());
+	REQUIRE(manager.getIntermediateStorageCount() == 0);
+	REQUIRE(manager.getIntermediateStorageByteSize() == 0);
+	REQUIRE(static_cast<size_t>(provider.getStorageCount()) == producerCount * storageCount);
+}
@@ -4,7 +4,9 @@
 
 #include "IntermediateStorage.h"
 #include "ParseLocation.h"
+#include "ParserClientImpl.h"
 #include "PersistentStorage.h"
+#include "TimeStamp.h"
 
 namespace
 {
@@ -17,6 +19,17 @@ public:
 		clear();
 	}
 
+	void addFile(const StorageFile& data) override
+	{
+		if (failOnAddingFile)
+		{
+			throw std::runtime_error("failing on purpose");
+		}
+		PersistentStorage::addFile(data);
+	}
+
+	bool failOnAddingFile = false;
+
 	// const size_t getNodeCount() const
 	//{
 	//	return getGraph().getNodeCount();
@@ -44,6 +57,34 @@ NameHierarchy createNameHierarchy(std::wstring s)
 	return nameHierarchy;
 }
 
+// a source file that includes the header and calls a function declared in there
+std::shared_ptr<IntermediateStorage> recordTranslationUnit(
+	const std::wstring& sourceFileName,
+	const std::wstring& headerFunctionName,
+	const std::wstring& headerFileName = L"header.h")
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	ParserClientImpl client(storage.get());
+
+	const Id sourceFileId = client.recordFile(FilePath(sourceFileName), true);
+	const Id headerFileId = client.recordFile(FilePath(headerFileName), true);
+	client.recordReference(
+		REFERENCE_INCLUDE, headerFileId, sourceFileId, ParseLocation(sourceFileId, 1, 1, 1, 10));
+
+	const Id headerFunctionId = client.recordSymbol(createNameHierarchy(headerFunctionName));
+	client.recordLocation(
+		headerFunctionId, ParseLocation(headerFileId, 1, 6, 1, 8), ParseLocationType::TOKEN);
+
+	const Id sourceFunctionId = client.recordSymbol(
+		createNameHierarchy(FilePath(sourceFileName).withoutExtension().wstr()));
+	client.recordLocation(
+		sourceFunctionId, ParseLocation(sourceFileId, 2, 6, 2, 8), ParseLocationType::TOKEN);
+	client.recordReference(
+		REFERENCE_CALL, headerFunctionId, sourceFunctionId, ParseLocation(sourceFileId, 3, 2, 3, 4));
+
+	return storage;
+}
+
 NameHierarchy createFunctionNameHierarchy(std::wstring ret, std::wstring name, std::wstring parameters)
 {
 	NameHierarchy nameHierarchy = createNameHierarchy(name);
@@ -283,3 +324,89 @@ TEST_CASE("storage finds and removes depending file nodes")
 	// TS_ASSERT(!storage.getEdgeWithId(id4));
 	// TS_ASSERT(!storage.getEdgeWithId(id5));
 }
+
+TEST_CASE("storage replaces elements of all files recorded by the translation units of a header")
+{
+	TestStorage storage;
+	storage.inject(recordTranslationUnit(L"a.cpp", L"foo").get());
+	storage.inject(recordTranslationUnit(L"b.cpp", L"foo").get());
+	storage.updateFileDependencies();
+	storage.buildCaches();
+
+	std::set<FilePath> filePaths = storage.getReferencing({FilePath(L"header.h")});
+	REQUIRE(filePaths == std::set<FilePath>({FilePath(L"a.cpp"), FilePath(L"b.cpp")}));
+	filePaths.insert(FilePath(L"header.h"));
+
+	REQUIRE(storage.replaceFileElements(
+		filePaths,
+		{recordTranslationUnit(L"a.cpp", L"bar"), recordTranslationUnit(L"b.cpp", L"bar")}));
+	storage.buildCaches();
+
+	REQUIRE(!storage.getNodeIdForNameHierarchy(createNameHierarchy(L"foo")));
+	REQUIRE(storage.getNodeIdForNameHierarchy(createNameHierarchy(L"bar")));
+	REQUIRE(storage.getNodeIdForNameHierarchy(createNameHierarchy(L"a")));
+	REQUIRE(storage.getNodeIdForNameHierarchy(createNameHierarchy(L"b")));
+	REQUIRE(2 == storage.getReferencing({FilePath(L"header.h")}).size());
+}
+
+TEST_CASE("storage keeps elements of files if replacing them fails")
+{
+	TestStorage storage;
+	storage.inject(recordTranslationUnit(L"a.cpp", L"foo").get());
+	storage.updateFileDependencies();
+
+	storage.failOnAddingFile = true;
+	REQUIRE(!storage.replaceFileElements(
+		{FilePath(L"a.cpp"), FilePath(L"header.h")}, {recordTranslationUnit(L"a.cpp", L"bar")}));
+	storage.failOnAddingFile = false;
+	storage.buildCaches();
+
+	REQUIRE(storage.getNodeIdForNameHierarchy(createNameHierarchy(L"foo")));
+	REQUIRE(!storage.getNodeIdForNameHierarchy(createNameHierarchy(L"bar")));
+	REQUIRE(storage.getFilePathIndexed(FilePath(L"a.cpp")));
+	REQUIRE(1 == storage.getReferencing({FilePath(L"header.h")}).size());
+
+	// the storage is usable afterwards
+	REQUIRE(storage.replaceFileElements(
+		{FilePath(L"a.cpp"), FilePath(L"header.h")}, {recordTranslationUnit(L"a.cpp", L"bar")}));
+	REQUIRE(storage.getNodeIdForNameHierarchy(createNameHierarchy(L"bar")));
+}
+
+TEST_CASE("storage replaces elements of a saved header", "[.benchmark]")
+{
+	// the storage part of re-indexing a saved header, the translation units are indexed beforehand
+	const size_t translationUnitCount = 2000;
+	const size_t includingTranslationUnitCount = 20;
+
+	TestStorage storage;
+	for (size_t i = 0; i < translationUnitCount; i++)
+	{
+		const std::wstring fileName = L"file_" + std::to_wstring(i) + L".cpp";
+		storage.inject(recordTranslationUnit(
+						   fileName,
+						   i < includingTranslationUnitCount ? L"foo" : L"other",
+						   i < includingTranslationUnitCount ? L"header.h" : L"other.h")
+						   .get());
+	}
+	storage.updateFileDependencies();
+	storage.buildCaches();
+
+	std::set<FilePath> filePaths = storage.getReferencing({FilePath(L"header.h")});
+	REQUIRE(includingTranslationUnitCount == filePaths.size());
+	filePaths.insert(FilePath(L"header.h"));
+
+	std::vector<std::shared_ptr<IntermediateStorage>> intermediateStorages;
+	for (size_t i = 0; i < includingTranslationUnitCount; i++)
+	{
+		const std::wstring fileName = L"file_" + std::to_wstring(i) + L".cpp";
+		intermediateStorages.push_back(recordTranslationUnit(fileName, L"foo"));
+	}
+
+	const TimeStamp start = TimeStamp::now();
+	REQUIRE(storage.replaceFileElements(filePaths, intermediateStorages));
+	const double seconds = TimeStamp::durationSeconds(start);
+
+	WARN(
+		"replacing " << includingTranslationUnitCount << " of " << translationUnitCount
+					 << " translation units: " << seconds << " s");
+}